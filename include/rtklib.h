@@ -306,7 +306,10 @@ extern "C" {
 #define MAXSTRPATH  300                /* max length of stream path */
 #define MAXCHARS    300
 #define MAXSTRMSG   1024                /* max length of stream message */
+#define MAXSTRWAIT  512                 /* max number of descriptors of stream waiter */
 #define MAXSTRRTK   8                   /* max number of stream in RTK server */
+#define MAXMROV     256                 /* max number of rovers in multi-rover server */
+#define MAXMCOR     4                   /* max number of correction streams in multi-rover server */
 #define MAXSBSMSG   32                  /* max number of SBAS msg in RTK server */
 #define MAXSOLMSG   8191                /* max length of solution message */
 #define MAXRAWLEN   4096                /* max length of receiver raw message */
@@ -319,6 +322,7 @@ extern "C" {
 #define MAXGISLAYER 32                  /* max number of GIS data layers */
 #define MAXRCVCMD   4096                /* max length of receiver commands */
 #define MAXFILE     12
+#define NTIDENODE   6                   /* number of nodes of tide interpolation */
 
 #define RNX2VER     2.10                /* RINEX ver.2 default output version */
 #define RNX3VER     3.00                /* RINEX ver.3 default output version */
@@ -493,6 +497,7 @@ extern "C" {
 #define SOLF_INS_LLH 6
 #define SOLF_INS_XYZ 7
 #define SOLF_INS_YGM 8
+#define SOLF_BIN     9                   /* solution format: binary record */
 
 #define SOLQ_NONE       0                   /* solution status: no solution */
 #define SOLQ_FIX        1                   /* solution status: fix */
@@ -609,6 +614,10 @@ extern "C" {
 #define KFOPT_VBKF        2
 #define KFOPT_SAGE_HUSA   3
 
+#define RMAT_DIAG   0                   /* measurement covariance: diagonal */
+#define RMAT_BLOCK  1                   /* measurement covariance: block-diagonal */
+#define RMAT_DENSE  2                   /* measurement covariance: dense */
+
 #define GLO_ARMODE_OFF     0            /* GLO AR mode: off */
 #define GLO_ARMODE_ON      1            /* GLO AR mode: on */
 #define GLO_ARMODE_AUTOCAL 2            /* GLO AR mode: autocal */
@@ -637,6 +646,7 @@ extern "C" {
 #define STR_HTTP     9                  /* stream type: http */
 #define STR_NTRIPC_S 10                 /* stream type: NTRIP caster server */
 #define STR_NTRIPC_C 11                 /* stream type: NTRIP caster client */
+#define STR_NTRIPCAS 11                 /* stream type: NTRIP caster */
 #define STR_UDPSVR   12                 /* stream type: UDP server */
 #define STR_UDPCLI   13                 /* stream type: UDP server */
 #define STR_MEMBUF   14                 /* stream type: memory buffer */
@@ -788,6 +798,7 @@ extern "C" {
 #define initlock(f) InitializeCriticalSection(f)
 #define lock(f)     EnterCriticalSection(f)
 #define unlock(f)   LeaveCriticalSection(f)
+#define THREADLOCAL __declspec(thread)
 #define FILEPATHSEP '\\'
 #else
 #define thread_t    pthread_t
@@ -795,6 +806,7 @@ extern "C" {
 #define initlock(f) pthread_mutex_init(f,NULL)
 #define lock(f)     pthread_mutex_lock(f)
 #define unlock(f)   pthread_mutex_unlock(f)
+#define THREADLOCAL __thread
 #define FILEPATHSEP '/'
 #endif
 
@@ -961,6 +973,30 @@ typedef struct {        /* earth rotation parameter type */
     erpd_t *data;       /* earth rotation parameter data */
 } erp_t;
 
+typedef struct {        /* astronomical context type */
+    gtime_t tutc;       /* reference time (utc) */
+    double erpv[5];     /* erp values {xp,yp,ut1_utc,lod} (rad,rad,s,s/d) */
+    double U[9];        /* eci to ecef transformation matrix */
+    double gmst;        /* greenwich mean sidereal time (rad) */
+    double rsun[3],rmoon[3]; /* sun/moon position in ecef (m) */
+    double vsun[3],vmoon[3]; /* sun/moon velocity in ecef (m/s) */
+} astro_t;
+
+typedef struct {        /* tidal displacement table type */
+    double tint;        /* node interval (s) (0: exact evaluation) */
+    int opt;            /* tide options of nodes */
+    int n;              /* number of valid nodes (0: not initialized) */
+    double k0;          /* node number of first node (time/tint) */
+    double rr[3];       /* site position of nodes (ecef) (m) */
+    double dr[NTIDENODE*3]; /* displacements at nodes (ecef) (m) */
+} tidetbl_t;
+
+typedef struct {        /* slant ionospheric delay cache type */
+    gtime_t time;       /* time of cached delays */
+    double iono[MAXSAT]; /* slant ionospheric delays (m) (0:no data) */
+    double std[MAXSAT]; /* standard deviations of delays (m) */
+} ionoc_t;
+
 typedef struct {        /* antenna parameter type */
     int sat;            /* satellite number (0:receiver) */
     char type[MAXANT];  /* antenna type */
@@ -971,11 +1007,21 @@ typedef struct {        /* antenna parameter type */
                         /* el=90,85,...,0 or nadir=0,1,2,3,... (deg) */
     double dazi;
     double zen1,zen2,dzen;
+    int nzen,nazi;      /* number of zenith/azimuth grid nodes (0: not set) */
 } pcv_t;
 
+typedef struct {        /* antenna parameter index type */
+    char key[MAXANT];   /* normalized antenna type "ANTENNA RADOME" */
+    int sat;            /* satellite number (0:receiver) */
+    int i;              /* index of antenna parameters */
+} pcvidx_t;
+
 typedef struct {        /* antenna parameters type */
     int n,nmax;         /* number of data/allocated */
     pcv_t *pcv;         /* antenna parameters data */
+    int nidx;           /* number of index entries (0: no index) */
+    pcvidx_t *idx;      /* index sorted by satellite, antenna type and order */
+    int ofs[MAXSAT+2];  /* start of index entries for each satellite */
 } pcvs_t;
 
 typedef struct {        /* almanac type */
@@ -1105,6 +1151,8 @@ typedef struct {        /* satellite fcb data type */
 
 typedef struct {
     int n,nmax;
+    double dt;          /* interval of records (s) (0: irregular) */
+    int sort;           /* records sorted by time (0:no,1:yes) */
     fcbd_t *data;
 }fcbs_t;
 
@@ -1116,6 +1164,8 @@ typedef struct {
 
 typedef struct {
     int n,nmax;
+    double dt;          /* interval of records (s) (0: irregular) */
+    int sort;           /* records sorted by time (0:no,1:yes) */
     nl_upd_t *data;
 }nl_upds_t;
 
@@ -1280,15 +1330,14 @@ typedef struct {        /* ppp corrections type */
     trop_t *trop[MAXSTA]; /* trop data */
 } pppcorr_t;
 
-typedef struct {
-    double code[MAXSAT][MAXCODE];
-    double phase[MAXSAT][MAXCODE];
-}osb_t;
-
-typedef struct {
-    gtime_t tmin,tmax;
-    double dt;
-    osb_t *sat_osb;
+typedef struct {        /* observable-specific signal biases type */
+    gtime_t tmin,tmax;  /* time span of biases (gpst) */
+    double dt;          /* interval of biases (s) */
+    int n;              /* number of intervals */
+    int ns;             /* number of satellite signals */
+    int *idx;           /* signal index {sat-1,code} -> {0,...,ns-1} (-1:none) */
+    double *code;       /* code biases {signal*n+interval} (m) */
+    double *phase;      /* phase biases {signal*n+interval} (m) */
 }osbs_t;
 
 typedef struct {        /* navigation data type */
@@ -1432,6 +1481,11 @@ typedef struct {        /* solution status buffer type */
     solstat_t *data;    /* solution status data */
 } solstatbuf_t;
 
+typedef struct {        /* sequential bit reader type */
+    const uint8_t *buff; /* byte data */
+    int pos;            /* bit position from start of data (bits) */
+} bitr_t;
+
 typedef struct {        /* RTCM control struct type */
     int staid;          /* station id */
     int stah;           /* station health */
@@ -2051,6 +2105,14 @@ typedef struct {        /* RTK control/result type */
     gtime_t filter_start;
     int exist_sys[NSYS+1];
     double dtrr;
+    astro_t ast;        /* astronomical context of current epoch */
+    tidetbl_t tide;     /* tidal displacement table */
+    int biascur;        /* record index of last fcb/upd search */
+    ionoc_t ionoc;      /* stec correction cache of last epoch */
+    int mainclk;        /* main system clock index of last epoch */
+    double mdlerr[6];   /* max single-double model diff (m) (-MDL_FLOAT=2)
+                           {windup,shapiro,pcv,trop,tide,phase residual by
+                           satellite models} */
 } rtk_t;
 
 typedef struct {
@@ -2065,8 +2127,10 @@ typedef struct {
     int *cp_idx;       /* priori carrier phase residual index */
 
     double sigma0;
-    double *R;         /* covariance using for residual normalize */
-    double *Qvv;       /* post covariance get from filter fun     */
+    double *R;         /* variance using for residual normalize (nv x 1) */
+    double *Qvv;       /* diagonal of post covariance from filter (nv x 1) */
+    int qvvfull;       /* request full post covariance Qvvf from filter */
+    double *Qvvf;      /* full post covariance from filter (nv x nv) */
 
     double *pri_pr;    /* priori pseudorange residual index   */
     double *pri_cp;    /* priori carrier phase residual       */
@@ -2077,6 +2141,15 @@ typedef struct {
     double *norm_cp;   /* normalized post carrier phase residual  */
 }res_t;
 
+typedef struct {        /* measurement error covariance type */
+    int type;           /* storage type (RMAT_???) */
+    int n;              /* number of measurements */
+    int nb,nbmax;       /* number of blocks/allocated (RMAT_BLOCK) */
+    int nd;             /* allocated size of d (0:borrowed) */
+    int *blk;           /* block sizes (RMAT_BLOCK) */
+    double *d;          /* diagonal, packed blocks or full matrix */
+} rmat_t;
+
 typedef struct half_cyc_tag {  /* half-cycle correction list type */
     unsigned char sat;  /* satellite number */
     unsigned char freq; /* frequency number (0:L1,1:L2,2:L5) */
@@ -2128,6 +2201,23 @@ typedef struct {        /* receiver raw data control type */
     void *strp;
 } raw_t;
 
+typedef struct {        /* single-producer/single-consumer ring buffer type */
+    uint8_t *buff;      /* ring buffer */
+    uint32_t size;      /* buffer size (bytes) (power of 2) */
+    volatile uint32_t wp; /* write pointer (updated by producer only) */
+    volatile uint32_t rp; /* read pointer (updated by consumer only) */
+} ring_t;
+
+typedef struct {        /* thread wakeup event type (auto reset) */
+#ifdef WIN32
+    HANDLE handle;      /* event object */
+#else
+    pthread_mutex_t mutex; /* mutex of signaled flag */
+    pthread_cond_t cond; /* condition variable (monotonic clock) */
+    int flag;           /* signaled flag */
+#endif
+} event_t;
+
 typedef struct {        /* stream type */
     int type;           /* type (STR_???) */
     int mode;           /* mode (STR_MODE_?) */
@@ -2144,6 +2234,20 @@ typedef struct {        /* stream type */
     char msg [MAXSTRMSG];  /* stream message */
 } stream_t;
 
+typedef struct {        /* stream event waiter type */
+    int epfd;           /* event descriptor (-1: not available) */
+    int n;              /* number of registered descriptors */
+    int fd[MAXSTRWAIT]; /* registered descriptors */
+    int ev[MAXSTRWAIT]; /* registered events */
+    uint32_t tick;      /* tick of last registration of all descriptors */
+} strwait_t;
+
+typedef struct {        /* shared stream frame type */
+    int nref;           /* reference count */
+    int n;              /* data length (bytes) */
+    uint8_t *buff;      /* data (not modified after strfrmnew()) */
+} strfrm_t;
+
 typedef struct {        /* stream converter type */
     int itype,otype;    /* input and output stream type */
     int nmsg;           /* number of output messages */
@@ -2152,6 +2256,8 @@ typedef struct {        /* stream converter type */
     unsigned int tick[32]; /* cycle tick of output message */
     int ephsat[32];     /* satellites of output ephemeris */
     int stasel;         /* station info selection (0:remote,1:local) */
+    int nb,nbmax;       /* output data length and buffer size (bytes) */
+    uint8_t *obuf;      /* output data buffer */
     rtcm_t rtcm;        /* rtcm input data buffer */
     raw_t raw;          /* raw  input data buffer */
     rtcm_t out;         /* rtcm output data buffer */
@@ -2173,10 +2279,17 @@ typedef struct {        /* stream server type */
     stream_t stream[16]; /* input/output streams */
     stream_t strlog[16]; /* return log streams */
     strconv_t *conv[16]; /* stream converter */
+    int convsrc[16];    /* output stream of shared converted data (0:own) */
     thread_t thread;    /* server thread */
     lock_t lock;        /* lock flag */
 } strsvr_t;
 
+typedef struct {        /* RTK server input stream reader type */
+    int index;          /* input stream index (0:rov,1:base,2:corr) */
+    void *svr;          /* RTK server (rtksvr_t *) */
+    thread_t thread;    /* reader thread */
+} rtksvrrd_t;
+
 typedef struct {        /* RTK server type */
     int state;          /* server state (0:stop,1:running) */
     int cycle;          /* processing cycle (ms) */
@@ -2208,17 +2321,84 @@ typedef struct {        /* RTK server type */
     stream_t stream[8]; /* streams {rov,base,corr,sol1,sol2,logr,logb,logc} */
     stream_t *moni;     /* monitor stream */
     unsigned int tick;  /* start tick */
-    thread_t thread;    /* server thread */
+    thread_t thread;    /* solver thread */
+    thread_t thread_dec; /* decoder thread */
+    thread_t thread_out; /* output writer thread */
+    rtksvrrd_t reader[3]; /* input stream readers {rov,base,corr} */
+    ring_t rbuf[3];     /* input data rings (reader->decoder) */
+    ring_t robs;        /* observation epoch ring (decoder->solver) */
+    ring_t rout;        /* solution output ring (solver->writer) */
+    int ostate;         /* output writer state (0:stop,1:running) */
+    event_t ev_rd[3];   /* wakeup of readers (input ring space) */
+    event_t ev_dec;     /* wakeup of decoder (input data) */
+    event_t ev_sol;     /* wakeup of solver (observation data) */
+    event_t ev_osp;     /* wakeup of solver (output ring space) */
+    event_t ev_out;     /* wakeup of writer (output messages) */
+    sol_t sol;          /* latest solution (for monitor) */
+    double azel[MAXSAT*2]; /* latest satellite azimuth/elevation (rad) */
+    uint8_t vsat[MAXSAT]; /* latest valid satellite flags */
     int cputime;        /* CPU time (ms) for a processing cycle */
     int prcout;         /* missing observation data count */
+    int outdrop;        /* dropped output message count */
     int nave;           /* number of averaging base pos */
     double rb_ave[3];   /* averaging base pos */
     char cmds_periodic[3][MAXRCVCMD]; /* periodic commands */
     char cmd_reset[MAXRCVCMD]; /* reset command */
     double bl_reset;    /* baseline length to reset (km) */
-    lock_t lock;        /* lock flag */
+    lock_t lock;        /* lock flag (monitor status and buffers) */
+    lock_t lock_nav;    /* lock flag (navigation data and base position) */
 } rtksvr_t;
 
+typedef struct {        /* multi-rover server navigation snapshot type */
+    nav_t nav;          /* navigation data (read-only while referred) */
+    uint32_t ver;       /* snapshot version */
+    int nref;           /* number of references (0:free) */
+} navsnap_t;
+
+typedef struct {        /* multi-rover server rover engine type */
+    int index;          /* rover index */
+    int format;         /* input stream format (STRFMT_???) */
+    int busy;           /* serviced by worker (0:idle,1:busy) */
+    int nsol;           /* number of valid solutions */
+    uint32_t ver;       /* version of last referred navigation snapshot */
+    uint8_t *buff;      /* input buffer */
+    obs_t obs;          /* observation data of an epoch */
+    solopt_t solopt;    /* output solution options */
+    rtk_t rtk;          /* RTK control/result struct */
+    raw_t *raw;         /* receiver raw control (NULL: RTCM input) */
+    rtcm_t *rtcm;       /* RTCM control (NULL: receiver raw input) */
+    sol_t sol;          /* latest solution (for monitor) */
+    stream_t stream[3]; /* streams {input,solution,log} */
+    lock_t lock;        /* lock flag (latest solution) */
+} mrtkrov_t;
+
+typedef struct {        /* multi-rover RTK server type */
+    int state;          /* server state (0:stop,1:running) */
+    int cycle;          /* processing cycle (ms) */
+    int buffsize;       /* input buffer size (bytes) */
+    int nworker;        /* number of rover worker threads */
+    int nrov;           /* number of rover engines */
+    int next;           /* next rover engine serviced by worker */
+    int nsnap;          /* number of navigation snapshots */
+    int fnav;           /* navigation data updated after published */
+    uint32_t ver;       /* version of latest navigation snapshot */
+    int format[MAXMCOR]; /* correction stream formats */
+    int nb[MAXMCOR];    /* bytes in correction input buffers */
+    uint8_t *buff[MAXMCOR]; /* correction input buffers */
+    uint32_t nmsg[MAXMCOR][10]; /* correction input message counts */
+    raw_t  *raw [MAXMCOR]; /* receiver raw control of correction streams */
+    rtcm_t *rtcm[MAXMCOR]; /* RTCM control of correction streams */
+    stream_t stream[MAXMCOR]; /* correction streams */
+    nav_t nav;          /* working navigation data (correction decoder) */
+    navsnap_t *snap;    /* navigation snapshots */
+    navsnap_t *cur;     /* current navigation snapshot */
+    mrtkrov_t *rov[MAXMROV]; /* rover engines */
+    thread_t thread;    /* correction decoder thread */
+    thread_t *worker;   /* rover worker threads */
+    lock_t lock;        /* lock flag (rover engines) */
+    lock_t lock_snap;   /* lock flag (navigation snapshot references) */
+} mrtksvr_t;
+
 typedef struct {        /* gis data point type */
     double pos[3];      /* point data {lat,lon,height} (rad,m) */
 } gis_pnt_t;
@@ -2321,6 +2501,19 @@ EXPORT int  lsq_(const double *H,const double *R, const double *y, int n, int m,
                    double *Q);
 EXPORT int  filter(double *x, double *P, const double *H, const double *v,
                    const double *R, int n, int m,int qc, int kf_type,res_t *res,int tc);
+EXPORT int  filter_rmat(double *x, double *P, const double *H, const double *v,
+                        const rmat_t *R, int n, int m, int qc, int kf_type, res_t *res,
+                        int tc);
+EXPORT double *rmat_init(rmat_t *R, int type, int n, const int *blk, int nb);
+EXPORT void rmat_setdiag(rmat_t *R, const double *var, int n);
+EXPORT void rmat_wrap(rmat_t *R, const double *A, int n);
+EXPORT void rmat_free(rmat_t *R);
+EXPORT double rmat_get(const rmat_t *R, int i, int j);
+EXPORT void rmat_add(const rmat_t *R, double *A);
+EXPORT void rmat_todense(const rmat_t *R, double *A);
+EXPORT void rmat_mulr(const double *A, int n, const rmat_t *R, double *B);
+EXPORT void rmat_mull(const rmat_t *R, const double *A, int n, double *B);
+EXPORT void rmat_diagrar(const rmat_t *R, const double *A, double *d);
 EXPORT int  smoother(const double *xf, const double *Qf, const double *xb,
                      const double *Qb, int n, double *xs, double *Qs);
 EXPORT void matprint (int trans,const double *A, int n, int m, int p, int q);
@@ -2336,6 +2529,7 @@ EXPORT void upstr(const char *s,char *s1,int n);
 EXPORT void setstr(char *dst, const char *src, int n);
 EXPORT void strmcpy(const char* src,const char* str_flag,int start_idx,int m,char *s);
 EXPORT double  str2num(const char *s, int i, int n);
+EXPORT int     fixf2str(char *buff, double value, int width, int prec);
 EXPORT int     str2time(const char *s, int i, int n, gtime_t *t);
 EXPORT int     str2time1(const char *s, int i, int n, gtime_t *t);
 EXPORT void    time2str(gtime_t t, char *str, int n);
@@ -2370,6 +2564,16 @@ EXPORT int read_leaps(const char *file);
 EXPORT int adjgpsweek(int week);
 EXPORT unsigned int tickget(void);
 EXPORT void sleepms(int ms);
+EXPORT int  ringinit (ring_t *ring, int size);
+EXPORT void ringfree (ring_t *ring);
+EXPORT int  ringcount(ring_t *ring);
+EXPORT int  ringspace(ring_t *ring);
+EXPORT int  ringwrite(ring_t *ring, const uint8_t *buff, int n);
+EXPORT int  ringread (ring_t *ring, uint8_t *buff, int n);
+EXPORT void eventinit(event_t *event);
+EXPORT void eventfree(event_t *event);
+EXPORT void eventset (event_t *event);
+EXPORT int  eventwait(event_t *event, int timeout);
 
 EXPORT int reppath(const char *path, char *rpath, gtime_t time, const char *rov,
                    const char *base);
@@ -2422,6 +2626,8 @@ EXPORT int read_gnss_file(prcopt_t *popt, const filopt_t *fopt, int mode,int nee
 /* debug trace functions -----------------------------------------------------*/
 EXPORT void traceopen(const char *file);
 EXPORT void traceclose(void);
+EXPORT void traceopenthr(const char *file);
+EXPORT void traceclosethr(void);
 EXPORT void tracelevel(int level);
 EXPORT void trace    (int level, const char *format, ...);
 EXPORT void tracet   (int level, const char *format, ...);
@@ -2462,6 +2668,9 @@ EXPORT double ionppp(const double *pos, const double *azel, double re,
                      double hion, double *pppos);
 EXPORT int iontec(gtime_t time, const nav_t *nav, const double *pos,
                   const double *azel, int opt, double *delay, double *var);
+EXPORT int iontecs(gtime_t time, const nav_t *nav, const double *pos,
+                   const double *azel, int n, int opt, double *delay,
+                   double *var, int *stat);
 EXPORT double iontecvar(int ep,gtime_t t,const double *pos,const double *azel);
 EXPORT void readtec(const char *file, nav_t *nav, int opt);
 EXPORT double klobuchar_GPS(gtime_t t, const double *ion, const double *pos,
@@ -2470,16 +2679,20 @@ extern double klobuchar_BDS(gtime_t t, const double *ion, const double *pos,
                             const double *azel);
 extern int model_iono(gtime_t time, const double *pos, const double *azel,
                       const prcopt_t *opt, int sat, const double *x,
-                      const nav_t *nav, double *dion, double *var);
+                      const nav_t *nav, ionoc_t *ionoc, double *dion,
+                      double *var);
 
 EXPORT double saastamoinen(gtime_t time, const double *pos, const double *azel,
                         double humi,int gpt,double *ztrph,double *ztrpw);
 EXPORT double trop_UNB3(gtime_t t,double *pos,double el,double *ztrpw);
 EXPORT double tropmapf(const prcopt_t *popt,gtime_t time, const double *pos, const double *azel,
                        double *mapfw);
+EXPORT double tropmapfx(const prcopt_t *popt, gtime_t time, const double *pos,
+                        const double *azel, int opt, double *mapfw);
 EXPORT int model_trop(gtime_t time, const double *pos, const double *azel,
                       const prcopt_t *opt, const double *x, double *dtdx,
-                      const nav_t *nav, double *dtrp,double *ztrp,double *mtrp, double *var,int it);
+                      const nav_t *nav, double *dtrp,double *ztrp,double *mtrp, double *var,int it,
+                      int sp);
 
 EXPORT int ionocorr(gtime_t time, const nav_t *nav, int sat, const double *pos,
                     const double *azel, int ionoopt, double *ion, double *var);
@@ -2488,6 +2701,7 @@ EXPORT int tropcorr(gtime_t time, const nav_t *nav, const double *pos,
 
 /* antenna models ------------------------------------------------------------*/
 EXPORT int  readpcv(const char *file, pcvs_t *pcvs);
+EXPORT void freepcv(pcvs_t *pcvs);
 EXPORT pcv_t *searchpcv(int sat, const char *type, gtime_t time,
                         const pcvs_t *pcvs);
 EXPORT void antmodel(int sat,const pcv_t *pcv, const double *del, const double *azel,
@@ -2497,13 +2711,20 @@ EXPORT void antmodel_s(const pcv_t *pcv, double nadir, double *dant);
 /* earth tide models ---------------------------------------------------------*/
 EXPORT void sunmoonpos(gtime_t tutc, const double *erpv, double *rsun,
                        double *rmoon, double *gmst);
+EXPORT void astroinit(gtime_t tutc, const double *erpv, astro_t *ast);
+EXPORT void astrosunmoon(const astro_t *ast, gtime_t tutc, const double *erpv,
+                         double *rsun, double *rmoon, double *gmst);
 EXPORT void tidedisp(gtime_t tutc, const double *rr, int opt, const erp_t *erp,
-                     const double *odisp, double *dr);
+                     const astro_t *ast, const double *odisp, double *dr);
+EXPORT void tidedisp_tbl(tidetbl_t *tbl, gtime_t tutc, const double *rr, int opt,
+                         const erp_t *erp, const astro_t *ast,
+                         const double *odisp, double *dr);
 
 /* geiod models --------------------------------------------------------------*/
 EXPORT int opengeoid(int model, const char *file);
 EXPORT void closegeoid(void);
 EXPORT double geoidh(const double *pos);
+EXPORT void geoidh_n(const double *pos, int n, double *h);
 
 /* datum transformation ------------------------------------------------------*/
 EXPORT int loaddatump(const char *file);
@@ -2529,8 +2750,12 @@ EXPORT int outrnxinavh(FILE *fp, const rnxopt_t *opt, const nav_t *nav);
 EXPORT int outrnxnavb (FILE *fp, const rnxopt_t *opt, const eph_t *eph);
 EXPORT int outrnxgnavb(FILE *fp, const rnxopt_t *opt, const geph_t *geph);
 EXPORT int outrnxhnavb(FILE *fp, const rnxopt_t *opt, const seph_t *seph);
+EXPORT int navf2str(char *buff, double value, int n);
 EXPORT int rtk_uncompress(const char *file, char *uncfile);
 EXPORT int convrnx(const prcopt_t *popt,int format, rnxopt_t *opt, const char *file, char **ofile);
+EXPORT int convrnx_batch(const prcopt_t *popt, int n, const int *format,
+                         rnxopt_t *opt, char **file, char **ofile, int nthread,
+                         int *stat);
 EXPORT int  init_rnxctr (rnxctr_t *rnx);
 EXPORT void free_rnxctr (rnxctr_t *rnx);
 EXPORT int  open_rnxctr (rnxctr_t *rnx, FILE *fp);
@@ -2546,15 +2771,19 @@ EXPORT void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
                      double *var);
 EXPORT void seph2pos(gtime_t time, const seph_t *seph, double *rs, double *dts,
                      double *var);
-EXPORT int  peph2pos(const prcopt_t *popt,gtime_t time, int sat, const nav_t *nav, int opt,
-                     double *rs, double *dts, double *var);
+EXPORT void eph2posn(int n, const gtime_t *time, const eph_t **eph, double *rs,
+                     double *dts, double *var);
+EXPORT int  peph2pos(const prcopt_t *popt,gtime_t time, int sat, const nav_t *nav,
+                     const astro_t *ast, int opt, double *rs, double *dts,
+                     double *var);
 EXPORT void satantoff(const prcopt_t *popt,gtime_t time, const double *rs, int sat, const nav_t *nav,
-                      double *dant);
+                      const astro_t *ast, double *dant);
 EXPORT int  satpos(const prcopt_t *popt,gtime_t time, gtime_t teph, int sat, int ephopt,
-                   const nav_t *nav, double *rs, double *dts, double *var,
-                   int *svh);
+                   const nav_t *nav, const astro_t *ast, double *rs, double *dts,
+                   double *var, int *svh);
 EXPORT void satposs(const prcopt_t *popt,gtime_t time, const obsd_t *obs, int n, const nav_t *nav,
-                    int sateph, double *rs, double *dts, double *var, int *svh);
+                    const astro_t *ast, int sateph, double *rs, double *dts,
+                    double *var, int *svh);
 EXPORT void satseleph(int sys, int sel);
 EXPORT int  getseleph(int sys);
 EXPORT void readsp3(const char *file, nav_t *nav, int opt);
@@ -2565,6 +2794,10 @@ EXPORT int  readosb_igg(const char *file, nav_t *nav);
 EXPORT int  readfcb(const char *file, nav_t *nav);
 EXPORT int  readosb(const char *file, nav_t *nav);
 EXPORT int  readupd(const prcopt_t *opt,char *file_ewl,char *file_wl,char *file_nl, nav_t *nav);
+EXPORT int  searchfcb(const fcbs_t *fcbs, gtime_t time, int *cur);
+EXPORT int  searchnlupd(const nl_upds_t *nls, gtime_t time, int *cur);
+EXPORT int  getosb(const osbs_t *osbs, gtime_t time, int sat, int code,
+                   double *cbias, double *pbias);
 EXPORT void readotl(prcopt_t *popt, const char *file, const sta_t *sta);
 EXPORT void setpcv(gtime_t time, prcopt_t *popt, nav_t *nav, const pcvs_t *pcvs,
                    const pcvs_t *pcvr, const sta_t *sta);
@@ -2581,6 +2814,8 @@ EXPORT uint32_t getbitu(const uint8_t *buff, int pos, int len);
 EXPORT int32_t          getbits(const uint8_t *buff, int pos, int len);
 EXPORT void setbitu(uint8_t *buff, int pos, int len, unsigned int data);
 EXPORT void setbits(uint8_t *buff, int pos, int len, int data);
+EXPORT uint32_t rdbitu(bitr_t *br, int len);
+EXPORT int32_t  rdbits(bitr_t *br, int len);
 EXPORT uint32_t rtk_crc32  (const uint8_t *buff, int len);
 EXPORT uint32_t rtk_crc24q (const uint8_t *buff, int len);
 EXPORT uint16_t rtk_crc16(const uint8_t *buff, int len);
@@ -2603,6 +2838,9 @@ EXPORT int init_raw   (raw_t *raw, int format);
 EXPORT void free_raw  (raw_t *raw);
 EXPORT int input_raw  (raw_t *raw, int format, unsigned char data);
 EXPORT int input_rawf (raw_t *raw, int format, FILE *fp);
+EXPORT size_t input_raw_buf(raw_t *raw, int format, const uint8_t *buff,
+                            size_t n, int (*func)(raw_t *, int, void *),
+                            void *arg);
 
 EXPORT int init_rt17  (raw_t *raw);
 EXPORT int init_cmr   (raw_t *raw);
@@ -2653,6 +2891,8 @@ EXPORT int input_rtcm2 (rtcm_t *rtcm, unsigned char data);
 EXPORT int input_rtcm3 (rtcm_t *rtcm, unsigned char data);
 EXPORT int input_rtcm2f(rtcm_t *rtcm, FILE *fp);
 EXPORT int input_rtcm3f(rtcm_t *rtcm, FILE *fp);
+EXPORT size_t input_rtcm3_buf(rtcm_t *rtcm, const uint8_t *buff, size_t n,
+                              int (*func)(rtcm_t *, int, void *), void *arg);
 EXPORT int gen_rtcm2   (rtcm_t *rtcm, int type, int sync);
 EXPORT int gen_rtcm3   (rtcm_t *rtcm, int type, int subtype, int sync);
 
@@ -2681,6 +2921,8 @@ EXPORT int outsolheads(unsigned char *buff, const solopt_t *opt,const prcopt_t *
 EXPORT int outsols  (unsigned char *buff, const sol_t *sol, const double *rb,
                      const solopt_t *opt,const prcopt_t *popt,const solins_t *ins_sol);
 EXPORT int outsolexs(unsigned char *buff, const sol_t *sol, const ssat_t *ssat, const solopt_t *opt);
+EXPORT int outsolbs (unsigned char *buff, const sol_t *sol);
+EXPORT int outsolstatbs(unsigned char *buff, const solstat_t *stat);
 EXPORT void outprcopt(FILE *fp, const prcopt_t *opt);
 EXPORT void outsolhead(FILE *fp, const solopt_t *opt,const prcopt_t *popt);
 EXPORT void outsol  (FILE *fp, const sol_t *sol, const double *rb,
@@ -2743,7 +2985,14 @@ EXPORT int  stropen  (stream_t *stream, int type, int mode, const char *path);
 EXPORT void strclose (stream_t *stream);
 EXPORT int  strread  (stream_t *stream, unsigned char *buff, int n);
 EXPORT int  strwrite (stream_t *stream, unsigned char *buff, int n);
+EXPORT int  strwritefrm(stream_t *stream, strfrm_t *frm);
+EXPORT strfrm_t *strfrmnew(const uint8_t *buff, int n);
+EXPORT void strfrmfree(strfrm_t *frm);
 EXPORT void strsync  (stream_t *stream1, stream_t *stream2);
+EXPORT int  strwaitinit(strwait_t *wait);
+EXPORT void strwaitfree(strwait_t *wait);
+EXPORT int  strwait  (strwait_t *wait, stream_t *stream, int n, int timeout);
+EXPORT int  strwaitp (strwait_t *wait, stream_t **stream, int n, int timeout);
 EXPORT int  strstat  (stream_t *stream, char *msg);
 EXPORT int  strstatx (stream_t *stream, char *msg);
 EXPORT void strsum   (stream_t *stream, int *inb, int *inr, int *outb, int *outr);
@@ -2774,8 +3023,9 @@ EXPORT void getcorrobs(const prcopt_t *popt,const obsd_t *obs,const nav_t *nav,c
 
 EXPORT int test_sys(int sys, int m);
 EXPORT void ddcov(const int *nb, int n, const double *Ri, const double *Rj, int nv, double *R);
+EXPORT void ddcov_rmat(const int *nb, int n, const double *Ri, const double *Rj, int nv, rmat_t *R);
 EXPORT void init_prires(const double *v,const int *vflag,int nv,res_t *res);
-EXPORT void init_postres(rtk_t *rtk,const double *post_v,res_t *res,const double *R);
+EXPORT void init_postres(rtk_t *rtk,const double *post_v,res_t *res,const double *var);
 EXPORT void freeres(res_t *res);
 EXPORT int resqc(gtime_t t,rtk_t *rtk,res_t *res,int *exc,int ppp);
 EXPORT int pri_res_check(gtime_t t,rtk_t *rtk,const double *pri_v,const int *vflag,int nv,int *exc);
@@ -2790,7 +3040,7 @@ EXPORT void rtkinit(rtk_t *rtk, const prcopt_t *opt,const imup_t *imup);
 EXPORT void rtkfree(rtk_t *rtk);
 EXPORT int  rtkpos (rtk_t *rtk, obsd_t *obs, int nobs, const nav_t *nav);
 EXPORT int iamb_ppk(const prcopt_t *opt,int sat,int f);
-EXPORT int  rtkopenstat(const char *file, int level);
+EXPORT int  rtkopenstat(const char *file, int level, int format);
 EXPORT void rtkclosestat(void);
 EXPORT int  rtkoutstat(rtk_t *rtk, char *buff);
 EXPORT int  rtkopenfcbstat(const char *file_wl,const char *file_nl,const char *file_lc);
@@ -2823,6 +3073,7 @@ EXPORT int postpos(gtime_t ts, gtime_t te, double ti, double tu,
                    const prcopt_t *popt, const solopt_t *sopt,
                    const filopt_t *fopt, char **infile, int n, char *outfile,
                    const char *rov, const char *base);
+EXPORT void postposstat(int *nepoch, int *nfix);
 EXPORT int couplepos(prcopt_t *popt,const filopt_t *fopt,solopt_t *solopt,stream_t *moni);
 
 /* stream server functions ---------------------------------------------------*/
@@ -2857,6 +3108,20 @@ EXPORT int  rtksvrostat (rtksvr_t *svr, int type, gtime_t *time, int *sat,
 EXPORT void rtksvrsstat (rtksvr_t *svr, int *sstat, char *msg);
 EXPORT int  rtksvrmark(rtksvr_t *svr, const char *name, const char *comment);
 
+/* multi-rover rtk server functions ------------------------------------------*/
+EXPORT int  mrtksvrinit  (mrtksvr_t *svr);
+EXPORT void mrtksvrfree  (mrtksvr_t *svr);
+EXPORT int  mrtksvrstart (mrtksvr_t *svr, int cycle, int buffsize, int nworker,
+                          const int *strs, char **paths, const int *formats,
+                          char **rcvopts, char *errmsg);
+EXPORT void mrtksvrstop  (mrtksvr_t *svr);
+EXPORT int  mrtksvraddrov(mrtksvr_t *svr, const int *strs, char **paths,
+                          int format, const char *rcvopt,
+                          const prcopt_t *prcopt, const solopt_t *solopt,
+                          char *errmsg);
+EXPORT int  mrtksvrrovstat(mrtksvr_t *svr, int index, sol_t *sol, int *nsol,
+                           uint32_t *ver);
+
 /* downloader functions ------------------------------------------------------*/
 EXPORT int dl_readurls(const char *file, char **types, int ntype, url_t *urls,
                        int nmax);
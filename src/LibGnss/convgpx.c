@@ -54,17 +54,24 @@ static void outpoint(FILE *fp, gtime_t time, const double *pos,
 static void outtrack(FILE *fp, const solbuf_t *solbuf, int outalt, int outtime)
 {
     gtime_t time;
-    double pos[3],ep[6];
+    double pos[3],ep[6],*poss=NULL,*hgeo=NULL,h=0.0;
     int i;
     
+    /* geoid heights of whole track */
+    if (outalt==2&&solbuf->n>0&&(poss=mat(3,solbuf->n))&&
+        (hgeo=mat(solbuf->n,1))) {
+        for (i=0;i<solbuf->n;i++) ecef2pos(solbuf->data[i].rr,poss+i*3);
+        geoidh_n(poss,solbuf->n,hgeo);
+    }
     fprintf(fp,"<trk>\n");
     fprintf(fp," <trkseg>\n");
     for (i=0;i<solbuf->n;i++) {
         ecef2pos(solbuf->data[i].rr,pos);
         fprintf(fp,"  <trkpt lat=\"%.9f\" lon=\"%.9f\">\n",pos[0]*R2D,
                 pos[1]*R2D);
+        if (outalt==2) h=hgeo?hgeo[i]:geoidh(pos);
         if (outalt) {
-            fprintf(fp,"   <ele>%.4f</ele>\n",pos[2]-(outalt==2?geoidh(pos):0.0));
+            fprintf(fp,"   <ele>%.4f</ele>\n",pos[2]-(outalt==2?h:0.0));
         }
         if (outtime) {
             time=solbuf->data[i].time;
@@ -75,12 +82,13 @@ static void outtrack(FILE *fp, const solbuf_t *solbuf, int outalt, int outtime)
                     ep[0],ep[1],ep[2],ep[3],ep[4],ep[5]);
         }
         if (outalt==2) {
-            fprintf(fp,"   <geoidheight>%.4f</geoidheight>\n",geoidh(pos));
+            fprintf(fp,"   <geoidheight>%.4f</geoidheight>\n",h);
         }
         fprintf(fp,"  </trkpt>\n");
     }
     fprintf(fp," </trkseg>\n");
     fprintf(fp,"</trk>\n");
+    free(poss); free(hgeo);
 }
 /* save gpx file -------------------------------------------------------------*/
 static int savegpx(const char *file, const solbuf_t *solbuf, int outtrk,
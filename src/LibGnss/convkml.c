@@ -35,9 +35,15 @@ static const char *mark="http://maps.google.com/mapfiles/kml/pal2/icon18.png";
 static void outtrack(FILE *f, const solbuf_t *solbuf, const char *color,
                      int outalt, int outtime)
 {
-    double pos[3];
+    double pos[3],*poss=NULL,*hgeo=NULL;
     int i;
     
+    /* geoid heights of whole track */
+    if (outalt==2&&solbuf->n>0&&(poss=mat(3,solbuf->n))&&
+        (hgeo=mat(solbuf->n,1))) {
+        for (i=0;i<solbuf->n;i++) ecef2pos(solbuf->data[i].rr,poss+i*3);
+        geoidh_n(poss,solbuf->n,hgeo);
+    }
     fprintf(f,"<Placemark>\n");
     fprintf(f,"<name>Rover Track</name>\n");
     fprintf(f,"<Style>\n");
@@ -51,9 +57,10 @@ static void outtrack(FILE *f, const solbuf_t *solbuf, const char *color,
     for (i=0;i<solbuf->n;i++) {
         ecef2pos(solbuf->data[i].rr,pos);
         if      (outalt==0) pos[2]=0.0;
-        else if (outalt==2) pos[2]-=geoidh(pos);
+        else if (outalt==2) pos[2]-=hgeo?hgeo[i]:geoidh(pos);
         fprintf(f,"%13.9f,%12.9f,%5.3f\n",pos[1]*R2D,pos[0]*R2D,pos[2]);
     }
+    free(poss); free(hgeo);
     fprintf(f,"</coordinates>\n");
     fprintf(f,"</LineString>\n");
     fprintf(f,"</Placemark>\n");
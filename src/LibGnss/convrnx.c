@@ -43,12 +43,16 @@
 *                           fix bug on screening time in screent_ttol()
 *                           fix bug on screening QZS L1S messages as SBAS
 *                           use integer types in stdint.h
+*           2026/10/18 1.16 add API convrnx_batch()
+*                           large stdio buffer for output RINEX files
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
 #define NOUTFILE        9       /* number of output files */
 #define NSATSYS         7       /* number of satellite systems */
 #define TSTARTMARGIN    60.0    /* time margin for file name replacement */
+#define MAXCNVTHREAD    64      /* max number of batch conversion threads */
+#define RNXBUFSIZE      1048576 /* size of output file buffer (bytes) */
 
 #define EVENT_STARTMOVE 2       /* rinex event start moving antenna */
 #define EVENT_NEWSITE   3       /* rinex event new site occupation */
@@ -57,6 +61,18 @@
 
 /* type definitions ----------------------------------------------------------*/
 
+typedef struct {                /* batch conversion type */
+    const prcopt_t *popt;       /* processing options */
+    int n;                      /* number of conversion jobs */
+    const int *format;          /* receiver raw formats */
+    rnxopt_t *opt;              /* RINEX options */
+    char **file;                /* input files */
+    char **ofile;               /* output files (NOUTFILE per job) */
+    int *stat;                  /* status of jobs */
+    int next;                   /* index of next job */
+    lock_t lock;                /* lock flag */
+} cnvbatch_t;
+
 typedef struct stas_tag {       /* station list type */
     int staid;                  /* station IS */
     gtime_t ts,te;              /* first and last observation time */
@@ -866,6 +882,8 @@ static int openfile(FILE **ofp, char *files[], const char *file,
             for (i--;i>=0;i--) if (ofp[i]) fclose(ofp[i]);
             return 0;
         }
+        setvbuf(ofp[i],NULL,_IOFBF,RNXBUFSIZE);
+        
         /* write RINEX header */
         write_header(ofp,i,opt,nav);
     }
@@ -1421,3 +1439,85 @@ extern int convrnx(const prcopt_t *popt,int format, rnxopt_t *opt, const char *f
     
     return stat;
 }
+/* batch conversion thread --------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI cnvthread(void *arg)
+#else
+static void *cnvthread(void *arg)
+#endif
+{
+    cnvbatch_t *batch=(cnvbatch_t *)arg;
+    int i;
+    
+    for (;;) {
+        lock(&batch->lock);
+        i=batch->next++;
+        unlock(&batch->lock);
+        if (i>=batch->n) break;
+        
+        batch->stat[i]=convrnx(batch->popt,batch->format[i],batch->opt+i,
+                               batch->file[i],batch->ofile+i*NOUTFILE);
+    }
+    return 0;
+}
+/* RINEX converter for multiple files ------------------------------------------
+* convert receiver log files to RINEX in parallel
+* args   : prcopt_t *popt I     processing options
+*          int    n      I      number of conversion jobs
+*          int    *format I     receiver raw formats {format[0],...}
+*          rnxopt_t *opt IO     RINEX options {opt[0],...} (see convrnx())
+*          char   **file I      RTCM, receiver raw or RINEX files {file[0],...}
+*          char   **ofile IO    output files of job i: ofile[i*9]...ofile[i*9+8]
+*                               (see convrnx())
+*          int    nthread I     number of threads (0: number of jobs)
+*          int    *stat  O      status of jobs (1:ok,0:error,-1:abort)
+*                               (NULL: no output)
+* return : number of successfully converted jobs
+* notes  : each job is converted by convrnx() with its own stream file and
+*          RINEX options, so outputs are the same as those converted one by
+*          one. output files of the jobs must be different.
+*          showmsg() is called from the conversion threads.
+*-----------------------------------------------------------------------------*/
+extern int convrnx_batch(const prcopt_t *popt, int n, const int *format,
+                         rnxopt_t *opt, char **file, char **ofile, int nthread,
+                         int *stat)
+{
+    cnvbatch_t batch={0};
+    thread_t thread[MAXCNVTHREAD];
+    int i,nt,nok=0,*stat_;
+    
+    trace(3,"convrnx_batch: n=%d nthread=%d\n",n,nthread);
+    
+    if (n<=0||!(stat_=(int *)calloc(n,sizeof(int)))) return 0;
+    
+    batch.popt=popt; batch.n=n; batch.format=format; batch.opt=opt;
+    batch.file=file; batch.ofile=ofile; batch.stat=stat_;
+    initlock(&batch.lock);
+    
+    if (nthread<=0||nthread>n) nthread=n;
+    if (nthread>MAXCNVTHREAD) nthread=MAXCNVTHREAD;
+    
+    for (nt=0;nt<nthread-1;nt++) {
+#ifdef WIN32
+        if (!(thread[nt]=CreateThread(NULL,0,cnvthread,&batch,0,NULL))) break;
+#else
+        if (pthread_create(thread+nt,NULL,cnvthread,&batch)) break;
+#endif
+    }
+    cnvthread(&batch); /* calling thread takes jobs too */
+    
+    for (i=0;i<nt;i++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[i],INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i],NULL);
+#endif
+    }
+    for (i=0;i<n;i++) {
+        if (stat_[i]>0) nok++;
+        if (stat) stat[i]=stat_[i];
+    }
+    free(stat_);
+    return nok;
+}
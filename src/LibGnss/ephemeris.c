@@ -70,6 +70,10 @@
 *                           fix bug on clock reference time in satpos_ssr()
 *                           fix bug on wrong value with ura=15 in var_ura()
 *                           use integer types in stdint.h
+*                           add api eph2posn()
+*                           cache glonass orbit integration per satellite
+*                           analytical satellite velocity and clock drift
+*                           for broadcast ephemeris in satpos(),satposs()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -104,6 +108,15 @@
 #define STD_GAL_NAPA 500.0        /* error of galileo ephemeris for NAPA (m) */
 
 #define MAX_ITER_KEPLER 30        /* max number of iteration of Kelpler */
+#define NEPHBLK     32            /* number of ephemerides in a block */
+
+typedef struct {            /* glonass orbit integration cache type */
+    gtime_t toe;            /* ephemeris reference time (gpst) (0: empty) */
+    int iode;               /* ephemeris iode */
+    double pos[3],vel[3];   /* ephemeris position/velocity (m|m/s) */
+    int k;                  /* node of cached state (k*TSTEP from toe) */
+    double x[6];            /* state at node {x,y,z,vx,vy,vz} (m|m/s) */
+} glocache_t;
 
 /* ephemeris selections ------------------------------------------------------*/
 static int eph_sel[]={ /* GPS,GLO,GAL,QZS,BDS,IRN,SBS */
@@ -285,6 +298,142 @@ extern void eph2pos(gtime_t time, const eph_t *eph, double *rs, double *dts, dou
     /* position and clock error variance */
     *var=var_uraeph(sys,eph->sva);
 }
+/* broadcast ephemerides to satellite positions, velocities and clocks ---------
+* compute satellite positions, velocities, clock biases and drifts with
+* broadcast ephemerides of multiple satellites (gps,galileo,qzss,beidou,navic)
+* args   : int    n         I   number of satellites
+*          gtime_t *time    I   times (gpst) {time[0],...,time[n-1]}
+*          eph_t  **eph     I   broadcast ephemerides (NULL: not available)
+*          double *rs       O   satellite positions and velocities (ecef)
+*                               {x,y,z,vx,vy,vz} (m|m/s) (6 x n)
+*          double *dts      O   satellite clocks {bias,drift} (s|s/s) (2 x n)
+*          double *var      O   satellite position and clock variances (m^2)
+* return : none
+* notes  : positions and clock biases are same as eph2pos(). velocities and
+*          clock drifts are derived analytically instead of differential
+*          approximation. the ephemerides are processed in blocks of NEPHBLK
+*          satellites with the parameters in the structure of arrays and the
+*          kepler equations are solved for all satellites of a block together.
+*          if no ephemeris or kepler iteration overflow, set 0 to outputs
+*-----------------------------------------------------------------------------*/
+extern void eph2posn(int n, const gtime_t *time, const eph_t **eph, double *rs,
+                     double *dts, double *var)
+{
+    double tk[NEPHBLK],M[NEPHBLK],E[NEPHBLK],Ek[NEPHBLK],e[NEPHBLK];
+    double A[NEPHBLK],nm[NEPHBLK],mu[NEPHBLK],omge[NEPHBLK];
+    double sinE,cosE,Ed,phi,phid,sin2p,cos2p,u,ud,r,rd,i,id,cosu,sinu,x,y,xd,yd;
+    double O,Od,sinO,cosO,sini,cosi,xg,yg,zg,vg[3],sino,coso,tc,del,*p;
+    const eph_t *ep;
+    int j,k,l,m,iter[NEPHBLK],idx[NEPHBLK],sys[NEPHBLK],prn,geo,done;
+    
+    trace(4,"eph2posn: n=%d\n",n);
+    
+    for (j=0;j<n;j++) {
+        for (k=0;k<6;k++) rs[k+j*6]=0.0;
+        dts[j*2]=dts[1+j*2]=var[j]=0.0;
+    }
+    for (j=0;j<n;j=k) {
+        
+        /* gather ephemeris parameters of block */
+        for (k=j,m=0;k<n&&m<NEPHBLK;k++) {
+            if (!(ep=eph[k])||ep->A<=0.0) continue;
+            switch ((sys[m]=satsys(ep->sat,NULL))) {
+                case SYS_GAL: mu[m]=MU_GAL; omge[m]=OMGE_GAL; break;
+                case SYS_CMP: mu[m]=MU_CMP; omge[m]=OMGE_CMP; break;
+                default:      mu[m]=MU_GPS; omge[m]=OMGE;     break;
+            }
+            idx[m]=k;
+            tk[m]=timediff(time[k],ep->toe);
+            e [m]=ep->e;
+            A [m]=ep->A;
+            nm[m]=sqrt(mu[m]/(A[m]*A[m]*A[m]))+ep->deln;
+            M [m]=ep->M0+nm[m]*tk[m];
+            m++;
+        }
+        /* kepler equations of block by newton's method */
+        for (l=0;l<m;l++) {
+            E[l]=M[l]; Ek[l]=0.0; iter[l]=0;
+        }
+        for (done=0;!done;) {
+            for (l=0,done=1;l<m;l++) {
+                if (fabs(E[l]-Ek[l])<=RTOL_KEPLER||iter[l]>=MAX_ITER_KEPLER) continue;
+                Ek[l]=E[l];
+                E[l]-=(E[l]-e[l]*sin(E[l])-M[l])/(1.0-e[l]*cos(E[l]));
+                iter[l]++;
+                done=0;
+            }
+        }
+        /* positions, velocities and clocks */
+        for (l=0;l<m;l++) {
+            ep=eph[idx[l]];
+            if (iter[l]>=MAX_ITER_KEPLER) {
+                trace(2,"eph2posn: kepler iteration overflow sat=%2d\n",ep->sat);
+                continue;
+            }
+            sinE=sin(E[l]); cosE=cos(E[l]);
+            Ed=nm[l]/(1.0-e[l]*cosE);
+            
+            phi=atan2(sqrt(1.0-e[l]*e[l])*sinE,cosE-e[l])+ep->omg;
+            phid=sqrt(1.0-e[l]*e[l])*Ed/(1.0-e[l]*cosE);
+            sin2p=sin(2.0*phi); cos2p=cos(2.0*phi);
+            u=phi+(ep->cus*sin2p+ep->cuc*cos2p);
+            r=A[l]*(1.0-e[l]*cosE)+(ep->crs*sin2p+ep->crc*cos2p);
+            i=ep->i0+ep->idot*tk[l]+(ep->cis*sin2p+ep->cic*cos2p);
+            ud=phid*(1.0+2.0*(ep->cus*cos2p-ep->cuc*sin2p));
+            rd=A[l]*e[l]*sinE*Ed+2.0*phid*(ep->crs*cos2p-ep->crc*sin2p);
+            id=ep->idot+2.0*phid*(ep->cis*cos2p-ep->cic*sin2p);
+            cosu=cos(u); sinu=sin(u);
+            x=r*cosu; xd=rd*cosu-r*sinu*ud;
+            y=r*sinu; yd=rd*sinu+r*cosu*ud;
+            cosi=cos(i); sini=sin(i);
+            satsys(ep->sat,&prn);
+            
+            /* beidou geo satellite */
+            if ((geo=sys[l]==SYS_CMP&&(prn<=5||prn>=59))) { /* ref [9] table 4-1 */
+                O=ep->OMG0+ep->OMGd*tk[l]-omge[l]*ep->toes;
+                Od=ep->OMGd;
+            }
+            else {
+                O=ep->OMG0+(ep->OMGd-omge[l])*tk[l]-omge[l]*ep->toes;
+                Od=ep->OMGd-omge[l];
+            }
+            sinO=sin(O); cosO=cos(O);
+            xg=x*cosO-y*cosi*sinO;
+            yg=x*sinO+y*cosi*cosO;
+            zg=y*sini;
+            vg[0]=xd*cosO-yd*cosi*sinO+y*sini*sinO*id-yg*Od;
+            vg[1]=xd*sinO+yd*cosi*cosO-y*sini*cosO*id+xg*Od;
+            vg[2]=yd*sini+y*cosi*id;
+            
+            p=rs+idx[l]*6;
+            if (geo) {
+                sino=sin(omge[l]*tk[l]); coso=cos(omge[l]*tk[l]);
+                p[0]= xg*coso+yg*sino*COS_5+zg*sino*SIN_5;
+                p[1]=-xg*sino+yg*coso*COS_5+zg*coso*SIN_5;
+                p[2]=-yg*SIN_5+zg*COS_5;
+                p[3]= vg[0]*coso+vg[1]*sino*COS_5+vg[2]*sino*SIN_5+omge[l]*p[1];
+                p[4]=-vg[0]*sino+vg[1]*coso*COS_5+vg[2]*coso*SIN_5-omge[l]*p[0];
+                p[5]=-vg[1]*SIN_5+vg[2]*COS_5;
+            }
+            else {
+                p[0]=xg;    p[1]=yg;    p[2]=zg;
+                p[3]=vg[0]; p[4]=vg[1]; p[5]=vg[2];
+            }
+            tc=timediff(time[idx[l]],ep->toc);
+            p=dts+idx[l]*2;
+            p[0]=ep->f0+ep->f1*tc+ep->f2*tc*tc;
+            p[1]=ep->f1+2.0*ep->f2*tc;
+            
+            /* relativity correction */
+            del=2.0*sqrt(mu[l]*A[l])*e[l];
+            p[0]-=del*sinE/SQR(CLIGHT);
+            p[1]-=del*cosE*Ed/SQR(CLIGHT);
+            
+            /* position and clock error variance */
+            var[idx[l]]=var_uraeph(sys[l],ep->sva);
+        }
+    }
+}
 /* glonass orbit differential equations --------------------------------------*/
 static void deq(const double *x, double *xdot, const double *acc)
 {
@@ -315,6 +464,71 @@ static void glorbit(double t, double *x, const double *acc)
     deq(w,k4,acc);
     for (i=0;i<6;i++) x[i]+=(k1[i]+2.0*k2[i]+2.0*k3[i]+k4[i])*t/6.0;
 }
+/* glonass ephemeris to satellite position and velocity -----------------------
+* integrate glonass orbit from toe to time with cache of integration nodes
+* args   : gtime_t time     I   time (gpst)
+*          geph_t *geph     I   glonass ephemeris
+*          double *x        O   satellite position and velocity (ecef)
+*                               {x,y,z,vx,vy,vz} (m|m/s)
+* return : none
+* notes  : the orbit is integrated with steps of TSTEP from toe to the last
+*          node before time and by a partial step to time. the state at the
+*          last node is cached per satellite and the next call steps forward
+*          or backward from the cached node if it is closer than toe. the
+*          cache is invalidated if the ephemeris changes. a zero-initialized
+*          entry (toe=0) never matches an ephemeris. forward stepping gives
+*          same results as integration from toe
+*-----------------------------------------------------------------------------*/
+static void geph2state(gtime_t time, const geph_t *geph, double *x)
+{
+    static THREADLOCAL glocache_t cache[MAXPRNGLO+1];
+    glocache_t *c=NULL;
+    double t,tt,xn[6];
+    int i,k,k0=0,prn;
+    
+    t=timediff(time,geph->toe);
+    
+    /* node before time and partial step to time */
+    k=(int)(fabs(t)/TSTEP);
+    if (t<0.0) k=-k;
+    t-=k*TSTEP;
+    
+    for (i=0;i<3;i++) {
+        xn[i  ]=geph->pos[i];
+        xn[i+3]=geph->vel[i];
+    }
+    if (satsys(geph->sat,&prn)==SYS_GLO&&prn>=1&&prn<=MAXPRNGLO) {
+        c=cache+prn;
+        if (c->iode==geph->iode&&timediff(c->toe,geph->toe)==0.0&&
+            !memcmp(c->pos,geph->pos,sizeof(c->pos))&&
+            !memcmp(c->vel,geph->vel,sizeof(c->vel))) {
+            
+            /* start from cached node if closer than toe */
+            if (abs(k-c->k)<abs(k)) {
+                k0=c->k;
+                for (i=0;i<6;i++) xn[i]=c->x[i];
+            }
+        }
+        else {
+            c->toe=geph->toe;
+            c->iode=geph->iode;
+            for (i=0;i<3;i++) {
+                c->pos[i]=geph->pos[i];
+                c->vel[i]=geph->vel[i];
+            }
+        }
+    }
+    for (tt=k<k0?-TSTEP:TSTEP;k0!=k;k0+=k<k0?-1:1) {
+        glorbit(tt,xn,geph->acc);
+    }
+    if (c) {
+        c->k=k;
+        for (i=0;i<6;i++) c->x[i]=xn[i];
+    }
+    for (i=0;i<6;i++) x[i]=xn[i];
+    
+    if (fabs(t)>1E-9) glorbit(t,x,geph->acc);
+}
 /* glonass ephemeris to satellite clock bias -----------------------------------
 * compute satellite clock bias with glonass ephemeris
 * args   : gtime_t time     I   time by satellite clock (gpst)
@@ -349,7 +563,7 @@ extern double geph2clk(gtime_t time, const geph_t *geph)
 extern void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
                      double *var)
 {
-    double t,tt,x[6];
+    double t,x[6];
     int i;
     
     trace(4,"geph2pos: time=%s sat=%2d\n",time_str(time,3),geph->sat);
@@ -358,14 +572,8 @@ extern void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
     
     *dts=-geph->taun+geph->gamn*t;
     
-    for (i=0;i<3;i++) {
-        x[i  ]=geph->pos[i];
-        x[i+3]=geph->vel[i];
-    }
-    for (tt=t<0.0?-TSTEP:TSTEP;fabs(t)>1E-9;t-=tt) {
-        if (fabs(t)<TSTEP) tt=t;
-        glorbit(tt,x,geph->acc);
-    }
+    geph2state(time,geph,x);
+    
     for (i=0;i<3;i++) rs[i]=x[i];
     
     *var=SQR(ERREPH_GLO);
@@ -531,10 +739,10 @@ static int ephclk(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
 static int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
                   int iode, double *rs, double *dts, double *var, int *svh)
 {
-    eph_t  *eph;
+    const eph_t *eph;
     geph_t *geph;
     seph_t *seph;
-    double rst[3],dtst[1],tt=1E-3;
+    double t;
     int i,sys;
     
     trace(4,"ephpos  : time=%s sat=%2d iode=%d\n",time_str(time,3),sat,iode);
@@ -543,33 +751,31 @@ static int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
     
     *svh=-1;
     
+    /* satellite velocity and clock drift by analytical derivatives */
     if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS||sys==SYS_CMP||sys==SYS_IRN) {
         if (!(eph=seleph(teph,sat,iode,nav))) return 0;
-        eph2pos(time,eph,rs,dts,var);
-        time=timeadd(time,tt);
-        eph2pos(time,eph,rst,dtst,var);
+        eph2posn(1,&time,&eph,rs,dts,var);
         *svh=eph->svh;
     }
     else if (sys==SYS_GLO) {
         if (!(geph=selgeph(teph,sat,iode,nav))) return 0;
-        geph2pos(time,geph,rs,dts,var);
-        time=timeadd(time,tt);
-        geph2pos(time,geph,rst,dtst,var);
+        t=timediff(time,geph->toe);
+        geph2state(time,geph,rs);
+        dts[0]=-geph->taun+geph->gamn*t;
+        dts[1]=geph->gamn;
+        *var=SQR(ERREPH_GLO);
         *svh=geph->svh;
     }
     else if (sys==SYS_SBS) {
         if (!(seph=selseph(teph,sat,nav))) return 0;
         seph2pos(time,seph,rs,dts,var);
-        time=timeadd(time,tt);
-        seph2pos(time,seph,rst,dtst,var);
+        t=timediff(time,seph->t0);
+        for (i=0;i<3;i++) rs[i+3]=seph->vel[i]+seph->acc[i]*t;
+        dts[1]=seph->af1;
         *svh=seph->svh;
     }
     else return 0;
     
-    /* satellite velocity and clock drift by differential approx */
-    for (i=0;i<3;i++) rs[i+3]=(rst[i]-rs[i])/tt;
-    dts[1]=(dtst[0]-dts[0])/tt;
-    
     return 1;
 }
 /* satellite position and clock with sbas correction -------------------------*/
@@ -602,7 +808,8 @@ static int satpos_sbas(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
 }
 /* satellite position and clock with ssr correction --------------------------*/
 static int satpos_ssr(const prcopt_t *popt, gtime_t time, gtime_t teph, int sat, const nav_t *nav,
-                      int opt, double *rs, double *dts, double *var, int *svh)
+                      const astro_t *ast, int opt, double *rs, double *dts, double *var,
+                      int *svh)
 {
     const ssr_t *ssr;
     eph_t *eph;
@@ -682,7 +889,7 @@ static int satpos_ssr(const prcopt_t *popt, gtime_t time, gtime_t teph, int sat,
     
     /* satellite antenna offset correction */
     if (opt) {
-        satantoff(popt,time,rs,sat,nav,dant);
+        satantoff(popt,time,rs,sat,nav,ast,dant);
     }
     for (i=0;i<3;i++) {
         rs[i]+=-(er[i]*deph[0]+ea[i]*deph[1]+ec[i]*deph[2])+dant[i];
@@ -705,6 +912,7 @@ static int satpos_ssr(const prcopt_t *popt, gtime_t time, gtime_t teph, int sat,
 *          int    sat       I   satellite number
 *          nav_t  *nav      I   navigation data
 *          int    ephopt    I   ephemeris option (EPHOPT_???)
+*          astro_t *ast     I   astronomical context of epoch (NULL: not used)
 *          double *rs       O   sat position and velocity (ecef)
 *                               {x,y,z,vx,vy,vz} (m|m/s)
 *          double *dts      O   sat clock {bias,drift} (s|s/s)
@@ -715,8 +923,8 @@ static int satpos_ssr(const prcopt_t *popt, gtime_t time, gtime_t teph, int sat,
 *          satellite clock does not include code bias correction (tgd or bgd)
 *-----------------------------------------------------------------------------*/
 extern int satpos(const prcopt_t *popt,gtime_t time, gtime_t teph, int sat, int ephopt,
-                  const nav_t *nav, double *rs, double *dts, double *var,
-                  int *svh)
+                  const nav_t *nav, const astro_t *ast, double *rs, double *dts,
+                  double *var, int *svh)
 {
     trace(4,"satpos  : time=%s sat=%2d ephopt=%d\n",time_str(time,3),sat,ephopt);
     
@@ -725,10 +933,10 @@ extern int satpos(const prcopt_t *popt,gtime_t time, gtime_t teph, int sat, int
     switch (ephopt) {
         case EPHOPT_BRDC  : return ephpos     (time,teph,sat,nav,-1,rs,dts,var,svh);
         case EPHOPT_SBAS  : return satpos_sbas(time,teph,sat,nav,   rs,dts,var,svh);
-        case EPHOPT_SSRAPC: return satpos_ssr (popt,time,teph,sat,nav, 0,rs,dts,var,svh);
-        case EPHOPT_SSRCOM: return satpos_ssr (popt,time,teph,sat,nav, 1,rs,dts,var,svh);
+        case EPHOPT_SSRAPC: return satpos_ssr (popt,time,teph,sat,nav,ast,0,rs,dts,var,svh);
+        case EPHOPT_SSRCOM: return satpos_ssr (popt,time,teph,sat,nav,ast,1,rs,dts,var,svh);
         case EPHOPT_PREC  :
-            if (!peph2pos(popt,time,sat,nav,1,rs,dts,var)) break; else return 1;
+            if (!peph2pos(popt,time,sat,nav,ast,1,rs,dts,var)) break; else return 1;
     }
     *svh=-1;
     return 0;
@@ -739,6 +947,7 @@ extern int satpos(const prcopt_t *popt,gtime_t time, gtime_t teph, int sat, int
 *          obsd_t *obs      I   observation data
 *          int    n         I   number of observation data
 *          nav_t  *nav      I   navigation data
+*          astro_t *ast     I   astronomical context of epoch (NULL: not used)
 *          int    ephopt    I   ephemeris option (EPHOPT_???)
 *          double *rs       O   satellite positions and velocities (ecef)
 *          double *dts      O   satellite clocks
@@ -758,11 +967,12 @@ extern int satpos(const prcopt_t *popt,gtime_t time, gtime_t teph, int sat, int
 *          signal transmission time
 *-----------------------------------------------------------------------------*/
 extern void satposs(const prcopt_t *popt,gtime_t teph, const obsd_t *obs, int n, const nav_t *nav,
-                    int ephopt, double *rs, double *dts, double *var, int *svh)
+                    const astro_t *ast, int ephopt, double *rs, double *dts, double *var, int *svh)
 {
     gtime_t time[2*MAXOBS]={{0}};
+    const eph_t *eph[2*MAXOBS]={0};
     double dt,pr;
-    int i,j;
+    int i,j,sys,stat[2*MAXOBS]={0};
     
     trace(5,"satposs : teph=%s n=%d ephopt=%d\n",time_str(teph,3),n,ephopt);
     
@@ -787,9 +997,28 @@ extern void satposs(const prcopt_t *popt,gtime_t teph, const obsd_t *obs, int n,
             continue;
         }
         time[i]=timeadd(time[i],-dt);
+        stat[i]=1;
         
+        /* select broadcast ephemerides to be computed together */
+        if (ephopt!=EPHOPT_BRDC) continue;
+        sys=satsys(obs[i].sat,NULL);
+        if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS||sys==SYS_CMP||sys==SYS_IRN) {
+            eph[i]=seleph(teph,obs[i].sat,-1,nav);
+        }
+    }
+    /* satellite positions and clocks by broadcast ephemerides */
+    if (ephopt==EPHOPT_BRDC) {
+        eph2posn(i,time,eph,rs,dts,var);
+    }
+    for (i=0;i<n&&i<2*MAXOBS;i++) {
+        if (!stat[i]) continue;
+        
+        if (eph[i]) {
+            svh[i]=eph[i]->svh;
+            continue;
+        }
         /* satellite position and clock at transmission time */
-        if (!satpos(popt,time[i],teph,obs[i].sat,ephopt,nav,rs+i*6,dts+i*2,var+i,svh+i)) {
+        if (!satpos(popt,time[i],teph,obs[i].sat,ephopt,nav,ast,rs+i*6,dts+i*2,var+i,svh+i)) {
             trace(3,"no ephemeris %s sat=%2d\n",time_str(time[i],3),obs[i].sat);
             continue;
         }
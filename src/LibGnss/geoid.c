@@ -15,12 +15,76 @@
 *           2020/11/30 1.3  use integer types in stdint.h
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 static const double range[4];       /* embedded geoid area range {W,E,S,N} (deg) */
 static const float geoid[361][181]; /* embedded geoid heights (m) (lon x lat) */
 static FILE *fp_geoid=NULL;         /* geoid file pointer */
+static const uint8_t *map_geoid=NULL; /* geoid file image (NULL: read by fp) */
+static size_t size_geoid=0;         /* size of geoid file image (bytes) */
 static int model_geoid=GEOID_EMBEDDED; /* geoid model */
 
+/* map geoid file to memory --------------------------------------------------*/
+static void mapgeoid(FILE *fp)
+{
+#ifdef WIN32
+    uint8_t *p;
+    long size;
+    
+    if (fseek(fp,0,SEEK_END)==EOF||(size=ftell(fp))<=0||
+        fseek(fp,0,SEEK_SET)==EOF) return;
+    if (!(p=(uint8_t *)malloc((size_t)size))) {
+        trace(2,"geoid file image allocation error: size=%ld\n",size);
+        return;
+    }
+    if (fread(p,(size_t)size,1,fp)<1) {
+        trace(2,"geoid file read error: size=%ld\n",size);
+        free(p);
+        return;
+    }
+    map_geoid=p;
+    size_geoid=(size_t)size;
+#else
+    struct stat st;
+    void *p;
+    
+    if (fstat(fileno(fp),&st)<0||st.st_size<=0) return;
+    p=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fileno(fp),0);
+    if (p==MAP_FAILED) {
+        trace(2,"geoid file mmap error: size=%ld\n",(long)st.st_size);
+        return;
+    }
+    map_geoid=(const uint8_t *)p;
+    size_geoid=(size_t)st.st_size;
+#endif
+}
+/* unmap geoid file ----------------------------------------------------------*/
+static void unmapgeoid(void)
+{
+    if (!map_geoid) return;
+#ifdef WIN32
+    free((void *)map_geoid);
+#else
+    munmap((void *)map_geoid,size_geoid);
+#endif
+    map_geoid=NULL;
+    size_geoid=0;
+}
+/* read bytes of geoid file --------------------------------------------------*/
+static int geoid_read(long off, void *buff, int n)
+{
+    if (map_geoid) { /* file image shared by concurrent readers */
+        if (off<0||(size_t)off+n>size_geoid) return 0;
+        memcpy(buff,map_geoid+off,n);
+        return 1;
+    }
+    return fp_geoid&&fseek(fp_geoid,off,SEEK_SET)!=EOF&&
+           fread(buff,n,1,fp_geoid)==1;
+}
+
 /* bilinear interpolation ----------------------------------------------------*/
 static double interpb(const double *y, double a, double b)
 {
@@ -48,10 +112,10 @@ static double geoidh_emb(const double *pos)
     return interpb(y,a,b);
 }
 /* get 2 byte signed integer from file ---------------------------------------*/
-static int16_t fget2b(FILE *fp, int32_t off)
+static int16_t fget2b(long off)
 {
-    uint8_t v[2];
-    if (fseek(fp,off,SEEK_SET)==EOF||fread(v,2,1,fp)<1) {
+    uint8_t v[2]={0};
+    if (!geoid_read(off,v,2)) {
         trace(2,"geoid data file range error: off=%ld\n",off);
     }
     return ((int16_t)v[0]<<8)+v[1]; /* big-endian */
@@ -70,17 +134,17 @@ static double geoidh_egm96(const double *pos)
     b=(pos[0]-lat0)/dlat;
     i1=(int)a; a-=i1; i2=i1<nlon-1?i1+1:0;
     j1=(int)b; b-=j1; j2=j1<nlat-1?j1+1:j1;
-    y[0]=fget2b(fp_geoid,2L*(i1+j1*nlon))*0.01;
-    y[1]=fget2b(fp_geoid,2L*(i2+j1*nlon))*0.01;
-    y[2]=fget2b(fp_geoid,2L*(i1+j2*nlon))*0.01;
-    y[3]=fget2b(fp_geoid,2L*(i2+j2*nlon))*0.01;
+    y[0]=fget2b(2L*(i1+j1*nlon))*0.01;
+    y[1]=fget2b(2L*(i2+j1*nlon))*0.01;
+    y[2]=fget2b(2L*(i1+j2*nlon))*0.01;
+    y[3]=fget2b(2L*(i2+j2*nlon))*0.01;
     return interpb(y,a,b);
 }
 /* get 4byte float from file -------------------------------------------------*/
-static float fget4f(FILE *fp, int off)
+static float fget4f(long off)
 {
     float v=0.0;
-    if (fseek(fp,(long)off,SEEK_SET)==EOF||fread(&v,4,1,fp)<1) {
+    if (!geoid_read(off,&v,4)) {
         trace(2,"geoid data file range error: off=%ld\n",off);
     }
     return v; /* small-endian */
@@ -120,28 +184,28 @@ static double geoidh_egm08(const double *pos, int model)
     /* (2) Und_min2.5x2.5_egm2008_isw=82_WGS84_TideFree_SE.gz */
 #if 0
     /* not zero-inserted */
-    y[0]=fget4f(fp_geoid,4L*(i1+j1*(nlon)));
-    y[1]=fget4f(fp_geoid,4L*(i2+j1*(nlon)));
-    y[2]=fget4f(fp_geoid,4L*(i1+j2*(nlon)));
-    y[3]=fget4f(fp_geoid,4L*(i2+j2*(nlon)));
+    y[0]=fget4f(4L*(i1+j1*(nlon)));
+    y[1]=fget4f(4L*(i2+j1*(nlon)));
+    y[2]=fget4f(4L*(i1+j2*(nlon)));
+    y[3]=fget4f(4L*(i2+j2*(nlon)));
 #else
     /* zero-inserted version (2009/12/10) */
-    y[0]=fget4f(fp_geoid,4L*(i1+j1*(nlon+2)+1));
-    y[1]=fget4f(fp_geoid,4L*(i2+j1*(nlon+2)+1));
-    y[2]=fget4f(fp_geoid,4L*(i1+j2*(nlon+2)+1));
-    y[3]=fget4f(fp_geoid,4L*(i2+j2*(nlon+2)+1));
+    y[0]=fget4f(4L*(i1+j1*(nlon+2)+1));
+    y[1]=fget4f(4L*(i2+j1*(nlon+2)+1));
+    y[2]=fget4f(4L*(i1+j2*(nlon+2)+1));
+    y[3]=fget4f(4L*(i2+j2*(nlon+2)+1));
 #endif
     return interpb(y,a,b);
 }
 /* get gsi geoid data --------------------------------------------------------*/
-static double fgetgsi(FILE *fp, int nlon, int nlat, int i, int j)
+static double fgetgsi(int nlon, int nlat, int i, int j)
 {
     const int nf=28,wf=9,nl=nf*wf+2,nr=(nlon-1)/nf+1;
     double v;
     int off=nl+j*nr*nl+i/nf*nl+i%nf*wf;
     char buff[16]="";
     
-    if (fseek(fp,(long)off,SEEK_SET)==EOF||fread(buff,wf,1,fp)<1) {
+    if (!geoid_read((long)off,buff,wf)) {
         trace(2,"out of range for gsi geoid: i=%d j=%d\n",i,j);
         return 0.0;
     }
@@ -168,10 +232,10 @@ static double geoidh_gsi(const double *pos)
     b=(pos[0]-lat0)/dlat;
     i1=(int)a; a-=i1; i2=i1<nlon-1?i1+1:i1;
     j1=(int)b; b-=j1; j2=j1<nlat-1?j1+1:j1;
-    y[0]=fgetgsi(fp_geoid,nlon,nlat,i1,j1);
-    y[1]=fgetgsi(fp_geoid,nlon,nlat,i2,j1);
-    y[2]=fgetgsi(fp_geoid,nlon,nlat,i1,j2);
-    y[3]=fgetgsi(fp_geoid,nlon,nlat,i2,j2);
+    y[0]=fgetgsi(nlon,nlat,i1,j1);
+    y[1]=fgetgsi(nlon,nlat,i2,j1);
+    y[2]=fgetgsi(nlon,nlat,i1,j2);
+    y[3]=fgetgsi(nlon,nlat,i2,j2);
     if (y[0]==999.0||y[1]==999.0||y[2]==999.0||y[3]==999.0) {
         trace(2,"geoidh_gsi: data outage (lat=%.3f lon=%.3f)\n",pos[0],pos[1]);
         return 0.0;
@@ -194,6 +258,8 @@ static double geoidh_gsi(const double *pos)
 *          Und_min1x1_egm2008_isw=82_WGS84_TideFree_SE    : EGM2008 1.0x1.0"
 *          gsigeome_ver4 : GSI geoid 2000 1.0x1.5" (japanese area)
 *          (byte-order of binary files must be compatible to cpu)
+*          the file is memory-mapped (loaded on windows) if possible, then
+*          geoidh() can be called by concurrent threads
 *-----------------------------------------------------------------------------*/
 extern int opengeoid(int model, const char *file)
 {
@@ -212,6 +278,7 @@ extern int opengeoid(int model, const char *file)
         trace(2,"geoid model file open error: model=%d file=%s\n",model,file);
         return 0;
     }
+    mapgeoid(fp_geoid);
     model_geoid=model;
     return 1;
 }
@@ -224,6 +291,7 @@ extern void closegeoid(void)
 {
     trace(3,"closegoid:\n");
     
+    unmapgeoid();
     if (fp_geoid) fclose(fp_geoid);
     fp_geoid=NULL;
     model_geoid=GEOID_EMBEDDED;
@@ -260,6 +328,23 @@ extern double geoidh(const double *pos)
     }
     return h;
 }
+/* geoid heights ---------------------------------------------------------------
+* get geoid heights of positions from geoid model
+* args   : double *pos      I   geodetic positions {lat,lon,h} (rad,m)
+*                               (pos[i*3:i*3+1]: position i)
+*          int    n         I   number of positions
+*          double *h        O   geoid heights (m) (0.0:error)
+* return : none
+* notes  : same as geoidh() for each position (solution buffers etc.)
+*-----------------------------------------------------------------------------*/
+extern void geoidh_n(const double *pos, int n, double *h)
+{
+    int i;
+    
+    trace(3,"geoidh_n: n=%d\n",n);
+    
+    for (i=0;i<n;i++) h[i]=geoidh(pos+i*3);
+}
 /*------------------------------------------------------------------------------
 * embedded geoid model
 * notes  : geoid heights are derived from EGM96 (1 x 1 deg grid)
@@ -476,6 +476,198 @@ extern int iontec(gtime_t time, const nav_t *nav, const double *pos,
 }
 
 
+/* ionospheric pierce points of satellites (SoA) -----------------------------*/
+static void ionppps(const double *pos, const double *azel, int n, double re,
+                    double hion, int opt, double *lat, double *lon, double *fs)
+{
+    double posp[3]={0},rp;
+    int i;
+    
+    for (i=0;i<n;i++) {
+        fs[i]=ionppp(pos,azel+i*2,re,hion,posp);
+        lat[i]=posp[0];
+        lon[i]=posp[1];
+    }
+    if (opt&2) { /* modified single layer mapping function (M-SLM) ref [2] */
+        for (i=0;i<n;i++) {
+            rp=re/(re+hion)*sin(0.9782*(PI/2.0-azel[1+i*2]));
+            fs[i]=1.0/sqrt(1.0-rp*rp);
+        }
+    }
+}
+/* interpolate tec grid data of satellites -----------------------------------
+* same as interptec() for the pierce points lat[],lon[]+dlon of n satellites.
+* grid coordinates are computed for all points before the cells are fetched
+*----------------------------------------------------------------------------*/
+static void interptecs(const tec_t *tec, int k, const double *lat,
+                       const double *lon, double dlon, int n, double *value,
+                       double *rms, int *stat)
+{
+    double a[MAXOBS],b[MAXOBS],x,y,d[4],r[4],v,s;
+    int i,m,ii[MAXOBS],jj[MAXOBS],index,nd;
+    
+    for (i=0;i<n;i++) {
+        x=lat[i]*R2D-tec->lats[0];
+        y=(lon[i]+dlon)*R2D-tec->lons[0];
+        if (tec->lons[2]>0.0) y-=floor( y/360)*360.0; /*  0<=dlon<360 */
+        else                  y+=floor(-y/360)*360.0; /* -360<dlon<=0 */
+        x/=tec->lats[2];
+        y/=tec->lons[2];
+        ii[i]=(int)floor(x); a[i]=x-ii[i];
+        jj[i]=(int)floor(y); b[i]=y-jj[i];
+    }
+    for (i=0;i<n;i++) {
+        for (m=0;m<4;m++) {
+            d[m]=r[m]=0.0;
+            if ((index=dataindex(ii[i]+(m%2),jj[i]+(m<2?0:1),k,tec->ndata))<0) {
+                continue;
+            }
+            d[m]=tec->data[index];
+            r[m]=tec->rms [index];
+        }
+        x=a[i]; y=b[i]; stat[i]=1;
+        
+        if (d[0]>0.0&&d[1]>0.0&&d[2]>0.0&&d[3]>0.0) {
+            value[i]=(1.0-x)*(1.0-y)*d[0]+x*(1.0-y)*d[1]+(1.0-x)*y*d[2]+x*y*d[3];
+            rms  [i]=(1.0-x)*(1.0-y)*r[0]+x*(1.0-y)*r[1]+(1.0-x)*y*r[2]+x*y*r[3];
+        }
+        else if (x<=0.5&&y<=0.5&&d[0]>0.0) {value[i]=d[0]; rms[i]=r[0];}
+        else if (x> 0.5&&y<=0.5&&d[1]>0.0) {value[i]=d[1]; rms[i]=r[1];}
+        else if (x<=0.5&&y> 0.5&&d[2]>0.0) {value[i]=d[2]; rms[i]=r[2];}
+        else if (x> 0.5&&y> 0.5&&d[3]>0.0) {value[i]=d[3]; rms[i]=r[3];}
+        else {
+            v=s=0.0;
+            for (m=0,nd=0;m<4;m++) if (d[m]>0.0) {nd++; v+=d[m]; s+=r[m];}
+            if (nd==0) {value[i]=rms[i]=0.0; stat[i]=0; continue;}
+            value[i]=v/nd; rms[i]=s/nd;
+        }
+    }
+}
+/* ionosphere delay of satellites by a tec map -------------------------------*/
+static void iondelays(gtime_t time, const tec_t *tec, const double *pos,
+                      const double *azel, int n, int opt, double *delay,
+                      double *var, int *stat)
+{
+    const double fact=40.30E16/FREQ1/FREQ1; /* tecu->L1 iono (m) */
+    double lat[MAXOBS],lon[MAXOBS],fs[MAXOBS],vtec[MAXOBS],rms[MAXOBS];
+    double hion,dlon=0.0;
+    int i,k,ok[MAXOBS];
+    
+    for (i=0;i<n;i++) {
+        delay[i]=var[i]=0.0;
+        stat[i]=1;
+    }
+    if (tec->lats[2]==0.0||tec->lons[2]==0.0) {
+        for (i=0;i<n;i++) stat[i]=0;
+        return;
+    }
+    if (opt&1) { /* earth rotation correction (sun-fixed coordinate) */
+        dlon=2.0*PI*timediff(time,tec->time)/86400.0;
+    }
+    for (k=0;k<tec->ndata[2];k++) { /* for a layer */
+        
+        hion=tec->hgts[0]+tec->hgts[2]*k;
+        
+        /* ionospheric pierce point positions */
+        ionppps(pos,azel,n,tec->rb,hion,opt,lat,lon,fs);
+        
+        /* interpolate tec grid data */
+        interptecs(tec,k,lat,lon,dlon,n,vtec,rms,ok);
+        
+        for (i=0;i<n;i++) {
+            if (!ok[i]) stat[i]=0;
+            delay[i]+=fact*fs[i]*vtec[i];
+            var[i]+=fact*fact*fs[i]*fs[i]*rms[i]*rms[i];
+        }
+    }
+}
+/* ionosphere model by tec grid data for satellites ----------------------------
+* compute ionospheric delays of the satellites of an epoch by tec grid data
+* args   : gtime_t time     I   time (gpst)
+*          nav_t  *nav      I   navigation data
+*          double *pos      I   receiver position {lat,lon,h} (rad,m)
+*          double *azel     I   azimuth/elevation angles {az,el} (rad)
+*                               (azel[i*2:i*2+1]: satellite i)
+*          int    n         I   number of satellites
+*          int    opt       I   model option (see iontec())
+*          double *delay    O   ionospheric delays (L1) (m)
+*          double *var      O   ionospheric dealy (L1) variances (m^2)
+*          int    *stat     O   status of satellites (1:ok,0:error)
+* return : number of satellites with status ok
+* notes  : same values as iontec() for each satellite. the tec maps bracketing
+*          time are searched once and pierce points and grid cells of all
+*          satellites are computed together per map. delay[] and var[] are
+*          not changed for satellites with error status as iontec()
+*-----------------------------------------------------------------------------*/
+extern int iontecs(gtime_t time, const nav_t *nav, const double *pos,
+                   const double *azel, int n, int opt, double *delay,
+                   double *var, int *stat)
+{
+    double dels[2][MAXOBS],vars[2][MAXOBS],a=0.0,tt;
+    int i,j,m,nn,ns=0,st[2][MAXOBS];
+    
+    trace(4,"iontecs : time=%s pos=%.1f %.1f n=%d\n",time_str(time,0),
+          pos[0]*R2D,pos[1]*R2D,n);
+    
+    /* no tec correction for low elevation or height */
+    for (j=0;j<n;j++) {
+        if (azel[1+j*2]<MIN_EL||pos[2]<MIN_HGT) {
+            delay[j]=0.0;
+            var[j]=VAR_NOTEC;
+            stat[j]=1; ns++;
+        }
+        else stat[j]=0;
+    }
+    if (ns>=n) return ns;
+    
+    for (i=0;i<nav->nt;i++) {
+        if (timediff(nav->tec[i].time,time)>0.0) break;
+    }
+    if (i==0||i>=nav->nt) {
+        trace(2,"%s: tec grid out of period\n",time_str(time,0));
+        return ns;
+    }
+    if ((tt=timediff(nav->tec[i].time,nav->tec[i-1].time))==0.0) {
+        trace(2,"tec grid time interval error\n");
+        return ns;
+    }
+    a=timediff(time,nav->tec[i-1].time)/tt;
+    
+    for (j=0;j<n;j+=MAXOBS) {
+        nn=n-j<MAXOBS?n-j:MAXOBS;
+        
+        /* ionospheric delays by the two bracketing tec maps */
+        for (m=0;m<2;m++) {
+            iondelays(time,nav->tec+i-1+m,pos,azel+j*2,nn,opt,dels[m],vars[m],
+                      st[m]);
+        }
+        for (m=0;m<nn;m++) {
+            if (stat[j+m]) continue;
+            
+            if (st[0][m]&&st[1][m]) { /* linear interpolation by time */
+                delay[j+m]=dels[0][m]*(1.0-a)+dels[1][m]*a;
+                var  [j+m]=vars[0][m]*(1.0-a)+vars[1][m]*a;
+            }
+            else if (st[0][m]) { /* nearest-neighbour extrapolation by time */
+                delay[j+m]=dels[0][m];
+                var  [j+m]=vars[0][m];
+            }
+            else if (st[1][m]) {
+                delay[j+m]=dels[1][m];
+                var  [j+m]=vars[1][m];
+            }
+            else {
+                trace(2,"%s: tec grid out of area pos=%6.2f %7.2f azel=%6.1f %5.1f\n",
+                      time_str(time,0),pos[0]*R2D,pos[1]*R2D,azel[(j+m)*2]*R2D,
+                      azel[1+(j+m)*2]*R2D);
+                continue;
+            }
+            stat[j+m]=1; ns++;
+        }
+    }
+    return ns;
+}
+
 extern double iontecvar(int ep,gtime_t t,const double *pos,const double *azel)
 {
     double re=6378.0,hion=375.0;
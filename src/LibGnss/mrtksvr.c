@@ -0,0 +1,832 @@
+/*------------------------------------------------------------------------------
+* mrtksvr.c : multi-rover rtk server functions
+*
+*          The server decodes correction/ephemeris streams once into a working
+*          navigation data and publishes it as versioned read-only snapshots.
+*          Rover engines, each with its own input/solution/log streams, are
+*          serviced by a pool of worker threads. A worker takes a reference of
+*          the current snapshot for each epoch and releases it after rtkpos(),
+*          so the decoder never blocks rover engines and a snapshot is recycled
+*          only after the last reference to it is released.
+*
+* options : -DWIN32    use WIN32 API
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/18 1.0  new
+*           2026/10/18 1.1  wait correction data arrival by strwait()
+*                           wait rover data arrival by strwaitp() in workers
+*-----------------------------------------------------------------------------*/
+#include <stddef.h>
+#include "rtklib.h"
+
+#define NSNAPSPARE      2       /* spare snapshots (current and publishing) */
+
+/* copy fields of navigation data in range [fld1,fld2) -----------------------*/
+#define NAVCPY(dst,src,fld1,fld2) \
+    memcpy((uint8_t *)(dst)+offsetof(nav_t,fld1), \
+           (const uint8_t *)(src)+offsetof(nav_t,fld1), \
+           offsetof(nav_t,fld2)-offsetof(nav_t,fld1))
+
+/* update ephemeris ----------------------------------------------------------*/
+static void update_eph(mrtksvr_t *svr, nav_t *nav, int ephsat, int ephset,
+                       int index)
+{
+    eph_t *eph1,*eph2,*eph3;
+    geph_t *geph1,*geph2,*geph3;
+    int prn;
+
+    if (satsys(ephsat,&prn)!=SYS_GLO) {
+        /* svr->nav.eph={current_set1,current_set2,prev_set1,prev_set2} */
+        eph1=nav->eph+ephsat-1+MAXSAT*ephset;         /* received */
+        eph2=svr->nav.eph+ephsat-1+MAXSAT*ephset;     /* current */
+        eph3=svr->nav.eph+ephsat-1+MAXSAT*(2+ephset); /* previous */
+        if (eph2->ttr.time==0||
+            (eph1->iode!=eph3->iode&&eph1->iode!=eph2->iode)||
+            (timediff(eph1->toe,eph3->toe)!=0.0&&
+             timediff(eph1->toe,eph2->toe)!=0.0)||
+            (timediff(eph1->toc,eph3->toc)!=0.0&&
+             timediff(eph1->toc,eph2->toc)!=0.0)) {
+            *eph3=*eph2; /* current ->previous */
+            *eph2=*eph1; /* received->current */
+            svr->fnav=1;
+        }
+        svr->nmsg[index][1]++;
+    }
+    else {
+        geph1=nav->geph+prn-1;
+        geph2=svr->nav.geph+prn-1;
+        geph3=svr->nav.geph+prn-1+MAXPRNGLO;
+        if (geph2->tof.time==0||
+            (geph1->iode!=geph3->iode&&geph1->iode!=geph2->iode)) {
+            *geph3=*geph2;
+            *geph2=*geph1;
+            svr->fnav=1;
+        }
+        svr->nmsg[index][6]++;
+    }
+}
+/* update ion/utc parameters -------------------------------------------------*/
+static void update_ionutc(mrtksvr_t *svr, nav_t *nav, int index)
+{
+    NAVCPY(&svr->nav,nav,utc_gps,leaps);
+    svr->fnav=1;
+    svr->nmsg[index][2]++;
+}
+/* update sbas message -------------------------------------------------------*/
+static void update_sbs(mrtksvr_t *svr, sbsmsg_t *sbsmsg, int index)
+{
+    if (sbsmsg) {
+        sbsmsg->rcv=index+1;
+        sbsupdatecorr(sbsmsg,&svr->nav);
+        svr->fnav=1;
+    }
+    svr->nmsg[index][3]++;
+}
+/* update ssr corrections ----------------------------------------------------*/
+static void update_ssr(mrtksvr_t *svr, int index)
+{
+    rtcm_t *rtcm=svr->rtcm[index];
+    int i,sys,prn,iode;
+
+    for (i=0;i<MAXSAT;i++) {
+        if (!rtcm->ssr[i].update) continue;
+
+        /* check consistency between iods of orbit and clock */
+        if (rtcm->ssr[i].iod[0]!=rtcm->ssr[i].iod[1]) continue;
+        rtcm->ssr[i].update=0;
+
+        iode=rtcm->ssr[i].iode;
+        sys=satsys(i+1,&prn);
+
+        /* check corresponding ephemeris exists */
+        if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS) {
+            if (svr->nav.eph[i       ].iode!=iode&&
+                svr->nav.eph[i+MAXSAT].iode!=iode) {
+                continue;
+            }
+        }
+        else if (sys==SYS_GLO) {
+            if (svr->nav.geph[prn-1          ].iode!=iode&&
+                svr->nav.geph[prn-1+MAXPRNGLO].iode!=iode) {
+                continue;
+            }
+        }
+        svr->nav.ssr[i]=rtcm->ssr[i];
+        svr->fnav=1;
+    }
+    svr->nmsg[index][7]++;
+}
+/* decode correction/ephemeris stream data -----------------------------------*/
+static void decodecorr(mrtksvr_t *svr, int index)
+{
+    nav_t *nav;
+    sbsmsg_t *sbsmsg=NULL;
+    int i,ret,ephsat,ephset;
+
+    tracet(4,"decodecorr: index=%d\n",index);
+
+    for (i=0;i<svr->nb[index];) {
+        ret=0;
+
+        if (svr->format[index]==STRFMT_RTCM2) {
+            ret=input_rtcm2(svr->rtcm[index],svr->buff[index][i++]);
+        }
+        else if (svr->format[index]==STRFMT_RTCM3) {
+            i+=(int)input_rtcm3_buf(svr->rtcm[index],svr->buff[index]+i,
+                                    svr->nb[index]-i,NULL,&ret);
+        }
+        else {
+            i+=(int)input_raw_buf(svr->raw[index],svr->format[index],
+                                  svr->buff[index]+i,svr->nb[index]-i,NULL,
+                                  &ret);
+        }
+        if (ret<=0&&ret!=-1) continue;
+
+        if (svr->rtcm[index]) {
+            nav=&svr->rtcm[index]->nav;
+            ephsat=svr->rtcm[index]->ephsat;
+            ephset=svr->rtcm[index]->ephset;
+        }
+        else {
+            nav=&svr->raw[index]->nav;
+            ephsat=svr->raw[index]->ephsat;
+            ephset=svr->raw[index]->ephset;
+            sbsmsg=&svr->raw[index]->sbsmsg;
+        }
+        if      (ret== 1) svr->nmsg[index][0]++; /* observation data ignored */
+        else if (ret== 2) update_eph(svr,nav,ephsat,ephset,index);
+        else if (ret== 3) update_sbs(svr,sbsmsg,index);
+        else if (ret== 9) update_ionutc(svr,nav,index);
+        else if (ret== 5) svr->nmsg[index][4]++;
+        else if (ret== 7) {svr->nmsg[index][5]++; svr->fnav=1;}
+        else if (ret==10) update_ssr(svr,index);
+        else if (ret==-1) svr->nmsg[index][9]++;
+    }
+    svr->nb[index]=0;
+}
+/* initialize navigation snapshot --------------------------------------------*/
+static int initsnap(navsnap_t *snap, const nav_t *nav)
+{
+    int i;
+
+    /* copy static parts of navigation data (erp, dcb, antenna pcv etc.) */
+    NAVCPY(&snap->nav,nav,n,pcvs);
+    NAVCPY(&snap->nav,nav,sbssat,lexeph);
+    memcpy(&snap->nav.lexion,&nav->lexion,
+           sizeof(nav_t)-offsetof(nav_t,lexion));
+
+    /* only loaded satellite antenna pcvs to keep untouched pages unmapped */
+    for (i=0;i<MAXSAT;i++) {
+        if (nav->pcvs[i].sat) snap->nav.pcvs[i]=nav->pcvs[i];
+    }
+    snap->nav.eph=NULL; snap->nav.geph=NULL; snap->nav.seph=NULL;
+    if (!(snap->nav.eph =(eph_t  *)malloc(sizeof(eph_t )*nav->n ))||
+        !(snap->nav.geph=(geph_t *)malloc(sizeof(geph_t)*nav->ng))||
+        !(snap->nav.seph=(seph_t *)malloc(sizeof(seph_t)*nav->ns))) {
+        return 0;
+    }
+    snap->ver=0;
+    snap->nref=0;
+    return 1;
+}
+/* copy updated parts of navigation data to snapshot -------------------------*/
+static void copysnap(navsnap_t *snap, const nav_t *nav)
+{
+    memcpy(snap->nav.eph ,nav->eph ,sizeof(eph_t )*nav->n );
+    memcpy(snap->nav.geph,nav->geph,sizeof(geph_t)*nav->ng);
+    memcpy(snap->nav.seph,nav->seph,sizeof(seph_t)*nav->ns);
+    NAVCPY(&snap->nav,nav,utc_gps,leaps);
+    NAVCPY(&snap->nav,nav,sbssat,lexeph); /* sbas, dgps and ssr */
+}
+/* publish working navigation data as new snapshot ---------------------------*/
+static void pubsnap(mrtksvr_t *svr)
+{
+    navsnap_t *snap=NULL,*prev;
+    int i;
+
+    /* free snapshot: never current and no rover engine referring to it */
+    lock(&svr->lock_snap);
+    for (i=0;i<svr->nsnap;i++) {
+        if (svr->snap[i].nref==0) {snap=svr->snap+i; break;}
+    }
+    unlock(&svr->lock_snap);
+
+    if (!snap) {
+        tracet(2,"navigation snapshot overflow\n");
+        return;
+    }
+    copysnap(snap,&svr->nav);
+
+    lock(&svr->lock_snap);
+    snap->ver=++svr->ver;
+    snap->nref=1; /* reference of server */
+    prev=svr->cur;
+    svr->cur=snap;
+    if (prev) prev->nref--;
+    unlock(&svr->lock_snap);
+
+    svr->fnav=0;
+    tracet(4,"pubsnap: ver=%u\n",snap->ver);
+}
+/* acquire/release reference of current navigation snapshot ------------------*/
+static navsnap_t *acqsnap(mrtksvr_t *svr)
+{
+    navsnap_t *snap;
+
+    lock(&svr->lock_snap);
+    snap=svr->cur;
+    snap->nref++;
+    unlock(&svr->lock_snap);
+    return snap;
+}
+static void relsnap(mrtksvr_t *svr, navsnap_t *snap)
+{
+    lock(&svr->lock_snap);
+    snap->nref--;
+    unlock(&svr->lock_snap);
+}
+/* update glonass frequency channel number in rover decoder ------------------*/
+static void update_glofcn(mrtkrov_t *rov, const nav_t *nav)
+{
+    int i,sat,frq;
+
+    for (i=0;i<MAXPRNGLO;i++) {
+        sat=satno(SYS_GLO,i+1);
+        if (nav->geph[i].sat!=sat) continue;
+        frq=nav->geph[i].frq;
+        if (frq<-7||frq>6) continue;
+
+        if (rov->rtcm) {
+            if (!rov->rtcm->nav.glo_fcn[i]) rov->rtcm->nav.glo_fcn[i]=frq+8;
+        }
+        else if (rov->raw->nav.geph[i].sat!=sat) {
+            rov->raw->nav.geph[i].sat=sat;
+            rov->raw->nav.geph[i].frq=frq;
+        }
+    }
+}
+/* carrier-phase bias (fcb) correction ---------------------------------------*/
+static void corr_phase_bias(obsd_t *obs, int n, const nav_t *nav)
+{
+    double freq;
+    uint8_t code;
+    int i,j;
+
+    for (i=0;i<n;i++) for (j=0;j<NFREQ;j++) {
+        code=obs[i].code[j];
+        if ((freq=sat2freq(obs[i].sat,code,nav))==0.0) continue;
+
+        /* correct phase bias (cyc) */
+        obs[i].L[j]-=nav->ssr[obs[i].sat-1].pbias[code-1]*freq/CLIGHT;
+    }
+}
+/* write solution to rover output stream -------------------------------------*/
+static void writesol(mrtkrov_t *rov)
+{
+    uint8_t buff[MAXSOLMSG+1];
+    int n;
+
+    if (rov->solopt.posf==SOLF_STAT) {
+        n=rtkoutstat(&rov->rtk,(char *)buff);
+    }
+    else {
+        n=outsols(buff,&rov->rtk.sol,rov->rtk.rb,&rov->solopt,&rov->rtk.opt,
+                  NULL);
+    }
+    strwrite(rov->stream+1,buff,n);
+
+    n=outsolexs(buff,&rov->rtk.sol,rov->rtk.ssat,&rov->solopt);
+    strwrite(rov->stream+1,buff,n);
+}
+/* rover engine positioning for an epoch -------------------------------------*/
+static void procrov(mrtksvr_t *svr, mrtkrov_t *rov, const obs_t *obs)
+{
+    navsnap_t *snap;
+    int i,n,sat,sys;
+
+    for (i=n=0;i<obs->n&&n<MAXOBS;i++) {
+        sat=obs->data[i].sat;
+        sys=satsys(sat,NULL);
+        if (rov->rtk.opt.exsats[sat-1]==1||!(sys&rov->rtk.opt.navsys)) {
+            continue;
+        }
+        rov->obs.data[n]=obs->data[i];
+        rov->obs.data[n++].rcv=1;
+    }
+    rov->obs.n=n;
+    sortobs(&rov->obs);
+
+    /* refer current navigation snapshot during positioning */
+    snap=acqsnap(svr);
+
+    if (snap->ver!=rov->ver) {
+        update_glofcn(rov,&snap->nav);
+        rov->ver=snap->ver;
+    }
+    if (!strstr(rov->rtk.opt.pppopt,"-DIS_FCB")) {
+        corr_phase_bias(rov->obs.data,rov->obs.n,&snap->nav);
+    }
+    rtkpos(&rov->rtk,rov->obs.data,rov->obs.n,&snap->nav);
+
+    relsnap(svr,snap);
+
+    lock(&rov->lock);
+    rov->sol=rov->rtk.sol;
+    if (rov->rtk.sol.stat!=SOLQ_NONE) rov->nsol++;
+    unlock(&rov->lock);
+
+    if (rov->rtk.sol.stat!=SOLQ_NONE) writesol(rov);
+}
+/* service rover engine: read, decode and process input data -----------------*/
+static int servrov(mrtksvr_t *svr, mrtkrov_t *rov)
+{
+    int i,n,ret;
+
+    if ((n=strread(rov->stream,rov->buff,svr->buffsize))<=0) return 0;
+
+    /* write rover raw/rtcm data to log stream */
+    strwrite(rov->stream+2,rov->buff,n);
+
+    for (i=0;i<n;) {
+        ret=0;
+        if (rov->format==STRFMT_RTCM2) {
+            ret=input_rtcm2(rov->rtcm,rov->buff[i++]);
+        }
+        else if (rov->format==STRFMT_RTCM3) {
+            i+=(int)input_rtcm3_buf(rov->rtcm,rov->buff+i,n-i,NULL,&ret);
+        }
+        else {
+            i+=(int)input_raw_buf(rov->raw,rov->format,rov->buff+i,n-i,NULL,
+                                  &ret);
+        }
+        if (ret==1) {
+            procrov(svr,rov,rov->rtcm?&rov->rtcm->obs:&rov->raw->obs);
+        }
+    }
+    return n;
+}
+/* claim/unclaim rover engine for worker -------------------------------------*/
+static mrtkrov_t *claimrov(mrtksvr_t *svr)
+{
+    mrtkrov_t *rov=NULL;
+    int i;
+
+    lock(&svr->lock);
+    for (i=0;i<svr->nrov;i++) {
+        rov=svr->rov[svr->next++%svr->nrov];
+        if (!rov->busy) break;
+    }
+    if (i<svr->nrov) rov->busy=1; else rov=NULL;
+    svr->next%=svr->nrov>0?svr->nrov:1;
+    unlock(&svr->lock);
+    return rov;
+}
+static void unclaimrov(mrtksvr_t *svr, mrtkrov_t *rov)
+{
+    lock(&svr->lock);
+    rov->busy=0;
+    unlock(&svr->lock);
+}
+/* correction decoder thread -------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI corrthread(void *arg)
+#else
+static void *corrthread(void *arg)
+#endif
+{
+    mrtksvr_t *svr=(mrtksvr_t *)arg;
+    strwait_t wait;
+    uint32_t tick;
+    int i,cputime;
+
+    tracet(3,"corrthread:\n");
+
+    strwaitinit(&wait);
+
+    while (svr->state) {
+        tick=tickget();
+
+        for (i=0;i<MAXMCOR;i++) {
+            if (!svr->buff[i]) continue;
+            if ((svr->nb[i]=strread(svr->stream+i,svr->buff[i],
+                                    svr->buffsize))<=0) {
+                continue;
+            }
+            decodecorr(svr,i);
+        }
+        /* publish navigation snapshot if updated */
+        if (svr->fnav) pubsnap(svr);
+
+        /* wait correction data arrival */
+        cputime=(int)(tickget()-tick);
+        strwait(&wait,svr->stream,MAXMCOR,svr->cycle-cputime);
+    }
+    strwaitfree(&wait);
+    return 0;
+}
+/* rover worker thread -------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI workthread(void *arg)
+#else
+static void *workthread(void *arg)
+#endif
+{
+    mrtksvr_t *svr=(mrtksvr_t *)arg;
+    mrtkrov_t *rov;
+    stream_t *streams[MAXMROV];
+    strwait_t wait;
+    int i,n,nidle=0;
+
+    tracet(3,"workthread:\n");
+
+    strwaitinit(&wait);
+
+    while (svr->state) {
+        if ((rov=claimrov(svr))) {
+            if (servrov(svr,rov)>0) nidle=0; else nidle++;
+            unclaimrov(svr,rov);
+        }
+        if (rov&&nidle<svr->nrov) continue;
+
+        /* wait input data arrival to rover engines not serviced by others.
+           a serviced engine is checked by its worker after unclaimed */
+        lock(&svr->lock);
+        for (i=n=0;i<svr->nrov;i++) {
+            if (!svr->rov[i]->busy) streams[n++]=svr->rov[i]->stream;
+        }
+        unlock(&svr->lock);
+        strwaitp(&wait,streams,n,svr->cycle);
+        nidle=0;
+    }
+    strwaitfree(&wait);
+    return 0;
+}
+/* create/join server thread -------------------------------------------------*/
+#ifdef WIN32
+static int createthread(thread_t *thread, LPTHREAD_START_ROUTINE func,
+                        void *arg)
+{
+    return (*thread=CreateThread(NULL,0,func,arg,0,NULL))!=NULL;
+}
+static void jointhread(thread_t thread)
+{
+    WaitForSingleObject(thread,10000);
+    CloseHandle(thread);
+}
+#else
+static int createthread(thread_t *thread, void *(*func)(void *), void *arg)
+{
+    return !pthread_create(thread,NULL,func,arg);
+}
+static void jointhread(thread_t thread)
+{
+    pthread_join(thread,NULL);
+}
+#endif
+/* free rover engine ---------------------------------------------------------*/
+static void freerov(mrtkrov_t *rov)
+{
+    int i;
+
+    for (i=0;i<3;i++) strclose(rov->stream+i);
+    if (rov->raw ) {free_raw (rov->raw ); free(rov->raw );}
+    if (rov->rtcm) {free_rtcm(rov->rtcm); free(rov->rtcm);}
+    free(rov->buff);
+    free(rov->obs.data);
+    rtkfree(&rov->rtk);
+    free(rov);
+}
+/* stop server threads and free buffers --------------------------------------*/
+static void stopsvr(mrtksvr_t *svr, int nthread)
+{
+    int i;
+
+    /* threads created in order of correction decoder and workers */
+    svr->state=0;
+    for (i=nthread-1;i>=1;i--) jointhread(svr->worker[i-1]);
+    if (nthread>0) jointhread(svr->thread);
+
+    for (i=0;i<svr->nrov;i++) freerov(svr->rov[i]);
+    svr->nrov=svr->next=0;
+
+    for (i=0;i<MAXMCOR;i++) {
+        strclose(svr->stream+i);
+        if (svr->raw [i]) {free_raw (svr->raw [i]); free(svr->raw [i]);}
+        if (svr->rtcm[i]) {free_rtcm(svr->rtcm[i]); free(svr->rtcm[i]);}
+        free(svr->buff[i]);
+        svr->raw[i]=NULL; svr->rtcm[i]=NULL; svr->buff[i]=NULL;
+        svr->nb[i]=0;
+    }
+    for (i=0;i<svr->nsnap;i++) {
+        free(svr->snap[i].nav.eph );
+        free(svr->snap[i].nav.geph);
+        free(svr->snap[i].nav.seph);
+    }
+    free(svr->snap); svr->snap=svr->cur=NULL;
+    svr->nsnap=0;
+    free(svr->worker); svr->worker=NULL;
+}
+/* initialize multi-rover rtk server -------------------------------------------
+* initialize multi-rover rtk server
+* args   : mrtksvr_t *svr   IO multi-rover rtk server
+* return : status (0:error,1:ok)
+* notes  : static navigation data (antenna pcv, erp, dcb etc.) shared by all
+*          rover engines should be set to svr->nav before mrtksvrstart()
+*-----------------------------------------------------------------------------*/
+extern int mrtksvrinit(mrtksvr_t *svr)
+{
+    eph_t  eph0 ={0,-1,-1};
+    geph_t geph0={0,-1};
+    seph_t seph0={0};
+    int i,j;
+
+    tracet(3,"mrtksvrinit:\n");
+
+    svr->state=svr->cycle=svr->buffsize=svr->nworker=0;
+    svr->nrov=svr->next=svr->nsnap=svr->fnav=0;
+    svr->ver=0;
+    for (i=0;i<MAXMCOR;i++) {
+        svr->format[i]=svr->nb[i]=0;
+        for (j=0;j<10;j++) svr->nmsg[i][j]=0;
+        svr->buff[i]=NULL;
+        svr->raw[i]=NULL;
+        svr->rtcm[i]=NULL;
+        strinit(svr->stream+i);
+    }
+    for (i=0;i<MAXMROV;i++) svr->rov[i]=NULL;
+    svr->snap=svr->cur=NULL;
+    svr->thread=0;
+    svr->worker=NULL;
+
+    memset(&svr->nav,0,sizeof(nav_t));
+    if (!(svr->nav.eph =(eph_t  *)malloc(sizeof(eph_t )*MAXSAT*4 ))||
+        !(svr->nav.geph=(geph_t *)malloc(sizeof(geph_t)*NSATGLO*2))||
+        !(svr->nav.seph=(seph_t *)malloc(sizeof(seph_t)*NSATSBS*2))) {
+        tracet(1,"mrtksvrinit: malloc error\n");
+        return 0;
+    }
+    for (i=0;i<MAXSAT*4 ;i++) svr->nav.eph [i]=eph0;
+    for (i=0;i<NSATGLO*2;i++) svr->nav.geph[i]=geph0;
+    for (i=0;i<NSATSBS*2;i++) svr->nav.seph[i]=seph0;
+    svr->nav.n =MAXSAT *2;
+    svr->nav.ng=NSATGLO*2;
+    svr->nav.ns=NSATSBS*2;
+
+    initlock(&svr->lock);
+    initlock(&svr->lock_snap);
+    return 1;
+}
+/* free multi-rover rtk server -------------------------------------------------
+* free multi-rover rtk server
+* args   : mrtksvr_t *svr   IO multi-rover rtk server
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void mrtksvrfree(mrtksvr_t *svr)
+{
+    free(svr->nav.eph );
+    free(svr->nav.geph);
+    free(svr->nav.seph);
+}
+/* start multi-rover rtk server ------------------------------------------------
+* start correction decoder and rover worker threads of multi-rover rtk server
+* args   : mrtksvr_t *svr   IO multi-rover rtk server
+*          int     cycle    I  server cycle (ms)
+*          int     buffsize I  input buffer size (bytes)
+*          int     nworker  I  number of rover worker threads
+*          int     *strs    I  correction stream types (STR_???) (STR_NONE:
+*                              not used) (MAXMCOR streams)
+*          char    **paths  I  correction stream paths
+*          int     *formats I  correction stream formats (STRFMT_???)
+*          char    **rcvopts I correction stream receiver options
+*          char    *errmsg  O  error message
+* return : status (1:ok 0:error)
+* notes  : rover engines are added by mrtksvraddrov() after server started
+*-----------------------------------------------------------------------------*/
+extern int mrtksvrstart(mrtksvr_t *svr, int cycle, int buffsize, int nworker,
+                        const int *strs, char **paths, const int *formats,
+                        char **rcvopts, char *errmsg)
+{
+    gtime_t time0={0};
+    int i,n;
+
+    tracet(3,"mrtksvrstart: cycle=%d buffsize=%d nworker=%d\n",cycle,buffsize,
+           nworker);
+
+    if (svr->state) {
+        sprintf(errmsg,"server already started");
+        return 0;
+    }
+    strinitcom();
+    svr->cycle=cycle>1?cycle:1;
+    svr->buffsize=buffsize>4096?buffsize:4096;
+    svr->nworker=nworker>1?nworker:1;
+    svr->nrov=svr->next=svr->fnav=0;
+
+    for (i=0;i<MAXSAT*4 ;i++) svr->nav.eph [i].ttr=time0;
+    for (i=0;i<NSATGLO*2;i++) svr->nav.geph[i].tof=time0;
+    for (i=0;i<NSATSBS*2;i++) svr->nav.seph[i].tof=time0;
+
+    /* navigation snapshots: current, publishing and referred by workers */
+    n=svr->nworker+NSNAPSPARE;
+    if (!(svr->snap=(navsnap_t *)calloc(n,sizeof(navsnap_t)))||
+        !(svr->worker=(thread_t *)malloc(sizeof(thread_t)*svr->nworker))) {
+        stopsvr(svr,0);
+        sprintf(errmsg,"multi-rover server malloc error");
+        return 0;
+    }
+    for (i=0;i<n;i++) {
+        svr->nsnap=i+1;
+        if (!initsnap(svr->snap+i,&svr->nav)) {
+            stopsvr(svr,0);
+            sprintf(errmsg,"multi-rover server malloc error");
+            return 0;
+        }
+    }
+    pubsnap(svr);
+
+    /* open correction streams */
+    for (i=0;i<MAXMCOR;i++) {
+        for (n=0;n<10;n++) svr->nmsg[i][n]=0;
+        if (strs[i]==STR_NONE) continue;
+
+        svr->format[i]=formats[i];
+        if (!(svr->buff[i]=(uint8_t *)malloc(svr->buffsize))) {
+            stopsvr(svr,0);
+            sprintf(errmsg,"multi-rover server malloc error");
+            return 0;
+        }
+        if (formats[i]==STRFMT_RTCM2||formats[i]==STRFMT_RTCM3) {
+            if ((svr->rtcm[i]=(rtcm_t *)malloc(sizeof(rtcm_t)))) {
+                init_rtcm(svr->rtcm[i]);
+                strcpy(svr->rtcm[i]->opt,rcvopts[i]);
+                svr->rtcm[i]->time=utc2gpst(timeget());
+                svr->rtcm[i]->dgps=svr->nav.dgps;
+            }
+        }
+        else if ((svr->raw[i]=(raw_t *)malloc(sizeof(raw_t)))) {
+            init_raw(svr->raw[i],formats[i]);
+            strcpy(svr->raw[i]->opt,rcvopts[i]);
+            svr->raw[i]->time=utc2gpst(timeget());
+        }
+        if (!svr->rtcm[i]&&!svr->raw[i]) {
+            stopsvr(svr,0);
+            sprintf(errmsg,"multi-rover server malloc error");
+            return 0;
+        }
+        if (!stropen(svr->stream+i,strs[i],STR_MODE_R,paths[i])) {
+            sprintf(errmsg,"corr%d open error path=%s",i+1,paths[i]);
+            stopsvr(svr,0);
+            return 0;
+        }
+    }
+    /* create correction decoder and rover worker threads */
+    svr->state=1;
+
+    n=0;
+    if (createthread(&svr->thread,corrthread,svr)) n++;
+    for (i=0;i<svr->nworker&&n==1+i;i++) {
+        if (createthread(svr->worker+i,workthread,svr)) n++;
+    }
+    if (n<svr->nworker+1) {
+        stopsvr(svr,n);
+        sprintf(errmsg,"thread create error\n");
+        return 0;
+    }
+    return 1;
+}
+/* stop multi-rover rtk server -------------------------------------------------
+* stop multi-rover rtk server threads, close streams and free rover engines
+* args   : mrtksvr_t *svr   IO multi-rover rtk server
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void mrtksvrstop(mrtksvr_t *svr)
+{
+    tracet(3,"mrtksvrstop:\n");
+
+    if (!svr->state) return;
+    stopsvr(svr,svr->nworker+1);
+}
+/* add rover engine to multi-rover rtk server ----------------------------------
+* add rover engine with own input, solution and log streams to running server
+* args   : mrtksvr_t *svr   IO multi-rover rtk server
+*          int     *strs    I  stream types (STR_???)
+*                              strs[0]=input stream rover
+*                              strs[1]=output stream solution
+*                              strs[2]=log stream rover (STR_NONE: no log)
+*          char    **paths  I  stream paths
+*          int     format   I  rover input stream format (STRFMT_???)
+*          char    *rcvopt  I  receiver option
+*          prcopt_t *prcopt I  processing options
+*          solopt_t *solopt I  solution options
+*          char   *errmsg   O  error message
+* return : rover index (-1: error)
+* notes  : base station is not supported. rover engine should be processed in
+*          single, dgps-free or ppp mode with the shared navigation data.
+*-----------------------------------------------------------------------------*/
+extern int mrtksvraddrov(mrtksvr_t *svr, const int *strs, char **paths,
+                         int format, const char *rcvopt,
+                         const prcopt_t *prcopt, const solopt_t *solopt,
+                         char *errmsg)
+{
+    mrtkrov_t *rov;
+    uint8_t buff[1024];
+    int i,n,rw;
+
+    tracet(3,"mrtksvraddrov: format=%d\n",format);
+
+    if (!svr->state) {
+        sprintf(errmsg,"server not started");
+        return -1;
+    }
+    if (svr->nrov>=MAXMROV) {
+        sprintf(errmsg,"rover engine overflow");
+        return -1;
+    }
+    if (!(rov=(mrtkrov_t *)calloc(1,sizeof(mrtkrov_t)))) {
+        sprintf(errmsg,"rover engine malloc error");
+        return -1;
+    }
+    rov->format=format;
+    rov->solopt=*solopt;
+    rtkinit(&rov->rtk,prcopt,NULL);
+    for (i=0;i<3;i++) strinit(rov->stream+i);
+    initlock(&rov->lock);
+
+    if (format==STRFMT_RTCM2||format==STRFMT_RTCM3) {
+        if ((rov->rtcm=(rtcm_t *)malloc(sizeof(rtcm_t)))) {
+            init_rtcm(rov->rtcm);
+            strcpy(rov->rtcm->opt,rcvopt);
+        }
+    }
+    else if ((rov->raw=(raw_t *)malloc(sizeof(raw_t)))) {
+        init_raw(rov->raw,format);
+        strcpy(rov->raw->opt,rcvopt);
+    }
+    if ((!rov->rtcm&&!rov->raw)||
+        !(rov->buff=(uint8_t *)malloc(svr->buffsize))||
+        !(rov->obs.data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))) {
+        freerov(rov);
+        sprintf(errmsg,"rover engine malloc error");
+        return -1;
+    }
+    for (i=0;i<3;i++) {
+        rw=i==0?STR_MODE_R:STR_MODE_W;
+        if (strs[i]!=STR_FILE) rw|=STR_MODE_W;
+        if (!stropen(rov->stream+i,strs[i],rw,paths[i])) {
+            sprintf(errmsg,"rover str%d open error path=%s",i+1,paths[i]);
+            freerov(rov);
+            return -1;
+        }
+    }
+    if (rov->rtcm) {
+        rov->rtcm->time=strs[0]==STR_FILE?strgettime(rov->stream):
+                        utc2gpst(timeget());
+    }
+    else {
+        rov->raw->time=strs[0]==STR_FILE?strgettime(rov->stream):
+                       utc2gpst(timeget());
+    }
+    /* write solution header to solution stream */
+    n=outsolheads(buff,&rov->solopt,&rov->rtk.opt);
+    strwrite(rov->stream+1,buff,n);
+
+    /* make rover engine visible to workers */
+    lock(&svr->lock);
+    rov->index=svr->nrov;
+    svr->rov[svr->nrov++]=rov;
+    unlock(&svr->lock);
+
+    return rov->index;
+}
+/* get rover engine status -----------------------------------------------------
+* get latest solution and status of rover engine
+* args   : mrtksvr_t *svr   I  multi-rover rtk server
+*          int     index    I  rover index
+*          sol_t   *sol     O  latest solution (NULL: no output)
+*          int     *nsol    O  number of valid solutions (NULL: no output)
+*          uint32_t *ver    O  version of last referred navigation snapshot
+*                              (NULL: no output)
+* return : rover input stream state (-1:error,0:close,1:wait,2:connect,
+*          -2:no rover engine)
+*-----------------------------------------------------------------------------*/
+extern int mrtksvrrovstat(mrtksvr_t *svr, int index, sol_t *sol, int *nsol,
+                          uint32_t *ver)
+{
+    mrtkrov_t *rov;
+    char msg[MAXSTRMSG];
+    int state;
+
+    lock(&svr->lock);
+    rov=index>=0&&index<svr->nrov?svr->rov[index]:NULL;
+    unlock(&svr->lock);
+    if (!rov) return -2;
+
+    lock(&rov->lock);
+    if (sol ) *sol =rov->sol;
+    if (nsol) *nsol=rov->nsol;
+    if (ver ) *ver =rov->ver;
+    unlock(&rov->lock);
+
+    state=strstat(rov->stream,msg);
+    return state;
+}
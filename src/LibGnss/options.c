@@ -24,6 +24,7 @@
 *           2016/06/10  1.9  add ant2-maxaveep,ant2-initrst
 *           2016/07/31  1.10 add out-outsingle,out-maxsolstd
 *           2017/06/14  1.11 add out-outvel
+*           2026/10/18  1.12 add out-solformat=bin
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -57,7 +58,7 @@ static char imucoord[10];
 #define NAVOPT  "1:gps+2:sbas+4:glo+8:gal+16:qzs+32:comp"
 #define GAROPT  "0:off,1:on,2:autocal,3:fix-and-hold"
 #define WEIGHTOPT "0:elevation,1:snr"
-#define SOLOPT  "0:llh,1:xyz,2:enu,3:nmea,4:stat,5:gsif,6:ins_llh,7:ins_xyz,8:ins_ygm"
+#define SOLOPT  "0:llh,1:xyz,2:enu,3:nmea,4:stat,5:gsif,6:ins_llh,7:ins_xyz,8:ins_ygm,9:bin"
 #define TSYOPT  "0:gpst,1:utc,2:jst"
 #define TFTOPT  "0:tow,1:hms"
 #define DFTOPT  "0:deg,1:dms"
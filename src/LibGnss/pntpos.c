@@ -1233,7 +1233,8 @@ extern int pntpos(int iep,const obsd_t *obs, int n, const nav_t *nav,
                   char *msg,const insopt_t *iopt,kf_t *ins_kf)
 {
     prcopt_t opt_=*opt;
-    double *rs,*dts,*var,*azel_,*resp;
+    astro_t ast,*past=NULL;
+    double *rs,*dts,*var,*azel_,*resp,erpv[5]={0};
     int i,stat,vsat[MAXOBS]={0},svh[MAXOBS];
 
     sol->stat=SOLQ_NONE;
@@ -1261,8 +1262,15 @@ extern int pntpos(int iep,const obsd_t *obs, int n, const nav_t *nav,
         opt_.ionoopt=IONOOPT_BRDC;
         opt_.tropopt=TROPOPT_SAAS;
     }
+    /* sun position and earth orientation of epoch for satellite antenna
+       offsets of precise/ssr orbits (erp not applied as in satantoff()) */
+    if (opt_.sateph==EPHOPT_PREC||opt_.sateph==EPHOPT_SSRAPC||
+        opt_.sateph==EPHOPT_SSRCOM) {
+        astroinit(gpst2utc(obs[0].time),erpv,&ast);
+        past=&ast;
+    }
     /* satellite positons, velocities and clocks */
-    satposs(opt,sol->time,obs,n,nav,opt_.sateph,rs,dts,var,svh);
+    satposs(opt,sol->time,obs,n,nav,past,opt_.sateph,rs,dts,var,svh);
 
     stat=estpos(iep,obs,n,rs,dts,var,svh,nav,&opt_,ssat,sol,azel_,vsat,resp,msg,0);
 
@@ -39,6 +39,9 @@
 *           2016/08/29  1.21 suppress warnings
 *           2016/10/10  1.22 fix bug on identification of file fopt->blq
 *           2017/06/13  1.23 add smoother of velocity solution
+*           2026/10/18  1.24 run combined forward/backward passes concurrently
+*                            (fix-and-hold ar only, see proccomb())
+*           2026/10/18  1.25 support binary solution format (SOLF_BIN)
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -47,11 +50,27 @@
 
 #define MAXPRCDAYS  100          /* max days of continuous processing */
 #define MAXINFILE   30          /* max number of input files */
+#define PASSSTACK   (64<<20)    /* stack size of combined pass thread (bytes) */
+
+/* type definitions ----------------------------------------------------------*/
+
+typedef struct {        /* processing pass type */
+    int revs;           /* analysis direction (0:forward,1:backward) */
+    int iobsu;          /* current rover observation data index */
+    int iobsr;          /* current reference observation data index */
+    int isbs;           /* current sbas message index */
+    int ilex;           /* current lex message index */
+    int mode;           /* procpos mode (0:forward/backward,1:combined) */
+    const prcopt_t *popt; /* processing options */
+    const solopt_t *sopt; /* solution options */
+    rtk_t *rtk;         /* rtk control/result */
+} procpass_t;
 
 /* constants/global variables ------------------------------------------------*/
 
 static pcvs_t pcvss={0};        /* receiver antenna parameters */
 static pcvs_t pcvsr={0};        /* satellite antenna parameters */
+static char atxfile[1024]="";   /* antenna parameter file loaded in pcvss */
 static obs_t obss={0};          /* observation data */
 static nav_t navs={0};          /* navigation data */
 static sbs_t sbss={0};          /* sbas messages */
@@ -59,12 +78,7 @@ static lex_t lexs={0};          /* lex messages */
 static sta_t stas[MAXRCV];      /* station information */
 static int nepoch=0;            /* number of observation epochs */
 static int nitm  =0;            /* number of invalid time marks */
-static int iobsu =0;            /* current rover observation data index */
-static int iobsr =0;            /* current reference observation data index */
-static int isbs  =0;            /* current sbas message index */
-static int ilex  =0;            /* current lex message index */
 static int iitm  =0;            /* current invalid time mark index */
-static int revs  =0;            /* analysis direction (0:forward,1:backward) */
 static int aborts=0;            /* abort status */
 static sol_t *solf;             /* forward solutions */
 static sol_t *solb;             /* backward solutions */
@@ -76,9 +90,12 @@ static char proc_rov [64]="";   /* rover for current processing */
 static char proc_base[64]="";   /* base station for current processing */
 static char rtcm_file[1024]=""; /* rtcm data file */
 static char rtcm_path[1024]=""; /* rtcm data path */
+static char trace_file[1024]="";/* debug trace file of session */
 static gtime_t invalidtm[100]={{0}};/* invalid time marks */
 static rtcm_t rtcm;             /* rtcm control struct */
 static FILE *fp_rtcm=NULL;      /* rtcm data file pointer */
+static int nepoch_all=0;        /* processed epochs of all sessions */
+static int nfix_all  =0;        /* fixed epochs of all sessions */
 
 /* show message and check break ----------------------------------------------*/
 static int checkbrk(const char *format, ...)
@@ -132,7 +149,7 @@ static void outheader(FILE *fp, char **file, int n, const prcopt_t *popt,
     
     trace(4,"outheader: n=%d\n",n);
     
-    if (sopt->posf==SOLF_NMEA||sopt->posf==SOLF_STAT) {
+    if (sopt->posf==SOLF_NMEA||sopt->posf==SOLF_STAT||sopt->posf==SOLF_BIN) {
         return;
     }
     if (sopt->outhead) {
@@ -240,53 +257,53 @@ static void update_rtcm_ssr(gtime_t time)
     }
 }
 /* input obs data, navigation messages and sbas correction -------------------*/
-static int inputobs(obsd_t *obs, int solq, const prcopt_t *popt)
+static int inputobs(procpass_t *pass, obsd_t *obs, int solq, const prcopt_t *popt)
 {
     gtime_t time={0};
     int i,nu,nr,n=0;
     
-    trace(3,"\ninfunc  : revs=%d iobsu=%d iobsr=%d isbs=%d\n",revs,iobsu,iobsr,isbs);
+    trace(3,"\ninfunc  : revs=%d iobsu=%d iobsr=%d isbs=%d\n",pass->revs,pass->iobsu,pass->iobsr,pass->isbs);
     
-    if (0<=iobsu&&iobsu<obss.n) {
-        settime((time=obss.data[iobsu].time));
+    if (0<=pass->iobsu&&pass->iobsu<obss.n) {
+        settime((time=obss.data[pass->iobsu].time));
         if (checkbrk("processing : %s Q=%d",time_str(time,0),solq)) {
             aborts=1; showmsg("aborted"); return -1;
         }
     }
-    if (!revs) { /* input forward data */
-        if ((nu=nextobsf(&obss,&iobsu,1))<=0) return -1;
+    if (!pass->revs) { /* input forward data */
+        if ((nu=nextobsf(&obss,&pass->iobsu,1))<=0) return -1;
         if (popt->intpref) {
-            for (;(nr=nextobsf(&obss,&iobsr,2))>0;iobsr+=nr)
-                if (timediff(obss.data[iobsr].time,obss.data[iobsu].time)>-DTTOL) break;
+            for (;(nr=nextobsf(&obss,&pass->iobsr,2))>0;pass->iobsr+=nr)
+                if (timediff(obss.data[pass->iobsr].time,obss.data[pass->iobsu].time)>-DTTOL) break;
         }
         else {
-            for (i=iobsr;(nr=nextobsf(&obss,&i,2))>0;iobsr=i,i+=nr)
-                if (timediff(obss.data[i].time,obss.data[iobsu].time)>DTTOL) break;
+            for (i=pass->iobsr;(nr=nextobsf(&obss,&i,2))>0;pass->iobsr=i,i+=nr)
+                if (timediff(obss.data[i].time,obss.data[pass->iobsu].time)>DTTOL) break;
         }
-        nr=nextobsf(&obss,&iobsr,2);
+        nr=nextobsf(&obss,&pass->iobsr,2);
         if (nr<=0) {
-            nr=nextobsf(&obss,&iobsr,2);
+            nr=nextobsf(&obss,&pass->iobsr,2);
         }
-        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsu+i];
-        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsr+i];
-        iobsu+=nu;
+        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=obss.data[pass->iobsu+i];
+        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=obss.data[pass->iobsr+i];
+        pass->iobsu+=nu;
         
         /* update sbas corrections */
-        while (isbs<sbss.n) {
-            time=gpst2time(sbss.msgs[isbs].week,sbss.msgs[isbs].tow);
+        while (pass->isbs<sbss.n) {
+            time=gpst2time(sbss.msgs[pass->isbs].week,sbss.msgs[pass->isbs].tow);
             
-            if (getbitu(sbss.msgs[isbs].msg,8,6)!=9) { /* except for geo nav */
-                sbsupdatecorr(sbss.msgs+isbs,&navs);
+            if (getbitu(sbss.msgs[pass->isbs].msg,8,6)!=9) { /* except for geo nav */
+                sbsupdatecorr(sbss.msgs+pass->isbs,&navs);
             }
             if (timediff(time,obs[0].time)>-1.0-DTTOL) break;
-            isbs++;
+            pass->isbs++;
         }
         /* update lex corrections */
-        while (ilex<lexs.n) {
-            if (lexupdatecorr(lexs.msgs+ilex,&navs,&time)) {
+        while (pass->ilex<lexs.n) {
+            if (lexupdatecorr(lexs.msgs+pass->ilex,&navs,&time)) {
                 if (timediff(time,obs[0].time)>-1.0-DTTOL) break;
             }
-            ilex++;
+            pass->ilex++;
         }
         /* update rtcm ssr corrections */
         if (*rtcm_file) {
@@ -294,36 +311,36 @@ static int inputobs(obsd_t *obs, int solq, const prcopt_t *popt)
         }
     }
     else { /* input backward data */
-        if ((nu=nextobsb(&obss,&iobsu,1))<=0) return -1;
+        if ((nu=nextobsb(&obss,&pass->iobsu,1))<=0) return -1;
         if (popt->intpref) {
-            for (;(nr=nextobsb(&obss,&iobsr,2))>0;iobsr-=nr)
-                if (timediff(obss.data[iobsr].time,obss.data[iobsu].time)<DTTOL) break;
+            for (;(nr=nextobsb(&obss,&pass->iobsr,2))>0;pass->iobsr-=nr)
+                if (timediff(obss.data[pass->iobsr].time,obss.data[pass->iobsu].time)<DTTOL) break;
         }
         else {
-            for (i=iobsr;(nr=nextobsb(&obss,&i,2))>0;iobsr=i,i-=nr)
-                if (timediff(obss.data[i].time,obss.data[iobsu].time)<-DTTOL) break;
+            for (i=pass->iobsr;(nr=nextobsb(&obss,&i,2))>0;pass->iobsr=i,i-=nr)
+                if (timediff(obss.data[i].time,obss.data[pass->iobsu].time)<-DTTOL) break;
         }
-        nr=nextobsb(&obss,&iobsr,2);
-        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsu-nu+1+i];
-        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=obss.data[iobsr-nr+1+i];
-        iobsu-=nu;
+        nr=nextobsb(&obss,&pass->iobsr,2);
+        for (i=0;i<nu&&n<MAXOBS*2;i++) obs[n++]=obss.data[pass->iobsu-nu+1+i];
+        for (i=0;i<nr&&n<MAXOBS*2;i++) obs[n++]=obss.data[pass->iobsr-nr+1+i];
+        pass->iobsu-=nu;
         
         /* update sbas corrections */
-        while (isbs>=0) {
-            time=gpst2time(sbss.msgs[isbs].week,sbss.msgs[isbs].tow);
+        while (pass->isbs>=0) {
+            time=gpst2time(sbss.msgs[pass->isbs].week,sbss.msgs[pass->isbs].tow);
             
-            if (getbitu(sbss.msgs[isbs].msg,8,6)!=9) { /* except for geo nav */
-                sbsupdatecorr(sbss.msgs+isbs,&navs);
+            if (getbitu(sbss.msgs[pass->isbs].msg,8,6)!=9) { /* except for geo nav */
+                sbsupdatecorr(sbss.msgs+pass->isbs,&navs);
             }
             if (timediff(time,obs[0].time)<1.0+DTTOL) break;
-            isbs--;
+            pass->isbs--;
         }
         /* update lex corrections */
-        while (ilex>=0) {
-            if (lexupdatecorr(lexs.msgs+ilex,&navs,&time)) {
+        while (pass->ilex>=0) {
+            if (lexupdatecorr(lexs.msgs+pass->ilex,&navs,&time)) {
                 if (timediff(time,obs[0].time)<1.0+DTTOL) break;
             }
-            ilex--;
+            pass->ilex--;
         }
     }
     return n;
@@ -401,7 +418,7 @@ static void corr_phase_bias_ssr(obsd_t *obs, int n, const nav_t *nav)
 
 /* process positioning -------------------------------------------------------*/
 static void procpos(FILE *fp, FILE *fptm, const prcopt_t *popt, const solopt_t *sopt,
-                    rtk_t *rtk, int mode)
+                    rtk_t *rtk, int mode, procpass_t *pass)
 {
     gtime_t time={0};
     sol_t sol={{0}},oldsol={{0}},newsol={{0}};
@@ -415,15 +432,15 @@ static void procpos(FILE *fp, FILE *fptm, const prcopt_t *popt, const solopt_t *
               (popt->mode==PMODE_STATIC||popt->mode==PMODE_STATIC_START||popt->mode==PMODE_PPP_STATIC);
     
     /* initialize unless running backwards on a combined run with continuous AR in which case keep the current states */
-    if (mode==0 || !revs || popt->modear==ARMODE_FIXHOLD)
+    if (mode==0 || !pass->revs || popt->modear==ARMODE_FIXHOLD)
         rtkinit(rtk,popt,NULL);
     
-    rtcm_path[0]='\0';
+    if (!pass->revs) rtcm_path[0]='\0';
     if(popt->mode!=PMODE_FIXED||popt->mode!=PMODE_PPP_FIXED){
         for(i=0;i<3;i++) rtk->sol.rr[i]=stas[0].pos[i];
     }
 
-    while ((nobs=inputobs(obs,rtk->sol.stat,popt))>=0) {
+    while ((nobs=inputobs(pass,obs,rtk->sol.stat,popt))>=0) {
 
         rtk->epoch++;
 
@@ -438,7 +455,7 @@ static void procpos(FILE *fp, FILE *fptm, const prcopt_t *popt, const solopt_t *
             if (rtk->sol.eventime.time != 0) {
                 if (mode == 0) {
                     outinvalidtm(fptm, sopt, rtk->sol.eventime);
-                } else if (!revs) {
+                } else if (!pass->revs) {
                     invalidtm[nitm++] = rtk->sol.eventime;
                 }
             }
@@ -468,7 +485,7 @@ static void procpos(FILE *fp, FILE *fptm, const prcopt_t *popt, const solopt_t *
 //            }
 //            oldsol = rtk->sol;
         }
-        else if (!revs) { /* combined-forward */
+        else if (!pass->revs) { /* combined-forward */
             if (isolf>=nepoch) return;
             solf[isolf]=rtk->sol;
             for (i=0;i<3;i++) rbf[i+isolf*3]=rtk->rb[i];
@@ -486,6 +503,99 @@ static void procpos(FILE *fp, FILE *fptm, const prcopt_t *popt, const solopt_t *
         outsol(fp,&sol,rb,sopt,&rtk->opt,NULL);
     }
 }
+/* combined processing pass thread ------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI procpasthread(void *arg)
+#else
+static void *procpasthread(void *arg)
+#endif
+{
+    procpass_t *pass=(procpass_t *)arg;
+    char path[1024],*p;
+
+    /* backward pass traces to its own file (xxx_b.trace) */
+    strcpy(path,trace_file);
+    if ((p=strrchr(path,'.'))&&!strchr(p,FILEPATHSEP)) {
+        sprintf(p,"_b%s",trace_file+(p-path));
+    }
+    else if (*path) strcat(path,"_b");
+    traceopenthr(path);
+
+    procpos(NULL,NULL,pass->popt,pass->sopt,pass->rtk,pass->mode,pass);
+
+    traceclosethr();
+    return 0;
+}
+/* test forward/backward passes of combined solution independent --------------
+* the passes can run concurrently only if the backward pass starts from
+* initialized states and neither pass feeds corrections or output files
+* shared with the other pass. the backward pass writes its debug trace to
+* a separate file
+*-----------------------------------------------------------------------------*/
+static int indeppass(const prcopt_t *popt, const solopt_t *sopt)
+{
+    if (popt->modear!=ARMODE_FIXHOLD) return 0; /* backward keeps states */
+    if (popt->mode>PMODE_PPP_FIXED) return 0;     /* shared ins states */
+    if (sbss.n>0||lexs.n>0||*rtcm_file) return 0; /* nav updated by pass */
+    if (sopt->sstat>0) return 0;                  /* shared stat file */
+    if (sopt->ambres&&popt->modear==ARMODE_PPPAR_ILS) return 0;
+    return 1;
+}
+/* combined forward/backward processing ---------------------------------------
+* the passes run concurrently only with fix-and-hold ar (indeppass()). in the
+* other ar modes the backward pass starts from the final states of the
+* forward pass, so both run sequentially on the same rtk struct
+*-----------------------------------------------------------------------------*/
+static void proccomb(const prcopt_t *popt, const solopt_t *sopt, rtk_t *rtk)
+{
+    procpass_t passf={0},passb={0};
+    rtk_t *rtkb;
+    thread_t thread;
+    int stat;
+#ifndef WIN32
+    pthread_attr_t attr;
+#endif
+
+    passf.mode=passb.mode=1;
+    passf.popt=passb.popt=popt;
+    passf.sopt=passb.sopt=sopt;
+    passb.revs=1; passb.iobsu=passb.iobsr=obss.n-1;
+    passb.isbs=sbss.n-1; passb.ilex=lexs.n-1;
+
+    if (!indeppass(popt,sopt)||!(rtkb=(rtk_t *)calloc(1,sizeof(rtk_t)))) {
+        procpos(NULL,NULL,popt,sopt,rtk,1,&passf); /* forward */
+        procpos(NULL,NULL,popt,sopt,rtk,1,&passb); /* backward */
+        return;
+    }
+    trace(3,"proccomb: forward/backward passes run concurrently\n");
+
+    /* backward pass on its own rtk control/result struct */
+    passb.rtk=rtkb;
+#ifdef WIN32
+    stat=(thread=CreateThread(NULL,PASSSTACK,procpasthread,&passb,0,NULL))!=NULL;
+#else
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr,PASSSTACK);
+    stat=!pthread_create(&thread,&attr,procpasthread,&passb);
+    pthread_attr_destroy(&attr);
+#endif
+    if (!stat) procpasthread(&passb);
+
+    procpos(NULL,NULL,popt,sopt,rtk,1,&passf); /* forward */
+
+    if (stat) {
+#ifdef WIN32
+        WaitForSingleObject(thread,INFINITE);
+        CloseHandle(thread);
+#else
+        pthread_join(thread,NULL);
+#endif
+    }
+    /* the backward pass is the last one in sequential processing */
+    rtkfree(rtk);
+    *rtk=*rtkb;
+    free(rtkb);
+}
 /* validation of combined solutions ------------------------------------------*/
 static int valcomb(const sol_t *solf, const sol_t *solb)
 {
@@ -814,7 +924,10 @@ extern void freeobsnav(obs_t *obs, nav_t *nav)
         free(nav->fcbs->data);nav->fcbs->data=NULL;nav->fcbs->nmax=nav->fcbs->n=0;
     }
     if(nav->osbs){
-        free(nav->osbs->sat_osb);nav->osbs->sat_osb=NULL;
+        free(nav->osbs->idx);nav->osbs->idx=NULL;
+        free(nav->osbs->code);nav->osbs->code=NULL;
+        free(nav->osbs->phase);nav->osbs->phase=NULL;
+        nav->osbs->ns=nav->osbs->n=0;
     }
     if(nav->upds){
         free(nav->upds->nls.data); nav->upds->nls.n=nav->upds->nls.nmax=0;
@@ -941,11 +1054,16 @@ static int openses(const prcopt_t *popt, const solopt_t *sopt,
     
     trace(3,"openses :\n");
 
-    /* read satellite antenna parameters */
-    if (*fopt->atx&&!(readpcv(fopt->atx,pcvs))) {
-        showmsg("error : no sat ant pcv in %s",fopt->atx);
-        trace(1,"sat antenna pcv read error: %s\n",fopt->atx);
-        return 0;
+    /* read satellite antenna parameters (kept loaded for the process) */
+    if (*fopt->atx&&(pcvs->n<=0||strcmp(fopt->atx,atxfile))) {
+        freepcv(pcvs);
+        *atxfile='\0';
+        if (!readpcv(fopt->atx,pcvs)) {
+            showmsg("error : no sat ant pcv in %s",fopt->atx);
+            trace(1,"sat antenna pcv read error: %s\n",fopt->atx);
+            return 0;
+        }
+        strcpy(atxfile,fopt->atx);
     }
 
     /* open geoid data */
@@ -973,13 +1091,8 @@ static void closeses(nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
 {
     trace(3,"closeses:\n");
     
-    /* free antenna parameters */
-    if(pcvs->pcv){
-        free(pcvs->pcv); pcvs->pcv=NULL; pcvs->n=pcvs->nmax=0;
-    }
-    if(pcvr->pcv){
-        free(pcvr->pcv); pcvr->pcv=NULL; pcvr->n=pcvr->nmax=0;
-    }
+    /* antenna parameters of atxfile are kept for next sessions */
+    freepcv(pcvr);
 
     /* close geoid data */
     closegeoid();
@@ -990,6 +1103,7 @@ static void closeses(nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
     /* close solution statistics and debug trace */
     rtkclosestat();
     traceclose();
+    trace_file[0]='\0';
 }
 /* set antenna parameters ----------------------------------------------------*/
 extern void setpcv(gtime_t time, prcopt_t *popt, nav_t *nav, const pcvs_t *pcvs,
@@ -1053,7 +1167,7 @@ extern int outhead(const char *outfile, char **infile, int n,
     if (*outfile) {
         createdir(outfile);
         
-        if (!(fp=fopen(outfile,"w"))) {
+        if (!(fp=fopen(outfile,sopt->posf==SOLF_BIN?"wb":"w"))) {
             showmsg("error : open output file %s",outfile);
             return 0;
         }
@@ -1066,11 +1180,11 @@ extern int outhead(const char *outfile, char **infile, int n,
     return 1;
 }
 /* open output file for append -----------------------------------------------*/
-static FILE *openfile(const char *outfile)
+static FILE *openfile(const char *outfile, const solopt_t *sopt)
 {
     trace(3,"openfile: outfile=%s\n",outfile);
     
-    return !*outfile?stdout:fopen(outfile,"a");
+    return !*outfile?stdout:fopen(outfile,sopt->posf==SOLF_BIN?"ab":"a");
 }
 /* Name time marks file ------------------------------------------------------*/
 static void namefiletm(char *outfiletm, const char *outfile)
@@ -1096,6 +1210,7 @@ static int execses(gtime_t ts,gtime_t te,double ti,const prcopt_t *popt,
 {
     FILE *fp,*fptm;
     rtk_t rtk={0};
+    procpass_t pass={0};
     prcopt_t popt_=*popt;
     solopt_t tmsopt = *sopt;
     char tracefile[1024],statfile[1024],path[1024],*ext,outfiletm[1024]={0};
@@ -1114,6 +1229,7 @@ static int execses(gtime_t ts,gtime_t te,double ti,const prcopt_t *popt,
         traceclose();
         traceopen(tracefile);
         tracelevel(sopt->trace);
+        strcpy(trace_file,tracefile);
     }
     tracelevel(sopt->trace);
 
@@ -1194,26 +1310,27 @@ static int execses(gtime_t ts,gtime_t te,double ti,const prcopt_t *popt,
         strcpy(statfile,outfile);
         strcat(statfile,".stat");
         rtkclosestat();
-        rtkopenstat(statfile,sopt->sstat);
+        rtkopenstat(statfile,sopt->sstat,sopt->posf);
     }
 
     if(sopt->ambres&&popt_.modear==ARMODE_PPPAR_ILS){
         rtkopenfcbstat(fopt->wl_amb,fopt->nl_amb,fopt->lc_amb);
     }
 
-    iobsu=iobsr=isbs=ilex=revs=aborts=0;
+    aborts=0;
     
     if (popt_.mode==PMODE_SINGLE||popt_.soltype==0) {
-        if ((fp=openfile(outfile)) && (fptm=openfile(outfiletm))) {
-            procpos(fp,fptm,&popt_,sopt,&rtk,0); /* forward */
+        if ((fp=openfile(outfile,sopt)) && (fptm=openfile(outfiletm,sopt))) {
+            procpos(fp,fptm,&popt_,sopt,&rtk,0,&pass); /* forward */
             fclose(fp);
             fclose(fptm);
         }
     }
     else if (popt_.soltype==1) {
-        if ((fp=openfile(outfile)) && (fptm=openfile(outfiletm))) {
-            revs=1; iobsu=iobsr=obss.n-1; isbs=sbss.n-1; ilex=lexs.n-1;
-            procpos(fp,fptm,&popt_,sopt,&rtk,0); /* backward */
+        if ((fp=openfile(outfile,sopt)) && (fptm=openfile(outfiletm,sopt))) {
+            pass.revs=1; pass.iobsu=pass.iobsr=obss.n-1;
+            pass.isbs=sbss.n-1; pass.ilex=lexs.n-1;
+            procpos(fp,fptm,&popt_,sopt,&rtk,0,&pass); /* backward */
             fclose(fp);
             fclose(fptm);
         }
@@ -1226,12 +1343,11 @@ static int execses(gtime_t ts,gtime_t te,double ti,const prcopt_t *popt,
         
         if (solf&&solb) {
             isolf=isolb=0;
-            procpos(NULL,NULL,&popt_,sopt,&rtk,1); /* forward */
-            revs=1; iobsu=iobsr=obss.n-1; isbs=sbss.n-1; ilex=lexs.n-1;
-            procpos(NULL,NULL,&popt_,sopt,&rtk,1); /* backward */
+            /* concurrent passes with fix-and-hold ar only, else sequential */
+            proccomb(&popt_,sopt,&rtk); /* forward and backward */
             
             /* combine forward/backward solutions */
-            if (!aborts&&(fp=openfile(outfile))  && (fptm=openfile(outfiletm))) {
+            if (!aborts&&(fp=openfile(outfile,sopt))  && (fptm=openfile(outfiletm,sopt))) {
                 combres(fp,fptm,&popt_,sopt);
                 fclose(fp);
                 fclose(fptm);
@@ -1244,6 +1360,8 @@ static int execses(gtime_t ts,gtime_t te,double ti,const prcopt_t *popt,
         free(rbb);
     }
     /*==*/
+    nepoch_all+=rtk.epoch;
+    nfix_all+=rtk.fix_epoch;
     if(popt->modear>=ARMODE_OFF){
         fprintf(stderr,"Total epoch: %d(100.0%s), Fix epoch: %d(%3.1f%s), Else: %d\n",
                 rtk.epoch,"%",rtk.fix_epoch,(rtk.fix_epoch+1e-9)/rtk.epoch*100.0,"%",rtk.epoch-rtk.fix_epoch);
@@ -1253,9 +1371,6 @@ static int execses(gtime_t ts,gtime_t te,double ti,const prcopt_t *popt,
     /* free rtk, obs and nav data */
     rtkfree(&rtk);
     freeobsnav(&obss,&navs);
-    if(pcvss.pcv) {
-        free(pcvss.pcv);pcvss.pcv=NULL;pcvss.n=pcvss.nmax=0;
-    }
     
     return aborts?1:0;
 }
@@ -1520,3 +1635,15 @@ extern int postpos(gtime_t ts, gtime_t te, double ti, double tu,
     
     return stat;
 }
+/* post-processing statistics --------------------------------------------------
+* get number of processed and fixed epochs accumulated over all sessions of
+* postpos() in the process
+* args   : int    *nepoch   O   number of processed epochs
+*          int    *nfix     O   number of fixed epochs
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void postposstat(int *nepoch, int *nfix)
+{
+    *nepoch=nepoch_all;
+    *nfix=nfix_all;
+}
@@ -54,6 +54,8 @@
 *           2015/11/13 1.11 add L5-receiver-dcb estimation
 *                           merge post-residual validation by rnx2rtkp_test
 *                           support support option opt->pppopt=-GAP_RESION=nnnn
+*                           support option opt->pppopt=-TIDE_TINT=nnn
+*                           support option opt->pppopt=-MDL_FLOAT=n
 *           2016/01/22 1.12 delete support for yaw-model bug
 *                           add support for ura of ephemeris
 *           2018/10/10 1.13 support api change of satexclude()
@@ -90,6 +92,9 @@
 #define ERR_CBIAS   0.3             /* code bias error std (m) */
 #define REL_HUMI    0.7             /* relative humidity for saastamoinen model */
 #define GAP_RESION  120             /* default gap to reset ionos parameters (ep) */
+#define TIDE_TINT   0.0             /* default node interval of tide table (s) (0:off) */
+#define TOL_MDLF    1E-4            /* tolerance of single-precision models (m) */
+#define MAXCOSPF    (1.0-1E-4)      /* max |cos| of windup angle in single-prec */
 
 #define EFACT_GPS_L5 10.0           /* error factor of GPS/QZS L5 */
 
@@ -118,6 +123,29 @@
 #define II(s,opt)    (NP(opt)+NC(opt)+NRDCB(opt)+NIFCB(opt)+NT(opt)+(s)-1)
 #define IB(s,f,opt)  (NR(opt)+MAXSAT*(f)+(s)-1)
 
+typedef struct {                    /* satellite models of epoch (SoA) */
+    int stat[MAXOBS];               /* status (0:none,1:ok,-1:trop/iono,-2:windup) */
+    double r[MAXOBS];               /* geometric distance (m) */
+    double el[MAXOBS];              /* elevation angle (rad) */
+    double e[MAXOBS*3];             /* line-of-sight vector */
+    double dtrp[MAXOBS],vart[MAXOBS]; /* trop delay/variance (m,m^2) */
+    double dtdx[MAXOBS*3];          /* trop partials (zwd,grad-n,grad-e) */
+    double ztrp[MAXOBS*2];          /* zenith trop delay (zhd,zwd) (m) */
+    double dion[MAXOBS],vari[MAXOBS]; /* iono delay/variance (m,m^2) */
+    double tec[MAXOBS],vartec[MAXOBS]; /* gim iono delay/variance (m,m^2) */
+    int stec[MAXOBS];               /* gim iono status (1:ok,0:error) */
+    double dantr[MAXOBS*NFREQ];     /* receiver antenna pcv (m) */
+    double dants[MAXOBS*NFREQ];     /* satellite antenna pcv (m) */
+    double shapiro[MAXOBS];         /* shapiro delay (m) */
+    int prec;                       /* correction models (0:double,1:single,2:check) */
+    double dmdl[MAXOBS*5];          /* single-double model diff (m)
+                                       {windup,shapiro,pcv,trop,residual} */
+    double L[MAXOBS*NFREQ],P[MAXOBS*NFREQ];   /* corrected phase/code (m) */
+    double Lc[MAXOBS*NFREQ],Pc[MAXOBS*NFREQ]; /* corrected combinations (m) */
+    double freqs[MAXOBS*NFREQ];     /* carrier frequencies (hz) */
+    double cbias[MAXOBS*NFREQ];     /* code biases (m) */
+} satmdl_t;
+
 extern int iamb_ppp(const prcopt_t *opt,int sat,int f)
 {
     return IB(sat,f,opt);
@@ -203,7 +231,7 @@ static void testeclipse(const obsd_t *obs, int n, const nav_t *nav, double *rs,r
     trace(4,"testeclipse:\n");
     
     /* unit vector of sun direction (ecef) */
-    sunmoonpos(gpst2utc(obs[0].time),erpv,rsun,NULL,NULL);
+    astrosunmoon(&rtk->ast,gpst2utc(obs[0].time),erpv,rsun,NULL,NULL);
     normv3(rsun,esun);
     
     for (i=0;i<n;i++) {
@@ -255,13 +283,13 @@ extern int yaw_angle(int sat, const char *type, int opt, double beta, double mu,
 }
 /* satellite attitude model --------------------------------------------------*/
 static int sat_yaw(gtime_t time, int sat, const char *type, int opt,
-                   const double *rs, double *exs, double *eys)
+                   const astro_t *ast, const double *rs, double *exs, double *eys)
 {
     double rsun[3],ri[6],es[3],esun[3],n[3],p[3],en[3],ep[3],ex[3],E,beta,mu;
     double yaw,cosy,siny,erpv[5]={0};
     int i;
     
-    sunmoonpos(gpst2utc(time),erpv,rsun,NULL,NULL);
+    astrosunmoon(ast,gpst2utc(time),erpv,rsun,NULL,NULL);
     
     /* beta and orbit angle */
     matcpy(ri,rs,6,1);
@@ -290,18 +318,75 @@ static int sat_yaw(gtime_t time, int sat, const char *type, int opt,
     }
     return 1;
 }
+/* phase windup angle --------------------------------------------------------*/
+static double phw_angle(const double *ek, const double *exs, const double *eys,
+                        const double *exr, const double *eyr)
+{
+    double eks[3],ekr[3],dr[3],ds[3],drs[3],cosp,ph;
+    int i;
+    
+    cross3(ek,eys,eks);
+    cross3(ek,eyr,ekr);
+    for (i=0;i<3;i++) {
+        ds[i]=exs[i]-ek[i]*dot(ek,exs,3)-eks[i];
+        dr[i]=exr[i]-ek[i]*dot(ek,exr,3)+ekr[i];
+    }
+    cosp=dot(ds,dr,3)/norm(ds,3)/norm(dr,3);
+    if      (cosp<-1.0) cosp=-1.0;
+    else if (cosp> 1.0) cosp= 1.0;
+    ph=acos(cosp)/2.0/PI;
+    cross3(ds,dr,drs);
+    if (dot(ek,drs,3)<0.0) ph=-ph;
+    return ph;
+}
+/* phase windup angle in single precision --------------------------------------
+* same as phw_angle() in single precision. return 0 if the angle is close to
+* 0 or pi (|cos|>MAXCOSPF), where acos() in single precision loses accuracy
+*-----------------------------------------------------------------------------*/
+static int phw_anglef(const double *ek_, const double *exs_, const double *eys_,
+                      const double *exr_, const double *eyr_, double *ph)
+{
+    float ek[3],exs[3],eys[3],exr[3],eyr[3],eks[3],ekr[3],ds[3],dr[3],drs[3];
+    float ekxs,ekxr,cosp;
+    int i;
+    
+    for (i=0;i<3;i++) {
+        ek [i]=(float)ek_ [i]; exs[i]=(float)exs_[i]; eys[i]=(float)eys_[i];
+        exr[i]=(float)exr_[i]; eyr[i]=(float)eyr_[i];
+    }
+    eks[0]=ek[1]*eys[2]-ek[2]*eys[1]; ekr[0]=ek[1]*eyr[2]-ek[2]*eyr[1];
+    eks[1]=ek[2]*eys[0]-ek[0]*eys[2]; ekr[1]=ek[2]*eyr[0]-ek[0]*eyr[2];
+    eks[2]=ek[0]*eys[1]-ek[1]*eys[0]; ekr[2]=ek[0]*eyr[1]-ek[1]*eyr[0];
+    ekxs=ek[0]*exs[0]+ek[1]*exs[1]+ek[2]*exs[2];
+    ekxr=ek[0]*exr[0]+ek[1]*exr[1]+ek[2]*exr[2];
+    for (i=0;i<3;i++) {
+        ds[i]=exs[i]-ek[i]*ekxs-eks[i];
+        dr[i]=exr[i]-ek[i]*ekxr+ekr[i];
+    }
+    cosp=(ds[0]*dr[0]+ds[1]*dr[1]+ds[2]*dr[2])/
+         sqrtf((ds[0]*ds[0]+ds[1]*ds[1]+ds[2]*ds[2])*
+               (dr[0]*dr[0]+dr[1]*dr[1]+dr[2]*dr[2]));
+    if (fabsf(cosp)>(float)MAXCOSPF) return 0;
+    
+    drs[0]=ds[1]*dr[2]-ds[2]*dr[1];
+    drs[1]=ds[2]*dr[0]-ds[0]*dr[2];
+    drs[2]=ds[0]*dr[1]-ds[1]*dr[0];
+    *ph=acosf(cosp)/2.0f/(float)PI;
+    if (ek[0]*drs[0]+ek[1]*drs[1]+ek[2]*drs[2]<0.0f) *ph=-*ph;
+    return 1;
+}
 /* phase windup model --------------------------------------------------------*/
-static int model_phw(gtime_t time, int sat, const char *type, int opt,
-                     const double *rs, const double *rr, double *phw)
+static int model_phw(gtime_t time, int sat, const char *type, int opt, int sp,
+                     const astro_t *ast, const double *rs, const double *rr,
+                     double *phw)
 {
-    double exs[3],eys[3],ek[3],exr[3],eyr[3],eks[3],ekr[3],E[9];
-    double dr[3],ds[3],drs[3],r[3],pos[3],cosp,ph;
+    double exs[3],eys[3],ek[3],exr[3],eyr[3],E[9],r[3],pos[3],ph;
     int i;
     
     if (opt<=0) return 1; /* no phase windup */
     
     /* satellite yaw attitude model */
-    if (!sat_yaw(time,sat,type,opt,rs,exs,eys)) return 0;
+    if (!sat_yaw(time,sat,type,opt,ast,rs,exs,eys)) return 0;
     
     /* unit vector satellite to receiver */
     for (i=0;i<3;i++) r[i]=rr[i]-rs[i];
@@ -313,20 +398,10 @@ static int model_phw(gtime_t time, int sat, const char *type, int opt,
     exr[0]= E[1]; exr[1]= E[4]; exr[2]= E[7]; /* x = north */
     eyr[0]=-E[0]; eyr[1]=-E[3]; eyr[2]=-E[6]; /* y = west  */
     
-    /* phase windup effect */
-    cross3(ek,eys,eks);
-    cross3(ek,eyr,ekr);
-    for (i=0;i<3;i++) {
-        ds[i]=exs[i]-ek[i]*dot(ek,exs,3)-eks[i];
-        dr[i]=exr[i]-ek[i]*dot(ek,exr,3)+ekr[i];
+    /* phase windup effect (single precision if sp and well-conditioned) */
+    if (!sp||!phw_anglef(ek,exs,eys,exr,eyr,&ph)) {
+        ph=phw_angle(ek,exs,eys,exr,eyr);
     }
-    cosp=dot(ds,dr,3)/norm(ds,3)/norm(dr,3);
-    if      (cosp<-1.0) cosp=-1.0;
-    else if (cosp> 1.0) cosp= 1.0;
-    ph=acos(cosp)/2.0/PI;
-    cross3(ds,dr,drs);
-    if (dot(ek,drs,3)<0.0) ph=-ph;
-    
     *phw=ph+floor(*phw-ph+0.5); /* in cycle */
     return 1;
 }
@@ -429,24 +504,22 @@ static double mwmeas(const prcopt_t *opt,const obsd_t *obs, const nav_t *nav,dou
             mea_P2+=corrISC(opt,nav->cbias[obs->sat-1],obs->code[f2],obs->sat);
             if(sys==SYS_GPS){
                 if(obs->code[f1]==CODE_L1C){
-                    osb_P1=nav->osbs->sat_osb[0].code[obs->sat-1][CODE_L1C];
-                    osb_L1=nav->osbs->sat_osb[0].phase[obs->sat-1][CODE_L1C];
+                    getosb(nav->osbs,nav->osbs->tmin,obs->sat,CODE_L1C,&osb_P1,&osb_L1);
                 }
                 if(obs->code[f2]==CODE_L2W){
-                    osb_P2=nav->osbs->sat_osb[0].code[obs->sat-1][CODE_L2W];
-                    osb_L2=nav->osbs->sat_osb[0].phase[obs->sat-1][CODE_L2W];
+                    getosb(nav->osbs,nav->osbs->tmin,obs->sat,CODE_L2W,&osb_P2,&osb_L2);
                 }
             }
             else if(sys==SYS_GLO){
                 osb_L1=osb_L2=0.0;
             }
             else if(sys==SYS_CMP){
-                if(obs->code[f1]==CODE_L2I) osb_L1=nav->osbs->sat_osb[0].phase[obs->sat-1][CODE_L2I];
-                if(obs->code[f2]==CODE_L6I) osb_L2=nav->osbs->sat_osb[0].phase[obs->sat-1][CODE_L6I];
+                if(obs->code[f1]==CODE_L2I) getosb(nav->osbs,nav->osbs->tmin,obs->sat,CODE_L2I,NULL,&osb_L1);
+                if(obs->code[f2]==CODE_L6I) getosb(nav->osbs,nav->osbs->tmin,obs->sat,CODE_L6I,NULL,&osb_L2);
             }
             else if(sys==SYS_GAL){
-                if(obs->code[f1]==CODE_L1C) osb_L1=nav->osbs->sat_osb[0].phase[obs->sat-1][CODE_L1C];
-                if(obs->code[f2]==CODE_L5Q) osb_L2=nav->osbs->sat_osb[0].phase[obs->sat-1][CODE_L5Q];
+                if(obs->code[f1]==CODE_L1C) getosb(nav->osbs,nav->osbs->tmin,obs->sat,CODE_L1C,NULL,&osb_L1);
+                if(obs->code[f2]==CODE_L5Q) getosb(nav->osbs,nav->osbs->tmin,obs->sat,CODE_L5Q,NULL,&osb_L2);
             }
         }
         else if(opt->arprod==AR_PROD_OSB_GRM||opt->arprod==AR_PROD_OSB_CNT||opt->arprod==AR_PROD_OSB_COM||opt->arprod==AR_PROD_OSB_SGG){
@@ -826,7 +899,6 @@ static void udclk_ppp(rtk_t *rtk,const obsd_t *obs,int n)
 {
     double dtr;
     int i,sat,sat_idx,main_irc,irc,num_sys=NSYS;
-    static int last_main_irc;
 
     trace(4,"udclk_ppp:\n");
 
@@ -877,7 +949,7 @@ static void udclk_ppp(rtk_t *rtk,const obsd_t *obs,int n)
                 if(i==1) initx(rtk,0.0,SQR(0.01),irc);
                 else if(i==2) initx(rtk,CLIGHT*dtr,VAR_CLK,irc);
                 else{
-                    if(last_main_irc!=main_irc){
+                    if(rtk->mainclk!=main_irc){
                         initx(rtk,CLIGHT*dtr,VAR_CLK,irc);
                     }
                     else{
@@ -898,7 +970,7 @@ static void udclk_ppp(rtk_t *rtk,const obsd_t *obs,int n)
             }
         }
     }
-    last_main_irc=main_irc;
+    rtk->mainclk=main_irc;
 }
 
 /* temporal update of L5-receiver-dcb parameters -----------------------------*/
@@ -1457,9 +1529,10 @@ extern void bd2_multipath(rtk_t *rtk,obsd_t *obs,int n)
 
 /* satellite antenna phase center variation ----------------------------------*/
 static void satantpcv(const double *rs, const double *rr, const pcv_t *pcv,
-                      double *dant)
+                      int sp, double *dant)
 {
     double ru[3],rz[3],eu[3],ez[3],nadir,cosa;
+    float cosaf;
     int i;
     
     for (i=0;i<3;i++) {
@@ -1468,20 +1541,26 @@ static void satantpcv(const double *rs, const double *rr, const pcv_t *pcv,
     }
     if (!normv3(ru,eu)||!normv3(rz,ez)) return;
     
-    cosa=dot(eu,ez,3);
-    cosa=cosa<-1.0?-1.0:(cosa>1.0?1.0:cosa);
-    nadir=acos(cosa);
+    if (sp) { /* single-precision nadir angle */
+        cosaf=(float)eu[0]*(float)ez[0]+(float)eu[1]*(float)ez[1]+
+              (float)eu[2]*(float)ez[2];
+        cosaf=cosaf<-1.0f?-1.0f:(cosaf>1.0f?1.0f:cosaf);
+        nadir=acosf(cosaf);
+    }
+    else {
+        cosa=dot(eu,ez,3);
+        cosa=cosa<-1.0?-1.0:(cosa>1.0?1.0:cosa);
+        nadir=acos(cosa);
+    }
     
     antmodel_s(pcv,nadir,dant);
 }
 /* ionospheric model ---------------------------------------------------------*/
 extern int model_iono(gtime_t time, const double *pos, const double *azel,
                       const prcopt_t *opt, int sat, const double *x,
-                      const nav_t *nav, double *dion, double *var)
+                      const nav_t *nav, ionoc_t *ionoc, double *dion,
+                      double *var)
 {
-    static double iono_p[MAXSAT]={0},std_p[MAXSAT]={0};
-    static gtime_t time_p;
-    
     if (opt->ionoopt==IONOOPT_SBAS) {
         return sbsioncorr(time,nav,pos,azel,dion,var);
     }
@@ -1506,12 +1585,12 @@ extern int model_iono(gtime_t time, const double *pos, const double *azel,
         return 1;
     }
     if (opt->ionoopt==IONOOPT_STEC) {
-        if (timediff(time,time_p)!=0.0&&
-            !pppcorr_stec(&nav->pppcorr,time,pos,iono_p,std_p)) return 0;
-        if (iono_p[sat-1]==0.0||std_p[sat-1]>0.1) return 0;
-        time_p=time;
-        *dion=iono_p[sat-1];
-        *var=SQR(std_p[sat-1]);
+        if (timediff(time,ionoc->time)!=0.0&&
+            !pppcorr_stec(&nav->pppcorr,time,pos,ionoc->iono,ionoc->std)) return 0;
+        if (ionoc->iono[sat-1]==0.0||ionoc->std[sat-1]>0.1) return 0;
+        ionoc->time=time;
+        *dion=ionoc->iono[sat-1];
+        *var=SQR(ionoc->std[sat-1]);
         return 1;
     }
     return 0;
@@ -1519,7 +1598,7 @@ extern int model_iono(gtime_t time, const double *pos, const double *azel,
 /* precise tropospheric model ------------------------------------------------*/
 static double trop_model_prec(const prcopt_t *opt,gtime_t time, const double *pos,
                               const double *azel, const double *x, double *dtdx,
-                              double *var,double ztrp[2],double mtrp[2])
+                              double *var,double ztrp[2],double mtrp[2],int sp)
 {
     const double zazel[]={0.0,PI/2.0};
     double zhd,m_h,m_w,cotz,grad_n,grad_e;
@@ -1528,7 +1607,7 @@ static double trop_model_prec(const prcopt_t *opt,gtime_t time, const double *po
     zhd=saastamoinen(time,pos,zazel,0.0,1,NULL,NULL);
 
     /* mapping function */
-    m_h=tropmapf(opt,time,pos,azel,&m_w);
+    m_h=tropmapfx(opt,time,pos,azel,sp,&m_w);
     if(mtrp){
         mtrp[0]=m_h;
         mtrp[1]=m_w;
@@ -1554,7 +1633,8 @@ static double trop_model_prec(const prcopt_t *opt,gtime_t time, const double *po
 /* tropospheric model ---------------------------------------------------------*/
 extern int model_trop(gtime_t time, const double *pos, const double *azel,
                       const prcopt_t *opt, const double *x, double *dtdx,
-                      const nav_t *nav, double *dtrp,double *ztrp,double *mtrp, double *var,int it)
+                      const nav_t *nav, double *dtrp,double *ztrp,double *mtrp, double *var,int it,
+                      int sp)
 {
     double trp[3]={0},std[3];
 
@@ -1569,12 +1649,12 @@ extern int model_trop(gtime_t time, const double *pos, const double *azel,
     }
     if (opt->tropopt==TROPOPT_EST||opt->tropopt==TROPOPT_ESTG) {
         matcpy(trp,x+it,opt->tropopt==TROPOPT_EST?1:3,1);
-        *dtrp=trop_model_prec(opt,time,pos,azel,trp,dtdx,var,ztrp,mtrp);
+        *dtrp=trop_model_prec(opt,time,pos,azel,trp,dtdx,var,ztrp,mtrp,sp);
         return 1;
     }
     if (opt->tropopt==TROPOPT_ZTD) {
         if (pppcorr_trop(&nav->pppcorr,time,pos,trp,std)) {
-            *dtrp=trop_model_prec(opt,time,pos,azel,trp,dtdx,var,ztrp,mtrp);
+            *dtrp=trop_model_prec(opt,time,pos,azel,trp,dtdx,var,ztrp,mtrp,sp);
             *var=SQR(dtdx[0]*std[0]);
             return 1;
         }
@@ -1603,6 +1683,25 @@ static double shapiro_corr(int sys,const double *rs,double *rr)
 
     return 2.0*mu/(CLIGHT*CLIGHT)*log((drs+drr+r)/(drs+drr-r));
 }
+/* shapiro delay in single precision -----------------------------------------*/
+static double shapiro_corrf(int sys, const double *rs, const double *rr)
+{
+    float drr,drs,r,d[3],mu;
+    int i;
+    
+    for (i=0;i<3;i++) d[i]=(float)(rs[i]-rr[i]);
+    drr=(float)sqrt(rr[0]*rr[0]+rr[1]*rr[1]+rr[2]*rr[2]);
+    drs=(float)sqrt(rs[0]*rs[0]+rs[1]*rs[1]+rs[2]*rs[2]);
+    r=sqrtf(d[0]*d[0]+d[1]*d[1]+d[2]*d[2]);
+    
+    switch (sys) {
+        case SYS_CMP:
+        case SYS_GAL: mu=3.986004418E14f; break;
+        case SYS_GLO: mu=3.9860044E14f;   break;
+        default:      mu=3.9860050E14f;   break;
+    }
+    return 2.0f*mu/(float)(CLIGHT*CLIGHT)*logf((drs+drr+r)/(drs+drr-r));
+}
 
 /* constraint to local correction --------------------------------------------*/
 static int const_corr(const obsd_t *obs, int n, const int *exc,
@@ -1645,7 +1744,7 @@ static int const_corr(const obsd_t *obs, int n, const int *exc,
 static void tracesatinfo(const prcopt_t *opt,int level,int f,const int *frq_idxs,int type,const rtk_t *rtk,const obsd_t *obs,double meas,double range,double dtr,double isb,double rdcb,double rifcb,
         double trp,double ion,double antr,double shapiro,const double *rs,double dts,double sdcb,double ants,double phw,double amb,double res,double sig)
 {
-    static int last_sat_no=0;
+    static THREADLOCAL int last_sat_no=0;
     char buff[1024]={'\0'};
     const ssat_t *sat_info=&rtk->ssat[obs->sat-1];
     int slip_flag;
@@ -1817,6 +1916,155 @@ static void tracesatinfo(const prcopt_t *opt,int level,int f,const int *frq_idxs
     }
 }
 
+/* precision of correction models (0:double,1:single,2:check) ----------------*/
+static int mdlprec(const prcopt_t *opt)
+{
+    const char *p;
+    int prec=0;
+
+    if ((p=strstr(opt->pppopt,"-MDL_FLOAT="))) sscanf(p,"-MDL_FLOAT=%d",&prec);
+    return prec;
+}
+/* satellite geometry -----------------------------------------------------------
+* geometric distance, line-of-sight vectors and azimuth/elevation of all
+* satellites of epoch (first stage of zero-differenced residuals)
+*-----------------------------------------------------------------------------*/
+static void satgeom(const obsd_t *obs, int n, const double *rs, const double *rr,
+                    const double *pos, satmdl_t *mdl, double *azel)
+{
+    int i;
+
+    for (i=0;i<n&&i<MAXOBS;i++) {
+        mdl->stat[i]=0;
+        mdl->r[i]=mdl->el[i]=0.0;
+        mdl->e[i*3]=mdl->e[1+i*3]=mdl->e[2+i*3]=0.0;
+        if (satsysidx(obs[i].sat)==-1) continue;
+        if ((mdl->r[i]=geodist(rs+i*6,rr,mdl->e+i*3))>0.0) {
+            mdl->el[i]=satazel(pos,mdl->e+i*3,azel+i*2);
+        }
+    }
+}
+/* models of a satellite -----------------------------------------------------*/
+static void satmodel_s(int i, const obsd_t *obs, const double *rs, const double *rr,
+                       const double *pos, const double *azel, const double *x,
+                       const nav_t *nav, rtk_t *rtk, satmdl_t *mdl)
+{
+    prcopt_t *opt=&rtk->opt;
+    int sat=obs[i].sat,sys_idx=satsysidx(sat),sp=mdl->prec==1;
+    double *dantr=mdl->dantr+i*NFREQ,*dants=mdl->dants+i*NFREQ,*dmdl=mdl->dmdl+i*5;
+    double dant[NFREQ*2]={0},dtdx[3],dtrp,var,phw;
+    int k;
+
+    for (k=0;k<3;k++) mdl->dtdx[k+i*3]=0.0;
+    for (k=0;k<NFREQ;k++) dantr[k]=dants[k]=0.0;
+    mdl->ztrp[i*2]=mdl->ztrp[1+i*2]=0.0;
+
+    /* tropospheric and ionospheric model (gim delays by satmodel()) */
+    if (!model_trop(obs[i].time,pos,azel+i*2,opt,x,mdl->dtdx+i*3,nav,mdl->dtrp+i,
+                    mdl->ztrp+i*2,rtk->ssat[sat-1].mtrp,mdl->vart+i,IT(opt),sp)) {
+        mdl->stat[i]=-1;
+        return;
+    }
+    if (opt->ionoopt==IONOOPT_TEC) {
+        if (!mdl->stec[i]) {
+            mdl->stat[i]=-1;
+            return;
+        }
+        mdl->dion[i]=mdl->tec[i];
+        mdl->vari[i]=mdl->vartec[i];
+    }
+    else if (!model_iono(obs[i].time,pos,azel+i*2,opt,sat,x,nav,&rtk->ionoc,
+                         mdl->dion+i,mdl->vari+i)) {
+        mdl->stat[i]=-1;
+        return;
+    }
+    /* satellite and receiver antenna model */
+    if (opt->posopt[0]) satantpcv(rs+i*6,rr,nav->pcvs+sat-1,sp,dants);
+    antmodel(sat,opt->pcvr,opt->antdel[0],azel+i*2,opt->posopt[1]|(sp?2:0),dantr);
+
+    /* phase windup model */
+    phw=rtk->ssat[sat-1].phw;
+    if (!model_phw(rtk->sol.time,sat,nav->pcvs[sat-1].type,opt->posopt[2]?2:0,
+                   sp,&rtk->ast,rs+i*6,rr,&rtk->ssat[sat-1].phw)) {
+        mdl->stat[i]=-2;
+        return;
+    }
+    /* shapiro time delay */
+    if (sp) {
+        mdl->shapiro[i]=shapiro_corrf(satsys(sat,NULL),rs+i*6,rr);
+    }
+    else {
+        mdl->shapiro[i]=shapiro_corr(satsys(sat,NULL),rs+i*6,(double *)rr);
+    }
+    /* differences of single-precision models to double-precision */
+    if (mdl->prec==2) {
+        model_phw(rtk->sol.time,sat,nav->pcvs[sat-1].type,opt->posopt[2]?2:0,1,
+                  &rtk->ast,rs+i*6,rr,&phw);
+        dmdl[0]=(phw-rtk->ssat[sat-1].phw)*CLIGHT/FREQ1;
+        dmdl[1]=shapiro_corrf(satsys(sat,NULL),rs+i*6,rr)-mdl->shapiro[i];
+        if (opt->posopt[0]) satantpcv(rs+i*6,rr,nav->pcvs+sat-1,1,dant+NFREQ);
+        antmodel(sat,opt->pcvr,opt->antdel[0],azel+i*2,opt->posopt[1]|2,dant);
+        dmdl[2]=dant[0]+dant[NFREQ]-dantr[0]-dants[0];
+        dmdl[3]=0.0;
+        if (model_trop(obs[i].time,pos,azel+i*2,opt,x,dtdx,nav,&dtrp,NULL,NULL,
+                       &var,IT(opt),1)) {
+            dmdl[3]=dtrp-mdl->dtrp[i];
+        }
+        /* phase residual of first frequency */
+        dmdl[4]=-dmdl[0]+dmdl[1]-dmdl[2]-dmdl[3];
+    }
+
+    getcorrobs(opt,obs+i,nav,opt->gnss_frq_idx[sys_idx],dantr,dants,
+               rtk->ssat[sat-1].phw,mdl->L+i*NFREQ,mdl->P+i*NFREQ,mdl->Lc+i*NFREQ,
+               mdl->Pc+i*NFREQ,mdl->freqs+i*NFREQ,mdl->cbias+i*NFREQ,
+               &rtk->ssat[sat-1]);
+}
+/* satellite models ---------------------------------------------------------------
+* tropospheric, ionospheric, antenna, phase windup and relativistic models and
+* corrected observables of the satellites selected by stat[i]==1 (second stage
+* of zero-differenced residuals). the loop is kept serial: the models update
+* per-satellite states of rtk (ssat windup/trop) and the iono cache rtk->ionoc.
+* opt->pppopt=-MDL_FLOAT=1 selects single-precision windup, shapiro, antenna
+* and troposphere mapping models and -MDL_FLOAT=2 computes them in both
+* precisions, uses double-precision and records the max differences in
+* rtk->mdlerr (trace level 2 if >TOL_MDLF)
+*-----------------------------------------------------------------------------*/
+static void satmodel(const obsd_t *obs, int n, const double *rs, const double *rr,
+                     const double *pos, const double *azel, const double *x,
+                     const nav_t *nav, rtk_t *rtk, satmdl_t *mdl)
+{
+    const char *type[]={"windup","shapiro","pcv","trop","residual"};
+    double d;
+    int i,j,nn=n<MAXOBS?n:MAXOBS;
+
+    mdl->prec=mdlprec(&rtk->opt);
+
+    /* gim ionospheric delays of all satellites of epoch */
+    if (rtk->opt.ionoopt==IONOOPT_TEC||rtk->opt.ionoopt==IONOOPT_UC_CONS) {
+        iontecs(obs[0].time,nav,pos,azel,nn,1,mdl->tec,mdl->vartec,mdl->stec);
+    }
+    for (i=0;i<nn;i++) {
+        if (mdl->stat[i]!=1) continue;
+        satmodel_s(i,obs,rs,rr,pos,azel,x,nav,rtk,mdl);
+    }
+    /* max differences of single-precision models */
+    for (i=0;mdl->prec==2&&i<nn;i++) {
+        if (mdl->stat[i]!=1) continue;
+        for (j=0;j<5;j++) {
+            if ((d=fabs(mdl->dmdl[j+i*5]))<=rtk->mdlerr[j<4?j:5]) continue;
+            rtk->mdlerr[j<4?j:5]=d;
+            trace(d>TOL_MDLF?2:4,"single-precision model diff: %s sat=%s %s=%.3e m\n",
+                  time_str(obs[i].time,0),sat_id(obs[i].sat),type[j],d);
+        }
+    }
+    /* zenith trop delay of last modeled satellite */
+    for (i=nn-1;i>=0;i--) {
+        if (mdl->stat[i]==0||(mdl->ztrp[i*2]==0.0&&mdl->ztrp[1+i*2]==0.0)) continue;
+        rtk->sol.ztrp[0]=mdl->ztrp[i*2];
+        rtk->sol.ztrp[1]=mdl->ztrp[1+i*2];
+        break;
+    }
+}
 static int zdres(int post, const obsd_t *obs, int n, const double *rs,
                  const double *dts, const double *var_rs, const int *svh,
                  const double *dr, int *exc, const nav_t *nav,
@@ -1824,14 +2072,15 @@ static int zdres(int post, const obsd_t *obs, int n, const double *rs,
                  double *gamma,double *azel,double *rpos,double *var_sat,int *vflg)
 {
     prcopt_t *opt=&rtk->opt;
-    double y,r,bias,C=1.0,rr[3],pos[3],dtdx[3],L[NFREQ]={0},P[NFREQ]={0},Lc[NFREQ]={0},Pc[NFREQ]={0},freqs[NFREQ]={0},freq_base=0.0;
+    satmdl_t mdl;
+    double y,r,bias,C=1.0,rr[3],pos[3],*dtdx,*L,*P,*Lc,*Pc,*freqs,freq_base=0.0;
     double var[MAXOBS*2],dtrp=0.0,dion=0.0,vart=0.0,vari=0.0;
-    double dantr[NFREQ]={0},dants[NFREQ]={0};
-    double ve[MAXOBS*2*NFREQ]={0},vare[MAXOBS*2*NFREQ]={0},cbias[NFREQ]={0},shapiro=0,isb=0,rdcb=0.0,rifcb=0.0;
+    double *dantr,*dants;
+    double ve[MAXOBS*2*NFREQ]={0},vare[MAXOBS*2*NFREQ]={0},*cbias,shapiro=0,isb=0,rdcb=0.0,rifcb=0.0;
     double tec_fact=1.0,freq;
     char str[32];
     int ne=0,obsi[MAXOBS*2*NFREQ]={0},frqi[MAXOBS*2*NFREQ];
-    int i,j,k,sat,sys,sys_idx=-1,nv=0,it=0,prn;
+    int i,j,k,sat,sys,sys_idx=-1,nv=0,prn;
     int iamb=0,iion=0;
     int *frq_idxs=NULL,level=3;
     int vaild_ns=0;
@@ -1848,16 +2097,16 @@ static int zdres(int post, const obsd_t *obs, int n, const double *rs,
     }
     trace(level,"%s(%5d) %s residual: rr=%12.3f %12.3f %12.3f dr=%6.3f %6.3f %6.3f\n",time_str(obs->time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,post?"post":"prior",rr[0],rr[1],rr[2],dr[0],dr[1],dr[2]);
 
+    /* satellite geometry and exclusion */
+    satgeom(obs,n,rs,rr,pos,&mdl,azel);
+
     for (i=0;i<n&&i<MAXOBS;i++) {
         sat=obs[i].sat;
-        sys=satsys(sat,&prn);
-        sys_idx=satsysidx(sat);
-        if(sys_idx==-1) continue;
+        if(satsysidx(sat)==-1) continue;
 
-        frq_idxs=rtk->opt.gnss_frq_idx[sys_idx];
+        matcpy(los+3*i,mdl.e+3*i,3,1);
 
-        if ((r=geodist(rs+i*6,rr,los+3*i))<=0.0||
-            satazel(pos,los+3*i,azel+i*2)<opt->elmin) {
+        if (mdl.r[i]<=0.0||mdl.el[i]<opt->elmin) {
             exc[i]=1;
             continue;
         }
@@ -1870,27 +2119,25 @@ static int zdres(int post, const obsd_t *obs, int n, const double *rs,
             exc[i]=1;
             continue;
         }
+        mdl.stat[i]=1;
+    }
+    /* satellite models */
+    satmodel(obs,n,rs,rr,pos,azel,x,nav,rtk,&mdl);
 
-        /* tropospheric and ionospheric model */
-        it=IT(opt);
-        if (!model_trop(obs[i].time,pos,azel+i*2,opt,x,dtdx,nav,&dtrp,rtk->sol.ztrp,rtk->ssat[sat-1].mtrp,&vart,it)||
-            !model_iono(obs[i].time,pos,azel+i*2,opt,sat,x,nav,&dion,&vari)) {
-            continue;
-        }
-
-        /* satellite and receiver antenna model */
-        if (opt->posopt[0]) satantpcv(rs+i*6,rr,nav->pcvs+sat-1,dants);
-        antmodel(obs[i].sat,opt->pcvr,opt->antdel[0],azel+i*2,opt->posopt[1],dantr);
-
-        /* phase windup model */
-        if (!model_phw(rtk->sol.time,sat,nav->pcvs[sat-1].type,
-                       opt->posopt[2]?2:0,rs+i*6,rr,&rtk->ssat[sat-1].phw)) {
-            continue;
-        }
-
-        shapiro=shapiro_corr(satsys(sat,NULL),rs+i*6,rr);
+    for (i=0;i<n&&i<MAXOBS;i++) {
+        if (mdl.stat[i]!=1) continue;
 
-        getcorrobs(&rtk->opt,obs+i,nav,frq_idxs,dantr,dants,rtk->ssat[sat-1].phw,L,P,Lc,Pc,freqs,cbias,&rtk->ssat[sat-1]);
+        sat=obs[i].sat;
+        sys=satsys(sat,&prn);
+        sys_idx=satsysidx(sat);
+        frq_idxs=rtk->opt.gnss_frq_idx[sys_idx];
+        r=mdl.r[i];
+        dtrp=mdl.dtrp[i]; vart=mdl.vart[i]; dtdx=mdl.dtdx+i*3;
+        dion=mdl.dion[i]; vari=mdl.vari[i];
+        dantr=mdl.dantr+i*NFREQ; dants=mdl.dants+i*NFREQ;
+        shapiro=mdl.shapiro[i];
+        L=mdl.L+i*NFREQ; P=mdl.P+i*NFREQ; Lc=mdl.Lc+i*NFREQ; Pc=mdl.Pc+i*NFREQ;
+        freqs=mdl.freqs+i*NFREQ; cbias=mdl.cbias+i*NFREQ;
 
         tec_fact=40.30E16/freq_base/freq_base;
 
@@ -1996,7 +2243,7 @@ static int zdres(int post, const obsd_t *obs, int n, const double *rs,
 static int ppp_res(int post, const obsd_t *obs, int n, const double *rs,
                    const double *dts, const double *var_rs, const int *svh,
                    const double *dr, int *exc, const nav_t *nav,
-                   const double *x, rtk_t *rtk, double *v, double *H, double *R,
+                   const double *x, rtk_t *rtk, double *v, double *H, rmat_t *R,
                    double *azel,double *rpos,int *v_flag,int *valid_ns)
 {
     prcopt_t *opt=&rtk->opt;
@@ -2087,21 +2334,22 @@ static int ppp_res(int post, const obsd_t *obs, int n, const double *rs,
                 b++;
             }
         }
-        ddcov(nb,b,Ri,Rj,nv,R);
+        ddcov_rmat(nb,b,Ri,Rj,nv,R);
         free(y);free(var_sat);free(e);free(mw);
         free(gamma);free(lam);free(Ri);free(Rj);
         return nv;
     }
     else{
         int level=3;
-        double y,r,cdtr,bias,C=1.0,rr[3],pos[3],e[3],dtdx[3],L[NFREQ]={0},P[NFREQ]={0},Lc[NFREQ]={0},Pc[NFREQ]={0},freqs[NFREQ]={0},freq_base=0.0,freq_base2=0.0,freq=0.0;
+        satmdl_t mdl;
+        double y,r,cdtr,bias,C=1.0,rr[3],pos[3],*e,*dtdx,*L,*P,*Lc,*Pc,*freqs,freq_base=0.0,freq_base2=0.0,freq=0.0;
         double var[MAXOBS*2],dtrp=0.0,dion=0.0,vart=0.0,vari=0.0,tec_ion=0.0;
-        double dantr[NFREQ]={0},dants[NFREQ]={0},ztrp[2]={0};
-        double ve[MAXOBS*2*NFREQ]={0},vare[MAXOBS*2*NFREQ]={0},vmax=0,varmax=0,cbias[NFREQ]={0},shapiro=0,isb=0,rdcb=0.0,rifcb=0.0;
+        double *dantr,*dants,ztrp[2]={0};
+        double ve[MAXOBS*2*NFREQ]={0},vare[MAXOBS*2*NFREQ]={0},vmax=0,varmax=0,*cbias,shapiro=0,isb=0,rdcb=0.0,rifcb=0.0;
         double alpha,beta,tec_fact=1.0;
         char str[32];
         int ne=0,obsi[MAXOBS*2*NFREQ]={0},frqi[MAXOBS*2*NFREQ],maxobs,maxfrq,rej;
-        int i,j,k,sat,sys,sys_idx=-1,nx=rtk->nx,stat=1,it=0,prn;
+        int i,j,k,sat,sys,sys_idx=-1,nx=rtk->nx,stat=1,prn;
         int isys=0,iamb=0,itrp=0,iion=0,main_irc=0,irc=0,mask[6]={0},bd3_flag=0;
         int *frq_idxs=NULL,vs=0;
 
@@ -2117,14 +2365,15 @@ static int ppp_res(int post, const obsd_t *obs, int n, const double *rs,
         }
         trace(level,"%5d %s residual(%s): rr=%12.3f %12.3f %12.3f dr=%6.3f %6.3f %6.3f\n",
                 rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,post?"post":"prior",time_str(obs[0].time,1),rr[0],rr[1],rr[2],dr[0],dr[1],dr[2]);
+
+        /* satellite geometry and exclusion */
+        satgeom(obs,n,rs,rr,pos,&mdl,azel);
+
         for (i=0;i<n&&i<MAXOBS;i++) {
             sat=obs[i].sat;
-            sys=satsys(sat,&prn);
-            sys_idx=satsysidx(sat);
-            if(sys_idx==-1) continue;
+            if(satsysidx(sat)==-1) continue;
 
-            if ((r=geodist(rs+i*6,rr,e))<=0.0||
-                satazel(pos,e,azel+i*2)<opt->elmin) {
+            if (mdl.r[i]<=0.0||mdl.el[i]<opt->elmin) {
                 exc[sat-1]=1;
                 continue;
             }
@@ -2133,28 +2382,31 @@ static int ppp_res(int post, const obsd_t *obs, int n, const double *rs,
                 exc[sat-1]=1;
                 continue;
             }
+            mdl.stat[i]=1;
+        }
+        /* satellite models */
+        satmodel(obs,n,rs,rr,pos,azel,x,nav,rtk,&mdl);
 
-            /* tropospheric and ionospheric model */
-            it=IT(opt);
-            if (!model_trop(obs[i].time,pos,azel+i*2,opt,x,dtdx,nav,&dtrp,rtk->sol.ztrp,rtk->ssat[sat-1].mtrp,&vart,it)||
-                !model_iono(obs[i].time,pos,azel+i*2,opt,sat,x,nav,&dion,&vari)) {
-                rtk->ssat[sat-1].vs=0;
-                continue;
-            }
+        for (i=0;i<n&&i<MAXOBS;i++) {
+            if (!mdl.stat[i]) continue;
 
-            /* satellite and receiver antenna model */
-            if (opt->posopt[0]) satantpcv(rs+i*6,rr,nav->pcvs+sat-1,dants);
-            antmodel(obs[i].sat,opt->pcvr,opt->antdel[0],azel+i*2,opt->posopt[1],dantr);
+            sat=obs[i].sat;
+            sys=satsys(sat,&prn);
+            sys_idx=satsysidx(sat);
 
-            /* phase windup model */
-            if (!model_phw(rtk->sol.time,sat,nav->pcvs[sat-1].type,
-                           opt->posopt[2]?2:0,rs+i*6,rr,&rtk->ssat[sat-1].phw)) {
+            if (mdl.stat[i]==-1) { /* trop/iono model error */
+                rtk->ssat[sat-1].vs=0;
                 continue;
             }
+            if (mdl.stat[i]!=1) continue;
 
-            shapiro=shapiro_corr(satsys(sat,NULL),rs+i*6,rr);
-
-            getcorrobs(&rtk->opt,obs+i,nav,rtk->opt.gnss_frq_idx[sys_idx],dantr,dants,rtk->ssat[sat-1].phw,L,P,Lc,Pc,freqs,cbias,&rtk->ssat[sat-1]);
+            r=mdl.r[i]; e=mdl.e+i*3;
+            dtrp=mdl.dtrp[i]; vart=mdl.vart[i]; dtdx=mdl.dtdx+i*3;
+            dion=mdl.dion[i]; vari=mdl.vari[i];
+            dantr=mdl.dantr+i*NFREQ; dants=mdl.dants+i*NFREQ;
+            shapiro=mdl.shapiro[i];
+            L=mdl.L+i*NFREQ; P=mdl.P+i*NFREQ; Lc=mdl.Lc+i*NFREQ; Pc=mdl.Pc+i*NFREQ;
+            freqs=mdl.freqs+i*NFREQ; cbias=mdl.cbias+i*NFREQ;
             frq_idxs=rtk->opt.gnss_frq_idx[sys_idx];
 
             tec_fact=40.30E16/freq_base/freq_base;
@@ -2366,7 +2618,7 @@ static int ppp_res(int post, const obsd_t *obs, int n, const double *rs,
 
             if(opt->ionoopt==IONOOPT_UC_CONS){
                 double var_tec=1.0;
-                iontec(obs[i].time,nav,pos,azel+i*2,1,&tec_ion,&var_tec);
+                if (mdl.stec[i]) tec_ion=mdl.tec[i];
                 var_tec=iontecvar(rtk->epoch,obs[0].time,pos,rtk->ssat[sat-1].azel);
                 iion=II(sat,opt);
                 v[nv]=tec_ion-x[iion];
@@ -2401,9 +2653,7 @@ static int ppp_res(int post, const obsd_t *obs, int n, const double *rs,
         /* constraint to local correction */
         nv+=const_corr(obs,n,exc,nav,x,pos,azel,rtk,v+nv,H+nv*rtk->nx,var+nv);
 
-        for (i=0;i<nv;i++) for (j=0;j<nv;j++) {
-                R[i+j*nv]=i==j?var[i]:0.0;
-        }
+        rmat_setdiag(R,var,nv);
         *valid_ns=vs;
         return post?stat:nv;
     }
@@ -2620,7 +2870,7 @@ extern int scan_ppp(rtk_t *rtk,const prcopt_t *opt,obsd_t *obs,int n)
 }
 
 /* validation of solution ----------------------------------------------------*/
-static int valpos(rtk_t *rtk, const double *v, const double *R, const int *vflg,
+static int valpos(rtk_t *rtk, const double *v, const rmat_t *R, const int *vflg,
                   int nv, double thres)
 {
     prcopt_t *opt=&rtk->opt;
@@ -2633,7 +2883,7 @@ static int valpos(rtk_t *rtk, const double *v, const double *R, const int *vflg,
     if (stat&&nv>NP(opt)) {
 
         /* chi-square validation */
-        for (i=0;i<nv;i++) vv+=v[i]*v[i]/R[i+i*nv];
+        for (i=0;i<nv;i++) vv+=v[i]*v[i]/rmat_get(R,i,i);
 
         if (vv>chisqr[nv-NP(opt)-1]) {
             trace(2,"%s(%d):residuals validation failed (nv=%d np=%d vv=%.2f cs=%.2f)\n",
@@ -2653,10 +2903,12 @@ static int valpos(rtk_t *rtk, const double *v, const double *R, const int *vflg,
 extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
 {
     const prcopt_t *opt=&rtk->opt;
-    double *rs,*dts,*var,*v,*H,*R,*azel,*xp,*Pp,*xa,*Pa,*norm_v,*post_v,*bias,dr[3]={0},std[3],rr[3],var_pos=0.0;
-    char str[32];
-    int i,j,nv,info,svh[MAXOBS],exc[MAXSAT]={0},stat=SOLQ_SINGLE,vflg[MAXOBS*NFREQ*2+1],qc_flag=0,valid_ns=0;
+    double *rs,*dts,*var,*v,*H,*azel,*xp,*Pp,*xa,*Pa,*norm_v,*post_v,*bias,dr[3]={0},std[3],rr[3],var_pos=0.0;
+    double drd[3],drf[3],d;
+    char str[32],*p;
+    int i,j,topt,prec,nv,nvp=0,info,svh[MAXOBS],exc[MAXSAT]={0},stat=SOLQ_SINGLE,vflg[MAXOBS*NFREQ*2+1],qc_flag=0,valid_ns=0;
     res_t res={0};
+    rmat_t R={0};
 
     int check_obs=0,check_pri=0;
     time2str(obs[0].time,str,2);
@@ -2677,7 +2929,7 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
     }
 
     /* satellite positions and clocks */
-    satposs(&rtk->opt,obs[0].time,obs,n,nav,rtk->opt.sateph,rs,dts,var,svh);
+    satposs(&rtk->opt,obs[0].time,obs,n,nav,&rtk->ast,rtk->opt.sateph,rs,dts,var,svh);
 
     /* detect cycle slip */
     detecs_ppp(obs,rtk,n,nav);
@@ -2692,15 +2944,39 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
 
     for(j=0;j<3;j++) rr[j]=rtk->x[j];
 
-    /* earth tides correction */
+    /* earth tides correction (interpolated from table of tint nodes only for
+       static site with -TIDE_TINT=nnn, otherwise evaluated every epoch) */
     if (opt->tidecorr) {
-        tidedisp(gpst2utc(obs[0].time),rr,opt->tidecorr==1?1:7,&nav->erp,
-                 opt->odisp[0],dr);
+        rtk->tide.tint=TIDE_TINT;
+        if ((p=strstr(opt->pppopt,"-TIDE_TINT="))) {
+            sscanf(p,"-TIDE_TINT=%lf",&rtk->tide.tint);
+        }
+        if (opt->mode!=PMODE_PPP_STATIC&&opt->mode!=PMODE_PPP_FIXED) {
+            rtk->tide.tint=0.0;
+        }
+        prec=mdlprec(opt);
+        topt=opt->tidecorr==1?1:7;
+        tidedisp_tbl(&rtk->tide,gpst2utc(obs[0].time),rr,topt|(prec==1?16:0),
+                     &nav->erp,&rtk->ast,opt->odisp[0],dr);
+        
+        /* difference of single-precision tide models to double-precision */
+        if (prec==2) {
+            tidedisp(gpst2utc(obs[0].time),rr,topt,&nav->erp,&rtk->ast,
+                     opt->odisp[0],drd);
+            tidedisp(gpst2utc(obs[0].time),rr,topt|16,&nav->erp,&rtk->ast,
+                     opt->odisp[0],drf);
+            for (j=0,d=0.0;j<3;j++) d+=SQR(drf[j]-drd[j]);
+            if ((d=sqrt(d))>rtk->mdlerr[4]) {
+                rtk->mdlerr[4]=d;
+                trace(d>TOL_MDLF?2:4,"single-precision model diff: %s tide=%.3e m\n",
+                      str,d);
+            }
+        }
     }
     nv=n*rtk->opt.nf*2+MAXSAT+3;
     xp=mat(rtk->nx,1); Pp=zeros(rtk->nx,rtk->nx);
     xa=mat(rtk->nx,1); Pa=zeros(rtk->nx,rtk->nx);
-    v=mat(nv,1); H=mat(rtk->nx,nv); R=mat(nv,nv);
+    v=mat(nv,1); H=mat(rtk->nx,nv);
     post_v=mat(nv,1);
     norm_v=mat(nv,1);
     bias=mat(rtk->nx,1);
@@ -2714,7 +2990,7 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
         matcpy(Pp,rtk->P,rtk->nx,rtk->nx);
 
         /* prefit residuals */
-        if (!(nv=ppp_res(0,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,v,H,R,azel,rr,vflg,&valid_ns))) {
+        if (!(nv=ppp_res(0,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,v,H,&R,azel,rr,vflg,&valid_ns))) {
             trace(2,"%s(%d): ppp (%d) no valid obs data\n",str,rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,i+1);
             break;
         }
@@ -2725,7 +3001,7 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
         /* measurement update of ekf states */
         int tra=0;
         init_prires(v,vflg,nv,&res);
-        if ((info=filter(xp,Pp,H,v,R,rtk->nx,nv,opt->robust,opt->kfopt,&res,tra))) {
+        if ((info=filter_rmat(xp,Pp,H,v,&R,rtk->nx,nv,opt->robust,opt->kfopt,&res,tra))) {
             trace(2,"%s ppp (%d) filter error info=%d\n",str,i+1,info);
             break;
         }
@@ -2734,7 +3010,7 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
         for(j=0;j<3;j++) rr[j]=xp[j];
 
         if(rtk->opt.robust){
-            ppp_res(i+1,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,post_v,H,R,azel,rr,vflg,&valid_ns);
+            nvp=ppp_res(i+1,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,post_v,H,&R,azel,rr,vflg,&valid_ns);
             init_postres(rtk,res.post_v,&res,res.Qvv);
             qc_flag=resqc(obs[0].time,rtk,&res,exc,1);
             if(qc_flag==1&&i>=5) qc_flag=0;
@@ -2745,7 +3021,7 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
         if(qc_flag&&i<5) continue;
         else{
             if(!rtk->opt.robust){
-                if(!ppp_res(i+1,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,post_v,H,R,azel,rr,vflg,&valid_ns)){
+                if(!(nvp=ppp_res(i+1,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,post_v,H,&R,azel,rr,vflg,&valid_ns))){
                     continue;
                 }
             }
@@ -2759,8 +3035,8 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
         trace(2,"%s ppp (%d) iteration overflows\n",str,i);
     }
 
-    /*check solution*/
-    if(valpos(rtk,post_v,R,vflg,nv,4.0)){
+    /*check solution with postfit residuals (nvp), not the prefit count */
+    if(valpos(rtk,post_v,&R,vflg,nvp,4.0)){
         matcpy(rtk->x,xp,rtk->nx,1);
         matcpy(rtk->P,Pp,rtk->nx,rtk->nx);
     }
@@ -2775,7 +3051,7 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
         if(manage_pppar(rtk,bias,xa,Pa,1,obs,n,nav,exc)){
             for(int k=0;k<3;k++) rr[k]=xa[k];
 
-            if(ppp_res(9,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,v,H,R,azel,rr,vflg,&valid_ns)){
+            if(ppp_res(9,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,v,H,&R,azel,rr,vflg,&valid_ns)){
                 stat=SOLQ_FIX;
                 rtk->fix_epoch++;
                 rtk->nfix++;
@@ -2802,7 +3078,7 @@ extern int pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
 
     free(norm_v);free(post_v);free(bias);
     free(rs); free(dts); free(var); free(azel);
-    free(xp); free(Pp); free(v); free(H); free(R);
+    free(xp); free(Pp); free(v); free(H); rmat_free(&R);
     free(xa);free(Pa);
 
     return stat==SOLQ_NONE?0:1;
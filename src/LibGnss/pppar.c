@@ -75,18 +75,15 @@ static double conf_func(int N, double B, double var)
     return p;
 }
 
-static int matchnlupd(const gtime_t obst,int sat1,int sat2,double *nl_upd1,double *nl_upd2,const nav_t *nav)
+static int matchnlupd(const gtime_t obst,int sat1,int sat2,double *nl_upd1,double *nl_upd2,const nav_t *nav,int *cur)
 {
     double upd1=0.0,upd2=0.0;
     int i,stat=0;
 
-    for(i=0;i<nav->upds->nls.n;i++){
-        if(timediff(nav->upds->nls.data[i].ts,obst)<=0&&timediff(nav->upds->nls.data[i].te,obst)>=0){
-            upd1=nav->upds->nls.data[i].nl[sat1-1];
-            upd2=nav->upds->nls.data[i].nl[sat2-1];
-            stat=1;
-            break;
-        }
+    if((i=searchnlupd(&nav->upds->nls,obst,cur))>=0){
+        upd1=nav->upds->nls.data[i].nl[sat1-1];
+        upd2=nav->upds->nls.data[i].nl[sat2-1];
+        stat=1;
     }
 
     if(nl_upd1) *nl_upd1=upd1;
@@ -95,18 +92,15 @@ static int matchnlupd(const gtime_t obst,int sat1,int sat2,double *nl_upd1,doubl
     return stat;
 }
 
-static int matchnlfcb(const gtime_t obst,int sat1,int sat2,double *nl_fcb1,double *nl_fcb2,const nav_t *nav)
+static int matchnlfcb(const gtime_t obst,int sat1,int sat2,double *nl_fcb1,double *nl_fcb2,const nav_t *nav,int *cur)
 {
     double fcb1=0.0,fcb2=0.0;
     int i,stat=0;
 
-    for(i=0;i<nav->fcbs->n;i++){
-        if(timediff(nav->fcbs->data[i].ts,obst)<=0&&timediff(nav->fcbs->data[i].te,obst)>=0){
-            fcb1=nav->fcbs->data[i].bias[sat1-1];
-            fcb2=nav->fcbs->data[i].bias[sat2-1];
-            stat=1;
-            break;
-        }
+    if((i=searchfcb(nav->fcbs,obst,cur))>=0){
+        fcb1=nav->fcbs->data[i].bias[sat1-1];
+        fcb2=nav->fcbs->data[i].bias[sat2-1];
+        stat=1;
     }
 
     if(nl_fcb1) *nl_fcb1=fcb1;
@@ -263,8 +257,8 @@ static int SDmat(rtk_t *rtk,const obsd_t *obs,int ns,const nav_t *nav,double *H_
         Nc[nb] = sd_if;
         if (opt.arprod == AR_PROD_FCB||opt.arprod==AR_PROD_UPD){
             double nl_fcb1=0.0,nl_fcb2=0.0;
-            if(opt.arprod==AR_PROD_FCB) matchnlfcb(obs[i].time,sat,ref_sat,&nl_fcb1,&nl_fcb2,nav);
-            else if(opt.arprod==AR_PROD_UPD) matchnlupd(obs[i].time,sat,ref_sat,&nl_fcb1,&nl_fcb2,nav);
+            if(opt.arprod==AR_PROD_FCB) matchnlfcb(obs[i].time,sat,ref_sat,&nl_fcb1,&nl_fcb2,nav,&rtk->biascur);
+            else if(opt.arprod==AR_PROD_UPD) matchnlupd(obs[i].time,sat,ref_sat,&nl_fcb1,&nl_fcb2,nav,&rtk->biascur);
 
             sd_nl_fcb[nb] = nl_fcb1 - nl_fcb2;
         }
@@ -510,10 +504,10 @@ static int pppar_IF_ILS(rtk_t *rtk,double *xa,double *bias,const obsd_t *obs,int
             opt.arprod == AR_PROD_OSB_CNT || opt.arprod == AR_PROD_OSB_COM||opt.arprod==AR_PROD_OSB_SGG) {
             nl_amb = (sd_if - gamma * ROUND(wl_amb)) / lam_nl;
         } else if (opt.arprod == AR_PROD_FCB || opt.arprod==AR_PROD_UPD) {
-            if (opt.arprod==AR_PROD_FCB&&!matchnlfcb(obs[i].time, sat, ref_sat, &nl_fcb1, &nl_fcb2, nav)) {
+            if (opt.arprod==AR_PROD_FCB&&!matchnlfcb(obs[i].time, sat, ref_sat, &nl_fcb1, &nl_fcb2, nav, &rtk->biascur)) {
                 continue;
             }
-            else if (opt.arprod==AR_PROD_UPD&&!matchnlupd(obs[i].time, sat, ref_sat, &nl_fcb1, &nl_fcb2, nav)) {
+            else if (opt.arprod==AR_PROD_UPD&&!matchnlupd(obs[i].time, sat, ref_sat, &nl_fcb1, &nl_fcb2, nav, &rtk->biascur)) {
                 continue;
             }
 
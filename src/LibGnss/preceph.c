@@ -41,6 +41,8 @@
 *           2015/05/10 1.15 add api readfcb()
 *                           modify api readdcb()
 *           2017/04/11 1.16 fix bug on antenna offset correction in peph2pos()
+*                           add api searchfcb(),searchnlupd(),getosb()
+*                           store osb per satellite signal in time order
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -332,7 +334,7 @@ extern int readsap(const char *file, gtime_t time, nav_t *nav)
         pcv=searchpcv(i+1,"",time,&pcvs);
         nav->pcvs[i]=pcv?*pcv:pcv0;
     }
-    free(pcvs.pcv);
+    freepcv(&pcvs);
     return 1;
 }
 
@@ -390,9 +392,7 @@ static int readfcbf(const char *file, nav_t *nav)
         return 0;
     }
 
-    nav->fcbs=(void *)malloc(sizeof(fcbs_t));
-    nav->fcbs->n=nav->fcbs->nmax=0;
-    nav->fcbs->data=NULL;
+    nav->fcbs=(fcbs_t *)calloc(1,sizeof(fcbs_t));
     readfcbhead(fp,nav);
 
     char sat_id[8];
@@ -442,6 +442,95 @@ static int readfcbf(const char *file, nav_t *nav)
     return 1;
 }
 
+/* start/end time of bias record {ts,te} ------------------------------------*/
+#define RECTIME(data,size,i) ((const gtime_t *)((const char *)(data)+(size_t)(i)*(size)))
+
+/* index bias records by time ------------------------------------------------*/
+static void indexrec(const void *data, size_t size, int n, double *dt, int *sort)
+{
+    const gtime_t *t,*tp;
+    double d;
+    int i;
+
+    *dt=0.0; *sort=1;
+
+    for (i=1;i<n;i++) {
+        t=RECTIME(data,size,i); tp=RECTIME(data,size,i-1);
+        if (timediff(t[0],tp[0])<0.0||timediff(t[1],tp[1])<0.0) {
+            *dt=0.0; *sort=0;
+            return;
+        }
+        d=timediff(t[0],tp[0]);
+        if (i==1) *dt=d;
+        else if (*dt>0.0&&fabs(d-*dt)>1E-3) *dt=-1.0; /* irregular */
+    }
+    if (*dt<0.0) *dt=0.0;
+}
+/* search bias record including time -----------------------------------------*/
+static int searchrec(const void *data, size_t size, int n, double dt, int sort,
+                     int *cur, gtime_t time)
+{
+    const gtime_t *t;
+    double k;
+    int i;
+
+    if (n<=0) return -1;
+
+    /* unsorted records: first record including time */
+    if (!sort) {
+        for (i=0;i<n;i++) {
+            t=RECTIME(data,size,i);
+            if (timediff(t[0],time)<=0.0&&timediff(t[1],time)>=0.0) return i;
+        }
+        return -1;
+    }
+    /* start from interval of fixed-rate records or last search */
+    if (dt>0.0) {
+        k=ceil(timediff(time,RECTIME(data,size,0)[1])/dt);
+        i=k<0.0?0:(k>n?n:(int)k);
+    }
+    else if (cur) {
+        i=*cur<0?0:(*cur>n?n:*cur);
+    }
+    else i=0;
+    /* first record with end time after time */
+    while (i>0&&timediff(RECTIME(data,size,i-1)[1],time)>=0.0) i--;
+    while (i<n&&timediff(RECTIME(data,size,i  )[1],time)< 0.0) i++;
+
+    if (i>=n) return -1;
+    if (cur) *cur=i;
+    return timediff(RECTIME(data,size,i)[0],time)<=0.0?i:-1;
+}
+/* search satellite fcb record -------------------------------------------------
+* search the first fcb record whose interval includes time
+* args   : fcbs_t *fcbs     I   satellite fcb data
+*          gtime_t time     I   time (gpst)
+*          int    *cur      IO  record index of last search (NULL: no hint)
+* return : record index (-1: not found)
+* notes  : fixed-rate records are indexed directly by time and irregular ones
+*          are searched from the record of the last search. the cursor is
+*          kept by the caller, so the data can be shared by threads
+*-----------------------------------------------------------------------------*/
+extern int searchfcb(const fcbs_t *fcbs, gtime_t time, int *cur)
+{
+    if (!fcbs) return -1;
+    return searchrec(fcbs->data,sizeof(fcbd_t),fcbs->n,fcbs->dt,fcbs->sort,
+                     cur,time);
+}
+/* search narrow-lane upd record -----------------------------------------------
+* search the first narrow-lane upd record whose interval includes time
+* args   : nl_upds_t *nls   I   narrow-lane upd data
+*          gtime_t time     I   time (gpst)
+*          int    *cur      IO  record index of last search (NULL: no hint)
+* return : record index (-1: not found)
+* notes  : see searchfcb()
+*-----------------------------------------------------------------------------*/
+extern int searchnlupd(const nl_upds_t *nls, gtime_t time, int *cur)
+{
+    if (!nls) return -1;
+    return searchrec(nls->data,sizeof(nl_upd_t),nls->n,nls->dt,nls->sort,
+                     cur,time);
+}
 /* read satellite fcb data -----------------------------------------------------
 * read satellite fractional cycle bias (dcb) parameters
 * args   : char   *file       I   fcb parameters file (wild-card * expanded)
@@ -469,6 +558,11 @@ extern int readfcb(const char *file, nav_t *nav)
     }
     for (i=0;i<MAXEXFILE;i++) free(efiles[i]);
     
+    if (nav->fcbs) {
+        indexrec(nav->fcbs->data,sizeof(fcbd_t),nav->fcbs->n,&nav->fcbs->dt,
+                 &nav->fcbs->sort);
+    }
+    
     return 1;
 }
 
@@ -556,12 +650,13 @@ static int readosbf(const char *file,biases_t *sat_bias)
 extern int  readosb(const char *file, nav_t *nav)
 {
     biases_t biases={0};
+    osbs_t *osbs;
 
     readosbf(file,&biases);
 
-    int nb,ii,i;
+    int i,j,k,i1,i2;
     gtime_t tmin={0},tmax={0};
-    double dt=0.0;
+    double dt=0.0,*bias;
 
     for(i=0;i<biases.nb;i++){
         if(i==0){
@@ -574,46 +669,83 @@ extern int  readosb(const char *file, nav_t *nav)
         if (timediff(biases.data[i].te, biases.data[i].ts) < dt) dt = timediff(biases.data[i].te, biases.data[i].ts);
     }
 
-    nav->osbs=(void *)malloc(sizeof(osbs_t));
-    char st1[20], st2[20];
-    time2str(tmin, st1, 0);
-    time2str(tmax, st2, 0);
-    if (!dt) {
-        nav->osbs->dt = 0.0;
-        nav->osbs->sat_osb = NULL;
+    nav->osbs=osbs=(osbs_t *)calloc(1,sizeof(osbs_t));
+    if (!osbs||!dt) {
+        free(biases.data);
         return 0;
     }
+    osbs->dt=dt;
+    osbs->tmin=tmin;
+    osbs->tmax=tmax;
+    osbs->n=(int)(timediff(tmax,tmin)/dt);
 
-    nav->osbs->dt=dt;
-    nav->osbs->tmin=tmin;
-    nav->osbs->tmax=tmax;
-    nb=(int)(timediff(tmax,tmin)/dt);
-    nav->osbs->sat_osb=(osb_t *)calloc(nb, sizeof(osb_t));
-
-    if(nav->osbs==NULL){
+    /* index satellite signals */
+    if (!(osbs->idx=(int *)malloc(sizeof(int)*MAXSAT*MAXCODE))) {
+        free(biases.data);
+        return 0;
+    }
+    for (i=0;i<MAXSAT*MAXCODE;i++) osbs->idx[i]=-1;
+    for (i=0;i<biases.nb;i++) {
+        if (biases.data[i].code<0||biases.data[i].code>=MAXCODE) continue;
+        k=(biases.data[i].sat-1)*MAXCODE+biases.data[i].code;
+        if (osbs->idx[k]<0) osbs->idx[k]=osbs->ns++;
+    }
+    osbs->code =(double *)calloc((size_t)osbs->ns*osbs->n+1,sizeof(double));
+    osbs->phase=(double *)calloc((size_t)osbs->ns*osbs->n+1,sizeof(double));
+    if (!osbs->code||!osbs->phase) {
+        free(osbs->idx); free(osbs->code); free(osbs->phase);
+        osbs->idx=NULL; osbs->code=osbs->phase=NULL; osbs->ns=0;
+        free(biases.data);
         return 0;
     }
-
-    int sat=0,code=0;
     for(i=0;i<biases.nb;i++){
-        sat=biases.data[i].sat-1;
-        code=biases.data[i].code;
-        int i1=(int)(timediff(biases.data[i].ts,tmin)/dt);
-        int i2=(int)(timediff(biases.data[i].te,tmin)/dt);
-        for(ii=i1;ii<i2;ii++){
-            if(biases.data[i].type){
-                nav->osbs->sat_osb[ii].code[sat][code]=biases.data[i].bia*1E-9*CLIGHT;
-            }
-            else{
-                nav->osbs->sat_osb[ii].phase[sat][code]=biases.data[i].bia*1E-9*CLIGHT;
-            }
+        if (biases.data[i].code<0||biases.data[i].code>=MAXCODE) continue;
+        k=osbs->idx[(biases.data[i].sat-1)*MAXCODE+biases.data[i].code];
+        bias=(biases.data[i].type?osbs->code:osbs->phase)+(size_t)k*osbs->n;
+        i1=(int)(timediff(biases.data[i].ts,tmin)/dt);
+        i2=(int)(timediff(biases.data[i].te,tmin)/dt);
+        for(j=i1;j<i2;j++){
+            bias[j]=biases.data[i].bia*1E-9*CLIGHT;
         }
     }
 
     free(biases.data);biases.data=NULL;biases.nmax=biases.nb=0;
     return 1;
 }
+/* observable-specific signal bias ---------------------------------------------
+* get code and phase biases of satellite signal in the interval of time
+* args   : osbs_t *osbs     I   observable-specific signal biases
+*          gtime_t time     I   time (gpst)
+*          int    sat       I   satellite number
+*          int    code      I   obs code (CODE_???)
+*          double *cbias    O   code bias  (m) (NULL: no output)
+*          double *pbias    O   phase bias (m) (NULL: no output)
+* return : status (1:ok,0:time out of span)
+* notes  : the biases are stored in time order per satellite signal, so the
+*          interval is indexed directly by time. if no bias of the signal,
+*          set 0 to the biases. if time is out of span, no output.
+*-----------------------------------------------------------------------------*/
+extern int getosb(const osbs_t *osbs, gtime_t time, int sat, int code,
+                  double *cbias, double *pbias)
+{
+    double t;
+    int i,k;
 
+    if (!osbs||osbs->dt==0.0||!osbs->idx) return 0;
+    if ((t=timediff(time,osbs->tmin))<0.0) return 0;
+    if (timediff(time,osbs->tmax)>0.0) return 0;
+    if ((i=(int)(t/osbs->dt))>=osbs->n) i=osbs->n-1;
+
+    if (sat<=0||sat>MAXSAT||code<0||code>=MAXCODE||
+        (k=osbs->idx[(sat-1)*MAXCODE+code])<0) {
+        if (cbias) *cbias=0.0;
+        if (pbias) *pbias=0.0;
+        return 1;
+    }
+    if (cbias) *cbias=osbs->code [(size_t)k*osbs->n+i];
+    if (pbias) *pbias=osbs->phase[(size_t)k*osbs->n+i];
+    return 1;
+}
 static int readupdf_ewl(const char *file, wl_upds_t *ewls)
 {
     FILE *fp;
@@ -702,6 +834,7 @@ static int readupdf_nl(const char *file, nl_upds_t *nls)
                 return -1;
             }
             nls->data=nl_data_temp;
+            memset(nls->data+nls->nmax-1024,0,sizeof(nl_upd_t)*1024);
         }
         nls->data[ep-1].ts=t;
         nls->data[ep-1].te=timeadd(t,30.0);
@@ -714,10 +847,12 @@ static int readupdf_nl(const char *file, nl_upds_t *nls)
 
 extern int  readupd(const prcopt_t *opt,char *file_ewl,char *file_wl,char *file_nl, nav_t *nav)
 {
-    nav->upds=(void *)malloc(sizeof(upds_t));
+    nav->upds=(upds_t *)calloc(1,sizeof(upds_t));
     readupdf_ewl(file_ewl,&nav->upds->wls);
     readupdf_wl(file_wl,&nav->upds->wls);
     readupdf_nl(file_nl,&nav->upds->nls);
+    indexrec(nav->upds->nls.data,sizeof(nl_upd_t),nav->upds->nls.n,
+             &nav->upds->nls.dt,&nav->upds->nls.sort);
 
     return 0;
 }
@@ -908,12 +1043,13 @@ static int pephclk(gtime_t time, int sat, const nav_t *nav, double *dts,
 *                                 {x,y,z,vx,vy,vz} (m|m/s)
 *          int    sat         I   satellite number
 *          nav_t  *nav        I   navigation data
+*          astro_t *ast       I   astronomical context of epoch (NULL: not used)
 *          double *dant       I   satellite antenna phase center offset (ecef)
 *                                 {dx,dy,dz} (m) (iono-free LC value)
 * return : none
 *-----------------------------------------------------------------------------*/
 extern void satantoff(const prcopt_t *popt,gtime_t time, const double *rs, int sat, const nav_t *nav,
-                      double *dant)
+                      const astro_t *ast, double *dant)
 {
     const pcv_t *pcv=nav->pcvs+sat-1;
     double ex[3],ey[3],ez[3],es[3],r[3],rsun[3],gmst,erpv[5]={0},freq[2];
@@ -925,7 +1061,7 @@ extern void satantoff(const prcopt_t *popt,gtime_t time, const double *rs, int s
     dant[0]=dant[1]=dant[2]=0.0;
 
     /* sun position in ecef */
-    sunmoonpos(gpst2utc(time),erpv,rsun,NULL,&gmst);
+    astrosunmoon(ast,gpst2utc(time),erpv,rsun,NULL,&gmst);
 
     /* unit vectors of satellite fixed coordinates */
     for (i=0;i<3;i++) r[i]=-rs[i];
@@ -989,6 +1125,7 @@ extern void satantoff(const prcopt_t *popt,gtime_t time, const double *rs, int s
 * args   : gtime_t time       I   time (gpst)
 *          int    sat         I   satellite number
 *          nav_t  *nav        I   navigation data
+*          astro_t *ast       I   astronomical context of epoch (NULL: not used)
 *          int    opt         I   sat postion option
 *                                 (0: center of mass, 1: antenna phase center)
 *          double *rs         O   sat position and velocity (ecef)
@@ -1002,8 +1139,9 @@ extern void satantoff(const prcopt_t *popt,gtime_t time, const double *rs, int s
 *          nav->nc must be set by calling readsp3(), readrnx() or readrnxt()
 *          if precise clocks are not set, clocks in sp3 are used instead
 *-----------------------------------------------------------------------------*/
-extern int peph2pos(const prcopt_t *popt,gtime_t time, int sat, const nav_t *nav, int opt,
-                    double *rs, double *dts, double *var)
+extern int peph2pos(const prcopt_t *popt,gtime_t time, int sat, const nav_t *nav,
+                    const astro_t *ast, int opt, double *rs, double *dts,
+                    double *var)
 {
     gtime_t time_tt;
     double rss[3],rst[3],dtss[1],dtst[1],dant[3]={0},vare=0.0,varc=0.0,tt=1E-3;
@@ -1023,7 +1161,7 @@ extern int peph2pos(const prcopt_t *popt,gtime_t time, int sat, const nav_t *nav
     
     /* satellite antenna offset correction */
     if (opt) {
-        satantoff(popt,time,rss,sat,nav,dant);
+        satantoff(popt,time,rss,sat,nav,ast,dant);
     }
     for (i=0;i<3;i++) {
         rs[i  ]=rss[i]+dant[i];
@@ -36,6 +36,7 @@
 *           2017/09/01  1.10 suppress warnings
 *
 *           2020/11/30  1.11 rewritten from scratch to support mosaic-X5 [1]
+*           2026/10/18  1.12 signal number table declared const
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -82,7 +83,7 @@ static int svid2sat(int svid)
     return 0; /* error */
 }
 /* signal number table ([1] 4.1.10) ------------------------------------------*/
-static uint8_t sig_tbl[SBF_MAXSIG+1][2]={ /* system, obs-code */
+static const uint8_t sig_tbl[SBF_MAXSIG+1][2]={ /* system, obs-code */
     {SYS_GPS, CODE_L1C}, /*  0: GPS L1C/A */
     {SYS_GPS, CODE_L1W}, /*  1: GPS L1P */
     {SYS_GPS, CODE_L2W}, /*  2: GPS L2P */
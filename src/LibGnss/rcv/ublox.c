@@ -75,6 +75,8 @@
 *                           support QZSS L1S (CODE_L1Z)
 *                           CODE_L1I -> CODE_L2I for BDS B1I (RINEX 3.04)
 *                           use integer types in stdint.h
+*           2026/10/18 1.29 no static adr buffer outside debug output in
+*                           decode_trkmeas() and decode_trkd5()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -464,7 +466,9 @@ static int decode_navtime(raw_t *raw)
 /* decode UBX-TRK-MEAS: trace measurement data (unofficial) ------------------*/
 static int decode_trkmeas(raw_t *raw)
 {
+#if 0 /* for debug */
     static double adrs[MAXSAT]={0};
+#endif
     uint8_t *p=raw->buff+6;
     gtime_t time;
     double ts,tr=-1.0,t,tau,utc_gpst,snr,adr,dop;
@@ -547,8 +551,8 @@ static int decode_trkmeas(raw_t *raw)
               U1(p+9),U1(p+10),U1(p+11),U1(p+12),U1(p+13),U1(p+14),U1(p+15),
               lock1,lock2,ts,snr,dop,adr,
               adrs[sat-1]==0.0||dop==0.0?0.0:(adr-adrs[sat-1])-dop);
-#endif
         adrs[sat-1]=adr;
+#endif
         
         /* check phase lock */
         if (!(flag&0x20)) continue;
@@ -585,7 +589,9 @@ static int decode_trkmeas(raw_t *raw)
 /* decode UBX-TRKD5: trace measurement data (unofficial) ---------------------*/
 static int decode_trkd5(raw_t *raw)
 {
+#if 0 /* for debug */
     static double adrs[MAXSAT]={0};
+#endif
     gtime_t time;
     double ts,tr=-1.0,t,tau,adr,dop,snr,utc_gpst;
     int i,j,n=0,type,off,len,sys,prn,sat,qi,frq,flag,week;
@@ -667,8 +673,8 @@ static int decode_trkd5(raw_t *raw)
               "snr=%4.1f dop=%9.3f adr=%13.3f %6.3f\n",U1(p+35),qi,U1(p+56),
               prn,frq,flag,ts,snr,dop,adr,
               adrs[sat-1]==0.0||dop==0.0?0.0:(adr-adrs[sat-1])-dop);
-#endif
         adrs[sat-1]=adr;
+#endif
         
         /* check phase lock */
         if (!(flag&0x08)) continue;
@@ -48,6 +48,7 @@
 *                           update references [1], [3] and [4]
 *                           add reference [6]
 *                           use integer types in stdint.h
+*           2026/10/18 1.18 add API input_raw_buf()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -1425,6 +1426,51 @@ extern int input_raw(raw_t *raw, int format, uint8_t data)
     }
     return 0;
 }
+/* input receiver raw data from buffer -----------------------------------------
+* input a block of receiver raw data from stream
+* args   : raw_t  *raw      IO  receiver raw data control struct
+*          int    format    I   receiver raw data format (STRFMT_???)
+*          uint8_t *buff    I   stream data
+*          size_t n         I   length of stream data (bytes)
+*          int (*func)()    I   message callback (NULL: stop at first message)
+*          void   *arg      IO  user argument passed to callback
+*                               (func==NULL: int *, message status or NULL)
+* return : number of bytes consumed
+* notes  : same as input_rtcm3_buf(). the decoder for the format is selected
+*          once per block instead of once per byte.
+*-----------------------------------------------------------------------------*/
+extern size_t input_raw_buf(raw_t *raw, int format, const uint8_t *buff,
+                            size_t n, int (*func)(raw_t *, int, void *),
+                            void *arg)
+{
+    int (*input)(raw_t *, uint8_t)=NULL;
+    size_t i;
+    int ret;
+    
+    trace(5,"input_raw_buf: format=%d n=%d\n",format,(int)n);
+    
+    switch (format) {
+        case STRFMT_OEM4  : input=input_oem4 ; break;
+        case STRFMT_UBX   : input=input_ubx  ; break;
+        case STRFMT_CRES  : input=input_cres ; break;
+        case STRFMT_STQ   : input=input_stq  ; break;
+        case STRFMT_JAVAD : input=input_javad; break;
+        case STRFMT_NVS   : input=input_nvs  ; break;
+        case STRFMT_BINEX : input=input_bnx  ; break;
+        case STRFMT_RT17  : input=input_rt17 ; break;
+        case STRFMT_SEPT  : input=input_sbf  ; break;
+        default: return n;
+    }
+    for (i=0;i<n;i++) {
+        if (!(ret=input(raw,buff[i]))) continue;
+        if (!func) {
+            if (arg) *(int *)arg=ret;
+            return i+1;
+        }
+        if (!func(raw,ret,arg)) return i+1;
+    }
+    return n;
+}
 /* input receiver raw data from file -------------------------------------------
 * fetch next receiver raw data and input a message from file
 * args   : raw_t  *raw      IO  receiver raw data control struct
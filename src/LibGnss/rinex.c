@@ -116,6 +116,9 @@
 *                           use API code2idx() to get frequency index
 *                           use intger types in stdint.h
 *                           suppress warnings
+*           2026/10/18 1.31 format OBS/NAV data fields without printf and
+*                           write an OBS epoch by a block in outrnxobsb()
+*                           add api navf2str()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -2159,20 +2162,21 @@ extern int outrnxobsh(FILE *fp, const rnxopt_t *opt, const nav_t *nav)
     return fprintf(fp,"%-60.60s%-20s\n","","END OF HEADER")!=EOF;
 }
 /* output observation data field ---------------------------------------------*/
-static void outrnxobsf(FILE *fp, double obs, int lli)
+static char *outrnxobsf(char *p, double obs, int lli)
 {
     if (obs==0.0||obs<=-1E9||obs>=1E9) {
-        fprintf(fp,"              ");
+        memcpy(p,"              ",14); p+=14;
     }
     else {
-        fprintf(fp,"%14.3f",obs);
+        p+=fixf2str(p,obs,14,3);
     }
     if (lli<0||!(lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK))) {
-        fprintf(fp,"  ");
+        *p++=' '; *p++=' ';
     }
     else {
-        fprintf(fp,"%1.1d ",lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK));
+        *p++='0'+(lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK)); *p++=' ';
     }
+    return p;
 }
 /* search obsservattion data index -------------------------------------------*/
 static int obsindex(int rnxver, int sys, const uint8_t *code, const char *tobs,
@@ -2250,7 +2254,7 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
 {
     const char *mask;
     double ep[6],dL;
-    char sats[MAXOBS][4]={""};
+    char sats[MAXOBS][4]={""},buff[16*MAXRNXLEN],*p=buff;
     int i,j,k,m,ns,sys,ind[MAXOBS],s[MAXOBS]={0};
     
     trace(3,"outrnxobsb: n=%d\n",n);
@@ -2276,38 +2280,43 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
     if (ns<=0) return 1;
 
     if (opt->rnxver<=299) { /* ver.2 */
-        fprintf(fp," %02d %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d",
-                (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5],flag,ns);
+        p+=sprintf(p," %02d %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d",
+                   (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5],flag,ns);
         for (i=0;i<ns;i++) {
-            if (i>0&&i%12==0) fprintf(fp,"\n%32s","");
-            fprintf(fp,"%-3s",sats[i]);
+            if (i>0&&i%12==0) p+=sprintf(p,"\n%32s","");
+            p+=sprintf(p,"%-3s",sats[i]);
         }
     }
     else { /* ver.3 */
-        fprintf(fp,"> %04.0f %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d%21s\n",
-                ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],flag,ns,"");
+        p+=sprintf(p,"> %04.0f %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d%21s\n",
+                   ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],flag,ns,"");
     }
     for (i=0;i<ns;i++) {
         sys=satsys(obs[ind[i]].sat,NULL);
         
+        /* flush record buffer */
+        if (p-buff>(int)sizeof(buff)-2*MAXRNXLEN) {
+            if (fwrite(buff,p-buff,1,fp)<1) return 0;
+            p=buff;
+        }
         if (opt->rnxver<=299) { /* ver.2 */
             m=0;
             mask=opt->mask[s[i]];
         }
         else { /* ver.3 */
-            fprintf(fp,"%-3s",sats[i]);
+            p+=sprintf(p,"%-3s",sats[i]);
             m=s[i];
             mask=opt->mask[s[i]];
         }
         for (j=0;j<opt->nobs[m];j++) {
             
             if (opt->rnxver<=299) { /* ver.2 */
-                if (j%5==0) fprintf(fp,"\n");
+                if (j%5==0) *p++='\n';
             }
             /* search obs data index */
             if ((k=obsindex(opt->rnxver,sys,obs[ind[i]].code,opt->tobs[m][j],
                             mask))<0) {
-                outrnxobsf(fp,0.0,-1);
+                p=outrnxobsf(p,0.0,-1);
                 continue;
             }
             /* phase shift (cyc) */
@@ -2316,25 +2325,68 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
             /* output field */
             switch (opt->tobs[m][j][0]) {
                 case 'C':
-                case 'P': outrnxobsf(fp,obs[ind[i]].P[k],-1); break;
-                case 'L': outrnxobsf(fp,obs[ind[i]].L[k]+dL,obs[ind[i]].LLI[k]); break;
-                case 'D': outrnxobsf(fp,obs[ind[i]].D[k],-1); break;
-                case 'S': outrnxobsf(fp,obs[ind[i]].SNR[k]*SNR_UNIT,-1); break;
+                case 'P': p=outrnxobsf(p,obs[ind[i]].P[k],-1); break;
+                case 'L': p=outrnxobsf(p,obs[ind[i]].L[k]+dL,obs[ind[i]].LLI[k]); break;
+                case 'D': p=outrnxobsf(p,obs[ind[i]].D[k],-1); break;
+                case 'S': p=outrnxobsf(p,obs[ind[i]].SNR[k]*SNR_UNIT,-1); break;
             }
         }
-        if (opt->rnxver>=300&&fprintf(fp,"\n")==EOF) return 0;
+        if (opt->rnxver>=300) *p++='\n';
     }
-    if (opt->rnxver>=300) return 1;
+    if (opt->rnxver<=299) *p++='\n';
     
-    return fprintf(fp,"\n")!=EOF;
+    return fwrite(buff,p-buff,1,fp)==1;
+}
+/* number to RINEX navigation data field --------------------------------------
+* convert number to RINEX navigation data field (" -.nnnnnnnnnnnnD+ee")
+* args   : char   *buff     O   string (null-terminated)
+*          double value     I   number
+*          int    n         I   number of mantissa digits
+* return : number of characters (excluding null)
+* notes  : output is the same as sprintf(buff," %s.%0*.0f%s%+03.0f",...) of the
+*          mantissa and exponent by log10(). mantissa is rounded half-to-even
+*          as printf "%.0f". non-finite or out of range values are passed to
+*          sprintf().
+*-----------------------------------------------------------------------------*/
+extern int navf2str(char *buff, double value, int n)
+{
+    double e=(fabs(value)<1E-99)?0.0:floor(log10(fabs(value))+1.0),m;
+    char s[32],*p=buff,*q=s+sizeof(s);
+    uint64_t v;
+    int i,exp;
+    
+    m=fabs(value)/pow(10.0,e-n);
+    
+    if (!(m<1E18)||fabs(e)>=1000.0) {
+        return sprintf(buff," %s.%0*.0f%s%+03.0f",value<0.0?"-":" ",n,m,
+                       NAVEXP,e);
+    }
+    /* mantissa digits by round-half-even as printf "%.0f" */
+    v=(uint64_t)nearbyint(m);
+    do {
+        *--q='0'+(char)(v%10);
+    } while (v/=10);
+    *p++=' '; *p++=value<0.0?'-':' '; *p++='.';
+    for (i=(int)(s+sizeof(s)-q);i<n;i++) *p++='0';
+    memcpy(p,q,s+sizeof(s)-q); p+=s+sizeof(s)-q;
+    
+    /* exponent */
+    exp=(int)e;
+    *p++=NAVEXP[0];
+    *p++=exp<0?'-':'+';
+    if (exp<0) exp=-exp;
+    if (exp>=100) *p++='0'+exp/100;
+    *p++='0'+exp/10%10;
+    *p++='0'+exp%10;
+    *p='\0';
+    return (int)(p-buff);
 }
 /* output data field in RINEX navigation data --------------------------------*/
 static void outnavf_n(FILE *fp, double value, int n)
 {
-    double e=(fabs(value)<1E-99)?0.0:floor(log10(fabs(value))+1.0);
+    char buff[64];
     
-    fprintf(fp," %s.%0*.0f%s%+03.0f",value<0.0?"-":" ",n,
-            fabs(value)/pow(10.0,e-n),NAVEXP,e);
+    fwrite(buff,navf2str(buff,value,n),1,fp);
 }
 static void outnavf(FILE *fp, double value)
 {
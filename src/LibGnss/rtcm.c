@@ -44,6 +44,9 @@
 *                           delete references [2]-[6],[8],[9],[11]-[14]
 *                           update reference [17]
 *                           use integer types in stdint.h
+*           2026/10/18 1.13 add API input_rtcm3_buf()
+*                           input_rtcm3f() reads frames in blocks instead of
+*                            byte by byte
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -189,6 +192,19 @@ extern int input_rtcm2(rtcm_t *rtcm, uint8_t data)
     }
     return 0;
 }
+/* check parity and decode rtcm 3 frame in buffer ----------------------------*/
+static int decode_frame3(rtcm_t *rtcm)
+{
+    rtcm->nbyte=0;
+    
+    /* check parity */
+    if (rtk_crc24q(rtcm->buff,rtcm->len)!=getbitu(rtcm->buff,rtcm->len*8,24)) {
+        trace(2,"rtcm3 parity error: len=%d\n",rtcm->len);
+        return 0;
+    }
+    /* decode rtcm3 message */
+    return decode_rtcm3(rtcm);
+}
 /* input RTCM 3 message from stream --------------------------------------------
 * fetch next RTCM 3 message and input a message from byte stream
 * args   : rtcm_t *rtcm     IO  rtcm control struct
@@ -276,15 +292,77 @@ extern int input_rtcm3(rtcm_t *rtcm, uint8_t data)
         rtcm->len=getbitu(rtcm->buff,14,10)+3; /* length without parity */
     }
     if (rtcm->nbyte<3||rtcm->nbyte<rtcm->len+3) return 0;
-    rtcm->nbyte=0;
     
-    /* check parity */
-    if (rtk_crc24q(rtcm->buff,rtcm->len)!=getbitu(rtcm->buff,rtcm->len*8,24)) {
-        trace(2,"rtcm3 parity error: len=%d\n",rtcm->len);
-        return 0;
+    return decode_frame3(rtcm);
+}
+/* input RTCM 3 messages from buffer -------------------------------------------
+* scan a block of RTCM 3 stream data and decode the complete frames in it
+* args   : rtcm_t *rtcm     IO  rtcm control struct
+*          uint8_t *buff    I   stream data
+*          size_t n         I   length of stream data (bytes)
+*          int (*func)()    I   message callback (NULL: stop at first message)
+*          void   *arg      IO  user argument passed to callback
+*                               (func==NULL: int *, message status or NULL)
+* return : number of bytes consumed
+* notes  : for each message with status !=0 (same as input_rtcm3()),
+*          func(rtcm,status,arg) is called. the scan stops after the message
+*          if the callback returns 0.
+*          preambles are searched with memchr() and a frame held in the buffer
+*          is checked without being fed byte by byte. a frame split across
+*          blocks is kept in rtcm->buff, so the byte API input_rtcm3() and the
+*          buffer API can be mixed on the same stream.
+*-----------------------------------------------------------------------------*/
+extern size_t input_rtcm3_buf(rtcm_t *rtcm, const uint8_t *buff, size_t n,
+                              int (*func)(rtcm_t *, int, void *), void *arg)
+{
+    const uint8_t *p;
+    size_t i=0,m;
+    int ret,len;
+    
+    trace(5,"input_rtcm3_buf: n=%d\n",(int)n);
+    
+    while (i<n) {
+        
+        /* synchronize frame */
+        if (rtcm->nbyte==0) {
+            if (!(p=(const uint8_t *)memchr(buff+i,RTCM3PREAMB,n-i))) return n;
+            i=(size_t)(p-buff);
+            
+            /* whole frame in input buffer */
+            if (n-i>=3&&n-i>=(size_t)(len=getbitu(p,14,10)+3)+3) {
+                memcpy(rtcm->buff,p,len+3);
+                rtcm->len=len;
+                i+=len+3;
+                if (!(ret=decode_frame3(rtcm))) continue;
+                if (!func) {
+                    if (arg) *(int *)arg=ret;
+                    return i;
+                }
+                if (!func(rtcm,ret,arg)) return i;
+                continue;
+            }
+        }
+        /* frame split across blocks */
+        m=rtcm->nbyte<3?3-rtcm->nbyte:rtcm->len+3-rtcm->nbyte;
+        if (m>n-i) m=n-i;
+        memcpy(rtcm->buff+rtcm->nbyte,buff+i,m);
+        rtcm->nbyte+=(int)m;
+        i+=m;
+        if (rtcm->nbyte<3) continue;
+        if (rtcm->nbyte==3) {
+            rtcm->len=getbitu(rtcm->buff,14,10)+3; /* length without parity */
+            continue;
+        }
+        if (rtcm->nbyte<rtcm->len+3) continue;
+        
+        if (!(ret=decode_frame3(rtcm))) continue;
+        if (!func) {
+            if (arg) *(int *)arg=ret;
+            return i;
+        }
+        if (!func(rtcm,ret,arg)) return i;
     }
-    /* decode rtcm3 message */
-    return decode_rtcm3(rtcm);
+    return n;
 }
 /* input RTCM 2 message from file ----------------------------------------------
 * fetch next RTCM 2 message and input a messsage from file
@@ -314,13 +392,31 @@ extern int input_rtcm2f(rtcm_t *rtcm, FILE *fp)
 *-----------------------------------------------------------------------------*/
 extern int input_rtcm3f(rtcm_t *rtcm, FILE *fp)
 {
-    int i,data=0,ret;
+    int i,m,data=0;
     
     trace(4,"input_rtcm3f: data=%02x\n",data);
     
-    for (i=0;i<4096;i++) {
-        if ((data=fgetc(fp))==EOF) return -2;
-        if ((ret=input_rtcm3(rtcm,(uint8_t)data))) return ret;
+    for (i=0;i<4096;) {
+        
+        /* synchronize frame */
+        if (rtcm->nbyte==0) {
+            if ((data=fgetc(fp))==EOF) return -2;
+            i++;
+            if (data!=RTCM3PREAMB) continue;
+            rtcm->buff[rtcm->nbyte++]=(uint8_t)data;
+        }
+        /* read frame header and then the rest of frame in a block */
+        if (rtcm->nbyte<3) {
+            m=(int)fread(rtcm->buff+rtcm->nbyte,1,3-rtcm->nbyte,fp);
+            rtcm->nbyte+=m; i+=m;
+            if (rtcm->nbyte<3) return -2;
+            rtcm->len=getbitu(rtcm->buff,14,10)+3; /* length without parity */
+        }
+        m=(int)fread(rtcm->buff+rtcm->nbyte,1,rtcm->len+3-rtcm->nbyte,fp);
+        rtcm->nbyte+=m; i+=m;
+        if (rtcm->nbyte<rtcm->len+3) return -2;
+        
+        if ((data=decode_frame3(rtcm))) return data;
     }
     return 0; /* return at every 4k bytes */
 }
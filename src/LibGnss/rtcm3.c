@@ -2101,44 +2101,46 @@ static int decode_msm_head(rtcm_t *rtcm, int sys, int *sync, int *iod,
                            msm_h_t *h, int *hsize)
 {
     msm_h_t h0={0};
+    bitr_t br={rtcm->buff,24};
     double tow,tod;
     char *msg,tstr[64];
-    int i=24,j,dow,mask,staid,type,ncell=0;
+    int j,dow,staid,type,ncell=0;
+    uint32_t mask=0;
     
-    type=getbitu(rtcm->buff,i,12); i+=12;
+    type=rdbitu(&br,12);
     
     *h=h0;
-    if (i+157<=rtcm->len*8) {
-        staid     =getbitu(rtcm->buff,i,12);       i+=12;
+    if (br.pos+157<=rtcm->len*8) {
+        staid     =rdbitu(&br,12);
         
         if (sys==SYS_GLO) {
-            dow   =getbitu(rtcm->buff,i, 3);       i+= 3;
-            tod   =getbitu(rtcm->buff,i,27)*0.001; i+=27;
+            dow   =rdbitu(&br, 3);
+            tod   =rdbitu(&br,27)*0.001;
             adjday_glot(rtcm,tod);
         }
         else if (sys==SYS_CMP) {
-            tow   =getbitu(rtcm->buff,i,30)*0.001; i+=30;
+            tow   =rdbitu(&br,30)*0.001;
             tow+=14.0; /* BDT -> GPST */
             adjweek(rtcm,tow);
         }
         else {
-            tow   =getbitu(rtcm->buff,i,30)*0.001; i+=30;
+            tow   =rdbitu(&br,30)*0.001;
             adjweek(rtcm,tow);
         }
-        *sync     =getbitu(rtcm->buff,i, 1);       i+= 1;
-        *iod      =getbitu(rtcm->buff,i, 3);       i+= 3;
-        h->time_s =getbitu(rtcm->buff,i, 7);       i+= 7;
-        h->clk_str=getbitu(rtcm->buff,i, 2);       i+= 2;
-        h->clk_ext=getbitu(rtcm->buff,i, 2);       i+= 2;
-        h->smooth =getbitu(rtcm->buff,i, 1);       i+= 1;
-        h->tint_s =getbitu(rtcm->buff,i, 3);       i+= 3;
+        *sync     =rdbitu(&br, 1);
+        *iod      =rdbitu(&br, 3);
+        h->time_s =rdbitu(&br, 7);
+        h->clk_str=rdbitu(&br, 2);
+        h->clk_ext=rdbitu(&br, 2);
+        h->smooth =rdbitu(&br, 1);
+        h->tint_s =rdbitu(&br, 3);
         for (j=1;j<=64;j++) {
-            mask=getbitu(rtcm->buff,i,1); i+=1;
-            if (mask) h->sats[h->nsat++]=j;
+            if (j%32==1) mask=rdbitu(&br,32);
+            if (mask&(1u<<(31-(j-1)%32))) h->sats[h->nsat++]=j;
         }
+        mask=rdbitu(&br,32);
         for (j=1;j<=32;j++) {
-            mask=getbitu(rtcm->buff,i,1); i+=1;
-            if (mask) h->sigs[h->nsig++]=j;
+            if (mask&(1u<<(32-j))) h->sigs[h->nsig++]=j;
         }
     }
     else {
@@ -2153,16 +2155,16 @@ static int decode_msm_head(rtcm_t *rtcm, int sys, int *sync, int *iod,
               type,h->nsat,h->nsig);
         return -1;
     }
-    if (i+h->nsat*h->nsig>rtcm->len*8) {
+    if (br.pos+h->nsat*h->nsig>rtcm->len*8) {
         trace(2,"rtcm3 %d length error: len=%d nsat=%d nsig=%d\n",type,
               rtcm->len,h->nsat,h->nsig);
         return -1;
     }
     for (j=0;j<h->nsat*h->nsig;j++) {
-        h->cellmask[j]=getbitu(rtcm->buff,i,1); i+=1;
+        h->cellmask[j]=rdbitu(&br,1);
         if (h->cellmask[j]) ncell++;
     }
-    *hsize=i;
+    *hsize=br.pos;
     
     time2str(rtcm->time,tstr,2);
     trace(4,"decode_head_msm: time=%s sys=%d staid=%d nsat=%d nsig=%d sync=%d iod=%d ncell=%d\n",
@@ -2188,6 +2190,7 @@ static int decode_msm0(rtcm_t *rtcm, int sys)
 static int decode_msm4(rtcm_t *rtcm, int sys)
 {
     msm_h_t h={0};
+    bitr_t br;
     double r[64],pr[64],cp[64],cnr[64];
     int i,j,type,sync,iod,ncell,rng,rng_m,prv,cpv,lock[64],half[64];
     
@@ -2195,6 +2198,7 @@ static int decode_msm4(rtcm_t *rtcm, int sys)
     
     /* decode msm header */
     if ((ncell=decode_msm_head(rtcm,sys,&sync,&iod,&h,&i))<0) return -1;
+    br.buff=rtcm->buff; br.pos=i;
     
     if (i+h.nsat*18+ncell*48>rtcm->len*8) {
         trace(2,"rtcm3 %d length error: nsat=%d ncell=%d len=%d\n",type,h.nsat,
@@ -2206,30 +2210,30 @@ static int decode_msm4(rtcm_t *rtcm, int sys)
     
     /* decode satellite data */
     for (j=0;j<h.nsat;j++) { /* range */
-        rng  =getbitu(rtcm->buff,i, 8); i+= 8;
+        rng  =rdbitu(&br,8);
         if (rng!=255) r[j]=rng*RANGE_MS;
     }
     for (j=0;j<h.nsat;j++) {
-        rng_m=getbitu(rtcm->buff,i,10); i+=10;
+        rng_m=rdbitu(&br,10);
         if (r[j]!=0.0) r[j]+=rng_m*P2_10*RANGE_MS;
     }
     /* decode signal data */
     for (j=0;j<ncell;j++) { /* pseudorange */
-        prv=getbits(rtcm->buff,i,15); i+=15;
+        prv=rdbits(&br,15);
         if (prv!=-16384) pr[j]=prv*P2_24*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* phaserange */
-        cpv=getbits(rtcm->buff,i,22); i+=22;
+        cpv=rdbits(&br,22);
         if (cpv!=-2097152) cp[j]=cpv*P2_29*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* lock time */
-        lock[j]=getbitu(rtcm->buff,i,4); i+=4;
+        lock[j]=rdbitu(&br,4);
     }
     for (j=0;j<ncell;j++) { /* half-cycle ambiguity */
-        half[j]=getbitu(rtcm->buff,i,1); i+=1;
+        half[j]=rdbitu(&br,1);
     }
     for (j=0;j<ncell;j++) { /* cnr */
-        cnr[j]=getbitu(rtcm->buff,i,6)*1.0; i+=6;
+        cnr[j]=rdbitu(&br,6)*1.0;
     }
     /* save obs data in msm message */
     save_msm_obs(rtcm,sys,&h,r,pr,cp,NULL,NULL,cnr,lock,NULL,half);
@@ -2241,6 +2245,7 @@ static int decode_msm4(rtcm_t *rtcm, int sys)
 static int decode_msm5(rtcm_t *rtcm, int sys)
 {
     msm_h_t h={0};
+    bitr_t br;
     double r[64],rr[64],pr[64],cp[64],rrf[64],cnr[64];
     int i,j,type,sync,iod,ncell,rng,rng_m,rate,prv,cpv,rrv,lock[64];
     int ex[64],half[64];
@@ -2249,6 +2254,7 @@ static int decode_msm5(rtcm_t *rtcm, int sys)
     
     /* decode msm header */
     if ((ncell=decode_msm_head(rtcm,sys,&sync,&iod,&h,&i))<0) return -1;
+    br.buff=rtcm->buff; br.pos=i;
     
     if (i+h.nsat*36+ncell*63>rtcm->len*8) {
         trace(2,"rtcm3 %d length error: nsat=%d ncell=%d len=%d\n",type,h.nsat,
@@ -2262,40 +2268,40 @@ static int decode_msm5(rtcm_t *rtcm, int sys)
     
     /* decode satellite data */
     for (j=0;j<h.nsat;j++) { /* range */
-        rng  =getbitu(rtcm->buff,i, 8); i+= 8;
+        rng  =rdbitu(&br,8);
         if (rng!=255) r[j]=rng*RANGE_MS;
     }
     for (j=0;j<h.nsat;j++) { /* extended info */
-        ex[j]=getbitu(rtcm->buff,i, 4); i+= 4;
+        ex[j]=rdbitu(&br,4);
     }
     for (j=0;j<h.nsat;j++) {
-        rng_m=getbitu(rtcm->buff,i,10); i+=10;
+        rng_m=rdbitu(&br,10);
         if (r[j]!=0.0) r[j]+=rng_m*P2_10*RANGE_MS;
     }
     for (j=0;j<h.nsat;j++) { /* phaserangerate */
-        rate =getbits(rtcm->buff,i,14); i+=14;
+        rate =rdbits(&br,14);
         if (rate!=-8192) rr[j]=rate*1.0;
     }
     /* decode signal data */
     for (j=0;j<ncell;j++) { /* pseudorange */
-        prv=getbits(rtcm->buff,i,15); i+=15;
+        prv=rdbits(&br,15);
         if (prv!=-16384) pr[j]=prv*P2_24*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* phaserange */
-        cpv=getbits(rtcm->buff,i,22); i+=22;
+        cpv=rdbits(&br,22);
         if (cpv!=-2097152) cp[j]=cpv*P2_29*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* lock time */
-        lock[j]=getbitu(rtcm->buff,i,4); i+=4;
+        lock[j]=rdbitu(&br,4);
     }
     for (j=0;j<ncell;j++) { /* half-cycle ambiguity */
-        half[j]=getbitu(rtcm->buff,i,1); i+=1;
+        half[j]=rdbitu(&br,1);
     }
     for (j=0;j<ncell;j++) { /* cnr */
-        cnr[j]=getbitu(rtcm->buff,i,6)*1.0; i+=6;
+        cnr[j]=rdbitu(&br,6)*1.0;
     }
     for (j=0;j<ncell;j++) { /* phaserangerate */
-        rrv=getbits(rtcm->buff,i,15); i+=15;
+        rrv=rdbits(&br,15);
         if (rrv!=-16384) rrf[j]=rrv*0.0001;
     }
     /* save obs data in msm message */
@@ -2308,6 +2314,7 @@ static int decode_msm5(rtcm_t *rtcm, int sys)
 static int decode_msm6(rtcm_t *rtcm, int sys)
 {
     msm_h_t h={0};
+    bitr_t br;
     double r[64],pr[64],cp[64],cnr[64];
     int i,j,type,sync,iod,ncell,rng,rng_m,prv,cpv,lock[64],half[64];
     
@@ -2315,6 +2322,7 @@ static int decode_msm6(rtcm_t *rtcm, int sys)
     
     /* decode msm header */
     if ((ncell=decode_msm_head(rtcm,sys,&sync,&iod,&h,&i))<0) return -1;
+    br.buff=rtcm->buff; br.pos=i;
     
     if (i+h.nsat*18+ncell*65>rtcm->len*8) {
         trace(2,"rtcm3 %d length error: nsat=%d ncell=%d len=%d\n",type,h.nsat,
@@ -2326,30 +2334,30 @@ static int decode_msm6(rtcm_t *rtcm, int sys)
     
     /* decode satellite data */
     for (j=0;j<h.nsat;j++) { /* range */
-        rng  =getbitu(rtcm->buff,i, 8); i+= 8;
+        rng  =rdbitu(&br,8);
         if (rng!=255) r[j]=rng*RANGE_MS;
     }
     for (j=0;j<h.nsat;j++) {
-        rng_m=getbitu(rtcm->buff,i,10); i+=10;
+        rng_m=rdbitu(&br,10);
         if (r[j]!=0.0) r[j]+=rng_m*P2_10*RANGE_MS;
     }
     /* decode signal data */
     for (j=0;j<ncell;j++) { /* pseudorange */
-        prv=getbits(rtcm->buff,i,20); i+=20;
+        prv=rdbits(&br,20);
         if (prv!=-524288) pr[j]=prv*P2_29*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* phaserange */
-        cpv=getbits(rtcm->buff,i,24); i+=24;
+        cpv=rdbits(&br,24);
         if (cpv!=-8388608) cp[j]=cpv*P2_31*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* lock time */
-        lock[j]=getbitu(rtcm->buff,i,10); i+=10;
+        lock[j]=rdbitu(&br,10);
     }
     for (j=0;j<ncell;j++) { /* half-cycle ambiguity */
-        half[j]=getbitu(rtcm->buff,i,1); i+=1;
+        half[j]=rdbitu(&br,1);
     }
     for (j=0;j<ncell;j++) { /* cnr */
-        cnr[j]=getbitu(rtcm->buff,i,10)*0.0625; i+=10;
+        cnr[j]=rdbitu(&br,10)*0.0625;
     }
     /* save obs data in msm message */
     save_msm_obs(rtcm,sys,&h,r,pr,cp,NULL,NULL,cnr,lock,NULL,half);
@@ -2361,6 +2369,7 @@ static int decode_msm6(rtcm_t *rtcm, int sys)
 static int decode_msm7(rtcm_t *rtcm, int sys)
 {
     msm_h_t h={0};
+    bitr_t br;
     double r[64],rr[64],pr[64],cp[64],rrf[64],cnr[64];
     int i,j,type,sync,iod,ncell,rng,rng_m,rate,prv,cpv,rrv,lock[64];
     int ex[64],half[64];
@@ -2369,6 +2378,7 @@ static int decode_msm7(rtcm_t *rtcm, int sys)
     
     /* decode msm header */
     if ((ncell=decode_msm_head(rtcm,sys,&sync,&iod,&h,&i))<0) return -1;
+    br.buff=rtcm->buff; br.pos=i;
     
     if (i+h.nsat*36+ncell*80>rtcm->len*8) {
         trace(2,"rtcm3 %d length error: nsat=%d ncell=%d len=%d\n",type,h.nsat,
@@ -2382,40 +2392,40 @@ static int decode_msm7(rtcm_t *rtcm, int sys)
     
     /* decode satellite data */
     for (j=0;j<h.nsat;j++) { /* range */
-        rng  =getbitu(rtcm->buff,i, 8); i+= 8;
+        rng  =rdbitu(&br,8);
         if (rng!=255) r[j]=rng*RANGE_MS;
     }
     for (j=0;j<h.nsat;j++) { /* extended info */
-        ex[j]=getbitu(rtcm->buff,i, 4); i+= 4;
+        ex[j]=rdbitu(&br,4);
     }
     for (j=0;j<h.nsat;j++) {
-        rng_m=getbitu(rtcm->buff,i,10); i+=10;
+        rng_m=rdbitu(&br,10);
         if (r[j]!=0.0) r[j]+=rng_m*P2_10*RANGE_MS;
     }
     for (j=0;j<h.nsat;j++) { /* phaserangerate */
-        rate =getbits(rtcm->buff,i,14); i+=14;
+        rate =rdbits(&br,14);
         if (rate!=-8192) rr[j]=rate*1.0;
     }
     /* decode signal data */
     for (j=0;j<ncell;j++) { /* pseudorange */
-        prv=getbits(rtcm->buff,i,20); i+=20;
+        prv=rdbits(&br,20);
         if (prv!=-524288) pr[j]=prv*P2_29*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* phaserange */
-        cpv=getbits(rtcm->buff,i,24); i+=24;
+        cpv=rdbits(&br,24);
         if (cpv!=-8388608) cp[j]=cpv*P2_31*RANGE_MS;
     }
     for (j=0;j<ncell;j++) { /* lock time */
-        lock[j]=getbitu(rtcm->buff,i,10); i+=10;
+        lock[j]=rdbitu(&br,10);
     }
     for (j=0;j<ncell;j++) { /* half-cycle amiguity */
-        half[j]=getbitu(rtcm->buff,i,1); i+=1;
+        half[j]=rdbitu(&br,1);
     }
     for (j=0;j<ncell;j++) { /* cnr */
-        cnr[j]=getbitu(rtcm->buff,i,10)*0.0625; i+=10;
+        cnr[j]=rdbitu(&br,10)*0.0625;
     }
     for (j=0;j<ncell;j++) { /* phaserangerate */
-        rrv=getbits(rtcm->buff,i,15); i+=15;
+        rrv=rdbits(&br,15);
         if (rrv!=-16384) rrf[j]=rrv*0.0001;
     }
     /* save obs data in msm message */
@@ -125,8 +125,18 @@
 *           2016/09/19 1.42 modify api deg2dms() to consider numerical error
 *           2017/04/11 1.43 delete EXPORT for global variables
 *           2018/10/10 1.44 modify api satexclude()
+*           2026/10/18 1.45 slicing-by-8 table for rtk_crc32()
+*                           use reentrant gmtime_r() in timeget()
+*                           add api fixf2str()
+*                           add api ringinit(),ringfree(),ringwrite(),
+*                           ringread(),ringcount(),ringspace()
+*                           fix bug on interpolation of erp in geterp()
+*                           add api tropmapfx()
+*                           add single-precision kernels option to antmodel()
+*                           change constant _POSIX_C_SOURCE 199506 -> 200112
+*                           for pthread_condattr_setclock()
 *-----------------------------------------------------------------------------*/
-#define _POSIX_C_SOURCE 199506
+#define _POSIX_C_SOURCE 200112L
 #include <stdarg.h>
 #include <ctype.h>
 #ifndef WIN32
@@ -145,6 +155,10 @@
 
 #define SQR(x)      ((x)*(x))
 #define MAX_VAR_EPH SQR(300.0)  /* max variance eph to reject satellite (m^2) */
+#define MAXSHCACHE  4           /* max stations in gpt/gmf coefficient cache */
+#define TOL_SHPOS   1E-6        /* position tolerance of coefficient cache (rad) */
+#define DTASTRO     1.0         /* time step for sun/moon rates of astro context (s) */
+#define MAXDTASTRO  1.0         /* max time offset from astro context epoch (s) */
 
 static const double gpst0[]={1980,1, 6,0,0,0}; /* gps time reference */
 static const double gst0 []={1999,8,22,0,0,0}; /* galileo system time reference */
@@ -419,6 +433,368 @@ static const unsigned int tbl_CRC24Q[]={
     0xE37B16,0x6537ED,0x69AE1B,0xEFE2E0,0x709DF7,0xF6D10C,0xFA48FA,0x7C0401,
     0x42FA2F,0xC4B6D4,0xC82F22,0x4E63D9,0xD11CCE,0x575035,0x5BC9C3,0xDD8538
 };
+static const unsigned int tbl_CRC32[8][256]={ /* slicing-by-8 */
+  {
+    0x00000000,0x77073096,0xEE0E612C,0x990951BA,0x076DC419,0x706AF48F,
+    0xE963A535,0x9E6495A3,0x0EDB8832,0x79DCB8A4,0xE0D5E91E,0x97D2D988,
+    0x09B64C2B,0x7EB17CBD,0xE7B82D07,0x90BF1D91,0x1DB71064,0x6AB020F2,
+    0xF3B97148,0x84BE41DE,0x1ADAD47D,0x6DDDE4EB,0xF4D4B551,0x83D385C7,
+    0x136C9856,0x646BA8C0,0xFD62F97A,0x8A65C9EC,0x14015C4F,0x63066CD9,
+    0xFA0F3D63,0x8D080DF5,0x3B6E20C8,0x4C69105E,0xD56041E4,0xA2677172,
+    0x3C03E4D1,0x4B04D447,0xD20D85FD,0xA50AB56B,0x35B5A8FA,0x42B2986C,
+    0xDBBBC9D6,0xACBCF940,0x32D86CE3,0x45DF5C75,0xDCD60DCF,0xABD13D59,
+    0x26D930AC,0x51DE003A,0xC8D75180,0xBFD06116,0x21B4F4B5,0x56B3C423,
+    0xCFBA9599,0xB8BDA50F,0x2802B89E,0x5F058808,0xC60CD9B2,0xB10BE924,
+    0x2F6F7C87,0x58684C11,0xC1611DAB,0xB6662D3D,0x76DC4190,0x01DB7106,
+    0x98D220BC,0xEFD5102A,0x71B18589,0x06B6B51F,0x9FBFE4A5,0xE8B8D433,
+    0x7807C9A2,0x0F00F934,0x9609A88E,0xE10E9818,0x7F6A0DBB,0x086D3D2D,
+    0x91646C97,0xE6635C01,0x6B6B51F4,0x1C6C6162,0x856530D8,0xF262004E,
+    0x6C0695ED,0x1B01A57B,0x8208F4C1,0xF50FC457,0x65B0D9C6,0x12B7E950,
+    0x8BBEB8EA,0xFCB9887C,0x62DD1DDF,0x15DA2D49,0x8CD37CF3,0xFBD44C65,
+    0x4DB26158,0x3AB551CE,0xA3BC0074,0xD4BB30E2,0x4ADFA541,0x3DD895D7,
+    0xA4D1C46D,0xD3D6F4FB,0x4369E96A,0x346ED9FC,0xAD678846,0xDA60B8D0,
+    0x44042D73,0x33031DE5,0xAA0A4C5F,0xDD0D7CC9,0x5005713C,0x270241AA,
+    0xBE0B1010,0xC90C2086,0x5768B525,0x206F85B3,0xB966D409,0xCE61E49F,
+    0x5EDEF90E,0x29D9C998,0xB0D09822,0xC7D7A8B4,0x59B33D17,0x2EB40D81,
+    0xB7BD5C3B,0xC0BA6CAD,0xEDB88320,0x9ABFB3B6,0x03B6E20C,0x74B1D29A,
+    0xEAD54739,0x9DD277AF,0x04DB2615,0x73DC1683,0xE3630B12,0x94643B84,
+    0x0D6D6A3E,0x7A6A5AA8,0xE40ECF0B,0x9309FF9D,0x0A00AE27,0x7D079EB1,
+    0xF00F9344,0x8708A3D2,0x1E01F268,0x6906C2FE,0xF762575D,0x806567CB,
+    0x196C3671,0x6E6B06E7,0xFED41B76,0x89D32BE0,0x10DA7A5A,0x67DD4ACC,
+    0xF9B9DF6F,0x8EBEEFF9,0x17B7BE43,0x60B08ED5,0xD6D6A3E8,0xA1D1937E,
+    0x38D8C2C4,0x4FDFF252,0xD1BB67F1,0xA6BC5767,0x3FB506DD,0x48B2364B,
+    0xD80D2BDA,0xAF0A1B4C,0x36034AF6,0x41047A60,0xDF60EFC3,0xA867DF55,
+    0x316E8EEF,0x4669BE79,0xCB61B38C,0xBC66831A,0x256FD2A0,0x5268E236,
+    0xCC0C7795,0xBB0B4703,0x220216B9,0x5505262F,0xC5BA3BBE,0xB2BD0B28,
+    0x2BB45A92,0x5CB36A04,0xC2D7FFA7,0xB5D0CF31,0x2CD99E8B,0x5BDEAE1D,
+    0x9B64C2B0,0xEC63F226,0x756AA39C,0x026D930A,0x9C0906A9,0xEB0E363F,
+    0x72076785,0x05005713,0x95BF4A82,0xE2B87A14,0x7BB12BAE,0x0CB61B38,
+    0x92D28E9B,0xE5D5BE0D,0x7CDCEFB7,0x0BDBDF21,0x86D3D2D4,0xF1D4E242,
+    0x68DDB3F8,0x1FDA836E,0x81BE16CD,0xF6B9265B,0x6FB077E1,0x18B74777,
+    0x88085AE6,0xFF0F6A70,0x66063BCA,0x11010B5C,0x8F659EFF,0xF862AE69,
+    0x616BFFD3,0x166CCF45,0xA00AE278,0xD70DD2EE,0x4E048354,0x3903B3C2,
+    0xA7672661,0xD06016F7,0x4969474D,0x3E6E77DB,0xAED16A4A,0xD9D65ADC,
+    0x40DF0B66,0x37D83BF0,0xA9BCAE53,0xDEBB9EC5,0x47B2CF7F,0x30B5FFE9,
+    0xBDBDF21C,0xCABAC28A,0x53B39330,0x24B4A3A6,0xBAD03605,0xCDD70693,
+    0x54DE5729,0x23D967BF,0xB3667A2E,0xC4614AB8,0x5D681B02,0x2A6F2B94,
+    0xB40BBE37,0xC30C8EA1,0x5A05DF1B,0x2D02EF8D
+  },
+  {
+    0x00000000,0x191B3141,0x32366282,0x2B2D53C3,0x646CC504,0x7D77F445,
+    0x565AA786,0x4F4196C7,0xC8D98A08,0xD1C2BB49,0xFAEFE88A,0xE3F4D9CB,
+    0xACB54F0C,0xB5AE7E4D,0x9E832D8E,0x87981CCF,0x4AC21251,0x53D92310,
+    0x78F470D3,0x61EF4192,0x2EAED755,0x37B5E614,0x1C98B5D7,0x05838496,
+    0x821B9859,0x9B00A918,0xB02DFADB,0xA936CB9A,0xE6775D5D,0xFF6C6C1C,
+    0xD4413FDF,0xCD5A0E9E,0x958424A2,0x8C9F15E3,0xA7B24620,0xBEA97761,
+    0xF1E8E1A6,0xE8F3D0E7,0xC3DE8324,0xDAC5B265,0x5D5DAEAA,0x44469FEB,
+    0x6F6BCC28,0x7670FD69,0x39316BAE,0x202A5AEF,0x0B07092C,0x121C386D,
+    0xDF4636F3,0xC65D07B2,0xED705471,0xF46B6530,0xBB2AF3F7,0xA231C2B6,
+    0x891C9175,0x9007A034,0x179FBCFB,0x0E848DBA,0x25A9DE79,0x3CB2EF38,
+    0x73F379FF,0x6AE848BE,0x41C51B7D,0x58DE2A3C,0xF0794F05,0xE9627E44,
+    0xC24F2D87,0xDB541CC6,0x94158A01,0x8D0EBB40,0xA623E883,0xBF38D9C2,
+    0x38A0C50D,0x21BBF44C,0x0A96A78F,0x138D96CE,0x5CCC0009,0x45D73148,
+    0x6EFA628B,0x77E153CA,0xBABB5D54,0xA3A06C15,0x888D3FD6,0x91960E97,
+    0xDED79850,0xC7CCA911,0xECE1FAD2,0xF5FACB93,0x7262D75C,0x6B79E61D,
+    0x4054B5DE,0x594F849F,0x160E1258,0x0F152319,0x243870DA,0x3D23419B,
+    0x65FD6BA7,0x7CE65AE6,0x57CB0925,0x4ED03864,0x0191AEA3,0x188A9FE2,
+    0x33A7CC21,0x2ABCFD60,0xAD24E1AF,0xB43FD0EE,0x9F12832D,0x8609B26C,
+    0xC94824AB,0xD05315EA,0xFB7E4629,0xE2657768,0x2F3F79F6,0x362448B7,
+    0x1D091B74,0x04122A35,0x4B53BCF2,0x52488DB3,0x7965DE70,0x607EEF31,
+    0xE7E6F3FE,0xFEFDC2BF,0xD5D0917C,0xCCCBA03D,0x838A36FA,0x9A9107BB,
+    0xB1BC5478,0xA8A76539,0x3B83984B,0x2298A90A,0x09B5FAC9,0x10AECB88,
+    0x5FEF5D4F,0x46F46C0E,0x6DD93FCD,0x74C20E8C,0xF35A1243,0xEA412302,
+    0xC16C70C1,0xD8774180,0x9736D747,0x8E2DE606,0xA500B5C5,0xBC1B8484,
+    0x71418A1A,0x685ABB5B,0x4377E898,0x5A6CD9D9,0x152D4F1E,0x0C367E5F,
+    0x271B2D9C,0x3E001CDD,0xB9980012,0xA0833153,0x8BAE6290,0x92B553D1,
+    0xDDF4C516,0xC4EFF457,0xEFC2A794,0xF6D996D5,0xAE07BCE9,0xB71C8DA8,
+    0x9C31DE6B,0x852AEF2A,0xCA6B79ED,0xD37048AC,0xF85D1B6F,0xE1462A2E,
+    0x66DE36E1,0x7FC507A0,0x54E85463,0x4DF36522,0x02B2F3E5,0x1BA9C2A4,
+    0x30849167,0x299FA026,0xE4C5AEB8,0xFDDE9FF9,0xD6F3CC3A,0xCFE8FD7B,
+    0x80A96BBC,0x99B25AFD,0xB29F093E,0xAB84387F,0x2C1C24B0,0x350715F1,
+    0x1E2A4632,0x07317773,0x4870E1B4,0x516BD0F5,0x7A468336,0x635DB277,
+    0xCBFAD74E,0xD2E1E60F,0xF9CCB5CC,0xE0D7848D,0xAF96124A,0xB68D230B,
+    0x9DA070C8,0x84BB4189,0x03235D46,0x1A386C07,0x31153FC4,0x280E0E85,
+    0x674F9842,0x7E54A903,0x5579FAC0,0x4C62CB81,0x8138C51F,0x9823F45E,
+    0xB30EA79D,0xAA1596DC,0xE554001B,0xFC4F315A,0xD7626299,0xCE7953D8,
+    0x49E14F17,0x50FA7E56,0x7BD72D95,0x62CC1CD4,0x2D8D8A13,0x3496BB52,
+    0x1FBBE891,0x06A0D9D0,0x5E7EF3EC,0x4765C2AD,0x6C48916E,0x7553A02F,
+    0x3A1236E8,0x230907A9,0x0824546A,0x113F652B,0x96A779E4,0x8FBC48A5,
+    0xA4911B66,0xBD8A2A27,0xF2CBBCE0,0xEBD08DA1,0xC0FDDE62,0xD9E6EF23,
+    0x14BCE1BD,0x0DA7D0FC,0x268A833F,0x3F91B27E,0x70D024B9,0x69CB15F8,
+    0x42E6463B,0x5BFD777A,0xDC656BB5,0xC57E5AF4,0xEE530937,0xF7483876,
+    0xB809AEB1,0xA1129FF0,0x8A3FCC33,0x9324FD72
+  },
+  {
+    0x00000000,0x01C26A37,0x0384D46E,0x0246BE59,0x0709A8DC,0x06CBC2EB,
+    0x048D7CB2,0x054F1685,0x0E1351B8,0x0FD13B8F,0x0D9785D6,0x0C55EFE1,
+    0x091AF964,0x08D89353,0x0A9E2D0A,0x0B5C473D,0x1C26A370,0x1DE4C947,
+    0x1FA2771E,0x1E601D29,0x1B2F0BAC,0x1AED619B,0x18ABDFC2,0x1969B5F5,
+    0x1235F2C8,0x13F798FF,0x11B126A6,0x10734C91,0x153C5A14,0x14FE3023,
+    0x16B88E7A,0x177AE44D,0x384D46E0,0x398F2CD7,0x3BC9928E,0x3A0BF8B9,
+    0x3F44EE3C,0x3E86840B,0x3CC03A52,0x3D025065,0x365E1758,0x379C7D6F,
+    0x35DAC336,0x3418A901,0x3157BF84,0x3095D5B3,0x32D36BEA,0x331101DD,
+    0x246BE590,0x25A98FA7,0x27EF31FE,0x262D5BC9,0x23624D4C,0x22A0277B,
+    0x20E69922,0x2124F315,0x2A78B428,0x2BBADE1F,0x29FC6046,0x283E0A71,
+    0x2D711CF4,0x2CB376C3,0x2EF5C89A,0x2F37A2AD,0x709A8DC0,0x7158E7F7,
+    0x731E59AE,0x72DC3399,0x7793251C,0x76514F2B,0x7417F172,0x75D59B45,
+    0x7E89DC78,0x7F4BB64F,0x7D0D0816,0x7CCF6221,0x798074A4,0x78421E93,
+    0x7A04A0CA,0x7BC6CAFD,0x6CBC2EB0,0x6D7E4487,0x6F38FADE,0x6EFA90E9,
+    0x6BB5866C,0x6A77EC5B,0x68315202,0x69F33835,0x62AF7F08,0x636D153F,
+    0x612BAB66,0x60E9C151,0x65A6D7D4,0x6464BDE3,0x662203BA,0x67E0698D,
+    0x48D7CB20,0x4915A117,0x4B531F4E,0x4A917579,0x4FDE63FC,0x4E1C09CB,
+    0x4C5AB792,0x4D98DDA5,0x46C49A98,0x4706F0AF,0x45404EF6,0x448224C1,
+    0x41CD3244,0x400F5873,0x4249E62A,0x438B8C1D,0x54F16850,0x55330267,
+    0x5775BC3E,0x56B7D609,0x53F8C08C,0x523AAABB,0x507C14E2,0x51BE7ED5,
+    0x5AE239E8,0x5B2053DF,0x5966ED86,0x58A487B1,0x5DEB9134,0x5C29FB03,
+    0x5E6F455A,0x5FAD2F6D,0xE1351B80,0xE0F771B7,0xE2B1CFEE,0xE373A5D9,
+    0xE63CB35C,0xE7FED96B,0xE5B86732,0xE47A0D05,0xEF264A38,0xEEE4200F,
+    0xECA29E56,0xED60F461,0xE82FE2E4,0xE9ED88D3,0xEBAB368A,0xEA695CBD,
+    0xFD13B8F0,0xFCD1D2C7,0xFE976C9E,0xFF5506A9,0xFA1A102C,0xFBD87A1B,
+    0xF99EC442,0xF85CAE75,0xF300E948,0xF2C2837F,0xF0843D26,0xF1465711,
+    0xF4094194,0xF5CB2BA3,0xF78D95FA,0xF64FFFCD,0xD9785D60,0xD8BA3757,
+    0xDAFC890E,0xDB3EE339,0xDE71F5BC,0xDFB39F8B,0xDDF521D2,0xDC374BE5,
+    0xD76B0CD8,0xD6A966EF,0xD4EFD8B6,0xD52DB281,0xD062A404,0xD1A0CE33,
+    0xD3E6706A,0xD2241A5D,0xC55EFE10,0xC49C9427,0xC6DA2A7E,0xC7184049,
+    0xC25756CC,0xC3953CFB,0xC1D382A2,0xC011E895,0xCB4DAFA8,0xCA8FC59F,
+    0xC8C97BC6,0xC90B11F1,0xCC440774,0xCD866D43,0xCFC0D31A,0xCE02B92D,
+    0x91AF9640,0x906DFC77,0x922B422E,0x93E92819,0x96A63E9C,0x976454AB,
+    0x9522EAF2,0x94E080C5,0x9FBCC7F8,0x9E7EADCF,0x9C381396,0x9DFA79A1,
+    0x98B56F24,0x99770513,0x9B31BB4A,0x9AF3D17D,0x8D893530,0x8C4B5F07,
+    0x8E0DE15E,0x8FCF8B69,0x8A809DEC,0x8B42F7DB,0x89044982,0x88C623B5,
+    0x839A6488,0x82580EBF,0x801EB0E6,0x81DCDAD1,0x8493CC54,0x8551A663,
+    0x8717183A,0x86D5720D,0xA9E2D0A0,0xA820BA97,0xAA6604CE,0xABA46EF9,
+    0xAEEB787C,0xAF29124B,0xAD6FAC12,0xACADC625,0xA7F18118,0xA633EB2F,
+    0xA4755576,0xA5B73F41,0xA0F829C4,0xA13A43F3,0xA37CFDAA,0xA2BE979D,
+    0xB5C473D0,0xB40619E7,0xB640A7BE,0xB782CD89,0xB2CDDB0C,0xB30FB13B,
+    0xB1490F62,0xB08B6555,0xBBD72268,0xBA15485F,0xB853F606,0xB9919C31,
+    0xBCDE8AB4,0xBD1CE083,0xBF5A5EDA,0xBE9834ED
+  },
+  {
+    0x00000000,0xB8BC6765,0xAA09C88B,0x12B5AFEE,0x8F629757,0x37DEF032,
+    0x256B5FDC,0x9DD738B9,0xC5B428EF,0x7D084F8A,0x6FBDE064,0xD7018701,
+    0x4AD6BFB8,0xF26AD8DD,0xE0DF7733,0x58631056,0x5019579F,0xE8A530FA,
+    0xFA109F14,0x42ACF871,0xDF7BC0C8,0x67C7A7AD,0x75720843,0xCDCE6F26,
+    0x95AD7F70,0x2D111815,0x3FA4B7FB,0x8718D09E,0x1ACFE827,0xA2738F42,
+    0xB0C620AC,0x087A47C9,0xA032AF3E,0x188EC85B,0x0A3B67B5,0xB28700D0,
+    0x2F503869,0x97EC5F0C,0x8559F0E2,0x3DE59787,0x658687D1,0xDD3AE0B4,
+    0xCF8F4F5A,0x7733283F,0xEAE41086,0x525877E3,0x40EDD80D,0xF851BF68,
+    0xF02BF8A1,0x48979FC4,0x5A22302A,0xE29E574F,0x7F496FF6,0xC7F50893,
+    0xD540A77D,0x6DFCC018,0x359FD04E,0x8D23B72B,0x9F9618C5,0x272A7FA0,
+    0xBAFD4719,0x0241207C,0x10F48F92,0xA848E8F7,0x9B14583D,0x23A83F58,
+    0x311D90B6,0x89A1F7D3,0x1476CF6A,0xACCAA80F,0xBE7F07E1,0x06C36084,
+    0x5EA070D2,0xE61C17B7,0xF4A9B859,0x4C15DF3C,0xD1C2E785,0x697E80E0,
+    0x7BCB2F0E,0xC377486B,0xCB0D0FA2,0x73B168C7,0x6104C729,0xD9B8A04C,
+    0x446F98F5,0xFCD3FF90,0xEE66507E,0x56DA371B,0x0EB9274D,0xB6054028,
+    0xA4B0EFC6,0x1C0C88A3,0x81DBB01A,0x3967D77F,0x2BD27891,0x936E1FF4,
+    0x3B26F703,0x839A9066,0x912F3F88,0x299358ED,0xB4446054,0x0CF80731,
+    0x1E4DA8DF,0xA6F1CFBA,0xFE92DFEC,0x462EB889,0x549B1767,0xEC277002,
+    0x71F048BB,0xC94C2FDE,0xDBF98030,0x6345E755,0x6B3FA09C,0xD383C7F9,
+    0xC1366817,0x798A0F72,0xE45D37CB,0x5CE150AE,0x4E54FF40,0xF6E89825,
+    0xAE8B8873,0x1637EF16,0x048240F8,0xBC3E279D,0x21E91F24,0x99557841,
+    0x8BE0D7AF,0x335CB0CA,0xED59B63B,0x55E5D15E,0x47507EB0,0xFFEC19D5,
+    0x623B216C,0xDA874609,0xC832E9E7,0x708E8E82,0x28ED9ED4,0x9051F9B1,
+    0x82E4565F,0x3A58313A,0xA78F0983,0x1F336EE6,0x0D86C108,0xB53AA66D,
+    0xBD40E1A4,0x05FC86C1,0x1749292F,0xAFF54E4A,0x322276F3,0x8A9E1196,
+    0x982BBE78,0x2097D91D,0x78F4C94B,0xC048AE2E,0xD2FD01C0,0x6A4166A5,
+    0xF7965E1C,0x4F2A3979,0x5D9F9697,0xE523F1F2,0x4D6B1905,0xF5D77E60,
+    0xE762D18E,0x5FDEB6EB,0xC2098E52,0x7AB5E937,0x680046D9,0xD0BC21BC,
+    0x88DF31EA,0x3063568F,0x22D6F961,0x9A6A9E04,0x07BDA6BD,0xBF01C1D8,
+    0xADB46E36,0x15080953,0x1D724E9A,0xA5CE29FF,0xB77B8611,0x0FC7E174,
+    0x9210D9CD,0x2AACBEA8,0x38191146,0x80A57623,0xD8C66675,0x607A0110,
+    0x72CFAEFE,0xCA73C99B,0x57A4F122,0xEF189647,0xFDAD39A9,0x45115ECC,
+    0x764DEE06,0xCEF18963,0xDC44268D,0x64F841E8,0xF92F7951,0x41931E34,
+    0x5326B1DA,0xEB9AD6BF,0xB3F9C6E9,0x0B45A18C,0x19F00E62,0xA14C6907,
+    0x3C9B51BE,0x842736DB,0x96929935,0x2E2EFE50,0x2654B999,0x9EE8DEFC,
+    0x8C5D7112,0x34E11677,0xA9362ECE,0x118A49AB,0x033FE645,0xBB838120,
+    0xE3E09176,0x5B5CF613,0x49E959FD,0xF1553E98,0x6C820621,0xD43E6144,
+    0xC68BCEAA,0x7E37A9CF,0xD67F4138,0x6EC3265D,0x7C7689B3,0xC4CAEED6,
+    0x591DD66F,0xE1A1B10A,0xF3141EE4,0x4BA87981,0x13CB69D7,0xAB770EB2,
+    0xB9C2A15C,0x017EC639,0x9CA9FE80,0x241599E5,0x36A0360B,0x8E1C516E,
+    0x866616A7,0x3EDA71C2,0x2C6FDE2C,0x94D3B949,0x090481F0,0xB1B8E695,
+    0xA30D497B,0x1BB12E1E,0x43D23E48,0xFB6E592D,0xE9DBF6C3,0x516791A6,
+    0xCCB0A91F,0x740CCE7A,0x66B96194,0xDE0506F1
+  },
+  {
+    0x00000000,0x3D6029B0,0x7AC05360,0x47A07AD0,0xF580A6C0,0xC8E08F70,
+    0x8F40F5A0,0xB220DC10,0x30704BC1,0x0D106271,0x4AB018A1,0x77D03111,
+    0xC5F0ED01,0xF890C4B1,0xBF30BE61,0x825097D1,0x60E09782,0x5D80BE32,
+    0x1A20C4E2,0x2740ED52,0x95603142,0xA80018F2,0xEFA06222,0xD2C04B92,
+    0x5090DC43,0x6DF0F5F3,0x2A508F23,0x1730A693,0xA5107A83,0x98705333,
+    0xDFD029E3,0xE2B00053,0xC1C12F04,0xFCA106B4,0xBB017C64,0x866155D4,
+    0x344189C4,0x0921A074,0x4E81DAA4,0x73E1F314,0xF1B164C5,0xCCD14D75,
+    0x8B7137A5,0xB6111E15,0x0431C205,0x3951EBB5,0x7EF19165,0x4391B8D5,
+    0xA121B886,0x9C419136,0xDBE1EBE6,0xE681C256,0x54A11E46,0x69C137F6,
+    0x2E614D26,0x13016496,0x9151F347,0xAC31DAF7,0xEB91A027,0xD6F18997,
+    0x64D15587,0x59B17C37,0x1E1106E7,0x23712F57,0x58F35849,0x659371F9,
+    0x22330B29,0x1F532299,0xAD73FE89,0x9013D739,0xD7B3ADE9,0xEAD38459,
+    0x68831388,0x55E33A38,0x124340E8,0x2F236958,0x9D03B548,0xA0639CF8,
+    0xE7C3E628,0xDAA3CF98,0x3813CFCB,0x0573E67B,0x42D39CAB,0x7FB3B51B,
+    0xCD93690B,0xF0F340BB,0xB7533A6B,0x8A3313DB,0x0863840A,0x3503ADBA,
+    0x72A3D76A,0x4FC3FEDA,0xFDE322CA,0xC0830B7A,0x872371AA,0xBA43581A,
+    0x9932774D,0xA4525EFD,0xE3F2242D,0xDE920D9D,0x6CB2D18D,0x51D2F83D,
+    0x167282ED,0x2B12AB5D,0xA9423C8C,0x9422153C,0xD3826FEC,0xEEE2465C,
+    0x5CC29A4C,0x61A2B3FC,0x2602C92C,0x1B62E09C,0xF9D2E0CF,0xC4B2C97F,
+    0x8312B3AF,0xBE729A1F,0x0C52460F,0x31326FBF,0x7692156F,0x4BF23CDF,
+    0xC9A2AB0E,0xF4C282BE,0xB362F86E,0x8E02D1DE,0x3C220DCE,0x0142247E,
+    0x46E25EAE,0x7B82771E,0xB1E6B092,0x8C869922,0xCB26E3F2,0xF646CA42,
+    0x44661652,0x79063FE2,0x3EA64532,0x03C66C82,0x8196FB53,0xBCF6D2E3,
+    0xFB56A833,0xC6368183,0x74165D93,0x49767423,0x0ED60EF3,0x33B62743,
+    0xD1062710,0xEC660EA0,0xABC67470,0x96A65DC0,0x248681D0,0x19E6A860,
+    0x5E46D2B0,0x6326FB00,0xE1766CD1,0xDC164561,0x9BB63FB1,0xA6D61601,
+    0x14F6CA11,0x2996E3A1,0x6E369971,0x5356B0C1,0x70279F96,0x4D47B626,
+    0x0AE7CCF6,0x3787E546,0x85A73956,0xB8C710E6,0xFF676A36,0xC2074386,
+    0x4057D457,0x7D37FDE7,0x3A978737,0x07F7AE87,0xB5D77297,0x88B75B27,
+    0xCF1721F7,0xF2770847,0x10C70814,0x2DA721A4,0x6A075B74,0x576772C4,
+    0xE547AED4,0xD8278764,0x9F87FDB4,0xA2E7D404,0x20B743D5,0x1DD76A65,
+    0x5A7710B5,0x67173905,0xD537E515,0xE857CCA5,0xAFF7B675,0x92979FC5,
+    0xE915E8DB,0xD475C16B,0x93D5BBBB,0xAEB5920B,0x1C954E1B,0x21F567AB,
+    0x66551D7B,0x5B3534CB,0xD965A31A,0xE4058AAA,0xA3A5F07A,0x9EC5D9CA,
+    0x2CE505DA,0x11852C6A,0x562556BA,0x6B457F0A,0x89F57F59,0xB49556E9,
+    0xF3352C39,0xCE550589,0x7C75D999,0x4115F029,0x06B58AF9,0x3BD5A349,
+    0xB9853498,0x84E51D28,0xC34567F8,0xFE254E48,0x4C059258,0x7165BBE8,
+    0x36C5C138,0x0BA5E888,0x28D4C7DF,0x15B4EE6F,0x521494BF,0x6F74BD0F,
+    0xDD54611F,0xE03448AF,0xA794327F,0x9AF41BCF,0x18A48C1E,0x25C4A5AE,
+    0x6264DF7E,0x5F04F6CE,0xED242ADE,0xD044036E,0x97E479BE,0xAA84500E,
+    0x4834505D,0x755479ED,0x32F4033D,0x0F942A8D,0xBDB4F69D,0x80D4DF2D,
+    0xC774A5FD,0xFA148C4D,0x78441B9C,0x4524322C,0x028448FC,0x3FE4614C,
+    0x8DC4BD5C,0xB0A494EC,0xF704EE3C,0xCA64C78C
+  },
+  {
+    0x00000000,0xCB5CD3A5,0x4DC8A10B,0x869472AE,0x9B914216,0x50CD91B3,
+    0xD659E31D,0x1D0530B8,0xEC53826D,0x270F51C8,0xA19B2366,0x6AC7F0C3,
+    0x77C2C07B,0xBC9E13DE,0x3A0A6170,0xF156B2D5,0x03D6029B,0xC88AD13E,
+    0x4E1EA390,0x85427035,0x9847408D,0x531B9328,0xD58FE186,0x1ED33223,
+    0xEF8580F6,0x24D95353,0xA24D21FD,0x6911F258,0x7414C2E0,0xBF481145,
+    0x39DC63EB,0xF280B04E,0x07AC0536,0xCCF0D693,0x4A64A43D,0x81387798,
+    0x9C3D4720,0x57619485,0xD1F5E62B,0x1AA9358E,0xEBFF875B,0x20A354FE,
+    0xA6372650,0x6D6BF5F5,0x706EC54D,0xBB3216E8,0x3DA66446,0xF6FAB7E3,
+    0x047A07AD,0xCF26D408,0x49B2A6A6,0x82EE7503,0x9FEB45BB,0x54B7961E,
+    0xD223E4B0,0x197F3715,0xE82985C0,0x23755665,0xA5E124CB,0x6EBDF76E,
+    0x73B8C7D6,0xB8E41473,0x3E7066DD,0xF52CB578,0x0F580A6C,0xC404D9C9,
+    0x4290AB67,0x89CC78C2,0x94C9487A,0x5F959BDF,0xD901E971,0x125D3AD4,
+    0xE30B8801,0x28575BA4,0xAEC3290A,0x659FFAAF,0x789ACA17,0xB3C619B2,
+    0x35526B1C,0xFE0EB8B9,0x0C8E08F7,0xC7D2DB52,0x4146A9FC,0x8A1A7A59,
+    0x971F4AE1,0x5C439944,0xDAD7EBEA,0x118B384F,0xE0DD8A9A,0x2B81593F,
+    0xAD152B91,0x6649F834,0x7B4CC88C,0xB0101B29,0x36846987,0xFDD8BA22,
+    0x08F40F5A,0xC3A8DCFF,0x453CAE51,0x8E607DF4,0x93654D4C,0x58399EE9,
+    0xDEADEC47,0x15F13FE2,0xE4A78D37,0x2FFB5E92,0xA96F2C3C,0x6233FF99,
+    0x7F36CF21,0xB46A1C84,0x32FE6E2A,0xF9A2BD8F,0x0B220DC1,0xC07EDE64,
+    0x46EAACCA,0x8DB67F6F,0x90B34FD7,0x5BEF9C72,0xDD7BEEDC,0x16273D79,
+    0xE7718FAC,0x2C2D5C09,0xAAB92EA7,0x61E5FD02,0x7CE0CDBA,0xB7BC1E1F,
+    0x31286CB1,0xFA74BF14,0x1EB014D8,0xD5ECC77D,0x5378B5D3,0x98246676,
+    0x852156CE,0x4E7D856B,0xC8E9F7C5,0x03B52460,0xF2E396B5,0x39BF4510,
+    0xBF2B37BE,0x7477E41B,0x6972D4A3,0xA22E0706,0x24BA75A8,0xEFE6A60D,
+    0x1D661643,0xD63AC5E6,0x50AEB748,0x9BF264ED,0x86F75455,0x4DAB87F0,
+    0xCB3FF55E,0x006326FB,0xF135942E,0x3A69478B,0xBCFD3525,0x77A1E680,
+    0x6AA4D638,0xA1F8059D,0x276C7733,0xEC30A496,0x191C11EE,0xD240C24B,
+    0x54D4B0E5,0x9F886340,0x828D53F8,0x49D1805D,0xCF45F2F3,0x04192156,
+    0xF54F9383,0x3E134026,0xB8873288,0x73DBE12D,0x6EDED195,0xA5820230,
+    0x2316709E,0xE84AA33B,0x1ACA1375,0xD196C0D0,0x5702B27E,0x9C5E61DB,
+    0x815B5163,0x4A0782C6,0xCC93F068,0x07CF23CD,0xF6999118,0x3DC542BD,
+    0xBB513013,0x700DE3B6,0x6D08D30E,0xA65400AB,0x20C07205,0xEB9CA1A0,
+    0x11E81EB4,0xDAB4CD11,0x5C20BFBF,0x977C6C1A,0x8A795CA2,0x41258F07,
+    0xC7B1FDA9,0x0CED2E0C,0xFDBB9CD9,0x36E74F7C,0xB0733DD2,0x7B2FEE77,
+    0x662ADECF,0xAD760D6A,0x2BE27FC4,0xE0BEAC61,0x123E1C2F,0xD962CF8A,
+    0x5FF6BD24,0x94AA6E81,0x89AF5E39,0x42F38D9C,0xC467FF32,0x0F3B2C97,
+    0xFE6D9E42,0x35314DE7,0xB3A53F49,0x78F9ECEC,0x65FCDC54,0xAEA00FF1,
+    0x28347D5F,0xE368AEFA,0x16441B82,0xDD18C827,0x5B8CBA89,0x90D0692C,
+    0x8DD55994,0x46898A31,0xC01DF89F,0x0B412B3A,0xFA1799EF,0x314B4A4A,
+    0xB7DF38E4,0x7C83EB41,0x6186DBF9,0xAADA085C,0x2C4E7AF2,0xE712A957,
+    0x15921919,0xDECECABC,0x585AB812,0x93066BB7,0x8E035B0F,0x455F88AA,
+    0xC3CBFA04,0x089729A1,0xF9C19B74,0x329D48D1,0xB4093A7F,0x7F55E9DA,
+    0x6250D962,0xA90C0AC7,0x2F987869,0xE4C4ABCC
+  },
+  {
+    0x00000000,0xA6770BB4,0x979F1129,0x31E81A9D,0xF44F2413,0x52382FA7,
+    0x63D0353A,0xC5A73E8E,0x33EF4E67,0x959845D3,0xA4705F4E,0x020754FA,
+    0xC7A06A74,0x61D761C0,0x503F7B5D,0xF64870E9,0x67DE9CCE,0xC1A9977A,
+    0xF0418DE7,0x56368653,0x9391B8DD,0x35E6B369,0x040EA9F4,0xA279A240,
+    0x5431D2A9,0xF246D91D,0xC3AEC380,0x65D9C834,0xA07EF6BA,0x0609FD0E,
+    0x37E1E793,0x9196EC27,0xCFBD399C,0x69CA3228,0x582228B5,0xFE552301,
+    0x3BF21D8F,0x9D85163B,0xAC6D0CA6,0x0A1A0712,0xFC5277FB,0x5A257C4F,
+    0x6BCD66D2,0xCDBA6D66,0x081D53E8,0xAE6A585C,0x9F8242C1,0x39F54975,
+    0xA863A552,0x0E14AEE6,0x3FFCB47B,0x998BBFCF,0x5C2C8141,0xFA5B8AF5,
+    0xCBB39068,0x6DC49BDC,0x9B8CEB35,0x3DFBE081,0x0C13FA1C,0xAA64F1A8,
+    0x6FC3CF26,0xC9B4C492,0xF85CDE0F,0x5E2BD5BB,0x440B7579,0xE27C7ECD,
+    0xD3946450,0x75E36FE4,0xB044516A,0x16335ADE,0x27DB4043,0x81AC4BF7,
+    0x77E43B1E,0xD19330AA,0xE07B2A37,0x460C2183,0x83AB1F0D,0x25DC14B9,
+    0x14340E24,0xB2430590,0x23D5E9B7,0x85A2E203,0xB44AF89E,0x123DF32A,
+    0xD79ACDA4,0x71EDC610,0x4005DC8D,0xE672D739,0x103AA7D0,0xB64DAC64,
+    0x87A5B6F9,0x21D2BD4D,0xE47583C3,0x42028877,0x73EA92EA,0xD59D995E,
+    0x8BB64CE5,0x2DC14751,0x1C295DCC,0xBA5E5678,0x7FF968F6,0xD98E6342,
+    0xE86679DF,0x4E11726B,0xB8590282,0x1E2E0936,0x2FC613AB,0x89B1181F,
+    0x4C162691,0xEA612D25,0xDB8937B8,0x7DFE3C0C,0xEC68D02B,0x4A1FDB9F,
+    0x7BF7C102,0xDD80CAB6,0x1827F438,0xBE50FF8C,0x8FB8E511,0x29CFEEA5,
+    0xDF879E4C,0x79F095F8,0x48188F65,0xEE6F84D1,0x2BC8BA5F,0x8DBFB1EB,
+    0xBC57AB76,0x1A20A0C2,0x8816EAF2,0x2E61E146,0x1F89FBDB,0xB9FEF06F,
+    0x7C59CEE1,0xDA2EC555,0xEBC6DFC8,0x4DB1D47C,0xBBF9A495,0x1D8EAF21,
+    0x2C66B5BC,0x8A11BE08,0x4FB68086,0xE9C18B32,0xD82991AF,0x7E5E9A1B,
+    0xEFC8763C,0x49BF7D88,0x78576715,0xDE206CA1,0x1B87522F,0xBDF0599B,
+    0x8C184306,0x2A6F48B2,0xDC27385B,0x7A5033EF,0x4BB82972,0xEDCF22C6,
+    0x28681C48,0x8E1F17FC,0xBFF70D61,0x198006D5,0x47ABD36E,0xE1DCD8DA,
+    0xD034C247,0x7643C9F3,0xB3E4F77D,0x1593FCC9,0x247BE654,0x820CEDE0,
+    0x74449D09,0xD23396BD,0xE3DB8C20,0x45AC8794,0x800BB91A,0x267CB2AE,
+    0x1794A833,0xB1E3A387,0x20754FA0,0x86024414,0xB7EA5E89,0x119D553D,
+    0xD43A6BB3,0x724D6007,0x43A57A9A,0xE5D2712E,0x139A01C7,0xB5ED0A73,
+    0x840510EE,0x22721B5A,0xE7D525D4,0x41A22E60,0x704A34FD,0xD63D3F49,
+    0xCC1D9F8B,0x6A6A943F,0x5B828EA2,0xFDF58516,0x3852BB98,0x9E25B02C,
+    0xAFCDAAB1,0x09BAA105,0xFFF2D1EC,0x5985DA58,0x686DC0C5,0xCE1ACB71,
+    0x0BBDF5FF,0xADCAFE4B,0x9C22E4D6,0x3A55EF62,0xABC30345,0x0DB408F1,
+    0x3C5C126C,0x9A2B19D8,0x5F8C2756,0xF9FB2CE2,0xC813367F,0x6E643DCB,
+    0x982C4D22,0x3E5B4696,0x0FB35C0B,0xA9C457BF,0x6C636931,0xCA146285,
+    0xFBFC7818,0x5D8B73AC,0x03A0A617,0xA5D7ADA3,0x943FB73E,0x3248BC8A,
+    0xF7EF8204,0x519889B0,0x6070932D,0xC6079899,0x304FE870,0x9638E3C4,
+    0xA7D0F959,0x01A7F2ED,0xC400CC63,0x6277C7D7,0x539FDD4A,0xF5E8D6FE,
+    0x647E3AD9,0xC209316D,0xF3E12BF0,0x55962044,0x90311ECA,0x3646157E,
+    0x07AE0FE3,0xA1D90457,0x579174BE,0xF1E67F0A,0xC00E6597,0x66796E23,
+    0xA3DE50AD,0x05A95B19,0x34414184,0x92364A30
+  },
+  {
+    0x00000000,0xCCAA009E,0x4225077D,0x8E8F07E3,0x844A0EFA,0x48E00E64,
+    0xC66F0987,0x0AC50919,0xD3E51BB5,0x1F4F1B2B,0x91C01CC8,0x5D6A1C56,
+    0x57AF154F,0x9B0515D1,0x158A1232,0xD92012AC,0x7CBB312B,0xB01131B5,
+    0x3E9E3656,0xF23436C8,0xF8F13FD1,0x345B3F4F,0xBAD438AC,0x767E3832,
+    0xAF5E2A9E,0x63F42A00,0xED7B2DE3,0x21D12D7D,0x2B142464,0xE7BE24FA,
+    0x69312319,0xA59B2387,0xF9766256,0x35DC62C8,0xBB53652B,0x77F965B5,
+    0x7D3C6CAC,0xB1966C32,0x3F196BD1,0xF3B36B4F,0x2A9379E3,0xE639797D,
+    0x68B67E9E,0xA41C7E00,0xAED97719,0x62737787,0xECFC7064,0x205670FA,
+    0x85CD537D,0x496753E3,0xC7E85400,0x0B42549E,0x01875D87,0xCD2D5D19,
+    0x43A25AFA,0x8F085A64,0x562848C8,0x9A824856,0x140D4FB5,0xD8A74F2B,
+    0xD2624632,0x1EC846AC,0x9047414F,0x5CED41D1,0x299DC2ED,0xE537C273,
+    0x6BB8C590,0xA712C50E,0xADD7CC17,0x617DCC89,0xEFF2CB6A,0x2358CBF4,
+    0xFA78D958,0x36D2D9C6,0xB85DDE25,0x74F7DEBB,0x7E32D7A2,0xB298D73C,
+    0x3C17D0DF,0xF0BDD041,0x5526F3C6,0x998CF358,0x1703F4BB,0xDBA9F425,
+    0xD16CFD3C,0x1DC6FDA2,0x9349FA41,0x5FE3FADF,0x86C3E873,0x4A69E8ED,
+    0xC4E6EF0E,0x084CEF90,0x0289E689,0xCE23E617,0x40ACE1F4,0x8C06E16A,
+    0xD0EBA0BB,0x1C41A025,0x92CEA7C6,0x5E64A758,0x54A1AE41,0x980BAEDF,
+    0x1684A93C,0xDA2EA9A2,0x030EBB0E,0xCFA4BB90,0x412BBC73,0x8D81BCED,
+    0x8744B5F4,0x4BEEB56A,0xC561B289,0x09CBB217,0xAC509190,0x60FA910E,
+    0xEE7596ED,0x22DF9673,0x281A9F6A,0xE4B09FF4,0x6A3F9817,0xA6959889,
+    0x7FB58A25,0xB31F8ABB,0x3D908D58,0xF13A8DC6,0xFBFF84DF,0x37558441,
+    0xB9DA83A2,0x7570833C,0x533B85DA,0x9F918544,0x111E82A7,0xDDB48239,
+    0xD7718B20,0x1BDB8BBE,0x95548C5D,0x59FE8CC3,0x80DE9E6F,0x4C749EF1,
+    0xC2FB9912,0x0E51998C,0x04949095,0xC83E900B,0x46B197E8,0x8A1B9776,
+    0x2F80B4F1,0xE32AB46F,0x6DA5B38C,0xA10FB312,0xABCABA0B,0x6760BA95,
+    0xE9EFBD76,0x2545BDE8,0xFC65AF44,0x30CFAFDA,0xBE40A839,0x72EAA8A7,
+    0x782FA1BE,0xB485A120,0x3A0AA6C3,0xF6A0A65D,0xAA4DE78C,0x66E7E712,
+    0xE868E0F1,0x24C2E06F,0x2E07E976,0xE2ADE9E8,0x6C22EE0B,0xA088EE95,
+    0x79A8FC39,0xB502FCA7,0x3B8DFB44,0xF727FBDA,0xFDE2F2C3,0x3148F25D,
+    0xBFC7F5BE,0x736DF520,0xD6F6D6A7,0x1A5CD639,0x94D3D1DA,0x5879D144,
+    0x52BCD85D,0x9E16D8C3,0x1099DF20,0xDC33DFBE,0x0513CD12,0xC9B9CD8C,
+    0x4736CA6F,0x8B9CCAF1,0x8159C3E8,0x4DF3C376,0xC37CC495,0x0FD6C40B,
+    0x7AA64737,0xB60C47A9,0x3883404A,0xF42940D4,0xFEEC49CD,0x32464953,
+    0xBCC94EB0,0x70634E2E,0xA9435C82,0x65E95C1C,0xEB665BFF,0x27CC5B61,
+    0x2D095278,0xE1A352E6,0x6F2C5505,0xA386559B,0x061D761C,0xCAB77682,
+    0x44387161,0x889271FF,0x825778E6,0x4EFD7878,0xC0727F9B,0x0CD87F05,
+    0xD5F86DA9,0x19526D37,0x97DD6AD4,0x5B776A4A,0x51B26353,0x9D1863CD,
+    0x1397642E,0xDF3D64B0,0x83D02561,0x4F7A25FF,0xC1F5221C,0x0D5F2282,
+    0x079A2B9B,0xCB302B05,0x45BF2CE6,0x89152C78,0x50353ED4,0x9C9F3E4A,
+    0x121039A9,0xDEBA3937,0xD47F302E,0x18D530B0,0x965A3753,0x5AF037CD,
+    0xFF6B144A,0x33C114D4,0xBD4E1337,0x71E413A9,0x7B211AB0,0xB78B1A2E,
+    0x39041DCD,0xF5AE1D53,0x2C8E0FFF,0xE0240F61,0x6EAB0882,0xA201081C,
+    0xA8C40105,0x646E019B,0xEAE10678,0x264B06E6
+  }
+};
 const double ura_value[]={              /* ura max values */
     2.4,3.4,4.85,6.85,9.65,13.65,24.0,48.0,96.0,192.0,384.0,768.0,1536.0,
     3072.0,6144.0
@@ -624,7 +1000,7 @@ extern void satno2id(int sat, char *id)
 
 EXPORT char *sat_id(int sat)
 {
-    static char id[8];
+    static THREADLOCAL char id[8];
 
     satno2id(sat,id);
 
@@ -984,13 +1360,22 @@ extern int getcodepri(int sys, uint8_t code, const char *opt)
 *          int    pos    I      bit position from start of data (bits)
 *          int    len    I      bit length (bits) (len<=32)
 * return : extracted unsigned/signed bits
+* notes  : the bytes covering the field are loaded into a 64-bit word and the
+*          field is extracted by a shift and a mask. no bytes after the field
+*          are accessed. if len>32, the last 32 bits of the field are returned
 *-----------------------------------------------------------------------------*/
 extern uint32_t getbitu(const unsigned char *buff, int pos, int len)
 {
-    unsigned int bits=0;
-    int i;
-    for (i=pos;i<pos+len;i++) bits=(bits<<1)+((buff[i/8]>>(7-i%8))&1u);
-    return bits;
+    const uint8_t *p;
+    uint64_t bits=0;
+    int i,n;
+    
+    if (len<=0) return 0;
+    if (len>32) {pos+=len-32; len=32;}
+    p=buff+pos/8; pos%=8;
+    n=(pos+len+7)/8;
+    for (i=0;i<n;i++) bits=(bits<<8)|p[i];
+    return (uint32_t)(bits>>(n*8-pos-len))&(0xFFFFFFFFu>>(32-len));
 }
 extern int getbits(const uint8_t *buff, int pos, int len)
 {
@@ -1008,37 +1393,71 @@ extern int getbits(const uint8_t *buff, int pos, int len)
 *-----------------------------------------------------------------------------*/
 extern void setbitu(uint8_t *buff, int pos, int len, unsigned int data)
 {
-    unsigned int mask=1u<<(len-1);
-    int i;
+    uint8_t *p;
+    uint64_t bits=0,mask;
+    int i,n,sh;
+    
     if (len<=0||32<len) return;
-    for (i=pos;i<pos+len;i++,mask>>=1) {
-        if (data&mask) buff[i/8]|=1u<<(7-i%8); else buff[i/8]&=~(1u<<(7-i%8));
-    }
+    p=buff+pos/8; pos%=8;
+    n=(pos+len+7)/8;
+    sh=n*8-pos-len;
+    mask=(uint64_t)(0xFFFFFFFFu>>(32-len))<<sh;
+    for (i=0;i<n;i++) bits=(bits<<8)|p[i];
+    bits=(bits&~mask)|(((uint64_t)data<<sh)&mask);
+    for (i=n-1;i>=0;i--,bits>>=8) p[i]=(uint8_t)bits;
 }
 extern void setbits(uint8_t *buff, int pos, int len, int data)
 {
     if (data<0) data|=1<<(len-1); else data&=~(1<<(len-1)); /* set sign bit */
     setbitu(buff,pos,len,(unsigned int)data);
 }
+/* read unsigned/signed bits sequentially --------------------------------------
+* extract unsigned/signed bits at the position of a bit reader and advance it
+* args   : bitr_t *br       IO  bit reader {buff,pos}
+*          int    len       I   bit length (bits) (len<=32)
+* return : extracted unsigned/signed bits
+* notes  : same as getbitu(br->buff,br->pos,len) and br->pos+=len
+*-----------------------------------------------------------------------------*/
+extern uint32_t rdbitu(bitr_t *br, int len)
+{
+    uint32_t bits=getbitu(br->buff,br->pos,len);
+    br->pos+=len;
+    return bits;
+}
+extern int32_t rdbits(bitr_t *br, int len)
+{
+    int32_t bits=getbits(br->buff,br->pos,len);
+    br->pos+=len;
+    return bits;
+}
 /* crc-32 parity ---------------------------------------------------------------
 * compute crc-32 parity for novatel raw
 * args   : unsigned char *buff I data
 *          int    len    I      data length (bytes)
 * return : crc-32 parity
 * notes  : see NovAtel OEMV firmware manual 1.7 32-bit CRC
+*          the polynomial is the reflected crc-32 (POLYCRC32), not the crc-32c
+*          of the SSE4.2 crc32 instruction, so no hardware path is used
 *-----------------------------------------------------------------------------*/
 extern uint32_t rtk_crc32(const uint8_t *buff, int len)
 {
-    unsigned int crc=0;
-    int i,j;
+    unsigned int crc=0,lo,hi;
     
     trace(4,"rtk_crc32: len=%d\n",len);
     
-    for (i=0;i<len;i++) {
-        crc^=buff[i];
-        for (j=0;j<8;j++) {
-            if (crc&1) crc=(crc>>1)^POLYCRC32; else crc>>=1;
-        }
+    /* slicing-by-8: 8 table lookups per 8 bytes */
+    for (;len>=8;len-=8,buff+=8) {
+        lo=crc^((unsigned int)buff[0]|(unsigned int)buff[1]<<8|
+                (unsigned int)buff[2]<<16|(unsigned int)buff[3]<<24);
+        hi=(unsigned int)buff[4]|(unsigned int)buff[5]<<8|
+           (unsigned int)buff[6]<<16|(unsigned int)buff[7]<<24;
+        crc=tbl_CRC32[7][lo&0xFF]^tbl_CRC32[6][(lo>>8)&0xFF]^
+            tbl_CRC32[5][(lo>>16)&0xFF]^tbl_CRC32[4][lo>>24]^
+            tbl_CRC32[3][hi&0xFF]^tbl_CRC32[2][(hi>>8)&0xFF]^
+            tbl_CRC32[1][(hi>>16)&0xFF]^tbl_CRC32[0][hi>>24];
+    }
+    for (;len>0;len--,buff++) {
+        crc=(crc>>8)^tbl_CRC32[0][(crc^*buff)&0xFF];
     }
     return crc;
 }
@@ -1661,6 +2080,221 @@ extern int smoother(const double *xf, const double *Qf, const double *xb,
     free(invQf); free(invQb); free(xx);
     return info;
 }
+/* measurement error covariance ------------------------------------------------
+* measurement error covariance R stored as diagonal, block-diagonal or dense
+* matrix. storage of R->d by type:
+*   RMAT_DIAG : variances (n x 1)
+*   RMAT_BLOCK: blocks (blk[i] x blk[i]) stored one after another, column-major
+*   RMAT_DENSE: full matrix (n x n), column-major
+* notes  : R->d is not freed by rmat_free() if R->nd==0 (borrowed by rmat_wrap())
+*-----------------------------------------------------------------------------*/
+
+/* initialize measurement error covariance -------------------------------------
+* set type and size of R and allocate zero-filled storage
+* args   : rmat_t *R        IO  measurement error covariance
+*          int    type      I   storage type (RMAT_???)
+*          int    n         I   number of measurements
+*          int    *blk      I   block sizes (nb x 1) (RMAT_BLOCK, sum(blk)=n)
+*          int    nb        I   number of blocks (RMAT_BLOCK)
+* return : storage of R (see above)
+*-----------------------------------------------------------------------------*/
+extern double *rmat_init(rmat_t *R, int type, int n, const int *blk, int nb)
+{
+    int i,nd=0;
+
+    R->type=type; R->n=n; R->nb=0;
+
+    if (type==RMAT_DIAG) nd=n;
+    else if (type==RMAT_DENSE) nd=n*n;
+    else {
+        if (R->nbmax<nb) {
+            free(R->blk);
+            R->nbmax=nb;
+            R->blk=imat(nb,1);
+        }
+        for (i=0;i<nb;i++) nd+=SQR(blk[i]);
+        for (i=0;i<nb;i++) R->blk[i]=blk[i];
+        R->nb=nb;
+    }
+    if (R->nd<nd) {
+        if (R->nd>0) free(R->d);
+        R->nd=nd;
+        R->d=mat(nd,1);
+    }
+    for (i=0;i<nd;i++) R->d[i]=0.0;
+    return R->d;
+}
+/* set diagonal measurement error covariance -----------------------------------
+* args   : rmat_t *R        IO  measurement error covariance
+*          double *var      I   variances (n x 1)
+*          int    n         I   number of measurements
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void rmat_setdiag(rmat_t *R, const double *var, int n)
+{
+    if (n<=0) {R->type=RMAT_DIAG; R->n=0; return;}
+    matcpy(rmat_init(R,RMAT_DIAG,n,NULL,0),var,n,1);
+}
+/* wrap dense matrix as measurement error covariance without copy ------------*/
+extern void rmat_wrap(rmat_t *R, const double *A, int n)
+{
+    R->type=RMAT_DENSE; R->n=n; R->nb=R->nbmax=R->nd=0;
+    R->blk=NULL; R->d=(double *)A;
+}
+/* free measurement error covariance -------------------------------------------*/
+extern void rmat_free(rmat_t *R)
+{
+    if (R->nd>0) free(R->d);
+    free(R->blk);
+    R->d=NULL; R->blk=NULL;
+    R->n=R->nb=R->nbmax=R->nd=0;
+}
+/* element of measurement error covariance -------------------------------------
+* args   : rmat_t *R        I   measurement error covariance
+*          int    i,j       I   row and column index
+* return : R(i,j)
+*-----------------------------------------------------------------------------*/
+extern double rmat_get(const rmat_t *R, int i, int j)
+{
+    const double *A=R->d;
+    int b,k=0;
+
+    if (R->type==RMAT_DIAG) return i==j?R->d[i]:0.0;
+    if (R->type==RMAT_DENSE) return R->d[i+j*R->n];
+
+    for (b=0;b<R->nb;k+=R->blk[b],A+=SQR(R->blk[b]),b++) {
+        if (i<k+R->blk[b]) {
+            if (j<k||j>=k+R->blk[b]) return 0.0;
+            return A[(i-k)+(j-k)*R->blk[b]];
+        }
+    }
+    return 0.0;
+}
+/* add measurement error covariance to dense matrix (A=A+R) --------------------
+* args   : rmat_t *R        I   measurement error covariance (n x n)
+*          double *A        IO  dense matrix (n x n)
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void rmat_add(const rmat_t *R, double *A)
+{
+    const double *B=R->d;
+    int i,j,b,k=0,m,n=R->n;
+
+    if (R->type==RMAT_DIAG) {
+        for (i=0;i<n;i++) A[i+i*n]+=R->d[i];
+    }
+    else if (R->type==RMAT_DENSE) {
+        for (i=0;i<n*n;i++) A[i]+=R->d[i];
+    }
+    else {
+        for (b=0;b<R->nb;k+=m,B+=m*m,b++) {
+            m=R->blk[b];
+            for (i=0;i<m;i++) for (j=0;j<m;j++) A[k+i+(k+j)*n]+=B[i+j*m];
+        }
+    }
+}
+/* convert measurement error covariance to dense matrix ----------------------*/
+extern void rmat_todense(const rmat_t *R, double *A)
+{
+    int i;
+
+    for (i=0;i<R->n*R->n;i++) A[i]=0.0;
+    rmat_add(R,A);
+}
+/* multiply matrix by measurement error covariance (B=A*R) ---------------------
+* args   : double *A        I   matrix A (n x m)
+*          int    n         I   number of rows of A
+*          rmat_t *R        I   measurement error covariance (m x m)
+*          double *B        O   B=A*R (n x m)
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void rmat_mulr(const double *A, int n, const rmat_t *R, double *B)
+{
+    const double *C=R->d;
+    double d;
+    int i,j,x,b,k=0,l,m=R->n;
+
+    if (R->type==RMAT_DIAG) {
+        for (j=0;j<m;j++) for (i=0;i<n;i++) B[i+j*n]=A[i+j*n]*R->d[j];
+    }
+    else if (R->type==RMAT_DENSE) {
+        matmul("NN",n,m,m,1.0,A,R->d,0.0,B);
+    }
+    else {
+        for (b=0;b<R->nb;k+=l,C+=l*l,b++) {
+            l=R->blk[b];
+            for (j=0;j<l;j++) for (i=0;i<n;i++) {
+                for (x=0,d=0.0;x<l;x++) d+=A[i+(k+x)*n]*C[x+j*l];
+                B[i+(k+j)*n]=d;
+            }
+        }
+    }
+}
+/* multiply measurement error covariance by matrix (B=R*A) ---------------------
+* args   : rmat_t *R        I   measurement error covariance (m x m)
+*          double *A        I   matrix A (m x n)
+*          int    n         I   number of columns of A
+*          double *B        O   B=R*A (m x n)
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void rmat_mull(const rmat_t *R, const double *A, int n, double *B)
+{
+    const double *C=R->d;
+    double d;
+    int i,j,x,b,k=0,l,m=R->n;
+
+    if (R->type==RMAT_DIAG) {
+        for (j=0;j<n;j++) for (i=0;i<m;i++) B[i+j*m]=R->d[i]*A[i+j*m];
+    }
+    else if (R->type==RMAT_DENSE) {
+        matmul("NN",m,n,m,1.0,R->d,A,0.0,B);
+    }
+    else {
+        for (b=0;b<R->nb;k+=l,C+=l*l,b++) {
+            l=R->blk[b];
+            for (j=0;j<n;j++) for (i=0;i<l;i++) {
+                for (x=0,d=0.0;x<l;x++) d+=C[i+x*l]*A[k+x+j*m];
+                B[k+i+j*m]=d;
+            }
+        }
+    }
+}
+/* diagonal of R*A*R ------------------------------------------------------------
+* args   : rmat_t *R        I   measurement error covariance (m x m)
+*          double *A        I   matrix A (m x m)
+*          double *d        O   diagonal of R*A*R (m x 1)
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void rmat_diagrar(const rmat_t *R, const double *A, double *d)
+{
+    const double *C=R->d;
+    double *T,s;
+    int i,j,x,b,k=0,l,m=R->n;
+
+    if (R->type==RMAT_DIAG) {
+        for (i=0;i<m;i++) d[i]=SQR(R->d[i])*A[i+i*m];
+    }
+    else if (R->type==RMAT_DENSE) {
+        T=mat(m,m);
+        matmul("NN",m,m,m,1.0,A,R->d,0.0,T);
+        for (i=0;i<m;i++) {
+            for (x=0,s=0.0;x<m;x++) s+=R->d[i+x*m]*T[x+i*m];
+            d[i]=s;
+        }
+        free(T);
+    }
+    else {
+        for (b=0;b<R->nb;k+=l,C+=l*l,b++) {
+            l=R->blk[b];
+            for (i=0;i<l;i++) {
+                for (x=0,s=0.0;x<l;x++) for (j=0;j<l;j++) {
+                    s+=C[i+x*l]*A[k+x+(k+j)*m]*C[j+i*l];
+                }
+                d[k+i]=s;
+            }
+        }
+    }
+}
 /* print matrix ----------------------------------------------------------------
 * print matrix to stdout
 * args   : double *A        I   matrix A (n x m)
@@ -1823,6 +2457,45 @@ extern double str2num(const char *s, int i, int n)
     *p='\0';
     return sscanf(str,"%lf",&value)==1?value:0.0;
 }
+/* number to fixed-point string ------------------------------------------------
+* convert number to fixed-point string without printf
+* args   : char   *buff     O   string (null-terminated)
+*          double value     I   number
+*          int    width     I   minimum field width
+*          int    prec      I   number of decimal places
+* return : number of characters (excluding null)
+* notes  : output is the same as sprintf(buff,"%*.*f",width,prec,value).
+*          values near a rounding tie, out of range (>=1E12 after scaling)
+*          and prec>9 are passed to sprintf().
+*-----------------------------------------------------------------------------*/
+extern int fixf2str(char *buff, double value, int width, int prec)
+{
+    static const double scale[]={
+        1E0,1E1,1E2,1E3,1E4,1E5,1E6,1E7,1E8,1E9
+    };
+    char s[32],*q=s+sizeof(s);
+    double a;
+    uint64_t v;
+    int i,n;
+    
+    if (prec<0||prec>9||!((a=fabs(value)*scale[prec])<1E12)||
+        fabs(a-floor(a)-0.5)<1E-3) {
+        return sprintf(buff,"%*.*f",width,prec,value);
+    }
+    v=(uint64_t)(a+0.5);
+    for (i=0;i<prec;i++,v/=10) *--q='0'+(char)(v%10);
+    if (prec>0) *--q='.';
+    do {
+        *--q='0'+(char)(v%10);
+    } while (v/=10);
+    if (signbit(value)) *--q='-';
+    
+    n=(int)(s+sizeof(s)-q);
+    for (i=n;i<width;i++) *buff++=' ';
+    memcpy(buff,q,n);
+    buff[n]='\0';
+    return n<width?width:n;
+}
 /* string to time --------------------------------------------------------------
 * convert substring in string to gtime_t struct
 * args   : char   *s        I   string ("... yyyy mm dd hh mm ss ...")
@@ -2063,9 +2736,9 @@ extern gtime_t timeget(void)
     ep[3]=ts.wHour; ep[4]=ts.wMinute; ep[5]=ts.wSecond+ts.wMilliseconds*1E-3;
 #else
     struct timeval tv;
-    struct tm *tt;
+    struct tm tm,*tt;
     
-    if (!gettimeofday(&tv,NULL)&&(tt=gmtime(&tv.tv_sec))) {
+    if (!gettimeofday(&tv,NULL)&&(tt=gmtime_r(&tv.tv_sec,&tm))) {
         ep[0]=tt->tm_year+1900; ep[1]=tt->tm_mon+1; ep[2]=tt->tm_mday;
         ep[3]=tt->tm_hour; ep[4]=tt->tm_min; ep[5]=tt->tm_sec+tv.tv_usec*1E-6;
     }
@@ -2330,7 +3003,7 @@ extern void time2str(gtime_t t, char *s, int n)
 *-----------------------------------------------------------------------------*/
 extern char *time_str(gtime_t t, int n)
 {
-    static char buff[64];
+    static THREADLOCAL char buff[64];
     time2str(t,buff,n);
     return buff;
 }
@@ -2404,6 +3077,210 @@ extern void sleepms(int ms)
     nanosleep(&ts,NULL);
 #endif
 }
+/* load/store ring buffer pointer with acquire/release ordering --------------*/
+#ifdef WIN32
+static uint32_t load_acq(volatile uint32_t *p)
+{
+    uint32_t v=*p;
+    MemoryBarrier();
+    return v;
+}
+static void store_rel(volatile uint32_t *p, uint32_t v)
+{
+    MemoryBarrier();
+    *p=v;
+}
+#else
+static uint32_t load_acq(volatile uint32_t *p)
+{
+    return __atomic_load_n(p,__ATOMIC_ACQUIRE);
+}
+static void store_rel(volatile uint32_t *p, uint32_t v)
+{
+    __atomic_store_n(p,v,__ATOMIC_RELEASE);
+}
+#endif
+/* initialize ring buffer ------------------------------------------------------
+* initialize single-producer/single-consumer ring buffer
+* args   : ring_t *ring     IO  ring buffer
+*          int    size      I   buffer size (bytes) (rounded up to power of 2)
+* return : status (1:ok,0:memory allocation error)
+* notes  : one thread may call ringwrite() while another thread calls
+*          ringread() without lock. ringinit() and ringfree() must not be
+*          called while the ring is used.
+*-----------------------------------------------------------------------------*/
+extern int ringinit(ring_t *ring, int size)
+{
+    uint32_t n=1024;
+    
+    trace(3,"ringinit: size=%d\n",size);
+    
+    while (n<(uint32_t)size&&n<0x40000000u) n<<=1;
+    ring->wp=ring->rp=0;
+    if (!(ring->buff=(uint8_t *)malloc(n))) {
+        ring->size=0;
+        return 0;
+    }
+    ring->size=n;
+    return 1;
+}
+/* free ring buffer ------------------------------------------------------------
+* free ring buffer
+* args   : ring_t *ring     IO  ring buffer
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void ringfree(ring_t *ring)
+{
+    free(ring->buff);
+    ring->buff=NULL;
+    ring->size=ring->wp=ring->rp=0;
+}
+/* number of bytes in ring buffer ----------------------------------------------
+* number of bytes which can be read by the consumer
+* args   : ring_t *ring     I   ring buffer
+* return : number of bytes
+*-----------------------------------------------------------------------------*/
+extern int ringcount(ring_t *ring)
+{
+    return (int)(load_acq(&ring->wp)-ring->rp);
+}
+/* free space of ring buffer ---------------------------------------------------
+* number of bytes which can be written by the producer
+* args   : ring_t *ring     I   ring buffer
+* return : number of bytes
+*-----------------------------------------------------------------------------*/
+extern int ringspace(ring_t *ring)
+{
+    return (int)(ring->size-(ring->wp-load_acq(&ring->rp)));
+}
+/* write ring buffer -----------------------------------------------------------
+* write data to ring buffer (producer)
+* args   : ring_t  *ring    IO  ring buffer
+*          uint8_t *buff    I   data
+*          int     n        I   data length (bytes)
+* return : number of bytes written (less than n if ring buffer is full)
+* notes  : written data are published to the consumer at once. to pass a
+*          record, check ringspace() and write the whole record by one call.
+*-----------------------------------------------------------------------------*/
+extern int ringwrite(ring_t *ring, const uint8_t *buff, int n)
+{
+    uint32_t wp=ring->wp,i=wp&(ring->size-1),m;
+    int space=ringspace(ring);
+    
+    if (n>space) n=space;
+    if (n<=0) return 0;
+    
+    m=ring->size-i<(uint32_t)n?ring->size-i:(uint32_t)n;
+    memcpy(ring->buff+i,buff,m);
+    memcpy(ring->buff,buff+m,n-m);
+    store_rel(&ring->wp,wp+n);
+    return n;
+}
+/* read ring buffer ------------------------------------------------------------
+* read data from ring buffer (consumer)
+* args   : ring_t  *ring    IO  ring buffer
+*          uint8_t *buff    O   data
+*          int     n        I   buffer size (bytes)
+* return : number of bytes read
+*-----------------------------------------------------------------------------*/
+extern int ringread(ring_t *ring, uint8_t *buff, int n)
+{
+    uint32_t rp=ring->rp,i=rp&(ring->size-1),m;
+    int count=ringcount(ring);
+    
+    if (n>count) n=count;
+    if (n<=0) return 0;
+    
+    m=ring->size-i<(uint32_t)n?ring->size-i:(uint32_t)n;
+    memcpy(buff,ring->buff+i,m);
+    memcpy(buff+m,ring->buff,n-m);
+    store_rel(&ring->rp,rp+n);
+    return n;
+}
+/* initialize thread wakeup event ---------------------------------------------
+* initialize event to wake up a thread waiting by eventwait()
+* args   : event_t *event   IO  event
+* return : none
+* notes  : the event is reset when eventwait() returns. eventset() before
+*          eventwait() is not lost. only one thread may wait on an event.
+*-----------------------------------------------------------------------------*/
+extern void eventinit(event_t *event)
+{
+#ifdef WIN32
+    event->handle=CreateEvent(NULL,FALSE,FALSE,NULL);
+#else
+    pthread_condattr_t attr;
+    
+    pthread_mutex_init(&event->mutex,NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr,CLOCK_MONOTONIC);
+    pthread_cond_init(&event->cond,&attr);
+    pthread_condattr_destroy(&attr);
+    event->flag=0;
+#endif
+}
+/* free thread wakeup event ----------------------------------------------------
+* free event
+* args   : event_t *event   IO  event
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void eventfree(event_t *event)
+{
+#ifdef WIN32
+    CloseHandle(event->handle);
+#else
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->mutex);
+#endif
+}
+/* signal thread wakeup event --------------------------------------------------
+* signal event and wake up the waiting thread
+* args   : event_t *event   IO  event
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void eventset(event_t *event)
+{
+#ifdef WIN32
+    SetEvent(event->handle);
+#else
+    pthread_mutex_lock(&event->mutex);
+    event->flag=1;
+    pthread_cond_signal(&event->cond);
+    pthread_mutex_unlock(&event->mutex);
+#endif
+}
+/* wait thread wakeup event ----------------------------------------------------
+* wait until event is signaled or timeout
+* args   : event_t *event   IO  event
+*          int     timeout  I   timeout (ms) (<=0: no wait)
+* return : status (1:signaled,0:timeout)
+*-----------------------------------------------------------------------------*/
+extern int eventwait(event_t *event, int timeout)
+{
+#ifdef WIN32
+    return WaitForSingleObject(event->handle,timeout>0?timeout:0)==WAIT_OBJECT_0;
+#else
+    struct timespec ts;
+    int stat;
+    
+    if (timeout<0) timeout=0;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    ts.tv_sec+=timeout/1000;
+    ts.tv_nsec+=timeout%1000*1000000L;
+    if (ts.tv_nsec>=1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec-=1000000000L;
+    }
+    pthread_mutex_lock(&event->mutex);
+    while (!event->flag) {
+        if (pthread_cond_timedwait(&event->cond,&event->mutex,&ts)) break;
+    }
+    stat=event->flag;
+    event->flag=0;
+    pthread_mutex_unlock(&event->mutex);
+    return stat;
+#endif
+}
 /* convert degree to deg-min-sec -----------------------------------------------
 * convert degree to degree-minute-second
 * args   : double deg       I   degree
@@ -2734,29 +3611,19 @@ static void nut_iau1980(double t, const double *f, double *dpsi, double *deps)
 *                               (NULL: no output)
 * return : none
 * note   : see ref [3] chap 5
-*          not thread-safe
+*          use astroinit() to share the result among consumers of an epoch
 *-----------------------------------------------------------------------------*/
 extern void eci2ecef(gtime_t tutc, const double *erpv, double *U, double *gmst)
 {
     const double ep2000[]={2000,1,1,12,0,0};
-    static gtime_t tutc_;
-    static double U_[9],gmst_;
     gtime_t tgps;
-    double eps,ze,th,z,t,t2,t3,dpsi,deps,gast,f[5];
+    double eps,ze,th,z,t,t2,t3,dpsi,deps,gast,gmst_,f[5];
     double R1[9],R2[9],R3[9],R[9],W[9],N[9],P[9],NP[9];
-    int i;
     
     trace(4,"eci2ecef: tutc=%s\n",time_str(tutc,3));
     
-    if (fabs(timediff(tutc,tutc_))<0.01) { /* read cache */
-        for (i=0;i<9;i++) U[i]=U_[i];
-        if (gmst) *gmst=gmst_; 
-        return;
-    }
-    tutc_=tutc;
-    
     /* terrestrial time */
-    tgps=utc2gpst(tutc_);
+    tgps=utc2gpst(tutc);
     t=(timediff(tgps,epoch2time(ep2000))+19.0+32.184)/86400.0/36525.0;
     t2=t*t; t3=t2*t;
     
@@ -2779,7 +3646,7 @@ extern void eci2ecef(gtime_t tutc, const double *erpv, double *U, double *gmst)
     matmul("NN",3,3,3,1.0,R ,R3,0.0,N); /* N=Rx(-eps)*Rz(-dspi)*Rx(eps) */
     
     /* greenwich aparent sidereal time (rad) */
-    gmst_=utc2gmst(tutc_,erpv[2]);
+    gmst_=utc2gmst(tutc,erpv[2]);
     gast=gmst_+dpsi*cos(eps);
     gast+=(0.00264*sin(f[4])+0.000063*sin(2.0*f[4]))*AS2R;
     
@@ -2788,9 +3655,7 @@ extern void eci2ecef(gtime_t tutc, const double *erpv, double *U, double *gmst)
     matmul("NN",3,3,3,1.0,R1,R2,0.0,W );
     matmul("NN",3,3,3,1.0,W ,R3,0.0,R ); /* W=Ry(-xp)*Rx(-yp) */
     matmul("NN",3,3,3,1.0,N ,P ,0.0,NP);
-    matmul("NN",3,3,3,1.0,R ,NP,0.0,U_); /* U=W*Rz(gast)*N*P */
-    
-    for (i=0;i<9;i++) U[i]=U_[i];
+    matmul("NN",3,3,3,1.0,R ,NP,0.0,U ); /* U=W*Rz(gast)*N*P */
     if (gmst) *gmst=gmst_; 
     
     trace(5,"gmst=%.12f gast=%.12f\n",gmst_,gast);
@@ -2897,6 +3762,10 @@ static int readantex(const char *file, pcvs_t *pcvs)
             state=1;
         }
         if (strstr(buff+60,"END OF ANTENNA")) {
+            if (pcv.dzen>0.0) {
+                pcv.nzen=(int)floor((pcv.zen2-pcv.zen1)/pcv.dzen+0.5)+1;
+                pcv.nazi=pcv.dazi>0.0?(int)floor(360.0/pcv.dazi+0.5)+1:0;
+            }
             addpcv(&pcv,pcvs);
             state=0;
         }
@@ -3009,6 +3878,63 @@ static int readantex(const char *file, pcvs_t *pcvs)
     
     return 1;
 }
+/* normalized antenna type "ANTENNA RADOME" ---------------------------------*/
+static void pcvkey(const char *type, char *key)
+{
+    char buff[MAXANT],*p,*q=NULL;
+    
+    strncpy(buff,type,MAXANT-1); buff[MAXANT-1]='\0';
+    if (!(p=strtok(buff," "))) {
+        *key='\0';
+        return;
+    }
+    q=strtok(NULL," ");
+    sprintf(key,"%.*s %.*s",MAXANT/2-1,p,MAXANT/2-2,q?q:"NONE");
+}
+/* compare antenna parameter index -------------------------------------------*/
+static int cmppcvkey(const void *p1, const void *p2)
+{
+    const pcvidx_t *q1=(const pcvidx_t *)p1,*q2=(const pcvidx_t *)p2;
+    
+    if (q1->sat!=q2->sat) return q1->sat-q2->sat;
+    return strcmp(q1->key,q2->key);
+}
+static int cmppcvidx(const void *p1, const void *p2)
+{
+    const pcvidx_t *q1=(const pcvidx_t *)p1,*q2=(const pcvidx_t *)p2;
+    int c;
+    
+    if ((c=cmppcvkey(p1,p2))) return c;
+    return q1->i-q2->i;
+}
+/* build antenna parameter index ---------------------------------------------*/
+static int indexpcv(pcvs_t *pcvs)
+{
+    int i,j;
+    
+    free(pcvs->idx); pcvs->idx=NULL; pcvs->nidx=0;
+    
+    if (pcvs->n<=0) return 1;
+    
+    if (!(pcvs->idx=(pcvidx_t *)malloc(sizeof(pcvidx_t)*pcvs->n))) {
+        trace(1,"indexpcv: memory allocation error\n");
+        return 0;
+    }
+    for (i=0;i<pcvs->n;i++) {
+        pcvs->idx[i].sat=pcvs->pcv[i].sat;
+        pcvs->idx[i].i=i;
+        if (pcvs->pcv[i].sat) pcvs->idx[i].key[0]='\0';
+        else pcvkey(pcvs->pcv[i].type,pcvs->idx[i].key);
+    }
+    qsort(pcvs->idx,pcvs->n,sizeof(pcvidx_t),cmppcvidx);
+    
+    for (i=j=0;i<=MAXSAT+1;i++) {
+        while (j<pcvs->n&&pcvs->idx[j].sat<i) j++;
+        pcvs->ofs[i]=j;
+    }
+    pcvs->nidx=pcvs->n;
+    return 1;
+}
 /* read antenna parameters ------------------------------------------------------
 * read antenna parameters
 * args   : char   *file       I   antenna parameter file (antex)
@@ -3018,12 +3944,12 @@ static int readantex(const char *file, pcvs_t *pcvs)
 *          file except for antex is recognized ngs antenna parameters
 *          see reference [3]
 *          only support non-azimuth-depedent parameters
+*          the index for searchpcv() is rebuilt after reading
 *-----------------------------------------------------------------------------*/
 extern int readpcv(const char *file, pcvs_t *pcvs)
 {
-    pcv_t *pcv;
     char *ext;
-    int i,stat;
+    int stat=0;
     
     trace(3,"readpcv: file=%s\n",file);
     
@@ -3035,9 +3961,54 @@ extern int readpcv(const char *file, pcvs_t *pcvs)
     else {
 //        stat=readngspcv(file,pcvs);
     }
+    if (stat) indexpcv(pcvs);
 
     return stat;
 }
+/* free antenna parameters -----------------------------------------------------
+* free antenna parameters and index
+* args   : pcvs_t *pcvs       IO  antenna parameters
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void freepcv(pcvs_t *pcvs)
+{
+    free(pcvs->pcv); pcvs->pcv=NULL; pcvs->n=pcvs->nmax=0;
+    free(pcvs->idx); pcvs->idx=NULL; pcvs->nidx=0;
+}
+/* search antenna parameter by index -----------------------------------------*/
+static pcv_t *searchpcv_idx(int sat, const char *type, gtime_t time,
+                            const pcvs_t *pcvs, int *stat)
+{
+    const pcvidx_t *idx;
+    pcvidx_t key={{0}};
+    pcv_t *pcv;
+    int i;
+    
+    *stat=1;
+    
+    if (sat) {
+        if (sat<0||MAXSAT<sat) return NULL;
+        for (i=pcvs->ofs[sat];i<pcvs->ofs[sat+1];i++) {
+            pcv=pcvs->pcv+pcvs->idx[i].i;
+            if (pcv->ts.time!=0&&timediff(pcv->ts,time)>0.0) continue;
+            if (pcv->te.time!=0&&timediff(pcv->te,time)<0.0) continue;
+            return pcv;
+        }
+        return NULL;
+    }
+    pcvkey(type,key.key);
+    if (!*key.key) return NULL;
+    
+    /* exact antenna and radome (radome NONE if omitted) */
+    idx=(const pcvidx_t *)bsearch(&key,pcvs->idx,pcvs->ofs[1],sizeof(pcvidx_t),
+                                  cmppcvkey);
+    if (!idx) {
+        *stat=0; /* fall back to substring search */
+        return NULL;
+    }
+    while (idx>pcvs->idx&&!cmppcvkey(idx-1,&key)) idx--;
+    return pcvs->pcv+idx->i;
+}
 /* search antenna parameter ----------------------------------------------------
 * read satellite antenna phase center position
 * args   : int    sat         I   satellite number (0: receiver antenna)
@@ -3045,16 +4016,24 @@ extern int readpcv(const char *file, pcvs_t *pcvs)
 *          gtime_t time       I   time to search parameters
 *          pcvs_t *pcvs       IO  antenna parameters
 * return : antenna parameter (NULL: no antenna)
+* notes  : with the index built by readpcv(), satellite antennas are searched
+*          among the entries of the satellite and receiver antennas by the
+*          exact antenna and radome type, before the substring search
 *-----------------------------------------------------------------------------*/
 extern pcv_t *searchpcv(int sat, const char *type, gtime_t time,
                         const pcvs_t *pcvs)
 {
     pcv_t *pcv;
     char buff[MAXANT],*types[2],*p;
-    int i,j,n=0;
+    int i,j,n=0,stat;
     
     trace(4,"searchpcv: sat=%2d type=%s\n",sat,type);
     
+    if (pcvs->idx&&pcvs->nidx==pcvs->n) {
+        pcv=searchpcv_idx(sat,type,time,pcvs,&stat);
+        if (stat) return pcv;
+    }
+
     if (sat) { /* search satellite antenna */
         for (i=0;i<pcvs->n;i++) {
             pcv=pcvs->pcv+i;
@@ -3955,17 +4934,15 @@ extern int geterp(const erp_t *erp, gtime_t time, double *erpv)
         erpv[3]=erp->data[erp->n-1].lod;
         return 1;
     }
-    for (j=0,k=erp->n-1;j<=k;) {
+    for (j=0,k=erp->n-1;j<k-1;) {
         i=(j+k)/2;
-        if (mjd<erp->data[i].mjd) k=i-1;
-        else if(mjd>erp->data[i+1].mjd)j=i+1;
-        else break;
+        if (mjd<erp->data[i].mjd) k=i; else j=i;
     }
-    if (erp->data[i].mjd==erp->data[i+1].mjd) {
+    if (erp->data[j].mjd==erp->data[j+1].mjd) {
         a=0.5;
     }
     else {
-        a=(mjd-erp->data[i+1].mjd)/(erp->data[i].mjd-mjd-erp->data[i+1].mjd);
+        a=(mjd-erp->data[j].mjd)/(erp->data[j+1].mjd-erp->data[j].mjd);
     }
     erpv[0]=(1.0-a)*erp->data[j].xp     +a*erp->data[j+1].xp;
     erpv[1]=(1.0-a)*erp->data[j].yp     +a*erp->data[j+1].yp;
@@ -4338,16 +5315,7 @@ extern void freenav(nav_t *nav, int opt)
 
 extern void matchcposb(int type,const obsd_t *obs,const nav_t *nav,int f,double *cbias,double *pbias)
 {
-    double ep[6]={0};
-    int i,j,sat=obs->sat,code=obs->code[f];
-    if(nav->osbs->dt==0.0) return;
-    if(timediff(obs->time,nav->osbs->tmin)<0.0) return;
-    if(timediff(obs->time,nav->osbs->tmax)>0.0) return;
-    i=(int)(timediff(obs->time,nav->osbs->tmin)/nav->osbs->dt);
-
-    time2epoch(obs->time,ep);
-    *cbias=nav->osbs->sat_osb[i].code[sat-1][code];
-    *pbias=nav->osbs->sat_osb[i].phase[sat-1][code];
+    getosb(nav->osbs,obs->time,obs->sat,obs->code[f],cbias,pbias);
 }
 
 /* correct obs --------------------------------------------------------------*/
@@ -4412,8 +5380,10 @@ extern void getcorrobs(const prcopt_t *popt,const obsd_t *obs,const nav_t *nav,c
             if(obs->L[f]!=0.0) corr_L[f]=obs->L[f]*CLIGHT/frqs[f]-phw*CLIGHT/frqs[f];
             if(popt->modear==ARMODE_PPPAR_ILS&&(popt->arprod>=AR_PROD_OSB_GRM&&popt->arprod<=AR_PROD_OSB_CNT)){
                 if(popt->arprod==AR_PROD_OSB_WHU||popt->arprod==AR_PROD_OSB_COM||popt->arprod==AR_PROD_OSB_SGG){
-                    corr_L[f]-=nav->osbs->sat_osb[0].phase[obs->sat-1][obs->code[f]];
-                    corr_P[f]-=nav->osbs->sat_osb[0].code[obs->sat-1][obs->code[f]];
+                    double cosb=0.0,posb=0.0;
+                    getosb(nav->osbs,nav->osbs->tmin,obs->sat,obs->code[f],&cosb,&posb);
+                    corr_L[f]-=posb;
+                    corr_P[f]-=cosb;
                 }
                 else if(ppp&&popt->modear==ARMODE_PPPAR_ILS&&(popt->arprod==AR_PROD_OSB_GRM||popt->arprod==AR_PROD_OSB_CNT)){
                     double cosb=0.0,posb=0.0;
@@ -4560,6 +5530,8 @@ static int level_trace;       /* level of trace */
 static unsigned int tick_trace=0; /* tick time at traceopen (ms) */
 static gtime_t time_trace={0};  /* time at traceopen */
 static lock_t lock_trace;       /* lock for trace */
+static THREADLOCAL FILE *fp_trace_thr=NULL; /* trace file of thread */
+static THREADLOCAL int off_trace_thr=0; /* trace file off for thread */
 
 static void traceswap(void)
 {
@@ -4604,6 +5576,29 @@ extern void traceclose(void)
     fp_trace=NULL;
     file_trace[0]='\0';
 }
+/* open/close trace file of calling thread ------------------------------------
+* redirect trace output of the calling thread to its own file, so that
+* concurrent processing threads do not interleave their traces
+* args   : char   *file     I   trace file path (NULL or "": no trace file)
+* return : none
+* notes  : messages of level<=2 are still printed to stderr
+*-----------------------------------------------------------------------------*/
+extern void traceopenthr(const char *file)
+{
+    gtime_t time=utc2gpst(timeget());
+    char path[1024]="";
+    
+    traceclosethr();
+    if (file&&*file) reppath(file,path,time,"","");
+    if (*path) fp_trace_thr=fopen(path,"w");
+    off_trace_thr=!fp_trace_thr;
+}
+extern void traceclosethr(void)
+{
+    if (fp_trace_thr) fclose(fp_trace_thr);
+    fp_trace_thr=NULL;
+    off_trace_thr=0;
+}
 extern void tracelevel(int level)
 {
     level_trace=level;
@@ -4633,6 +5628,12 @@ extern void tracestdout(void)
     fp_trace=stdout;
 }
 
+/* trace file of calling thread ----------------------------------------------*/
+static FILE *tracefp(void)
+{
+    if (fp_trace_thr) return fp_trace_thr;
+    return off_trace_thr?NULL:fp_trace;
+}
 extern void trace(int level, const char *format, ...)
 {
     va_list ap;
@@ -4651,27 +5652,27 @@ extern void trace(int level, const char *format, ...)
     //    return;
     //}
 
-    if (!fp_trace||level>level_trace) return;
+    if (!tracefp()||level>level_trace) return;
 
-    traceswap();
-    fprintf(fp_trace,"%d ",level);
-    va_start(ap,format); vfprintf(fp_trace,format,ap); va_end(ap);
-    fflush(fp_trace);
+    if (!fp_trace_thr) traceswap();
+    fprintf(tracefp(),"%d ",level);
+    va_start(ap,format); vfprintf(tracefp(),format,ap); va_end(ap);
+    fflush(tracefp());
 }
 extern void tracet(int level, const char *format, ...)
 {
     va_list ap;
     
-    if (!fp_trace||level>level_trace) return;
-    traceswap();
-    fprintf(fp_trace,"%d %9.3f: ",level,(tickget()-tick_trace)/1000.0);
-    va_start(ap,format); vfprintf(fp_trace,format,ap); va_end(ap);
-    fflush(fp_trace);
+    if (!tracefp()||level>level_trace) return;
+    if (!fp_trace_thr) traceswap();
+    fprintf(tracefp(),"%d %9.3f: ",level,(tickget()-tick_trace)/1000.0);
+    va_start(ap,format); vfprintf(tracefp(),format,ap); va_end(ap);
+    fflush(tracefp());
 }
 extern void tracemat(int level, const double *A, int n, int m, int p, int q)
 {
-    if (!fp_trace||level>1) return;
-//    if (!fp_trace||level>1) return;
+    if (!tracefp()||level>1) return;
+//    if (!tracefp()||level>1) return;
 //    if (level>2) return;
     matfprint(A,n,m,p,q,stderr); fflush(stderr);
 }
@@ -4680,35 +5681,35 @@ extern void traceobs(int level, const obsd_t *obs, int n)
     char str[64],id[16];
     int i;
     
-    if (!fp_trace||level>level_trace) return;
+    if (!tracefp()||level>level_trace) return;
     for (i=0;i<n;i++) {
         time2str(obs[i].time,str,3);
         satno2id(obs[i].sat,id);
-        fprintf(fp_trace," (%2d) %s %-3s rcv%d %13.3f %13.3f %13.3f %13.3f %d %d %d %d %x %x %3.1f %3.1f\n",
+        fprintf(tracefp()," (%2d) %s %-3s rcv%d %13.3f %13.3f %13.3f %13.3f %d %d %d %d %x %x %3.1f %3.1f\n",
               i+1,str,id,obs[i].rcv,obs[i].L[0],obs[i].L[1],obs[i].P[0],
               obs[i].P[1],obs[i].LLI[0],obs[i].LLI[1],obs[i].code[0],
               obs[i].code[1],obs[i].qualL[0],obs[i].qualP[0],obs[i].SNR[0]*0.25,obs[i].SNR[1]*0.25);
     }
-    fflush(fp_trace);
+    fflush(tracefp());
 }
 extern void tracenav(int level, const nav_t *nav)
 {
     char s1[64],s2[64],id[16];
     int i;
     
-    if (!fp_trace||level>level_trace) return;
+    if (!tracefp()||level>level_trace) return;
     for (i=0;i<nav->n;i++) {
         time2str(nav->eph[i].toe,s1,0);
         time2str(nav->eph[i].ttr,s2,0);
         satno2id(nav->eph[i].sat,id);
-        fprintf(fp_trace,"(%3d) %-3s : %s %s %3d %3d %02x\n",i+1,
+        fprintf(tracefp(),"(%3d) %-3s : %s %s %3d %3d %02x\n",i+1,
                 id,s1,s2,nav->eph[i].iode,nav->eph[i].iodc,nav->eph[i].svh);
     }
-    fprintf(fp_trace,"(ion) %9.4e %9.4e %9.4e %9.4e\n",nav->ion_gps[0],
+    fprintf(tracefp(),"(ion) %9.4e %9.4e %9.4e %9.4e\n",nav->ion_gps[0],
             nav->ion_gps[1],nav->ion_gps[2],nav->ion_gps[3]);
-    fprintf(fp_trace,"(ion) %9.4e %9.4e %9.4e %9.4e\n",nav->ion_gps[4],
+    fprintf(tracefp(),"(ion) %9.4e %9.4e %9.4e %9.4e\n",nav->ion_gps[4],
             nav->ion_gps[5],nav->ion_gps[6],nav->ion_gps[7]);
-    fprintf(fp_trace,"(ion) %9.4e %9.4e %9.4e %9.4e\n",nav->ion_gal[0],
+    fprintf(tracefp(),"(ion) %9.4e %9.4e %9.4e %9.4e\n",nav->ion_gal[0],
             nav->ion_gal[1],nav->ion_gal[2],nav->ion_gal[3]);
 }
 extern void tracegnav(int level, const nav_t *nav)
@@ -4716,12 +5717,12 @@ extern void tracegnav(int level, const nav_t *nav)
     char s1[64],s2[64],id[16];
     int i;
     
-    if (!fp_trace||level>level_trace) return;
+    if (!tracefp()||level>level_trace) return;
     for (i=0;i<nav->ng;i++) {
         time2str(nav->geph[i].toe,s1,0);
         time2str(nav->geph[i].tof,s2,0);
         satno2id(nav->geph[i].sat,id);
-        fprintf(fp_trace,"(%3d) %-3s : %s %s %2d %2d %8.3f\n",i+1,
+        fprintf(tracefp(),"(%3d) %-3s : %s %s %2d %2d %8.3f\n",i+1,
                 id,s1,s2,nav->geph[i].frq,nav->geph[i].svh,nav->geph[i].taun*1E6);
     }
 }
@@ -4730,12 +5731,12 @@ extern void tracehnav(int level, const nav_t *nav)
     char s1[64],s2[64],id[16];
     int i;
     
-    if (!fp_trace||level>level_trace) return;
+    if (!tracefp()||level>level_trace) return;
     for (i=0;i<nav->ns;i++) {
         time2str(nav->seph[i].t0,s1,0);
         time2str(nav->seph[i].tof,s2,0);
         satno2id(nav->seph[i].sat,id);
-        fprintf(fp_trace,"(%3d) %-3s : %s %s %2d %2d\n",i+1,
+        fprintf(tracefp(),"(%3d) %-3s : %s %s %2d %2d\n",i+1,
                 id,s1,s2,nav->seph[i].svh,nav->seph[i].sva);
     }
 }
@@ -4744,13 +5745,13 @@ extern void tracepeph(int level, const nav_t *nav)
     char s[64],id[16];
     int i,j;
     
-    if (!fp_trace||level>level_trace) return;
+    if (!tracefp()||level>level_trace) return;
     
     for (i=0;i<nav->ne;i++) {
         time2str(nav->peph[i].time,s,0);
         for (j=0;j<MAXSAT;j++) {
             satno2id(j+1,id);
-            fprintf(fp_trace,"%-3s %d %-3s %13.3f %13.3f %13.3f %13.3f %6.3f %6.3f %6.3f %6.3f\n",
+            fprintf(tracefp(),"%-3s %d %-3s %13.3f %13.3f %13.3f %13.3f %6.3f %6.3f %6.3f %6.3f\n",
                     s,nav->peph[i].index,id,
                     nav->peph[i].pos[j][0],nav->peph[i].pos[j][1],
                     nav->peph[i].pos[j][2],nav->peph[i].pos[j][3]*1E9,
@@ -4764,13 +5765,13 @@ extern void tracepclk(int level, const nav_t *nav)
     char s[64],id[16];
     int i,j;
     
-    if (!fp_trace||level>level_trace) return;
+    if (!tracefp()||level>level_trace) return;
     
     for (i=0;i<nav->nc;i++) {
         time2str(nav->pclk[i].time,s,0);
         for (j=0;j<MAXSAT;j++) {
             satno2id(j+1,id);
-            fprintf(fp_trace,"%-3s %d %-3s %13.3f %6.3f\n",
+            fprintf(tracefp(),"%-3s %d %-3s %13.3f %6.3f\n",
                     s,nav->pclk[i].index,id,
                     nav->pclk[i].clk[j][0]*1E9,nav->pclk[i].std[j][0]*1E9);
         }
@@ -4779,13 +5780,15 @@ extern void tracepclk(int level, const nav_t *nav)
 extern void traceb(int level, const unsigned char *p, int n)
 {
     int i;
-    if (!fp_trace||level>level_trace) return;
-    for (i=0;i<n;i++) fprintf(fp_trace,"%02X%s",*p++,i%8==7?" ":"");
-    fprintf(fp_trace,"\n");
+    if (!tracefp()||level>level_trace) return;
+    for (i=0;i<n;i++) fprintf(tracefp(),"%02X%s",*p++,i%8==7?" ":"");
+    fprintf(tracefp(),"\n");
 }
 #else
 extern void traceopen(const char *file) {}
 extern void traceclose(void) {}
+extern void traceopenthr(const char *file) {}
+extern void traceclosethr(void) {}
 extern void tracelevel(int level) {}
 extern void trace   (int level, const char *format, ...) {}
 extern void tracet  (int level, const char *format, ...) {}
@@ -5246,241 +6249,254 @@ extern double ionppp(const double *pos, const double *azel, double re,
     return 1.0/sqrt(1.0-rp*rp);
 }
 
-static void get_gpt(const double *pos,double dmjd, double *pres, double *temp, double *undu)
+/* gpt coefficients ----------------------------------------------------------*/
+static const double a_geoid[55]={
+        -5.6195e-001,-6.0794e-002,-2.0125e-001,-6.4180e-002,-3.6997e-002,
+        +1.0098e+001,+1.6436e+001,+1.4065e+001,+1.9881e+000,+6.4414e-001,
+        -4.7482e+000,-3.2290e+000,+5.0652e-001,+3.8279e-001,-2.6646e-002,
+        +1.7224e+000,-2.7970e-001,+6.8177e-001,-9.6658e-002,-1.5113e-002,
+        +2.9206e-003,-3.4621e+000,-3.8198e-001,+3.2306e-002,+6.9915e-003,
+        -2.3068e-003,-1.3548e-003,+4.7324e-006,+2.3527e+000,+1.2985e+000,
+        +2.1232e-001,+2.2571e-002,-3.7855e-003,+2.9449e-005,-1.6265e-004,
+        +1.1711e-007,+1.6732e+000,+1.9858e-001,+2.3975e-002,-9.0013e-004,
+        -2.2475e-003,-3.3095e-005,-1.2040e-005,+2.2010e-006,-1.0083e-006,
+        +8.6297e-001,+5.8231e-001,+2.0545e-002,-7.8110e-003,-1.4085e-004,
+        -8.8459e-006,+5.7256e-006,-1.5068e-006,+4.0095e-007,-2.4185e-008 };
+static const double b_geoid[55]={
+        +0.0000e+000,+0.0000e+000,-6.5993e-002,+0.0000e+000,+6.5364e-002,
+        -5.8320e+000,+0.0000e+000,+1.6961e+000,-1.3557e+000,+1.2694e+000,
+        0.0000e+000,-2.9310e+000,+9.4805e-001,-7.6243e-002,+4.1076e-002,
+        +0.0000e+000,-5.1808e-001,-3.4583e-001,-4.3632e-002,+2.2101e-003,
+        -1.0663e-002,+0.0000e+000,+1.0927e-001,-2.9463e-001,+1.4371e-003,
+        -1.1452e-002,-2.8156e-003,-3.5330e-004,+0.0000e+000,+4.4049e-001,
+        +5.5653e-002,-2.0396e-002,-1.7312e-003,+3.5805e-005,+7.2682e-005,
+        +2.2535e-006,+0.0000e+000,+1.9502e-002,+2.7919e-002,-8.1812e-003,
+        +4.4540e-004,+8.8663e-005,+5.5596e-005,+2.4826e-006,+1.0279e-006,
+        +0.0000e+000,+6.0529e-002,-3.5824e-002,-5.1367e-003,+3.0119e-005,
+        -2.9911e-005,+1.9844e-005,-1.2349e-006,-7.6756e-009,+5.0100e-008
+};
+static const double ap_mean[55]={
+        +1.0108e+003,+8.4886e+000,+1.4799e+000,-1.3897e+001,+3.7516e-003,
+        -1.4936e-001,+1.2232e+001,-7.6615e-001,-6.7699e-002,+8.1002e-003,
+        -1.5874e+001,+3.6614e-001,-6.7807e-002,-3.6309e-003,+5.9966e-004,
+        +4.8163e+000,-3.7363e-001,-7.2071e-002,+1.9998e-003,-6.2385e-004,
+        -3.7916e-004,+4.7609e+000,-3.9534e-001,+8.6667e-003,+1.1569e-002,
+        +1.1441e-003,-1.4193e-004,-8.5723e-005,+6.5008e-001,-5.0889e-001,
+        -1.5754e-002,-2.8305e-003,+5.7458e-004,+3.2577e-005,-9.6052e-006,
+        -2.7974e-006,+1.3530e+000,-2.7271e-001,-3.0276e-004,+3.6286e-003,
+        -2.0398e-004,+1.5846e-005,-7.7787e-006,+1.1210e-006,+9.9020e-008,
+        +5.5046e-001,-2.7312e-001,+3.2532e-003,-2.4277e-003,+1.1596e-004,
+        +2.6421e-007,-1.3263e-006,+2.7322e-007,+1.4058e-007,+4.9414e-009
+};
+static const double bp_mean[55]={
+        +0.0000e+000,+0.0000e+000,-1.2878e+000,+0.0000e+000,+7.0444e-001,
+        +3.3222e-001,+0.0000e+000,-2.9636e-001,+7.2248e-003,+7.9655e-003,
+        +0.0000e+000,+1.0854e+000,+1.1145e-002,-3.6513e-002,+3.1527e-003,
+        +0.0000e+000,-4.8434e-001,+5.2023e-002,-1.3091e-002,+1.8515e-003,
+        +1.5422e-004,+0.0000e+000,+6.8298e-001,+2.5261e-003,-9.9703e-004,
+        -1.0829e-003,+1.7688e-004,-3.1418e-005,+0.0000e+000,-3.7018e-001,
+        +4.3234e-002,+7.2559e-003,+3.1516e-004,+2.0024e-005,-8.0581e-006,
+        -2.3653e-006,+0.0000e+000,+1.0298e-001,-1.5086e-002,+5.6186e-003,
+        +3.2613e-005,+4.0567e-005,-1.3925e-006,-3.6219e-007,-2.0176e-008,
+        +0.0000e+000,-1.8364e-001,+1.8508e-002,+7.5016e-004,-9.6139e-005,
+        -3.1995e-006,+1.3868e-007,-1.9486e-007,+3.0165e-010,-6.4376e-010
+};
+static const double ap_amp[55]={
+        -1.0444e-001,+1.6618e-001,-6.3974e-002,+1.0922e+000,+5.7472e-001,
+        -3.0277e-001,-3.5087e+000,+7.1264e-003,-1.4030e-001,+3.7050e-002,
+        +4.0208e-001,-3.0431e-001,-1.3292e-001,+4.6746e-003,-1.5902e-004,
+        +2.8624e+000,-3.9315e-001,-6.4371e-002,+1.6444e-002,-2.3403e-003,
+        +4.2127e-005,+1.9945e+000,-6.0907e-001,-3.5386e-002,-1.0910e-003,
+        -1.2799e-004,+4.0970e-005,+2.2131e-005,-5.3292e-001,-2.9765e-001,
+        -3.2877e-002,+1.7691e-003,+5.9692e-005,+3.1725e-005,+2.0741e-005,
+        -3.7622e-007,+2.6372e+000,-3.1165e-001,+1.6439e-002,+2.1633e-004,
+        +1.7485e-004,+2.1587e-005,+6.1064e-006,-1.3755e-008,-7.8748e-008,
+        -5.9152e-001,-1.7676e-001,+8.1807e-003,+1.0445e-003,+2.3432e-004,
+        +9.3421e-006,+2.8104e-006,-1.5788e-007,-3.0648e-008,+2.6421e-010
+};
+static const double bp_amp[55]={
+        +0.0000e+000,+0.0000e+000,+9.3340e-001,+0.0000e+000,+8.2346e-001,
+        +2.2082e-001,+0.0000e+000,+9.6177e-001,-1.5650e-002,+1.2708e-003,
+        +0.0000e+000,-3.9913e-001,+2.8020e-002,+2.8334e-002,+8.5980e-004,
+        +0.0000e+000,+3.0545e-001,-2.1691e-002,+6.4067e-004,-3.6528e-005,
+        -1.1166e-004,+0.0000e+000,-7.6974e-002,-1.8986e-002,+5.6896e-003,
+        -2.4159e-004,-2.3033e-004,-9.6783e-006,+0.0000e+000,-1.0218e-001,
+        -1.3916e-002,-4.1025e-003,-5.1340e-005,-7.0114e-005,-3.3152e-007,
+        +1.6901e-006,+0.0000e+000,-1.2422e-002,+2.5072e-003,+1.1205e-003,
+        -1.3034e-004,-2.3971e-005,-2.6622e-006,+5.7852e-007,+4.5847e-008,
+        +0.0000e+000,+4.4777e-002,-3.0421e-003,+2.6062e-005,-7.2421e-005,
+        +1.9119e-006,+3.9236e-007,+2.2390e-007,+2.9765e-009,-4.6452e-009
+};
+static const double at_mean[55]={
+        +1.6257e+001,+2.1224e+000,+9.2569e-001,-2.5974e+001,+1.4510e+000,
+        +9.2468e-002,-5.3192e-001,+2.1094e-001,-6.9210e-002,-3.4060e-002,
+        -4.6569e+000,+2.6385e-001,-3.6093e-002,+1.0198e-002,-1.8783e-003,
+        +7.4983e-001,+1.1741e-001,+3.9940e-002,+5.1348e-003,+5.9111e-003,
+        +8.6133e-006,+6.3057e-001,+1.5203e-001,+3.9702e-002,+4.6334e-003,
+        +2.4406e-004,+1.5189e-004,+1.9581e-007,+5.4414e-001,+3.5722e-001,
+        +5.2763e-002,+4.1147e-003,-2.7239e-004,-5.9957e-005,+1.6394e-006,
+        -7.3045e-007,-2.9394e+000,+5.5579e-002,+1.8852e-002,+3.4272e-003,
+        -2.3193e-005,-2.9349e-005,+3.6397e-007,+2.0490e-006,-6.4719e-008,
+        -5.2225e-001,+2.0799e-001,+1.3477e-003,+3.1613e-004,-2.2285e-004,
+        -1.8137e-005,-1.5177e-007,+6.1343e-007,+7.8566e-008,+1.0749e-009
+};
+static const double bt_mean[55]={
+        +0.0000e+000,+0.0000e+000,+1.0210e+000,+0.0000e+000,+6.0194e-001,
+        +1.2292e-001,+0.0000e+000,-4.2184e-001,+1.8230e-001,+4.2329e-002,
+        +0.0000e+000,+9.3312e-002,+9.5346e-002,-1.9724e-003,+5.8776e-003,
+        +0.0000e+000,-2.0940e-001,+3.4199e-002,-5.7672e-003,-2.1590e-003,
+        +5.6815e-004,+0.0000e+000,+2.2858e-001,+1.2283e-002,-9.3679e-003,
+        -1.4233e-003,-1.5962e-004,+4.0160e-005,+0.0000e+000,+3.6353e-002,
+        -9.4263e-004,-3.6762e-003,+5.8608e-005,-2.6391e-005,+3.2095e-006,
+        -1.1605e-006,+0.0000e+000,+1.6306e-001,+1.3293e-002,-1.1395e-003,
+        +5.1097e-005,+3.3977e-005,+7.6449e-006,-1.7602e-007,-7.6558e-008,
+        +0.0000e+000,-4.5415e-002,-1.8027e-002,+3.6561e-004,-1.1274e-004,
+        +1.3047e-005,+2.0001e-006,-1.5152e-007,-2.7807e-008,+7.7491e-009
+};
+static const double at_amp[55]={
+        -1.8654e+000,-9.0041e+000,-1.2974e-001,-3.6053e+000,+2.0284e-002,
+        +2.1872e-001,-1.3015e+000,+4.0355e-001,+2.2216e-001,-4.0605e-003,
+        +1.9623e+000,+4.2887e-001,+2.1437e-001,-1.0061e-002,-1.1368e-003,
+        -6.9235e-002,+5.6758e-001,+1.1917e-001,-7.0765e-003,+3.0017e-004,
+        +3.0601e-004,+1.6559e+000,+2.0722e-001,+6.0013e-002,+1.7023e-004,
+        -9.2424e-004,+1.1269e-005,-6.9911e-006,-2.0886e+000,-6.7879e-002,
+        -8.5922e-004,-1.6087e-003,-4.5549e-005,+3.3178e-005,-6.1715e-006,
+        -1.4446e-006,-3.7210e-001,+1.5775e-001,-1.7827e-003,-4.4396e-004,
+        +2.2844e-004,-1.1215e-005,-2.1120e-006,-9.6421e-007,-1.4170e-008,
+        +7.8720e-001,-4.4238e-002,-1.5120e-003,-9.4119e-004,+4.0645e-006,
+        -4.9253e-006,-1.8656e-006,-4.0736e-007,-4.9594e-008,+1.6134e-009
+};
+static const double bt_amp[55]={
+        +0.0000e+000,+0.0000e+000,-8.9895e-001,+0.0000e+000,-1.0790e+000,
+        -1.2699e-001,+0.0000e+000,-5.9033e-001,+3.4865e-002,-3.2614e-002,
+        +0.0000e+000,-2.4310e-002,+1.5607e-002,-2.9833e-002,-5.9048e-003,
+        +0.0000e+000,+2.8383e-001,+4.0509e-002,-1.8834e-002,-1.2654e-003,
+        -1.3794e-004,+0.0000e+000,+1.3306e-001,+3.4960e-002,-3.6799e-003,
+        -3.5626e-004,+1.4814e-004,+3.7932e-006,+0.0000e+000,+2.0801e-001,
+        +6.5640e-003,-3.4893e-003,-2.7395e-004,+7.4296e-005,-7.9927e-006,
+        -1.0277e-006,+0.0000e+000,+3.6515e-002,-7.4319e-003,-6.2873e-004,
+        -8.2461e-005,+3.1095e-005,-5.3860e-007,-1.2055e-007,-1.1517e-007,
+        +0.0000e+000,+3.1404e-002,+1.5580e-002,-1.1428e-003,+3.3529e-005,
+        +1.0387e-005,-1.9378e-006,-2.7327e-007,+7.5833e-009,-9.2323e-009
+};
+/* spherical harmonics of degree and order 9 ---------------------------------*/
+static void sphharm9(const double *pos, double V[10][10], double W[10][10])
+{
+    double X,Y,Z;
+    int N,M;
+
+    X=cos(pos[0])*cos(pos[1]);
+    Y=cos(pos[0])*sin(pos[1]);
+    Z=sin(pos[0]);
+
+    V[0][0]=1.0;
+    W[0][0]=0.0;
+    V[1][0]=Z*V[0][0];
+    W[1][0]=0.0;
+
+    for (N=2;N<=9;N++) {
+        V[N][0]=((2*N-1)*Z*V[N-1][0]-(N-1)*V[N-2][0])/N;
+        W[N][0]=0.0;
+    }
+    for (M=1;M<=9;M++) {
+        V[M][M]=(2*M-1)*(X*V[M-1][M-1]-Y*W[M-1][M-1]);
+        W[M][M]=(2*M-1)*(X*W[M-1][M-1]+Y*V[M-1][M-1]);
+        if (M<9) {
+            V[M+1][M]=(2*M+1)*Z*V[M][M];
+            W[M+1][M]=(2*M+1)*Z*W[M][M];
+        }
+        for (N=M+2;N<=9;N++) {
+            V[N][M]=((2*N-1)*Z*V[N-1][M]-(N+M-1)*V[N-2][M])/(N-M);
+            W[N][M]=((2*N-1)*Z*W[N-1][M]-(N+M-1)*W[N-2][M])/(N-M);
+        }
+    }
+}
+/* expanded spherical harmonic coefficients with cache -------------------------
+* expand spherical harmonic coefficients of degree and order 9 at station
+* position. the expansions depend only on latitude and longitude, so they are
+* cached per station and reused while the position stays within TOL_SHPOS
+* args   : shcache_t *cache IO  coefficient cache (MAXSHCACHE entries)
+*          double *pos      I   station position {lat,lon,h} (rad,m)
+*          int    nc        I   number of coefficient sets (<=6)
+*          double **a,**b   I   cosine/sine coefficients of sets {a[i][55]}
+* return : expanded coefficients {c[0],...,c[nc-1]}
+*-----------------------------------------------------------------------------*/
+typedef struct {            /* expanded spherical harmonic coefficients type */
+    int valid;              /* valid flag */
+    double lat,lon;         /* latitude/longitude of expansion (rad) */
+    double c[6];            /* expanded coefficients */
+} shcache_t;
+
+static const double *shcoef(shcache_t *cache, const double *pos, int nc,
+                            const double *const *a, const double *const *b)
 {
     double V[10][10],W[10][10];
-    int I,N,M,NMAX,MMAX;
-    double DOY,TEMP0,PRES0,APM,APA,ATM,ATA,HORT,X,Y,Z;
-    double DLAT,DLON,DHGT,PRES,TEMP,UNDU;
-    const double TWOPI=6.283185307179586476925287;
+    int i,j,k,n,m;
 
-    double a_geoid[55] = {
-            -5.6195e-001,-6.0794e-002,-2.0125e-001,-6.4180e-002,-3.6997e-002,
-            +1.0098e+001,+1.6436e+001,+1.4065e+001,+1.9881e+000,+6.4414e-001,
-            -4.7482e+000,-3.2290e+000,+5.0652e-001,+3.8279e-001,-2.6646e-002,
-            +1.7224e+000,-2.7970e-001,+6.8177e-001,-9.6658e-002,-1.5113e-002,
-            +2.9206e-003,-3.4621e+000,-3.8198e-001,+3.2306e-002,+6.9915e-003,
-            -2.3068e-003,-1.3548e-003,+4.7324e-006,+2.3527e+000,+1.2985e+000,
-            +2.1232e-001,+2.2571e-002,-3.7855e-003,+2.9449e-005,-1.6265e-004,
-            +1.1711e-007,+1.6732e+000,+1.9858e-001,+2.3975e-002,-9.0013e-004,
-            -2.2475e-003,-3.3095e-005,-1.2040e-005,+2.2010e-006,-1.0083e-006,
-            +8.6297e-001,+5.8231e-001,+2.0545e-002,-7.8110e-003,-1.4085e-004,
-            -8.8459e-006,+5.7256e-006,-1.5068e-006,+4.0095e-007,-2.4185e-008 };
-    double b_geoid[55]={
-            +0.0000e+000,+0.0000e+000,-6.5993e-002,+0.0000e+000,+6.5364e-002,
-            -5.8320e+000,+0.0000e+000,+1.6961e+000,-1.3557e+000,+1.2694e+000,
-            0.0000e+000,-2.9310e+000,+9.4805e-001,-7.6243e-002,+4.1076e-002,
-            +0.0000e+000,-5.1808e-001,-3.4583e-001,-4.3632e-002,+2.2101e-003,
-            -1.0663e-002,+0.0000e+000,+1.0927e-001,-2.9463e-001,+1.4371e-003,
-            -1.1452e-002,-2.8156e-003,-3.5330e-004,+0.0000e+000,+4.4049e-001,
-            +5.5653e-002,-2.0396e-002,-1.7312e-003,+3.5805e-005,+7.2682e-005,
-            +2.2535e-006,+0.0000e+000,+1.9502e-002,+2.7919e-002,-8.1812e-003,
-            +4.4540e-004,+8.8663e-005,+5.5596e-005,+2.4826e-006,+1.0279e-006,
-            +0.0000e+000,+6.0529e-002,-3.5824e-002,-5.1367e-003,+3.0119e-005,
-            -2.9911e-005,+1.9844e-005,-1.2349e-006,-7.6756e-009,+5.0100e-008
-    };
-    double ap_mean[55]= {
-            +1.0108e+003,+8.4886e+000,+1.4799e+000,-1.3897e+001,+3.7516e-003,
-            -1.4936e-001,+1.2232e+001,-7.6615e-001,-6.7699e-002,+8.1002e-003,
-            -1.5874e+001,+3.6614e-001,-6.7807e-002,-3.6309e-003,+5.9966e-004,
-            +4.8163e+000,-3.7363e-001,-7.2071e-002,+1.9998e-003,-6.2385e-004,
-            -3.7916e-004,+4.7609e+000,-3.9534e-001,+8.6667e-003,+1.1569e-002,
-            +1.1441e-003,-1.4193e-004,-8.5723e-005,+6.5008e-001,-5.0889e-001,
-            -1.5754e-002,-2.8305e-003,+5.7458e-004,+3.2577e-005,-9.6052e-006,
-            -2.7974e-006,+1.3530e+000,-2.7271e-001,-3.0276e-004,+3.6286e-003,
-            -2.0398e-004,+1.5846e-005,-7.7787e-006,+1.1210e-006,+9.9020e-008,
-            +5.5046e-001,-2.7312e-001,+3.2532e-003,-2.4277e-003,+1.1596e-004,
-            +2.6421e-007,-1.3263e-006,+2.7322e-007,+1.4058e-007,+4.9414e-009
-    };
-    double bp_mean[55]= {
-            +0.0000e+000,+0.0000e+000,-1.2878e+000,+0.0000e+000,+7.0444e-001,
-            +3.3222e-001,+0.0000e+000,-2.9636e-001,+7.2248e-003,+7.9655e-003,
-            +0.0000e+000,+1.0854e+000,+1.1145e-002,-3.6513e-002,+3.1527e-003,
-            +0.0000e+000,-4.8434e-001,+5.2023e-002,-1.3091e-002,+1.8515e-003,
-            +1.5422e-004,+0.0000e+000,+6.8298e-001,+2.5261e-003,-9.9703e-004,
-            -1.0829e-003,+1.7688e-004,-3.1418e-005,+0.0000e+000,-3.7018e-001,
-            +4.3234e-002,+7.2559e-003,+3.1516e-004,+2.0024e-005,-8.0581e-006,
-            -2.3653e-006,+0.0000e+000,+1.0298e-001,-1.5086e-002,+5.6186e-003,
-            +3.2613e-005,+4.0567e-005,-1.3925e-006,-3.6219e-007,-2.0176e-008,
-            +0.0000e+000,-1.8364e-001,+1.8508e-002,+7.5016e-004,-9.6139e-005,
-            -3.1995e-006,+1.3868e-007,-1.9486e-007,+3.0165e-010,-6.4376e-010
-    };
-    double ap_amp[55]= {
-            -1.0444e-001,+1.6618e-001,-6.3974e-002,+1.0922e+000,+5.7472e-001,
-            -3.0277e-001,-3.5087e+000,+7.1264e-003,-1.4030e-001,+3.7050e-002,
-            +4.0208e-001,-3.0431e-001,-1.3292e-001,+4.6746e-003,-1.5902e-004,
-            +2.8624e+000,-3.9315e-001,-6.4371e-002,+1.6444e-002,-2.3403e-003,
-            +4.2127e-005,+1.9945e+000,-6.0907e-001,-3.5386e-002,-1.0910e-003,
-            -1.2799e-004,+4.0970e-005,+2.2131e-005,-5.3292e-001,-2.9765e-001,
-            -3.2877e-002,+1.7691e-003,+5.9692e-005,+3.1725e-005,+2.0741e-005,
-            -3.7622e-007,+2.6372e+000,-3.1165e-001,+1.6439e-002,+2.1633e-004,
-            +1.7485e-004,+2.1587e-005,+6.1064e-006,-1.3755e-008,-7.8748e-008,
-            -5.9152e-001,-1.7676e-001,+8.1807e-003,+1.0445e-003,+2.3432e-004,
-            +9.3421e-006,+2.8104e-006,-1.5788e-007,-3.0648e-008,+2.6421e-010
-    };
-    double bp_amp[55]= {
-            +0.0000e+000,+0.0000e+000,+9.3340e-001,+0.0000e+000,+8.2346e-001,
-            +2.2082e-001,+0.0000e+000,+9.6177e-001,-1.5650e-002,+1.2708e-003,
-            +0.0000e+000,-3.9913e-001,+2.8020e-002,+2.8334e-002,+8.5980e-004,
-            +0.0000e+000,+3.0545e-001,-2.1691e-002,+6.4067e-004,-3.6528e-005,
-            -1.1166e-004,+0.0000e+000,-7.6974e-002,-1.8986e-002,+5.6896e-003,
-            -2.4159e-004,-2.3033e-004,-9.6783e-006,+0.0000e+000,-1.0218e-001,
-            -1.3916e-002,-4.1025e-003,-5.1340e-005,-7.0114e-005,-3.3152e-007,
-            +1.6901e-006,+0.0000e+000,-1.2422e-002,+2.5072e-003,+1.1205e-003,
-            -1.3034e-004,-2.3971e-005,-2.6622e-006,+5.7852e-007,+4.5847e-008,
-            +0.0000e+000,+4.4777e-002,-3.0421e-003,+2.6062e-005,-7.2421e-005,
-            +1.9119e-006,+3.9236e-007,+2.2390e-007,+2.9765e-009,-4.6452e-009
-    };
-    double at_mean[55]= {
-            +1.6257e+001,+2.1224e+000,+9.2569e-001,-2.5974e+001,+1.4510e+000,
-            +9.2468e-002,-5.3192e-001,+2.1094e-001,-6.9210e-002,-3.4060e-002,
-            -4.6569e+000,+2.6385e-001,-3.6093e-002,+1.0198e-002,-1.8783e-003,
-            +7.4983e-001,+1.1741e-001,+3.9940e-002,+5.1348e-003,+5.9111e-003,
-            +8.6133e-006,+6.3057e-001,+1.5203e-001,+3.9702e-002,+4.6334e-003,
-            +2.4406e-004,+1.5189e-004,+1.9581e-007,+5.4414e-001,+3.5722e-001,
-            +5.2763e-002,+4.1147e-003,-2.7239e-004,-5.9957e-005,+1.6394e-006,
-            -7.3045e-007,-2.9394e+000,+5.5579e-002,+1.8852e-002,+3.4272e-003,
-            -2.3193e-005,-2.9349e-005,+3.6397e-007,+2.0490e-006,-6.4719e-008,
-            -5.2225e-001,+2.0799e-001,+1.3477e-003,+3.1613e-004,-2.2285e-004,
-            -1.8137e-005,-1.5177e-007,+6.1343e-007,+7.8566e-008,+1.0749e-009
-    };
-    double bt_mean[55]= {
-            +0.0000e+000,+0.0000e+000,+1.0210e+000,+0.0000e+000,+6.0194e-001,
-            +1.2292e-001,+0.0000e+000,-4.2184e-001,+1.8230e-001,+4.2329e-002,
-            +0.0000e+000,+9.3312e-002,+9.5346e-002,-1.9724e-003,+5.8776e-003,
-            +0.0000e+000,-2.0940e-001,+3.4199e-002,-5.7672e-003,-2.1590e-003,
-            +5.6815e-004,+0.0000e+000,+2.2858e-001,+1.2283e-002,-9.3679e-003,
-            -1.4233e-003,-1.5962e-004,+4.0160e-005,+0.0000e+000,+3.6353e-002,
-            -9.4263e-004,-3.6762e-003,+5.8608e-005,-2.6391e-005,+3.2095e-006,
-            -1.1605e-006,+0.0000e+000,+1.6306e-001,+1.3293e-002,-1.1395e-003,
-            +5.1097e-005,+3.3977e-005,+7.6449e-006,-1.7602e-007,-7.6558e-008,
-            +0.0000e+000,-4.5415e-002,-1.8027e-002,+3.6561e-004,-1.1274e-004,
-            +1.3047e-005,+2.0001e-006,-1.5152e-007,-2.7807e-008,+7.7491e-009
-    };
-    double at_amp[55]= {
-            -1.8654e+000,-9.0041e+000,-1.2974e-001,-3.6053e+000,+2.0284e-002,
-            +2.1872e-001,-1.3015e+000,+4.0355e-001,+2.2216e-001,-4.0605e-003,
-            +1.9623e+000,+4.2887e-001,+2.1437e-001,-1.0061e-002,-1.1368e-003,
-            -6.9235e-002,+5.6758e-001,+1.1917e-001,-7.0765e-003,+3.0017e-004,
-            +3.0601e-004,+1.6559e+000,+2.0722e-001,+6.0013e-002,+1.7023e-004,
-            -9.2424e-004,+1.1269e-005,-6.9911e-006,-2.0886e+000,-6.7879e-002,
-            -8.5922e-004,-1.6087e-003,-4.5549e-005,+3.3178e-005,-6.1715e-006,
-            -1.4446e-006,-3.7210e-001,+1.5775e-001,-1.7827e-003,-4.4396e-004,
-            +2.2844e-004,-1.1215e-005,-2.1120e-006,-9.6421e-007,-1.4170e-008,
-            +7.8720e-001,-4.4238e-002,-1.5120e-003,-9.4119e-004,+4.0645e-006,
-            -4.9253e-006,-1.8656e-006,-4.0736e-007,-4.9594e-008,+1.6134e-009
-    };
-    double bt_amp[55]= {
-            +0.0000e+000,+0.0000e+000,-8.9895e-001,+0.0000e+000,-1.0790e+000,
-            -1.2699e-001,+0.0000e+000,-5.9033e-001,+3.4865e-002,-3.2614e-002,
-            +0.0000e+000,-2.4310e-002,+1.5607e-002,-2.9833e-002,-5.9048e-003,
-            +0.0000e+000,+2.8383e-001,+4.0509e-002,-1.8834e-002,-1.2654e-003,
-            -1.3794e-004,+0.0000e+000,+1.3306e-001,+3.4960e-002,-3.6799e-003,
-            -3.5626e-004,+1.4814e-004,+3.7932e-006,+0.0000e+000,+2.0801e-001,
-            +6.5640e-003,-3.4893e-003,-2.7395e-004,+7.4296e-005,-7.9927e-006,
-            -1.0277e-006,+0.0000e+000,+3.6515e-002,-7.4319e-003,-6.2873e-004,
-            -8.2461e-005,+3.1095e-005,-5.3860e-007,-1.2055e-007,-1.1517e-007,
-            +0.0000e+000,+3.1404e-002,+1.5580e-002,-1.1428e-003,+3.3529e-005,
-            +1.0387e-005,-1.9378e-006,-2.7327e-007,+7.5833e-009,-9.2323e-009
-    };
+    for (i=0;i<MAXSHCACHE;i++) {
+        if (cache[i].valid&&fabs(pos[0]-cache[i].lat)<=TOL_SHPOS&&
+            fabs(pos[1]-cache[i].lon)<=TOL_SHPOS) return cache[i].c;
+    }
+    /* replace empty or oldest entry */
+    for (i=0,j=0;i<MAXSHCACHE;i++) {
+        if (!cache[i].valid) {j=i; break;}
+        if (cache[i].valid<cache[j].valid) j=i;
+    }
+    sphharm9(pos,V,W);
 
-    DLAT=pos[0];
-    DLON=pos[1];
-    DHGT=pos[2];
+    for (i=0;i<nc;i++) {
+        cache[j].c[i]=0.0;
+        for (n=0,k=0;n<=9;n++) for (m=0;m<=n;m++,k++) {
+            cache[j].c[i]+=a[i][k]*V[n][m]+b[i][k]*W[n][m];
+        }
+    }
+    for (i=0,k=0;i<MAXSHCACHE;i++) if (cache[i].valid>k) k=cache[i].valid;
+    cache[j].valid=k+1;
+    cache[j].lat=pos[0];
+    cache[j].lon=pos[1];
+    return cache[j].c;
+}
+/* global pressure and temperature model (gpt) ---------------------------------
+* args   : double *pos      I   station position {lat,lon,h} (rad,m)
+*          double dmjd      I   modified julian date
+*          double *pres     O   pressure (hpa)
+*          double *temp     O   temperature (deg-c)
+*          double *undu     O   geoid undulation (m)
+* return : none
+*-----------------------------------------------------------------------------*/
+static void get_gpt(const double *pos,double dmjd, double *pres, double *temp, double *undu)
+{
+    static THREADLOCAL shcache_t cache[MAXSHCACHE];
+    const double *a[]={a_geoid,ap_mean,ap_amp,at_mean,at_amp};
+    const double *b[]={b_geoid,bp_mean,bp_amp,bt_mean,bt_amp};
+    const double TWOPI=6.283185307179586476925287;
+    const double *c;
+    double DOY,HORT;
 
 //      Reference day is 28 January 1980
 //      This is taken from Niell (1996) to be consistent (See References)
 //      For constant values use: doy = 91.3125
     DOY=dmjd-44239+1-28;
 
-//		Define degree n and order m EGM
-    NMAX=MMAX=9;
-
-//      Define unit vector
-    X=cos(DLAT)*cos(DLON);
-    Y=cos(DLAT)*sin(DLON);
-    Z=sin(DLAT);
-
-//      Legendre polynomials
-    V[1-1][1-1] = 1.0;
-    W[1-1][1-1] = 0.0;
-    V[2-1][1-1] = Z * V[1-1][1-1];
-    W[2-1][1-1] = 0.0;
-
-    for (N=2;N<=NMAX;N++) {
-        V[N+1-1][1-1] = ((2*N-1) * Z * V[N-1][1-1] - (N-1) * V[N-1-1][1-1]) / N ;
-        W[N+1-1][1-1] = 0.0;
-    }
-
-    for( M=1;M<=NMAX;M++) {
-        V[M+1-1][M+1-1] = (2*M-1) * (X*V[M-1][M-1] - Y*W[M-1][M-1]);
-        W[M+1-1][M+1-1] = (2*M-1) * (X*W[M-1][M-1] + Y*V[M-1][M-1]);
-        if (M < NMAX) {
-            V[M+2-1][M+1-1] = (2*M+1) * Z * V[M+1-1][M+1-1];
-            W[M+2-1][M+1-1] = (2*M+1) * Z * W[M+1-1][M+1-1];
-        }
-        for (N=M+2;N<=NMAX;N++) {
-            V[N+1-1][M+1-1] = ((2*N-1)*Z*V[N-1][M+1-1] - (N+M-1)*V[N-1-1][M+1-1]) / (N-M);
-            W[N+1-1][M+1-1] = ((2*N-1)*Z*W[N-1][M+1-1] - (N+M-1)*W[N-1-1][M+1-1]) / (N-M);
-        }
-    }
-
-//      Geoidal height
-    UNDU = 0.0;
-    I = 0;
-
-    for (N=0;N<=NMAX;N++) {
-        for (M=0;M<=N;M++) {
-            I = I+1;
-            UNDU = UNDU + (a_geoid[I-1]*V[N+1-1][M+1-1] + b_geoid[I-1]*W[N+1-1][M+1-1]);
-        }
-    }
+//      geoidal height and pressure/temperature coefficients on the geoid
+    c=shcoef(cache,pos,5,a,b);
 
 //      orthometric height
-    HORT = DHGT - UNDU;
-
-//      Surface pressure on the geoid
-    APM = 0.0;
-    APA = 0.0;
-    I = 0;
-
-
-    for (N=0;N<=NMAX;N++) {
-        for (M=0;M<=N;M++) {
-            I = I+1;
-            APM = APM + ( ap_mean[I-1]*V[N+1-1][M+1-1] + bp_mean[I-1]*W[N+1-1][M+1-1] ) ;
-            APA = APA + ( ap_amp[I-1] *V[N+1-1][M+1-1] + bp_amp[I-1] *W[N+1-1][M+1-1] ) ;
-        }
-    }
-
-    PRES0  = APM + APA*cos(DOY/365.25*TWOPI);
-
-//      height correction for pressure
-    PRES = PRES0*pow(1.0-0.0000226*HORT, 5.225);
-
-//      Surface temperature on the geoid
-    ATM = 0.0;
-    ATA = 0.0;
-    I = 0;
-
-    for (N=0;N<=NMAX;N++) {
-        for (M=0;M<=N;M++) {
-            I = I+1;
-            ATM = ATM + (at_mean[I-1]*V[N+1-1][M+1-1] + bt_mean[I-1]*W[N+1-1][M+1-1]);
-            ATA = ATA + (at_amp[I-1] *V[N+1-1][M+1-1] + bt_amp[I-1] *W[N+1-1][M+1-1]);
-        }
-    }
-
-    TEMP0 =  ATM + ATA*cos(DOY/365.25*TWOPI);
+    HORT=pos[2]-c[0];
 
-//      height correction for temperature
-    TEMP = TEMP0 - 0.0065*HORT;
+//      surface pressure on the geoid and height correction for pressure
+    *pres=(c[1]+c[2]*cos(DOY/365.25*TWOPI))*pow(1.0-0.0000226*HORT,5.225);
 
-    *pres=PRES;
-    *temp=TEMP;
-    *undu=UNDU;
+//      surface temperature on the geoid and height correction for temperature
+    *temp=c[3]+c[4]*cos(DOY/365.25*TWOPI)-0.0065*HORT;
+    *undu=c[0];
 }
 
+/* continued fraction of mapping function in single precision --------------*/
+static float mapff(float sinel, float a, float b, float c)
+{
+    return (1.0f+a/(1.0f+b/(1.0f+c)))/(sinel+(a/(sinel+b/(sinel+c))));
+}
 #ifndef IERS_MODEL
 static double interpc(const double coef[], double lat)
 {
@@ -5494,7 +6510,7 @@ static double mapf(double el, double a, double b, double c)
     return (1.0+a/(1.0+b/(1.0+c)))/(sinel+(a/(sinel+b/(sinel+c))));
 }
 static double trpmap_nmf(gtime_t time, const double pos[], const double azel[],
-                  double *mapfw)
+                  int sp, double *mapfw)
 {
     /* ref [5] table 3 */
     /* hydro-ave-a,b,c, hydro-amp-a,b,c, wet-a,b,c at latitude 15,30,45,60,75 */
@@ -5514,6 +6530,7 @@ static double trpmap_nmf(gtime_t time, const double pos[], const double azel[],
     const double aht[]={ 2.53E-5, 5.49E-3, 1.14E-3}; /* height correction */
     
     double y,cosy,ah[3],aw[3],dm,el=azel[1],lat=pos[0]*R2D,hgt=pos[2];
+    float sinel,dmf;
     int i;
     
     if (el<=0.0) {
@@ -5530,6 +6547,12 @@ static double trpmap_nmf(gtime_t time, const double pos[], const double azel[],
         ah[i]=interpc(coef[i  ],lat)-interpc(coef[i+3],lat)*cosy;
         aw[i]=interpc(coef[i+6],lat);
     }
+    if (sp) { /* single-precision continued fractions */
+        sinel=sinf((float)el);
+        dmf=(1.0f/sinel-mapff(sinel,aht[0],aht[1],aht[2]))*(float)(hgt/1E3);
+        if (mapfw) *mapfw=mapff(sinel,aw[0],aw[1],aw[2]);
+        return mapff(sinel,ah[0],ah[1],ah[2])+dmf;
+    }
     /* ellipsoidal height is used instead of height above sea level */
     dm=(1.0/sin(el)-mapf(el,aht[0],aht[1],aht[2]))*hgt/1E3;
     
@@ -5651,7 +6674,8 @@ static double bw_amp[] = {
         +1.885e-07, +5.792e-07, +3.990e-08, +2.000e-08, -5.700e-09
 };
 
-static double tropmap_gmf(gtime_t tt,const double *pos,double elev,double *mapw)
+static double tropmap_gmf(gtime_t tt,const double *pos,double elev,int sp,
+                          double *mapw)
 {
     double maph=0.0;
     double pi = 4 * atan(1.0);
@@ -5662,40 +6686,10 @@ static double tropmap_gmf(gtime_t tt,const double *pos,double elev,double *mapw)
     mjd=time2mjday(tt);
     doy=mjd-44239.0+1.0-28;
 
-    double x=cos(pos[0])*cos(pos[1]);
-    double y=cos(pos[0])*sin(pos[1]);
-    double z=sin(pos[0]);
-
-    int nmax=9;
-
-    double v[20][20]={0.0};
-    double w[20][20]={0.0};
-
-    v[0][0] = 1.0;
-    w[0][0] = 0.0;
-    v[1][0] = z*v[0][0];
-    w[1][0] = 0.0;
-
-    int i = 0, j = 0;
-
-    for (i = 2; i <= nmax; ++i){
-        v[i][0] = ((2 * i - 1)*z*v[i - 1][0] - (i - 1)*v[i - 2][0]) / i;
-        w[i][0] = 0.0;
-    }
-
-    for (j = 1; j <= nmax; ++j){
-        v[j][j] = (2 * j - 1)*(x*v[j - 1][j - 1] - y*w[j - 1][j - 1]);
-        w[j][j] = (2 * j - 1)*(x*w[j - 1][j - 1] + y*v[j - 1][j - 1]);
-        if (j<nmax){
-            v[j + 1][j] = (2 * j + 1)*z*v[j][j];
-            w[j + 1][j] = (2 * j + 1)*z*w[j][j];
-        }
-
-        for (i = j + 2; i <= nmax; ++i){
-            v[i][j] = ((2 * i - 1)*z*v[i - 1][j] - (i + j - 1)*v[i - 2][j]) / (i - j);
-            w[i][j] = ((2 * i - 1)*z*w[i - 1][j] - (i + j - 1)*w[i - 2][j]) / (i - j);
-        }
-    }
+    static THREADLOCAL shcache_t cache[MAXSHCACHE];
+    const double *a[]={ah_mean,ah_amp,aw_mean,aw_amp};
+    const double *b[]={bh_mean,bh_amp,bw_mean,bw_amp};
+    const double *c=shcoef(cache,pos,4,a,b);
 
     double bh = 0.0029;
     double c0h = 0.062;
@@ -5714,21 +6708,17 @@ static double tropmap_gmf(gtime_t tt,const double *pos,double elev,double *mapw)
 
     double ch = c0h + ((cos(doy / 365.250 * 2 * pi + phh) + 1)*c11h / 2 + c10h)*(1 - cos(pos[0]));
 
-    double ahm = 0.0, aha = 0.0;
-    int k = 0;
-
-    for (i = 0; i <= nmax; ++i)
-    {
-        for (j = 0; j <= i; ++j)
-        {
-            k = k + 1;
-            ahm = ahm + (ah_mean[k - 1] * v[i][j] + bh_mean[k - 1] * w[i][j]);
-            aha = aha + (ah_amp[k - 1] * v[i][j] + bh_amp[k - 1] * w[i][j]);
-        }
-    }
+    double ahm = c[0], aha = c[1];
 
     double ah = (ahm + aha*cos(doy / 365.25*2.0*pi))*1e-5;
+    double aw = (c[2] + c[3]*cos(doy / 365.25 * 2 * pi))*1e-5;
 
+    if (sp) { /* single-precision continued fractions */
+        float sinef=sinf((float)elev);
+        *mapw=mapff(sinef,aw,0.00146f,0.04391f);
+        return mapff(sinef,ah,bh,ch)+(1.0f/sinef-mapff(sinef,2.53e-5f,5.49e-3f,
+                     1.14e-3f))*(float)(pos[2]/1000.0);
+    }
     double sine = sin(pi / 2 - zenith);
     double cose = cos(pi / 2 - zenith);
     double beta = bh / (sine + ch);
@@ -5754,22 +6744,6 @@ static double tropmap_gmf(gtime_t tt,const double *pos,double elev,double *mapw)
     double bw = 0.00146;
     double cw = 0.04391;
 
-    double awm = 0.0;
-    double awa = 0.0;
-
-    k = 0;
-    for (i = 0; i <= nmax; ++i)
-    {
-        for (j = 0; j <= i; ++j)
-        {
-            k = k + 1;
-            awm = awm + (aw_mean[k - 1] * v[i][j] + bw_mean[k - 1] * w[i][j]);
-            awa = awa + (aw_amp[k - 1] * v[i][j] + bw_amp[k - 1] * w[i][j]);
-        }
-    }
-
-    double aw = (awm + awa*cos(doy / 365.25 * 2 * pi))*1e-5;
-
     beta = bw / (sine + cw);
     gamma = aw / (sine + beta);
     topcon = (1.0 + aw / (1.0 + bw / (1.0 + cw)));
@@ -5833,15 +6807,18 @@ extern double trop_UNB3(gtime_t t,double *pos,double el,double *ztrpw)
 * args   : gtime_t t        I   time
 *          double *pos      I   receiver position {lat,lon,h} (rad,m)
 *          double *azel     I   azimuth/elevation angle {az,el} (rad)
+*          int    opt       I   options (1:single-precision nmf/gmf kernels)
 *          double *mapfw    IO  wet mapping function (NULL: not output)
 * return : dry mapping function
 * note   : see ref [5] (NMF) and [9] (GMF)
 *          original JGR paper of [5] has bugs in eq.(4) and (5). the corrected
 *          paper is obtained from:
 *          ftp://web.haystack.edu/pub/aen/nmf/NMF_JGR.pdf
+*          single-precision kernels evaluate the continued fractions in float.
+*          the gmf coefficients and the time arguments stay in double
 *-----------------------------------------------------------------------------*/
-extern double tropmapf(const prcopt_t *popt,gtime_t time, const double pos[], const double azel[],
-                       double *mapfw)
+extern double tropmapfx(const prcopt_t *popt, gtime_t time, const double pos[],
+                        const double azel[], int opt, double *mapfw)
 {
     trace(4,"tropmapf: pos=%10.6f %11.6f %6.1f azel=%5.1f %4.1f\n",
           pos[0]*R2D,pos[1]*R2D,pos[2],azel[0]*R2D,azel[1]*R2D);
@@ -5852,10 +6829,10 @@ extern double tropmapf(const prcopt_t *popt,gtime_t time, const double pos[], co
     }
 
     if(popt->tropmap==TROPMAP_NMF){
-        return trpmap_nmf(time,pos,azel,mapfw); /* NMF */
+        return trpmap_nmf(time,pos,azel,opt&1,mapfw); /* NMF */
     }
     else if(popt->tropmap==TROPMAP_GMF){
-        return tropmap_gmf(time,pos,azel[1],mapfw);
+        return tropmap_gmf(time,pos,azel[1],opt&1,mapfw);
     }
     else if(popt->tropmap==TROPMAP_VMF){
         double hg=0.0,Tg=0.0,undug=0.0;
@@ -5864,6 +6841,12 @@ extern double tropmapf(const prcopt_t *popt,gtime_t time, const double pos[], co
     }
     else return 0.0;
 }
+/* troposphere mapping function (double precision) ---------------------------*/
+extern double tropmapf(const prcopt_t *popt,gtime_t time, const double pos[], const double azel[],
+                       double *mapfw)
+{
+    return tropmapfx(popt,time,pos,azel,0,mapfw);
+}
 
 /* troposphere model -----------------------------------------------------------
 * compute tropospheric delay by standard atmosphere and saastamoinen model
@@ -6348,28 +7331,42 @@ static double interpvar0(int nd,double ang,const double *var)
     return var[i]*(1.0+i-ang)+var[i+1]*(ang-i);
 }
 
-static double interpvar1(double azim,double zeni,const pcv_t *pcv,int f)
+static float interpvarf(int nd, float ang, const double *var)
 {
-    double p,q,pcvr=0.0;
-    int izeni,iazim;
-    int i=(int)((pcv->zen2-pcv->zen1)/pcv->dzen)+1;
-
-
-    izeni=(int)((zeni-pcv->zen1)/pcv->dzen);
-    iazim=(int)(azim/pcv->dazi);
+    int i;
 
-    p=zeni/pcv->dzen-izeni;
-    q=azim/pcv->dazi-iazim;
+    ang=ang/5.0f;
+    if (ang>=nd) return (float)var[nd];
+    if (ang<0.0f) return (float)var[0];
+    i=(int)ang;
 
-    double a=pcv->var[f][(iazim+0)*i+(izeni+0)];
-    double b=pcv->var[f][(iazim+0)*i+(izeni+1)];
-    double c=pcv->var[f][(iazim+1)*i+(izeni+0)];
-    double d=pcv->var[f][(iazim+1)*i+(izeni+1)];
-    pcvr=(1.0-p)*(1.0-q)*pcv->var[f][(iazim+0)*i+(izeni+0)]
-         +p*(1.0-q)*pcv->var[f][(iazim+0)*i+(izeni+1)]
-         +q*(1.0-p)*pcv->var[f][(iazim+1)*i+(izeni+0)]
-         +p*q*pcv->var[f][(iazim+1)*i+(izeni+1)];
-    return pcvr;
+    return (float)var[i]*(1.0f+i-ang)+(float)var[i+1]*(ang-i);
+}
+/* bilinear weights of azimuth/zenith pcv grid -------------------------------
+* indices k[4] into pcv->var[f][] and weights w[4] are shared by all
+* frequencies of the antenna. grid is clamped to the zenith/azimuth range
+*----------------------------------------------------------------------------*/
+static void pcvweight(double azim, double zeni, const pcv_t *pcv, int *k,
+                      double *w)
+{
+    double p,q;
+    int nz,na,iz,ia;
+    
+    nz=pcv->nzen>0?pcv->nzen:(int)((pcv->zen2-pcv->zen1)/pcv->dzen)+1;
+    na=pcv->nazi>0?pcv->nazi:(int)(360.0/pcv->dazi)+1;
+    
+    p=(zeni-pcv->zen1)/pcv->dzen;
+    q=azim/pcv->dazi;
+    if (p<0.0) p=0.0; else if (p>nz-1) p=nz-1;
+    if (q<0.0) q=0.0; else if (q>na-1) q=na-1;
+    iz=(int)p; if (iz>=nz-1) iz=nz>1?nz-2:0;
+    ia=(int)q; if (ia>=na-1) ia=na>1?na-2:0;
+    p-=iz; q-=ia;
+    
+    k[0]=ia*nz+iz; k[1]=k[0]+(nz>1?1:0);
+    k[2]=k[0]+(na>1?nz:0); k[3]=k[2]+(nz>1?1:0);
+    w[0]=(1.0-p)*(1.0-q); w[1]=p*(1.0-q);
+    w[2]=(1.0-p)*q;       w[3]=p*q;
 }
 
 /* receiver antenna model ------------------------------------------------------
@@ -6377,23 +7374,71 @@ static double interpvar1(double azim,double zeni,const pcv_t *pcv,int f)
 * args   : pcv_t *pcv       I   antenna phase center parameters
 *          double *azel     I   azimuth/elevation for receiver {az,el} (rad)
 *          int     opt      I   option (0:only offset,1:offset+pcv)
+*                               (+2:single-precision kernels)
 *          double *dant     O   range offsets for each frequency (m)
 * return : none
 * notes  : current version does not support azimuth dependent terms
+*          single-precision kernels evaluate the line-of-sight vector, the
+*          offset projection and the pcv interpolation in float
 *-----------------------------------------------------------------------------*/
+static void antmodelf(int sys, const pcv_t *pcv, const double *del,
+                      const double *azel, int opt, double *dant)
+{
+    const double *var;
+    float e[3],cosel=cosf((float)azel[1]),w[4]={0},pcvv=0.0f,d;
+    double wd[4];
+    int i,j,ii=0,ip=-1,k[4]={0};
+
+    e[0]=sinf((float)azel[0])*cosel;
+    e[1]=cosf((float)azel[0])*cosel;
+    e[2]=sinf((float)azel[1]);
+
+    if (pcv->dazi!=0.0) {
+        pcvweight(azel[0]*R2D,90-azel[1]*R2D,pcv,k,wd);
+        for (j=0;j<4;j++) w[j]=(float)wd[j];
+    }
+    for (i=0;i<NFREQ;i++) {
+        if (sys==SYS_GPS||sys==SYS_CMP||sys==SYS_GAL||sys==SYS_QZS) {
+            ii=i>=2?1:i;
+        }
+        else if (sys==SYS_GLO) {
+            ii=i+NFREQ>=2?1+NFREQ:i+NFREQ;
+        }
+        if (ii!=ip) {
+            var=pcv->var[ii];
+            if (pcv->dazi!=0.0) {
+                pcvv=w[0]*(float)var[k[0]]+w[1]*(float)var[k[1]]+
+                     w[2]*(float)var[k[2]]+w[3]*(float)var[k[3]];
+            }
+            else {
+                pcvv=(opt&1)?interpvarf(0,90.0f-(float)(azel[1]*R2D),var):0.0f;
+            }
+            ip=ii;
+        }
+        for (j=0,d=pcvv;j<3;j++) d-=(float)(pcv->off[ii][j]+del[j])*e[j];
+        dant[i]=d;
+    }
+}
 extern void antmodel(int sat,const pcv_t *pcv, const double *del, const double *azel,
                      int opt, double *dant)
 {
-    double e[3],off[3],cosel=cos(azel[1]);
-    int i,j,sys,ii=0;
+    const double *var;
+    double e[3],off[3],cosel=cos(azel[1]),w[4]={0},pcvv=0.0;
+    int i,j,sys,ii=0,ip=-1,k[4]={0};
 
     trace(4,"antmodel: azel=%6.1f %4.1f opt=%d\n",azel[0]*R2D,azel[1]*R2D,opt);
     
+    if (opt&2) {
+        antmodelf(satsys(sat,NULL),pcv,del,azel,opt,dant);
+        return;
+    }
     e[0]=sin(azel[0])*cosel;
     e[1]=cos(azel[0])*cosel;
     e[2]=sin(azel[1]);
 
     sys=satsys(sat,NULL);
+    
+    if (pcv->dazi!=0.0) pcvweight(azel[0]*R2D,90-azel[1]*R2D,pcv,k,w);
 
     for(i=0;i<NFREQ;i++){
         if(sys==SYS_GPS||sys==SYS_CMP||sys==SYS_GAL||sys==SYS_QZS){
@@ -6405,14 +7450,17 @@ extern void antmodel(int sat,const pcv_t *pcv, const double *del, const double *
             if(ii>=2) ii=1+NFREQ;
         }
         for(j=0;j<3;j++) off[j]=pcv->off[ii][j]+del[j];
-        if(pcv->dazi!=0.0){
-            double a=-dot(off,e,3);
-            double b=interpvar1(azel[0]*R2D,90-azel[1]*R2D,pcv,ii);
-            dant[i]=-dot(off,e,3)+interpvar1(azel[0]*R2D,90-azel[1]*R2D,pcv,ii);
-        }
-        else{
-            dant[i]=-dot(off,e,3)+(opt?interpvar0(0,90-azel[1]*R2D,pcv->var[ii]):0.0);
+        if (ii!=ip) { /* frequencies above L2 share the L2 pcv */
+            var=pcv->var[ii];
+            if(pcv->dazi!=0.0){
+                pcvv=w[0]*var[k[0]]+w[1]*var[k[1]]+w[2]*var[k[2]]+w[3]*var[k[3]];
+            }
+            else{
+                pcvv=(opt&1)?interpvar0(0,90-azel[1]*R2D,var):0.0;
+            }
+            ip=ii;
         }
+        dant[i]=-dot(off,e,3)+pcvv;
     }
 
 
@@ -6526,6 +7574,66 @@ extern void sunmoonpos(gtime_t tutc, const double *erpv, double *rsun,
     if (rmoon) matmul("NN",3,1,3,1.0,U,rm,0.0,rmoon);
     if (gmst ) *gmst=gmst_;
 }
+/* initialize astronomical context --------------------------------------------
+* compute sun/moon position and earth orientation once for an epoch
+* args   : gtime_t tutc     I   reference time in utc
+*          double *erpv     I   erp value {xp,yp,ut1_utc,lod} (rad,rad,s,s/d)
+*          astro_t *ast     O   astronomical context
+* return : none
+* notes  : sun/moon rates are derived by differencing over DTASTRO and are
+*          used by astrosunmoon() to move the context to nearby time tags
+*          (satellite transmission time etc.)
+*-----------------------------------------------------------------------------*/
+extern void astroinit(gtime_t tutc, const double *erpv, astro_t *ast)
+{
+    double rs[3],rm[3],gmst;
+    int i;
+    
+    trace(4,"astroinit: tutc=%s\n",time_str(tutc,3));
+    
+    ast->tutc=tutc;
+    for (i=0;i<5;i++) ast->erpv[i]=erpv[i];
+    
+    eci2ecef(tutc,erpv,ast->U,&ast->gmst);
+    sunmoonpos_eci(timeadd(tutc,erpv[2]),rs,rm);
+    matmul("NN",3,1,3,1.0,ast->U,rs,0.0,ast->rsun );
+    matmul("NN",3,1,3,1.0,ast->U,rm,0.0,ast->rmoon);
+    
+    sunmoonpos(timeadd(tutc,DTASTRO),erpv,rs,rm,&gmst);
+    for (i=0;i<3;i++) {
+        ast->vsun [i]=(rs[i]-ast->rsun [i])/DTASTRO;
+        ast->vmoon[i]=(rm[i]-ast->rmoon[i])/DTASTRO;
+    }
+}
+/* sun and moon position from astronomical context -----------------------------
+* get sun and moon position in ecef at a time near the context epoch
+* args   : astro_t *ast     I   astronomical context (NULL: not used)
+*          gtime_t tutc     I   time in utc
+*          double *erpv     I   erp value used without context or out of
+*                               MAXDTASTRO {xp,yp,ut1_utc,lod} (rad,rad,s,s/d)
+*          double *rsun     IO  sun position in ecef  (m) (NULL: not output)
+*          double *rmoon    IO  moon position in ecef (m) (NULL: not output)
+*          double *gmst     O   gmst (rad) (NULL: not output)
+* return : none
+* notes  : within MAXDTASTRO of the context epoch the positions are
+*          extrapolated linearly, otherwise sunmoonpos() is called
+*-----------------------------------------------------------------------------*/
+extern void astrosunmoon(const astro_t *ast, gtime_t tutc, const double *erpv,
+                         double *rsun, double *rmoon, double *gmst)
+{
+    double dt;
+    int i;
+    
+    if (!ast||fabs(dt=timediff(tutc,ast->tutc))>MAXDTASTRO) {
+        sunmoonpos(tutc,erpv,rsun,rmoon,gmst);
+        return;
+    }
+    for (i=0;i<3;i++) {
+        if (rsun ) rsun [i]=ast->rsun [i]+ast->vsun [i]*dt;
+        if (rmoon) rmoon[i]=ast->rmoon[i]+ast->vmoon[i]*dt;
+    }
+    if (gmst) *gmst=ast->gmst+OMGE*dt;
+}
 /* carrier smoothing -----------------------------------------------------------
 * carrier smoothing by Hatch filter
 * args   : obs_t  *obs      IO  raw observation data/smoothed observation data
@@ -41,6 +41,7 @@
 *           2016/08/20 1.22 fix bug on ddres() function
 *           2018/10/10 1.13 support api change of satexclude()
 *           2018/12/15 1.14 disable ambiguity resolution for gps-qzss
+*           2026/10/18 1.15 add format arg to rtkopenstat() for binary status
 *-----------------------------------------------------------------------------*/
 #include <stdarg.h>
 #include "rtklib.h"
@@ -101,6 +102,7 @@ extern int resamb_TCAR(rtk_t *rtk, const obsd_t *obs, const int *sat,
 
 /* global variables ----------------------------------------------------------*/
 static int statlevel=0;          /* rtk status output level (0:off) */
+static int statbin=0;            /* rtk status binary format (0:text,1:binary) */
 static FILE *fp_stat=NULL;       /* rtk status file pointer */
 static FILE *fp_wl_fcb=NULL;
 static FILE *fp_nl_fcb=NULL;
@@ -117,6 +119,7 @@ extern int iamb_ppk(const prcopt_t *opt,int sat,int f)
 * open solution status file and set output level
 * args   : char     *file   I   rtk status file
 *          int      level   I   rtk status level (0: off)
+*          int      format  I   rtk status format (SOLF_BIN: binary, else text)
 * return : status (1:ok,0:error)
 * notes  : file can constain time keywords (%Y,%y,%m...) defined in reppath().
 *          The time to replace keywords is based on UTC of CPU time.
@@ -186,19 +189,24 @@ extern int iamb_ppk(const prcopt_t *opt,int sat,int f)
 *          bias_var : variance of phase bias
 *          lambda   : wavelength
 *
+*   with format SOLF_BIN, the status file consists of binary records of the
+*   solution (type 1) followed by binary records of $SAT (type 2). see
+*   outsolbs() and outsolstatbs() for the record formats.
+*
 *-----------------------------------------------------------------------------*/
-extern int rtkopenstat(const char *file, int level)
+extern int rtkopenstat(const char *file, int level, int format)
 {
     gtime_t time=utc2gpst(timeget());
     char path[1024];
     
-    trace(3,"rtkopenstat: file=%s level=%d\n",file,level);
+    trace(3,"rtkopenstat: file=%s level=%d format=%d\n",file,level,format);
     
     if (level<=0) return 0;
     
     reppath(file,path,time,"","");
+    statbin=format==SOLF_BIN;
     
-    if (!(fp_stat=fopen(path,"w"))) {
+    if (!(fp_stat=fopen(path,statbin?"wb":"w"))) {
         trace(1,"rtkopenstat: file open error path=%s\n",path);
         return 0;
     }
@@ -241,6 +249,7 @@ extern void rtkclosestat(void)
     fp_stat=NULL;
     file_stat[0]='\0';
     statlevel=0;
+    statbin=0;
 }
 /* write solution status to buffer -------------------------------------------*/
 extern int rtkoutstat(rtk_t *rtk, char *buff)
@@ -346,13 +355,55 @@ static void swapsolstat(void)
     }
     if (fp_stat) fclose(fp_stat);
     
-    if (!(fp_stat=fopen(path,"w"))) {
+    if (!(fp_stat=fopen(path,statbin?"wb":"w"))) {
         trace(2,"swapsolstat: file open error path=%s\n",path);
         return;
     }
     trace(3,"swapsolstat: path=%s\n",path);
 }
-
+/* output binary solution status ---------------------------------------------*/
+static void outsolstatb(rtk_t *rtk)
+{
+    ssat_t *ssat;
+    solstat_t stat={{0}};
+    uint8_t buff[MAXSOLMSG];
+    int i,j,k,n,nfreq,nf=NF(&rtk->opt),ppp;
+    
+    n=outsolbs(buff,&rtk->sol);
+    fwrite(buff,n,1,fp_stat);
+    
+    if (rtk->sol.stat==SOLQ_NONE||statlevel<=1) return;
+    
+    nfreq=rtk->opt.mode>=PMODE_DGPS?nf:1;
+    ppp=(rtk->opt.mode>=PMODE_PPP_KINEMA&&rtk->opt.mode<=PMODE_PPP_FIXED)||rtk->opt.mode==PMODE_LC_PPP||rtk->opt.mode==PMODE_TC_PPP;
+    stat.time=rtk->sol.time;
+    
+    for (i=0;i<MAXSAT;i++) {
+        ssat=rtk->ssat+i;
+        if (!ssat->vs) continue;
+        stat.sat=(uint8_t)(i+1);
+        stat.az=(float)ssat->azel[0];
+        stat.el=(float)ssat->azel[1];
+        for (j=0;j<nfreq;j++) {
+            k=(ppp?iamb_ppp(&rtk->opt,i+1,j):IB(i+1,j,&rtk->opt));
+            stat.frq  =(uint8_t)(j+1);
+            stat.resp =(float)ssat->resp[j];
+            stat.resc =(float)ssat->resc[j];
+            stat.flag =(uint8_t)((ssat->vsat[j]<<5)+((ssat->slip[j]&3)<<3)+ssat->fix[j]);
+            stat.snr  =(uint8_t)ssat->snr[j];
+            stat.lock =(uint16_t)ssat->lock[j];
+            stat.outc =(uint16_t)ssat->outc[j];
+            stat.slipc=(uint16_t)ssat->slipc[j];
+            stat.rejc =(uint16_t)ssat->rejc[j];
+            stat.amb  =(float)rtk->x[k];
+            stat.var_amb=(float)SQRT(rtk->P[k+k*rtk->nx]);
+            stat.nv_cp=(float)ssat->norm_v[0][j];
+            stat.nv_pr=(float)ssat->norm_v[1][j];
+            n=outsolstatbs(buff,&stat);
+            fwrite(buff,n,1,fp_stat);
+        }
+    }
+}
 /* output solution status ----------------------------------------------------*/
 static void outsolstat(rtk_t *rtk,const nav_t *nav,const obsd_t *obs,int nobs)
 {
@@ -367,6 +418,11 @@ static void outsolstat(rtk_t *rtk,const nav_t *nav,const obsd_t *obs,int nobs)
     
     /* swap solution status file */
     swapsolstat();
+    
+    if (statbin) {
+        outsolstatb(rtk);
+        return;
+    }
 
 #if 1
     /* write solution status */
@@ -1367,7 +1423,7 @@ static int zdres(int base, const obsd_t *obs, int n, const double *rs,
 
     /* adjust rcvr pos for earth tide correction */
     if (opt->tidecorr) {
-        tidedisp(gpst2utc(obs[0].time),rr_,opt->tidecorr,&nav->erp,
+        tidedisp(gpst2utc(obs[0].time),rr_,opt->tidecorr,&nav->erp,NULL,
                  opt->odisp[base],disp);
         for (i=0;i<3;i++) rr_[i]+=disp[i];
     }
@@ -1446,6 +1502,23 @@ extern void ddcov(const int *nb, int n, const double *Ri, const double *Rj,
     }
     trace(5,"R=\n"); tracemat(5,R,nv,nv,8,6);
 }
+/* double-differenced measurement error covariance as per-group blocks -------
+* same as ddcov() but R is stored block-diagonal (one block per group)       */
+extern void ddcov_rmat(const int *nb, int n, const double *Ri, const double *Rj,
+                       int nv, rmat_t *R)
+{
+    double *A;
+    int i,j,k=0,b;
+
+    trace(3,"ddcov_rmat: n=%d\n",n);
+
+    A=rmat_init(R,RMAT_BLOCK,nv,nb,n);
+    for (b=0;b<n;k+=nb[b],A+=nb[b]*nb[b],b++) {
+        for (i=0;i<nb[b];i++) for (j=0;j<nb[b];j++) {
+            A[i+j*nb[b]]=Ri[k+i]+(i==j?Rj[k+i]:0.0);
+        }
+    }
+}
 /* baseline length constraint ------------------------------------------------*/
 static int constbl(rtk_t *rtk, const double *x, const double *P, double *v,
                    double *H, double *Ri, double *Rj, int index)
@@ -1882,10 +1955,10 @@ static int ddres(int post,rtk_t *rtk, const nav_t *nav, const obsd_t *obs, doubl
 static double intpres(gtime_t time, const obsd_t *obs, int n, const nav_t *nav,
                       rtk_t *rtk, double *y)
 {
-    static obsd_t obsb[MAXOBS];
-    static double yb[MAXOBS*NFREQ*2],rs[MAXOBS*6],dts[MAXOBS*2],var[MAXOBS];
-    static double e[MAXOBS*3],azel[MAXOBS*2],freq[MAXOBS*NFREQ];
-    static int nb=0,svh[MAXOBS*2];
+    static THREADLOCAL obsd_t obsb[MAXOBS];
+    static THREADLOCAL double yb[MAXOBS*NFREQ*2],rs[MAXOBS*6],dts[MAXOBS*2],var[MAXOBS];
+    static THREADLOCAL double e[MAXOBS*3],azel[MAXOBS*2],freq[MAXOBS*NFREQ];
+    static THREADLOCAL int nb=0,svh[MAXOBS*2];
     prcopt_t *opt=&rtk->opt;
     double tt=timediff(time,obs[0].time),ttb,*p,*q;
     int i,j,k,nf=NF(opt);
@@ -1899,7 +1972,7 @@ static double intpres(gtime_t time, const obsd_t *obs, int n, const nav_t *nav,
     ttb=timediff(time,obsb[0].time);
     if (fabs(ttb)>opt->maxtdiff*2.0||ttb==tt) return tt;
     
-    satposs(&rtk->opt,time,obsb,nb,nav,opt->sateph,rs,dts,var,svh);
+    satposs(&rtk->opt,time,obsb,nb,nav,&rtk->ast,opt->sateph,rs,dts,var,svh);
     
     if (!zdres(1,obsb,nb,rs,dts,var,svh,nav,rtk->rb,opt,1,yb,e,azel,freq)) {
         return tt;
@@ -2637,7 +2710,7 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr, const nav_t *na
         }
     }
     /* compute satellite positions, velocities and clocks */
-    satposs(&rtk->opt,time,obs,n,nav,opt->sateph,rs,dts,var,svh);
+    satposs(&rtk->opt,time,obs,n,nav,&rtk->ast,opt->sateph,rs,dts,var,svh);
 
     /* calculate [range - measured pseudorange] for base station (phase and code)
          output is in y[nu:nu+nr], see call for rover below for more details                                                 */
@@ -2903,6 +2976,8 @@ extern void rtkinit(rtk_t *rtk, const prcopt_t *opt,const imup_t *imup)
     sol_t sol0={{0}};
     ambc_t ambc0={{{0}}};
     ssat_t ssat0={0};
+    tidetbl_t tide0={0};
+    ionoc_t ionoc0={{0}};
     int i;
     insopt_t insopt=opt->insopt;
     
@@ -2955,6 +3030,11 @@ extern void rtkinit(rtk_t *rtk, const prcopt_t *opt,const imup_t *imup)
     rtk->sol.thres=(float)opt->thresar[0];
     rtk->opt=gnss_opt;
     rtk->clk_jump=0;
+    rtk->tide=tide0;
+    for (i=0;i<6;i++) rtk->mdlerr[i]=0.0;
+    rtk->biascur=0;
+    rtk->ionoc=ionoc0;
+    rtk->mainclk=0;
 }
 /* free rtk control ------------------------------------------------------------
 * free memory for rtk control struct
@@ -3034,6 +3114,7 @@ extern int rtkpos(rtk_t *rtk, obsd_t *obs, int n, const nav_t *nav)
     prcopt_t *opt=&rtk->opt;
     sol_t solb={{0}};
     gtime_t time;
+    double erpv[5]={0};
     int i,nu,nr,stat=0;
     char msg[128]="";
     
@@ -3057,6 +3138,10 @@ extern int rtkpos(rtk_t *rtk, obsd_t *obs, int n, const nav_t *nav)
 
     time=rtk->sol.time; /* previous epoch */
     
+    /* sun/moon and earth orientation shared by models of the epoch */
+    geterp(&nav->erp,obs[0].time,erpv);
+    astroinit(gpst2utc(obs[0].time),erpv,&rtk->ast);
+    
     /* rover position by single point positioning */
     if (!pntpos((rtk->tc||rtk->stc)?rtk->ins_kf->couple_epoch:rtk->epoch,opt->adjobs?obsd:obs,nu,nav,&rtk->opt,&rtk->sol,NULL,rtk->ssat,msg,&opt->insopt,rtk->ins_kf)) {
         trace(2,"%s(%d): point pos error vs=%d ",time_str(obs[0].time,1),(rtk->tc||rtk->stc)?rtk->ins_kf->couple_epoch:rtk->epoch,rtk->sol.ns);
@@ -42,10 +42,33 @@
 *                            handle multiple ephemeris sets in updatesvr()
 *                            use API sat2freq() to get carrier frequency
 *                            use integer types in stdint.h
+*           2026/10/18  1.23 input rtcm 3/receiver raw data by block in
+*                            decoderaw()
+*           2026/10/18  1.24 pipeline server by input reader, decoder, solver
+*                            and output writer threads connected by rings
+*                            monitor reads published status of solver
+*                            wake pipeline stages by events instead of polling
+*           2026/10/18  1.25 wait input data arrival by strwait() in reader
+*                            threads instead of sleep of server cycle
 *-----------------------------------------------------------------------------*/
+#include <stddef.h>
 #include "rtklib.h"
 
 #define MIN_INT_RESET   30000   /* mininum interval of reset command (ms) */
+#define NOBSRING        32      /* observation ring size (max size epochs) */
+#define NOUTRING        64      /* output ring size (max size messages) */
+#define MAX_WAIT        1000    /* max wait of pipeline stages for event (ms) */
+
+typedef struct {        /* observation epoch record (decoder->solver) */
+    int n[2];           /* number of rover/base observation data */
+    int fbase;          /* base station observation updated (0:no,1:yes) */
+    obsd_t data[MAXOBS*2]; /* rover and base observation data */
+} obsrec_t;
+
+typedef struct {        /* solution output record header (solver->writer) */
+    int index;          /* output (0:solution 1,1:solution 2,2:monitor) */
+    int n;              /* message length (bytes) */
+} outrec_t;
 
 /* write solution header to output stream ------------------------------------*/
 static void writesolhead(stream_t *stream, const solopt_t *solopt,const prcopt_t *popt)
@@ -67,6 +90,30 @@ static void saveoutbuf(rtksvr_t *svr, uint8_t *buff, int n, int index)
     
     rtksvrunlock(svr);
 }
+/* queue solution message to output writer -----------------------------------*/
+static void queueout(rtksvr_t *svr, int index, const uint8_t *buff, int n)
+{
+    uint8_t rec[sizeof(outrec_t)+MAXSOLMSG+1];
+    outrec_t hdr;
+    
+    if (n<=0) return;
+    
+    /* wait for output writer if output ring full */
+    while (ringspace(&svr->rout)<(int)sizeof(hdr)+n) {
+        if (svr->ostate&&eventwait(&svr->ev_osp,MAX_WAIT)) continue;
+        
+        /* drop message if writer stalled */
+        tracet(2,"output ring overflow: index=%d n=%d\n",index,n);
+        svr->outdrop++;
+        return;
+    }
+    hdr.index=index;
+    hdr.n=n;
+    memcpy(rec,&hdr,sizeof(hdr));
+    memcpy(rec+sizeof(hdr),buff,n);
+    ringwrite(&svr->rout,rec,(int)sizeof(hdr)+n);
+    eventset(&svr->ev_out);
+}
 /* write solution to output stream -------------------------------------------*/
 static void writesol(rtksvr_t *svr, int index)
 {
@@ -81,37 +128,71 @@ static void writesol(rtksvr_t *svr, int index)
         if (svr->solopt[i].posf==SOLF_STAT) {
             
             /* output solution status */
-            rtksvrlock(svr);
             n=rtkoutstat(&svr->rtk,(char *)buff);
-            rtksvrunlock(svr);
         }
         else {
             /* output solution */
             n=outsols(buff,&svr->rtk.sol,svr->rtk.rb,svr->solopt+i,&svr->rtk.opt,NULL);
         }
-        strwrite(svr->stream+i+3,buff,n);
-        
-        /* save output buffer */
-        saveoutbuf(svr,buff,n,i);
+        queueout(svr,i,buff,n);
         
         /* output extended solution */
         n=outsolexs(buff,&svr->rtk.sol,svr->rtk.ssat,svr->solopt+i);
-        strwrite(svr->stream+i+3,buff,n);
-        
-        /* save output buffer */
-        saveoutbuf(svr,buff,n,i);
+        queueout(svr,i,buff,n);
     }
     /* output solution to monitor port */
     if (svr->moni) {
         n=outsols(buff,&svr->rtk.sol,svr->rtk.rb,&solopt,&svr->rtk.opt,NULL);
-        strwrite(svr->moni,buff,n);
+        queueout(svr,2,buff,n);
     }
     /* save solution buffer */
+    rtksvrlock(svr);
     if (svr->nsol<MAXSOLBUF) {
-        rtksvrlock(svr);
         svr->solbuf[svr->nsol++]=svr->rtk.sol;
-        rtksvrunlock(svr);
     }
+    rtksvrunlock(svr);
+}
+/* write queued solution messages to output streams --------------------------*/
+static int writeout(rtksvr_t *svr, uint8_t *buff)
+{
+    outrec_t hdr;
+    int nrec;
+    
+    for (nrec=0;ringcount(&svr->rout)>=(int)sizeof(hdr);nrec++) {
+        ringread(&svr->rout,(uint8_t *)&hdr,sizeof(hdr));
+        ringread(&svr->rout,buff,hdr.n);
+        eventset(&svr->ev_osp);
+        
+        if (hdr.index<2) {
+            strwrite(svr->stream+hdr.index+3,buff,hdr.n);
+            
+            /* save output buffer */
+            saveoutbuf(svr,buff,hdr.n,hdr.index);
+        }
+        else if (svr->moni) {
+            strwrite(svr->moni,buff,hdr.n);
+        }
+    }
+    return nrec;
+}
+/* publish solution status for monitor ---------------------------------------*/
+static void pubstat(rtksvr_t *svr)
+{
+    const ssat_t *ssat;
+    int i,single;
+    
+    rtksvrlock(svr);
+    
+    svr->sol=svr->rtk.sol;
+    single=svr->rtk.sol.stat==SOLQ_NONE||svr->rtk.sol.stat==SOLQ_SINGLE;
+    
+    for (i=0;i<MAXSAT;i++) {
+        ssat=svr->rtk.ssat+i;
+        svr->azel[i*2  ]=ssat->azel[0];
+        svr->azel[i*2+1]=ssat->azel[1];
+        svr->vsat[i]=single?ssat->vs:ssat->vsat[0];
+    }
+    rtksvrunlock(svr);
 }
 /* update glonass frequency channel number in raw data struct ----------------*/
 static void update_glofcn(rtksvr_t *svr)
@@ -311,9 +392,14 @@ static void update_svr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav,
            ephset,index);
     
     if (ret==1) { /* observation data */
+        rtksvrlock(svr);
         update_obs(svr,obs,index,iobs);
+        rtksvrunlock(svr);
+        return;
     }
-    else if (ret==2) { /* ephemeris */
+    lock(&svr->lock_nav);
+    
+    if (ret==2) { /* ephemeris */
         update_eph(svr,nav,ephsat,ephset,index);
     }
     else if (ret==3) { /* sbas message */
@@ -334,6 +420,7 @@ static void update_svr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav,
     else if (ret==-1) { /* error */
         svr->nmsg[index][9]++;
     }
+    unlock(&svr->lock_nav);
 }
 /* decode receiver raw/rtcm data ---------------------------------------------*/
 static int decoderaw(rtksvr_t *svr, int index)
@@ -345,27 +432,30 @@ static int decoderaw(rtksvr_t *svr, int index)
     
     tracet(4,"decoderaw: index=%d\n",index);
     
-    rtksvrlock(svr);
-    
-    for (i=0;i<svr->nb[index];i++) {
+    /* stop at observation buffer full and keep rest for next decoding */
+    for (i=0;i<svr->nb[index]&&fobs<MAXOBSBUF;) {
+        ret=0;
         
         /* input rtcm/receiver raw data from stream */
         if (svr->format[index]==STRFMT_RTCM2) {
-            ret=input_rtcm2(svr->rtcm+index,svr->buff[index][i]);
+            ret=input_rtcm2(svr->rtcm+index,svr->buff[index][i++]);
             obs=&svr->rtcm[index].obs;
             nav=&svr->rtcm[index].nav;
             ephsat=svr->rtcm[index].ephsat;
             ephset=svr->rtcm[index].ephset;
         }
         else if (svr->format[index]==STRFMT_RTCM3) {
-            ret=input_rtcm3(svr->rtcm+index,svr->buff[index][i]);
+            i+=(int)input_rtcm3_buf(svr->rtcm+index,svr->buff[index]+i,
+                                    svr->nb[index]-i,NULL,&ret);
             obs=&svr->rtcm[index].obs;
             nav=&svr->rtcm[index].nav;
             ephsat=svr->rtcm[index].ephsat;
             ephset=svr->rtcm[index].ephset;
         }
         else {
-            ret=input_raw(svr->raw+index,svr->format[index],svr->buff[index][i]);
+            i+=(int)input_raw_buf(svr->raw+index,svr->format[index],
+                                  svr->buff[index]+i,svr->nb[index]-i,NULL,
+                                  &ret);
             obs=&svr->raw[index].obs;
             nav=&svr->raw[index].nav;
             ephsat=svr->raw[index].ephsat;
@@ -383,13 +473,12 @@ static int decoderaw(rtksvr_t *svr, int index)
             update_svr(svr,ret,obs,nav,ephsat,ephset,sbsmsg,index,fobs);
         }
         /* observation data received */
-        if (ret==1) {
-            if (fobs<MAXOBSBUF) fobs++; else svr->prcout++;
-        }
+        if (ret==1) fobs++;
     }
-    svr->nb[index]=0;
-    
-    rtksvrunlock(svr);
+    if (i<svr->nb[index]) {
+        memmove(svr->buff[index],svr->buff[index]+i,svr->nb[index]-i);
+    }
+    svr->nb[index]-=i;
     
     return fobs;
 }
@@ -402,19 +491,14 @@ static void decodefile(const prcopt_t *popt,rtksvr_t *svr, int index)
     
     tracet(4,"decodefile: index=%d\n",index);
     
-    rtksvrlock(svr);
-    
     /* check file path completed */
     if ((nb=svr->nb[index])<=2||
         svr->buff[index][nb-2]!='\r'||svr->buff[index][nb-1]!='\n') {
-        rtksvrunlock(svr);
         return;
     }
     strncpy(file,(char *)svr->buff[index],nb-2); file[nb-2]='\0';
     svr->nb[index]=0;
     
-    rtksvrunlock(svr);
-    
     if (svr->format[index]==STRFMT_SP3) { /* precise ephemeris */
         
         /* read sp3 precise ephemeris */
@@ -424,7 +508,7 @@ static void decodefile(const prcopt_t *popt,rtksvr_t *svr, int index)
             return;
         }
         /* update precise ephemeris */
-        rtksvrlock(svr);
+        lock(&svr->lock_nav);
         
         if (svr->nav.peph) free(svr->nav.peph);
         svr->nav.ne=svr->nav.nemax=nav.ne;
@@ -432,7 +516,7 @@ static void decodefile(const prcopt_t *popt,rtksvr_t *svr, int index)
         svr->ftime[index]=utc2gpst(timeget());
         strcpy(svr->files[index],file);
         
-        rtksvrunlock(svr);
+        unlock(&svr->lock_nav);
     }
     else if (svr->format[index]==STRFMT_RNXCLK) { /* precise clock */
         
@@ -442,7 +526,7 @@ static void decodefile(const prcopt_t *popt,rtksvr_t *svr, int index)
             return;
         }
         /* update precise clock */
-        rtksvrlock(svr);
+        lock(&svr->lock_nav);
         
         if (svr->nav.pclk) free(svr->nav.pclk);
         svr->nav.nc=svr->nav.ncmax=nav.nc;
@@ -450,7 +534,7 @@ static void decodefile(const prcopt_t *popt,rtksvr_t *svr, int index)
         svr->ftime[index]=utc2gpst(timeget());
         strcpy(svr->files[index],file);
         
-        rtksvrunlock(svr);
+        unlock(&svr->lock_nav);
     }
 }
 /* carrier-phase bias (fcb) correction ---------------------------------------*/
@@ -557,88 +641,224 @@ static void send_nmea(rtksvr_t *svr, uint32_t *tickreset)
 			   sol_nmea.rr[2]);
 	}
 }
-/* rtk server thread ---------------------------------------------------------*/
+/* queue observation epochs to solver ----------------------------------------*/
+static void queueobs(rtksvr_t *svr, obsrec_t *rec, const int *fobs)
+{
+    int i,j,n,size;
+    
+    /* a base-only record is queued for averaging single base pos */
+    for (i=0;i<fobs[0]||(i==0&&fobs[1]>0);i++) {
+        n=0;
+        if (i<fobs[0]) { /* rover observation data */
+            for (j=0;j<svr->obs[0][i].n&&n<MAXOBS*2;j++) {
+                rec->data[n++]=svr->obs[0][i].data[j];
+            }
+        }
+        rec->n[0]=n;
+        for (j=0;j<svr->obs[1][0].n&&n<MAXOBS*2;j++) {
+            rec->data[n++]=svr->obs[1][0].data[j];
+        }
+        rec->n[1]=n-rec->n[0];
+        rec->fbase=i==0&&fobs[1]>0;
+        
+        size=(int)(offsetof(obsrec_t,data)+sizeof(obsd_t)*n);
+        
+        /* if solver overload, inclement obs outage counter */
+        if (ringspace(&svr->robs)<size) {
+            tracet(2,"observation ring overflow: n=%d\n",n);
+            svr->prcout++;
+            continue;
+        }
+        ringwrite(&svr->robs,(uint8_t *)rec,size);
+        eventset(&svr->ev_sol);
+    }
+}
+/* input stream reader thread ------------------------------------------------*/
 #ifdef WIN32
-static DWORD WINAPI rtksvrthread(void *arg)
+static DWORD WINAPI readthread(void *arg)
 #else
-static void *rtksvrthread(void *arg)
+static void *readthread(void *arg)
 #endif
 {
-    rtksvr_t *svr=(rtksvr_t *)arg;
-    obs_t obs;
-    obsd_t data[MAXOBS*2];
-    sol_t sol={{0}};
-    double tt;
-    uint32_t tick,ticknmea,tick1hz,tickreset;
-    uint8_t *p,*q;
-    char msg[128];
-    int i,j,n,fobs[3]={0},cycle,cputime;
+    rtksvrrd_t *rd=(rtksvrrd_t *)arg;
+    rtksvr_t *svr=(rtksvr_t *)rd->svr;
+    strwait_t wait;
+    uint8_t *buff;
+    uint32_t tick;
+    int i=rd->index,n,m,cycle,timeout;
     
-    tracet(3,"rtksvrthread:\n");
+    tracet(3,"readthread: index=%d\n",i);
     
-    svr->state=1; obs.data=data;
-    svr->tick=tickget();
-    ticknmea=tick1hz=svr->tick-1000;
-    tickreset=svr->tick-MIN_INT_RESET;
+    if (!(buff=(uint8_t *)malloc(svr->buffsize))) {
+        tracet(1,"readthread: malloc error\n");
+        return 0;
+    }
+    strwaitinit(&wait);
     
-    for (cycle=0;svr->state;cycle++) {
+    for (cycle=0;svr->state;) {
         tick=tickget();
-        for (i=0;i<3;i++) {
-            p=svr->buff[i]+svr->nb[i]; q=svr->buff[i]+svr->buffsize;
+        
+        /* read receiver raw/rtcm data from input stream up to ring space */
+        if ((n=ringspace(svr->rbuf+i))<=0) {
+            eventwait(svr->ev_rd+i,svr->cycle);
+            continue;
+        }
+        if ((n=strread(svr->stream+i,buff,n<svr->buffsize?n:svr->buffsize))>0) {
             
-            /* read receiver raw/rtcm data from input stream */
-            if ((n=strread(svr->stream+i,p,q-p))<=0) {
-                continue;
-            }
             /* write receiver raw/rtcm data to log stream */
-            strwrite(svr->stream+i+5,p,n);
-            svr->nb[i]+=n;
+            strwrite(svr->stream+i+5,buff,n);
             
             /* save peek buffer */
             rtksvrlock(svr);
-            n=n<svr->buffsize-svr->npb[i]?n:svr->buffsize-svr->npb[i];
-            memcpy(svr->pbuf[i]+svr->npb[i],p,n);
-            svr->npb[i]+=n;
+            m=n<svr->buffsize-svr->npb[i]?n:svr->buffsize-svr->npb[i];
+            memcpy(svr->pbuf[i]+svr->npb[i],buff,m);
+            svr->npb[i]+=m;
             rtksvrunlock(svr);
+            
+            /* pass receiver raw/rtcm data to decoder */
+            ringwrite(svr->rbuf+i,buff,n);
+            eventset(&svr->ev_dec);
         }
-        for (i=0;i<3;i++) {
+        /* write periodic command to input stream at each server cycle */
+        for (;cycle<=(int)(tick-svr->tick)/svr->cycle;cycle++) {
+            periodic_cmd(cycle*svr->cycle,svr->cmds_periodic[i],svr->stream+i);
+        }
+        /* wait input data arrival until next cycle */
+        timeout=cycle*svr->cycle-(int)(tickget()-svr->tick);
+        strwait(&wait,svr->stream+i,1,timeout);
+    }
+    strwaitfree(&wait);
+    free(buff);
+    return 0;
+}
+/* decoder thread ------------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI decthread(void *arg)
+#else
+static void *decthread(void *arg)
+#endif
+{
+    rtksvr_t *svr=(rtksvr_t *)arg;
+    obsrec_t *rec;
+    int i,n,busy,fobs[3];
+    
+    tracet(3,"decthread:\n");
+    
+    if (!(rec=(obsrec_t *)malloc(sizeof(obsrec_t)))) {
+        tracet(1,"decthread: malloc error\n");
+        return 0;
+    }
+    while (svr->state) {
+        for (i=busy=0;i<3;i++) {
+            fobs[i]=0;
+            
+            /* fetch receiver raw/rtcm data from reader */
+            n=ringread(svr->rbuf+i,svr->buff[i]+svr->nb[i],
+                       svr->buffsize-svr->nb[i]);
+            svr->nb[i]+=n;
+            if (n>0) eventset(svr->ev_rd+i);
+            
             if (svr->format[i]==STRFMT_SP3||svr->format[i]==STRFMT_RNXCLK) {
                 /* decode download file */
-                decodefile(&svr->rtk.opt,svr,i);
+                if (n>0) decodefile(&svr->rtk.opt,svr,i);
             }
-            else {
+            else if (svr->nb[i]>0) {
                 /* decode receiver raw/rtcm data */
                 fobs[i]=decoderaw(svr,i);
+                busy+=n>0||svr->nb[i]>0;
             }
         }
-        /* averaging single base pos */
-        if (fobs[1]>0&&svr->rtk.opt.refpos==POSOPT_SINGLE) {
-            if ((svr->rtk.opt.maxaveep<=0||svr->nave<svr->rtk.opt.maxaveep)&&
-                pntpos(0,svr->obs[1][0].data,svr->obs[1][0].n,&svr->nav,
-                       &svr->rtk.opt,&sol,NULL,NULL,msg,NULL,NULL)) {
-                svr->nave++;
-                for (i=0;i<3;i++) {
-                    svr->rb_ave[i]+=(sol.rr[i]-svr->rb_ave[i])/svr->nave;
+        /* pass observation data to solver */
+        queueobs(svr,rec,fobs);
+        
+        /* wait input data from readers */
+        if (!busy) eventwait(&svr->ev_dec,MAX_WAIT);
+    }
+    free(rec);
+    return 0;
+}
+/* output writer thread ------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI outthread(void *arg)
+#else
+static void *outthread(void *arg)
+#endif
+{
+    rtksvr_t *svr=(rtksvr_t *)arg;
+    uint8_t buff[MAXSOLMSG+1];
+    
+    tracet(3,"outthread:\n");
+    
+    while (svr->ostate) {
+        if (!writeout(svr,buff)) eventwait(&svr->ev_out,MAX_WAIT);
+    }
+    /* flush solutions queued before solver stopped */
+    writeout(svr,buff);
+    return 0;
+}
+/* rtk server (solver) thread ------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI rtksvrthread(void *arg)
+#else
+static void *rtksvrthread(void *arg)
+#endif
+{
+    rtksvr_t *svr=(rtksvr_t *)arg;
+    obsrec_t *rec;
+    sol_t sol={{0}};
+    double tt;
+    uint32_t tick,ticknmea,tick1hz,tickreset;
+    char msg[128];
+    int i,nep,cputime,timeout;
+    
+    tracet(3,"rtksvrthread:\n");
+    
+    if (!(rec=(obsrec_t *)malloc(sizeof(obsrec_t)))) {
+        tracet(1,"rtksvrthread: malloc error\n");
+        return 0;
+    }
+    ticknmea=tick1hz=svr->tick-1000;
+    tickreset=svr->tick-MIN_INT_RESET;
+    
+    while (svr->state) {
+        tick=tickget();
+        
+        for (nep=0;ringcount(&svr->robs)>=(int)offsetof(obsrec_t,data);nep++) {
+            
+            /* fetch observation data from decoder */
+            ringread(&svr->robs,(uint8_t *)rec,(int)offsetof(obsrec_t,data));
+            ringread(&svr->robs,(uint8_t *)rec->data,
+                     (int)sizeof(obsd_t)*(rec->n[0]+rec->n[1]));
+            
+            lock(&svr->lock_nav);
+            
+            /* averaging single base pos */
+            if (rec->fbase&&svr->rtk.opt.refpos==POSOPT_SINGLE) {
+                if ((svr->rtk.opt.maxaveep<=0||svr->nave<svr->rtk.opt.maxaveep)&&
+                    pntpos(0,rec->data+rec->n[0],rec->n[1],&svr->nav,
+                           &svr->rtk.opt,&sol,NULL,NULL,msg,NULL,NULL)) {
+                    svr->nave++;
+                    for (i=0;i<3;i++) {
+                        svr->rb_ave[i]+=(sol.rr[i]-svr->rb_ave[i])/svr->nave;
+                    }
                 }
+                for (i=0;i<3;i++) svr->rtk.opt.rb[i]=svr->rb_ave[i];
             }
-            for (i=0;i<3;i++) svr->rtk.opt.rb[i]=svr->rb_ave[i];
-        }
-        for (i=0;i<fobs[0];i++) { /* for each rover observation data */
-            obs.n=0;
-            for (j=0;j<svr->obs[0][i].n&&obs.n<MAXOBS*2;j++) {
-                obs.data[obs.n++]=svr->obs[0][i].data[j];
-            }
-            for (j=0;j<svr->obs[1][0].n&&obs.n<MAXOBS*2;j++) {
-                obs.data[obs.n++]=svr->obs[1][0].data[j];
+            if (rec->n[0]<=0) { /* no rover observation data */
+                unlock(&svr->lock_nav);
+                continue;
             }
             /* carrier phase bias correction */
             if (!strstr(svr->rtk.opt.pppopt,"-DIS_FCB")) {
-                corr_phase_bias(obs.data,obs.n,&svr->nav);
+                corr_phase_bias(rec->data,rec->n[0]+rec->n[1],&svr->nav);
             }
             /* rtk positioning */
-            rtksvrlock(svr);
-            rtkpos(&svr->rtk,obs.data,obs.n,&svr->nav);
-            rtksvrunlock(svr);
+            rtkpos(&svr->rtk,rec->data,rec->n[0]+rec->n[1],&svr->nav);
+            
+            unlock(&svr->lock_nav);
+            
+            /* publish solution status for monitor */
+            pubstat(svr);
             
             if (svr->rtk.sol.stat!=SOLQ_NONE) {
                 
@@ -647,11 +867,7 @@ static void *rtksvrthread(void *arg)
                 timeset(gpst2utc(timeadd(svr->rtk.sol.time,tt)));
                 
                 /* write solution */
-                writesol(svr,i);
-            }
-            /* if cpu overload, inclement obs outage counter and break */
-            if ((int)(tickget()-tick)>=svr->cycle) {
-                svr->prcout+=fobs[0]-i-1;
+                writesol(svr,nep);
             }
         }
         /* send null solution if no solution (1hz) */
@@ -659,20 +875,67 @@ static void *rtksvrthread(void *arg)
             writesol(svr,0);
             tick1hz=tick;
         }
-        /* write periodic command to input stream */
-        for (i=0;i<3;i++) {
-            periodic_cmd(cycle*svr->cycle,svr->cmds_periodic[i],svr->stream+i);
-        }
         /* send nmea request to base/nrtk input stream */
         if (svr->nmeacycle>0&&(int)(tick-ticknmea)>=svr->nmeacycle) {
             send_nmea(svr,&tickreset);
             ticknmea=tick;
         }
+        if (!nep) {
+            /* wait observation data until next null solution or nmea request */
+            timeout=MAX_WAIT;
+            if (svr->rtk.sol.stat==SOLQ_NONE) {
+                timeout=MIN(timeout,1000-(int)(tick-tick1hz));
+            }
+            if (svr->nmeacycle>0) {
+                timeout=MIN(timeout,svr->nmeacycle-(int)(tick-ticknmea));
+            }
+            eventwait(&svr->ev_sol,timeout);
+            continue;
+        }
         if ((cputime=(int)(tickget()-tick))>0) svr->cputime=cputime;
-         
-        /* sleep until next cycle */
-        sleepms(svr->cycle-cputime);
     }
+    free(rec);
+    return 0;
+}
+/* create/join server thread -------------------------------------------------*/
+#ifdef WIN32
+static int createthread(thread_t *thread, LPTHREAD_START_ROUTINE func,
+                        void *arg)
+{
+    return (*thread=CreateThread(NULL,0,func,arg,0,NULL))!=NULL;
+}
+static void jointhread(thread_t thread)
+{
+    WaitForSingleObject(thread,10000);
+    CloseHandle(thread);
+}
+#else
+static int createthread(thread_t *thread, void *(*func)(void *), void *arg)
+{
+    return !pthread_create(thread,NULL,func,arg);
+}
+static void jointhread(thread_t thread)
+{
+    pthread_join(thread,NULL);
+}
+#endif
+/* stop server threads and free buffers --------------------------------------*/
+static void stopsvr(rtksvr_t *svr, int nthread)
+{
+    int i;
+    
+    /* threads created in order of writer,solver,decoder,readers */
+    svr->state=0;
+    for (i=0;i<3;i++) eventset(svr->ev_rd+i);
+    eventset(&svr->ev_dec);
+    eventset(&svr->ev_sol);
+    for (i=nthread-1;i>=3;i--) jointhread(svr->reader[i-3].thread);
+    if (nthread>2) jointhread(svr->thread_dec);
+    if (nthread>1) jointhread(svr->thread);
+    svr->ostate=0;
+    eventset(&svr->ev_out);
+    if (nthread>0) jointhread(svr->thread_out);
+    
     for (i=0;i<MAXSTRRTK;i++) strclose(svr->stream+i);
     for (i=0;i<3;i++) {
         svr->nb[i]=svr->npb[i]=0;
@@ -680,12 +943,14 @@ static void *rtksvrthread(void *arg)
         free(svr->pbuf[i]); svr->pbuf[i]=NULL;
         free_raw (svr->raw +i);
         free_rtcm(svr->rtcm+i);
+        ringfree(svr->rbuf+i);
     }
     for (i=0;i<2;i++) {
         svr->nsb[i]=0;
         free(svr->sbuf[i]); svr->sbuf[i]=NULL;
     }
-    return 0;
+    ringfree(&svr->robs);
+    ringfree(&svr->rout);
 }
 /* initialize rtk server -------------------------------------------------------
 * initialize rtk server
@@ -722,8 +987,20 @@ extern int rtksvrinit(rtksvr_t *svr)
     for (i=0;i<3;i++) svr->files[i][0]='\0';
     svr->moni=NULL;
     svr->tick=0;
-    svr->thread=0;
-    svr->cputime=svr->prcout=svr->nave=0;
+    svr->thread=svr->thread_dec=svr->thread_out=0;
+    svr->ostate=0;
+    svr->sol=sol0;
+    for (i=0;i<MAXSAT*2;i++) svr->azel[i]=0.0;
+    for (i=0;i<MAXSAT;i++) svr->vsat[i]=0;
+    for (i=0;i<3;i++) {
+        svr->reader[i].index=i;
+        svr->reader[i].svr=svr;
+        svr->reader[i].thread=0;
+        memset(svr->rbuf+i,0,sizeof(ring_t));
+    }
+    memset(&svr->robs,0,sizeof(ring_t));
+    memset(&svr->rout,0,sizeof(ring_t));
+    svr->cputime=svr->prcout=svr->outdrop=svr->nave=0;
     for (i=0;i<3;i++) svr->rb_ave[i]=0.0;
     
     memset(&svr->nav,0,sizeof(nav_t));
@@ -756,6 +1033,12 @@ extern int rtksvrinit(rtksvr_t *svr)
     *svr->cmd_reset='\0';
     svr->bl_reset=10.0;
     initlock(&svr->lock);
+    initlock(&svr->lock_nav);
+    for (i=0;i<3;i++) eventinit(svr->ev_rd+i);
+    eventinit(&svr->ev_dec);
+    eventinit(&svr->ev_sol);
+    eventinit(&svr->ev_osp);
+    eventinit(&svr->ev_out);
     
     return 1;
 }
@@ -775,6 +1058,11 @@ extern void rtksvrfree(rtksvr_t *svr)
         free(svr->obs[i][j].data);
     }
     rtkfree(&svr->rtk);
+    for (i=0;i<3;i++) eventfree(svr->ev_rd+i);
+    eventfree(&svr->ev_dec);
+    eventfree(&svr->ev_sol);
+    eventfree(&svr->ev_osp);
+    eventfree(&svr->ev_out);
 }
 /* lock/unlock rtk server ------------------------------------------------------
 * lock/unlock rtk server
@@ -785,7 +1073,8 @@ extern void rtksvrlock  (rtksvr_t *svr) {lock  (&svr->lock);}
 extern void rtksvrunlock(rtksvr_t *svr) {unlock(&svr->lock);}
 
 /* start rtk server ------------------------------------------------------------
-* start rtk server thread
+* start rtk server threads (input stream readers, decoder, solver and output
+* writer connected by single-producer/single-consumer rings)
 * args   : rtksvr_t *svr    IO rtk server
 *          int     cycle    I  server cycle (ms)
 *          int     buffsize I  input buffer size (bytes)
@@ -836,7 +1125,7 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
                        solopt_t *solopt, stream_t *moni, char *errmsg)
 {
     gtime_t time,time0={0};
-    int i,j,rw;
+    int i,j,n,rw;
     
     tracet(3,"rtksvrstart: cycle=%d buffsize=%d navsel=%d nmeacycle=%d nmeareq=%d\n",
            cycle,buffsize,navsel,nmeacycle,nmeareq);
@@ -855,7 +1144,7 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
     svr->navsel=navsel;
     svr->nsbs=0;
     svr->nsol=0;
-    svr->prcout=0;
+    svr->prcout=svr->outdrop=0;
     rtkfree(&svr->rtk);
     rtkinit(&svr->rtk,prcopt,NULL);
     
@@ -865,8 +1154,9 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
     }
     for (i=0;i<3;i++) { /* input/log streams */
         svr->nb[i]=svr->npb[i]=0;
-        if (!(svr->buff[i]=(uint8_t *)malloc(buffsize))||
-            !(svr->pbuf[i]=(uint8_t *)malloc(buffsize))) {
+        if (!(svr->buff[i]=(uint8_t *)malloc(svr->buffsize))||
+            !(svr->pbuf[i]=(uint8_t *)malloc(svr->buffsize))||
+            !ringinit(svr->rbuf+i,svr->buffsize*4)) {
             tracet(1,"rtksvrstart: malloc error\n");
             sprintf(errmsg,"rtk server malloc error");
             return 0;
@@ -887,12 +1177,19 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
         svr->rtcm[i].dgps=svr->nav.dgps;
     }
     for (i=0;i<2;i++) { /* output peek buffer */
-        if (!(svr->sbuf[i]=(uint8_t *)malloc(buffsize))) {
+        if (!(svr->sbuf[i]=(uint8_t *)malloc(svr->buffsize))) {
             tracet(1,"rtksvrstart: malloc error\n");
             sprintf(errmsg,"rtk server malloc error");
             return 0;
         }
     }
+    /* observation and output rings between decoder, solver and writer */
+    if (!ringinit(&svr->robs,(int)sizeof(obsrec_t)*NOBSRING)||
+        !ringinit(&svr->rout,(int)(sizeof(outrec_t)+MAXSOLMSG)*NOUTRING)) {
+        tracet(1,"rtksvrstart: malloc error\n");
+        sprintf(errmsg,"rtk server malloc error");
+        return 0;
+    }
     /* set solution options */
     for (i=0;i<2;i++) {
         svr->solopt[i]=solopt[i];
@@ -942,13 +1239,22 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
     for (i=3;i<5;i++) {
         writesolhead(svr->stream+i,svr->solopt+i-3,&svr->rtk.opt);
     }
-    /* create rtk server thread */
-#ifdef WIN32
-    if (!(svr->thread=CreateThread(NULL,0,rtksvrthread,svr,0,NULL))) {
-#else
-    if (pthread_create(&svr->thread,NULL,rtksvrthread,svr)) {
-#endif
-        for (i=0;i<MAXSTRRTK;i++) strclose(svr->stream+i);
+    /* publish initial solution status */
+    pubstat(svr);
+    
+    /* create output writer, solver, decoder and input reader threads */
+    svr->state=svr->ostate=1;
+    svr->tick=tickget();
+    
+    n=0;
+    if (createthread(&svr->thread_out,outthread,svr)) n++;
+    if (n==1&&createthread(&svr->thread,rtksvrthread,svr)) n++;
+    if (n==2&&createthread(&svr->thread_dec,decthread,svr)) n++;
+    for (i=0;i<3&&n==3+i;i++) {
+        if (createthread(&svr->reader[i].thread,readthread,svr->reader+i)) n++;
+    }
+    if (n<6) {
+        stopsvr(svr,n);
         sprintf(errmsg,"thread create error\n");
         return 0;
     }
@@ -976,16 +1282,8 @@ extern void rtksvrstop(rtksvr_t *svr, char **cmds)
     }
     rtksvrunlock(svr);
     
-    /* stop rtk server */
-    svr->state=0;
-    
-    /* free rtk server thread */
-#ifdef WIN32
-    WaitForSingleObject(svr->thread,10000);
-    CloseHandle(svr->thread);
-#else
-    pthread_join(svr->thread,NULL);
-#endif
+    /* stop rtk server threads */
+    stopsvr(svr,6);
 }
 /* open output/log stream ------------------------------------------------------
 * open output/log stream
@@ -1073,17 +1371,12 @@ extern int rtksvrostat(rtksvr_t *svr, int rcv, gtime_t *time, int *sat,
     }
     for (i=0;i<ns;i++) {
         sat [i]=svr->obs[rcv][0].data[i].sat;
-        az  [i]=svr->rtk.ssat[sat[i]-1].azel[0];
-        el  [i]=svr->rtk.ssat[sat[i]-1].azel[1];
+        az  [i]=svr->azel[(sat[i]-1)*2  ];
+        el  [i]=svr->azel[(sat[i]-1)*2+1];
         for (j=0;j<NFREQ;j++) {
             snr[i][j]=(int)(svr->obs[rcv][0].data[i].SNR[j]*SNR_UNIT+0.5);
         }
-        if (svr->rtk.sol.stat==SOLQ_NONE||svr->rtk.sol.stat==SOLQ_SINGLE) {
-            vsat[i]=svr->rtk.ssat[sat[i]-1].vs;
-        }
-        else {
-            vsat[i]=svr->rtk.ssat[sat[i]-1].vsat[0];
-        }
+        vsat[i]=svr->vsat[sat[i]-1];
     }
     rtksvrunlock(svr);
     return ns;
@@ -1118,6 +1411,7 @@ extern void rtksvrsstat(rtksvr_t *svr, int *sstat, char *msg)
 *-----------------------------------------------------------------------------*/
 extern int rtksvrmark(rtksvr_t *svr, const char *name, const char *comment)
 {
+    sol_t sol;
     char buff[MAXSOLMSG+1],tstr[32],*p,*q;
     double tow,pos[3];
     int i,sum,week;
@@ -1126,29 +1420,32 @@ extern int rtksvrmark(rtksvr_t *svr, const char *name, const char *comment)
     
     if (!svr->state) return 0;
     
+    /* solution published by solver */
     rtksvrlock(svr);
+    sol=svr->sol;
+    rtksvrunlock(svr);
     
-    time2str(svr->rtk.sol.time,tstr,3);
-    tow=time2gpst(svr->rtk.sol.time,&week);
-    ecef2pos(svr->rtk.sol.rr,pos);
+    time2str(sol.time,tstr,3);
+    tow=time2gpst(sol.time,&week);
+    ecef2pos(sol.rr,pos);
     
     for (i=0;i<2;i++) {
         p=buff;
         if (svr->solopt[i].posf==SOLF_STAT) {
             p+=sprintf(p,"$MARK,%d,%.3f,%d,%.4f,%.4f,%.4f,%s,%s\r\n",week,tow,
-                       svr->rtk.sol.stat,svr->rtk.sol.rr[0],svr->rtk.sol.rr[1],
-                       svr->rtk.sol.rr[2],name,comment);
+                       sol.stat,sol.rr[0],sol.rr[1],
+                       sol.rr[2],name,comment);
         }
         else if (svr->solopt[i].posf==SOLF_NMEA) {
             p+=sprintf(p,"$GPTXT,01,01,02,MARK:%s,%s,%.9f,%.9f,%.4f,%d,%s",
-                       name,tstr,pos[0]*R2D,pos[1]*R2D,pos[2],svr->rtk.sol.stat,
+                       name,tstr,pos[0]*R2D,pos[1]*R2D,pos[2],sol.stat,
                        comment);
             for (q=(char *)buff+1,sum=0;*q;q++) sum^=*q; /* check-sum */
             p+=sprintf(p,"*%02X\r\n",sum);
         }
         else {
             p+=sprintf(p,"%s MARK: %s,%s,%.9f,%.9f,%.4f,%d,%s\r\n",COMMENTH,
-                       name,tstr,pos[0]*R2D,pos[1]*R2D,pos[2],svr->rtk.sol.stat,
+                       name,tstr,pos[0]*R2D,pos[1]*R2D,pos[2],sol.stat,
                        comment);
         }
         strwrite(svr->stream+i+3,(uint8_t *)buff,(int)(p-buff));
@@ -1157,10 +1454,9 @@ extern int rtksvrmark(rtksvr_t *svr, const char *name, const char *comment)
     if (svr->moni) {
         p=buff;
         p+=sprintf(p,"%s MARK: %s,%s,%.9f,%.9f,%.4f,%d,%s\r\n",COMMENTH,
-                   name,tstr,pos[0]*R2D,pos[1]*R2D,pos[2],svr->rtk.sol.stat,
+                   name,tstr,pos[0]*R2D,pos[1]*R2D,pos[2],sol.stat,
                    comment);
         strwrite(svr->moni,(uint8_t *)buff,(int)(p-buff));
     }
-    rtksvrunlock(svr);
     return 1;
 }
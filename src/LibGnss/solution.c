@@ -53,6 +53,9 @@
 *                            add reading age information in NMEA GGA
 *                            use integer types in stdint.h
 *                            suppress warnings
+*           2026/10/18  1.19 format LLH/XYZ/ENU fields without printf
+*                            support binary solution/status format (SOLF_BIN)
+*                            add api outsolbs(),outsolstatbs()
 *-----------------------------------------------------------------------------*/
 #include <ctype.h>
 #include "rtklib.h"
@@ -68,6 +71,32 @@
 
 #define KNOT2M     0.514444444  /* m/knot */
 
+#define SOLBSYNC1  0xD4         /* binary solution record sync code 1 */
+#define SOLBSYNC2  0x53         /* binary solution record sync code 2 */
+#define SOLB_SOL   1            /* binary record type: solution */
+#define SOLB_SAT   2            /* binary record type: satellite status */
+#define SOLBLEN_SOL 201         /* binary solution payload length (bytes) */
+#define SOLBLEN_SAT 64          /* binary satellite status payload length */
+#define MAXSOLBLEN (4+255+2)    /* max binary record length (bytes) */
+
+/* get/set fields of binary record (little-endian) ---------------------------*/
+static uint64_t getle(const uint8_t *p, int n)
+{
+    uint64_t u=0; while (n--) u=(u<<8)|p[n]; return u;
+}
+static void setle(uint8_t *p, uint64_t u, int n)
+{
+    int i; for (i=0;i<n;i++,u>>=8) p[i]=(uint8_t)u;
+}
+static uint16_t U2(const uint8_t *p) {return (uint16_t)getle(p,2);}
+static float    R4(const uint8_t *p) {uint32_t u=(uint32_t)getle(p,4); float r; memcpy(&r,&u,4); return r;}
+static double   R8(const uint8_t *p) {uint64_t u=getle(p,8); double r; memcpy(&r,&u,8); return r;}
+static int64_t  I8(const uint8_t *p) {return (int64_t)getle(p,8);}
+static void setU2(uint8_t *p, uint16_t u) {setle(p,u,2);}
+static void setR4(uint8_t *p, double   r) {float f=(float)r; uint32_t u; memcpy(&u,&f,4); setle(p,u,4);}
+static void setR8(uint8_t *p, double   r) {uint64_t u; memcpy(&u,&r,8); setle(p,u,8);}
+static void setI8(uint8_t *p, int64_t  i) {setle(p,(uint64_t)i,8);}
+
 static const int nmea_sys[]={ /* NMEA systems */
     SYS_GPS|SYS_SBS,SYS_GLO,SYS_GAL,SYS_CMP,SYS_QZS,SYS_IRN,0
 };
@@ -891,6 +920,118 @@ extern int inputsol(uint8_t data, gtime_t ts, gtime_t te, double tint,
     /* add solution to solution buffer */
     return addsol(solbuf,&sol);
 }
+/* decode binary record header/crc -------------------------------------------*/
+static int test_recb(const uint8_t *buff)
+{
+    int len=buff[3];
+    
+    if (buff[0]!=SOLBSYNC1||buff[1]!=SOLBSYNC2) return 0;
+    if (buff[2]==SOLB_SOL&&len!=SOLBLEN_SOL) return 0;
+    if (buff[2]==SOLB_SAT&&len!=SOLBLEN_SAT) return 0;
+    return U2(buff+4+len)==rtk_crc16(buff,4+len);
+}
+/* read binary solution record -----------------------------------------------*/
+static int readrecb(FILE *fp, uint8_t *buff)
+{
+    int c,len;
+    
+    while ((c=fgetc(fp))!=EOF) {
+        if (c!=SOLBSYNC1) continue;
+        if ((c=fgetc(fp))!=SOLBSYNC2) {
+            if (c==EOF) break;
+            ungetc(c,fp);
+            continue;
+        }
+        buff[0]=SOLBSYNC1; buff[1]=SOLBSYNC2;
+        if (fread(buff+2,1,2,fp)<2) break;
+        len=buff[3];
+        if (fread(buff+4,1,len+2,fp)<(size_t)len+2) break;
+        if (test_recb(buff)) return buff[2];
+        
+        trace(2,"binary solution record error: type=%d len=%d\n",buff[2],len);
+        
+        /* resync just after the rejected sync code */
+        fseek(fp,-(long)(len+4),SEEK_CUR);
+    }
+    return 0;
+}
+/* decode binary solution ----------------------------------------------------*/
+static void decode_solb(const uint8_t *p, sol_t *sol)
+{
+    static const sol_t sol0={{0}};
+    int i;
+    
+    *sol=sol0;
+    sol->time.time=(time_t)I8(p); sol->time.sec=R8(p+8);
+    for (i=0;i<6;i++) sol->rr [i]=R8(p+ 16+i*8);
+    for (i=0;i<6;i++) sol->qr [i]=R4(p+ 64+i*4);
+    for (i=0;i<6;i++) sol->qv [i]=R4(p+ 88+i*4);
+    for (i=0;i<6;i++) sol->dtr[i]=R8(p+112+i*8);
+    for (i=0;i<2;i++) sol->ztrp[i]=R4(p+160+i*4);
+    for (i=0;i<4;i++) sol->dop[i]=R4(p+168+i*4);
+    sol->age     =R4(p+184);
+    sol->ratio   =R4(p+188);
+    sol->thres   =R4(p+192);
+    sol->type    =p[196];
+    sol->stat    =p[197];
+    sol->ns      =p[198];
+    sol->ar_wl_ns=p[199];
+    sol->ar_nl_ns=p[200];
+}
+/* decode binary solution status ---------------------------------------------*/
+static void decode_solstatb(const uint8_t *p, solstat_t *stat)
+{
+    static const solstat_t stat0={{0}};
+    
+    *stat=stat0;
+    stat->time.time=(time_t)I8(p); stat->time.sec=R8(p+8);
+    stat->sat    =p[16];
+    stat->frq    =p[17];
+    stat->flag   =p[18];
+    stat->az     =R4(p+20);
+    stat->el     =R4(p+24);
+    stat->resp   =R4(p+28);
+    stat->resc   =R4(p+32);
+    stat->snr    =(unsigned char)U2(p+36);
+    stat->lock   =U2(p+38);
+    stat->outc   =U2(p+40);
+    stat->slipc  =U2(p+42);
+    stat->rejc   =U2(p+44);
+    stat->amb    =R4(p+48);
+    stat->var_amb=R4(p+52);
+    stat->nv_cp  =R4(p+56);
+    stat->nv_pr  =R4(p+60);
+}
+/* test binary solution file -------------------------------------------------*/
+static int test_solb(FILE *fp)
+{
+    int c1,c2;
+    
+    c1=fgetc(fp); c2=fgetc(fp);
+    rewind(fp);
+    return c1==SOLBSYNC1&&c2==SOLBSYNC2;
+}
+/* read binary solution data -------------------------------------------------*/
+static int readsoldatab(FILE *fp, gtime_t ts, gtime_t te, double tint,
+                        int qflag, solbuf_t *solbuf)
+{
+    sol_t sol;
+    uint8_t buff[MAXSOLBLEN];
+    
+    trace(3,"readsoldatab:\n");
+    
+    while (readrecb(fp,buff)) {
+        if (buff[2]!=SOLB_SOL) continue;
+        decode_solb(buff+4,&sol);
+        
+        if (sol.stat<=SOLQ_NONE||!screent(sol.time,ts,te,tint)||
+            (qflag&&sol.stat!=qflag)) {
+            continue;
+        }
+        addsol(solbuf,&sol);
+    }
+    return solbuf->n>0;
+}
 /* read solution data --------------------------------------------------------*/
 extern int readsoldata(FILE *fp, gtime_t ts, gtime_t te, double tint, int qflag,
                       const solopt_t *opt, solbuf_t *solbuf,int coord)
@@ -961,6 +1102,14 @@ extern int readsolt(char *files[], int nfile, gtime_t ts, gtime_t te,
             trace(2,"readsolt: file open error %s\n",files[i]);
             continue;
         }
+        /* binary solution file */
+        if (test_solb(fp)) {
+            if (!readsoldatab(fp,ts,te,tint,qflag,solbuf)) {
+                trace(2,"readsolt: no solution in %s\n",files[i]);
+            }
+            fclose(fp);
+            continue;
+        }
         /* read solution options in header */
         readsolopt(fp,&opt);
         rewind(fp);
@@ -1197,6 +1346,17 @@ static int readsolstatdata(FILE *fp, gtime_t ts, gtime_t te, double tint,
     
     trace(3,"readsolstatdata:\n");
     
+    if (test_solb(fp)) {
+        while (readrecb(fp,(uint8_t *)buff)) {
+            if ((uint8_t)buff[2]!=SOLB_SAT) continue;
+            decode_solstatb((uint8_t *)buff+4,&stat);
+            
+            if (screent(stat.time,ts,te,tint)) {
+                addsolstat(statbuf,&stat);
+            }
+        }
+        return statbuf->n>0;
+    }
     while (fgets(buff,sizeof(buff),fp)) {
         
         /* decode solution status */
@@ -1238,7 +1398,7 @@ extern int readsolstatt(char *files[], int nfile, gtime_t ts, gtime_t te,
         else {
             sprintf(path,"%s.stat",files[i]);
         }
-        if (!(fp=fopen(path,"r"))) {
+        if (!(fp=fopen(path,"rb"))) {
             trace(2,"readsolstatt: file open error %s\n",path);
             continue;
         }
@@ -1459,31 +1619,39 @@ extern int readref(const char *file,solbuf_t *sol,const solopt_t *sopt,int week,
     return sol->n;
 }
 
+/* output separator and fixed-point field ------------------------------------*/
+static char *outfld(char *p, const char *sep, double value, int width, int prec)
+{
+    while (*sep) *p++=*sep++;
+    return p+fixf2str(p,value,width,prec);
+}
 /* output solution as the form of x/y/z-ecef ---------------------------------*/
 static int outecef(uint8_t *buff, const char *s, const sol_t *sol,
                    const solopt_t *opt)
 {
     const char *sep=opt2sep(opt);
     char *p=(char *)buff;
+    int i;
     
     trace(3,"outecef:\n");
     
-    p+=sprintf(p,"%s%s%14.4f%s%14.4f%s%14.4f%s%3d%s%3d%s%4.1f%s%8.4f%s%8.4f%s%8.4f%s"
-               "%8.4f%s%8.4f%s%8.4f%s%6.2f%s%6.1f",
-               s,sep,sol->rr[0],sep,sol->rr[1],sep,sol->rr[2],sep,sol->stat,sep,
-               sol->ns,sep,sol->dop[1],sep,SQRT(sol->qr[0]),sep,SQRT(sol->qr[1]),sep,
-               SQRT(sol->qr[2]),sep,sqvar(sol->qr[3]),sep,sqvar(sol->qr[4]),sep,
-               sqvar(sol->qr[5]),sep,sol->age,sep,sol->ratio);
+    p+=sprintf(p,"%s",s);
+    for (i=0;i<3;i++) p=outfld(p,sep,sol->rr[i],14,4);
+    p=outfld(p,sep,sol->stat,3,0);
+    p=outfld(p,sep,sol->ns,3,0);
+    p=outfld(p,sep,sol->dop[1],4,1);
+    for (i=0;i<3;i++) p=outfld(p,sep,SQRT(sol->qr[i]),8,4);
+    for (i=3;i<6;i++) p=outfld(p,sep,sqvar(sol->qr[i]),8,4);
+    p=outfld(p,sep,sol->age,6,2);
+    p=outfld(p,sep,sol->ratio,6,1);
     
     if (opt->outvel) { /* output velocity */
-        p+=sprintf(p,"%s%10.5f%s%10.5f%s%10.5f%s%9.5f%s%8.5f%s%8.5f%s%8.5f%s"
-                   "%8.5f%s%8.5f",
-                   sep,sol->rr[3],sep,sol->rr[4],sep,sol->rr[5],sep,
-                   SQRT(sol->qv[0]),sep,SQRT(sol->qv[1]),sep,SQRT(sol->qv[2]),
-                   sep,sqvar(sol->qv[3]),sep,sqvar(sol->qv[4]),sep,
-                   sqvar(sol->qv[5]));
+        for (i=3;i<6;i++) p=outfld(p,sep,sol->rr[i],10,5);
+        p=outfld(p,sep,SQRT(sol->qv[0]),9,5);
+        for (i=1;i<3;i++) p=outfld(p,sep,SQRT(sol->qv[i]),8,5);
+        for (i=3;i<6;i++) p=outfld(p,sep,sqvar(sol->qv[i]),8,5);
     }
-    p+=sprintf(p,"\r\n");
+    *p++='\r'; *p++='\n';
     return p-(char *)buff;
 }
 /* output solution as the form of lat/lon/height -----------------------------*/
@@ -1510,133 +1678,145 @@ static int outpos(uint8_t *buff, const char *s, const sol_t *sol,
                    dms2[2]);
     }
     else {
-        p+=sprintf(p,"%s%s%14.9f%s%14.9f",s,sep,pos[0]*R2D,sep,pos[1]*R2D);
-    }
-
-    p+=sprintf(p,"%s%10.4f%s%3d%s%3d%s%4.1f%s%8.4f%s%8.4f%s%8.4f%s%8.4f%s%8.4f%s%8.4f"
-               "%s%6.2f%s%6.1f",
-               sep,pos[2],sep,sol->stat,sep,sol->ns,sep,sol->dop[1],sep,SQRT(Q[4]),sep,
-               SQRT(Q[0]),sep,SQRT(Q[8]),sep,sqvar(Q[1]),sep,sqvar(Q[2]),
-               sep,sqvar(Q[5]),sep,sol->age,sep,sol->ratio);
+        p+=sprintf(p,"%s",s);
+        p=outfld(p,sep,pos[0]*R2D,14,9);
+        p=outfld(p,sep,pos[1]*R2D,14,9);
+    }
+    p=outfld(p,sep,pos[2],10,4);
+    p=outfld(p,sep,sol->stat,3,0);
+    p=outfld(p,sep,sol->ns,3,0);
+    p=outfld(p,sep,sol->dop[1],4,1);
+    p=outfld(p,sep,SQRT(Q[4]),8,4);
+    p=outfld(p,sep,SQRT(Q[0]),8,4);
+    p=outfld(p,sep,SQRT(Q[8]),8,4);
+    p=outfld(p,sep,sqvar(Q[1]),8,4);
+    p=outfld(p,sep,sqvar(Q[2]),8,4);
+    p=outfld(p,sep,sqvar(Q[5]),8,4);
+    p=outfld(p,sep,sol->age,6,2);
+    p=outfld(p,sep,sol->ratio,6,1);
     
     if (opt->outvel) { /* output velocity */
         soltocov_vel(sol,P);
         ecef2enu(pos,sol->rr+3,vel);
         covenu(pos,P,Q);/*NED*/
-        p+=sprintf(p,"%s%10.5f%s%10.5f%s%10.5f%s%9.5f%s%8.5f%s%8.5f%s%8.5f%s"
-                   "%8.5f%s%8.5f",
-                   sep,vel[1],sep,vel[0],sep,vel[2],sep,SQRT(Q[4]),sep,
-                   SQRT(Q[0]),sep,SQRT(Q[8]),sep,sqvar(Q[1]),sep,sqvar(Q[2]),
-                   sep,sqvar(Q[5]));
+        p=outfld(p,sep,vel[1],10,5);
+        p=outfld(p,sep,vel[0],10,5);
+        p=outfld(p,sep,vel[2],10,5);
+        p=outfld(p,sep,SQRT(Q[4]),9,5);
+        p=outfld(p,sep,SQRT(Q[0]),8,5);
+        p=outfld(p,sep,SQRT(Q[8]),8,5);
+        p=outfld(p,sep,sqvar(Q[1]),8,5);
+        p=outfld(p,sep,sqvar(Q[2]),8,5);
+        p=outfld(p,sep,sqvar(Q[5]),8,5);
     }
 
     if(opt->outclk){
         if(popt->navsys&SYS_GPS){ /*GPS main*/
-            p+=sprintf(p,"%s%12.2f",sep,sol->dtr[0]*1E9);/* GPS receiver clock offset ns*/
+            p=outfld(p,sep,sol->dtr[0]*1E9,12,2);/* GPS receiver clock offset ns*/
             if(popt->navsys&SYS_GLO){
-                p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[1])*1E9);/* GLO receiver clock offset ns*/
+                p=outfld(p,sep,(sol->dtr[1])*1E9,12,2);/* GLO receiver clock offset ns*/
             }
             if(popt->navsys&SYS_GAL){
-                p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[2])*1E9);/* GAL clock offset ns*/
+                p=outfld(p,sep,(sol->dtr[2])*1E9,12,2);/* GAL clock offset ns*/
             }
             if(popt->navsys&SYS_CMP){
                 if(popt->bd3opt<=BD3OPT_BD23){
-                    p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[3])*1E9);/* BDS clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[3])*1E9,12,2);/* BDS clock offset ns*/
                 }
                 else if(popt->bd3opt==BD3OPT_BD2_3){
-                    p+=sprintf(p,"%s%12.2f%s%12.2f",sep,(sol->dtr[3])*1E9,sep,(sol->dtr[5])*1E9);/* BD2 and BD3 clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[3])*1E9,12,2); p=outfld(p,sep,(sol->dtr[5])*1E9,12,2);/* BD2 and BD3 clock offset ns*/
                 }
                 else if(popt->bd3opt==BD3OPT_BD3){
-                    p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[5])*1E9);/* BD3 clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[5])*1E9,12,2);/* BD3 clock offset ns*/
                 }
             }
             if(popt->navsys&SYS_QZS){
-                p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[4])*1E9);/* QZS clock offset ns*/
+                p=outfld(p,sep,(sol->dtr[4])*1E9,12,2);/* QZS clock offset ns*/
             }
         }
         else if(popt->navsys&SYS_GLO){ /*GLO main*/
-            p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[1])*1E9);/* GLO receiver clock offset ns*/
+            p=outfld(p,sep,(sol->dtr[1])*1E9,12,2);/* GLO receiver clock offset ns*/
             if(popt->navsys&SYS_GAL){
-                p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[2])*1E9);/* GAL clock offset ns*/
+                p=outfld(p,sep,(sol->dtr[2])*1E9,12,2);/* GAL clock offset ns*/
             }
             if(popt->navsys&SYS_CMP){
                 if(popt->bd3opt<=BD3OPT_BD23){
-                    p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[3])*1E9);/* BDS clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[3])*1E9,12,2);/* BDS clock offset ns*/
                 }
                 else if(popt->bd3opt==BD3OPT_BD2_3){
-                    p+=sprintf(p,"%s%12.2f%s%12.2f",sep,(sol->dtr[3])*1E9,sep,(sol->dtr[5])*1E9);/* BD2 and BD3 clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[3])*1E9,12,2); p=outfld(p,sep,(sol->dtr[5])*1E9,12,2);/* BD2 and BD3 clock offset ns*/
                 }
                 else if(popt->bd3opt==BD3OPT_BD3){
-                    p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[5])*1E9);/* BD3 clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[5])*1E9,12,2);/* BD3 clock offset ns*/
                 }
             }
             if(popt->navsys&SYS_QZS){
-                p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[4])*1E9);/* QZS clock offset ns*/
+                p=outfld(p,sep,(sol->dtr[4])*1E9,12,2);/* QZS clock offset ns*/
             }
         }
         else if(popt->navsys&SYS_GAL){ /*GAL main*/
-            p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[2])*1E9);/* GAL clock offset ns*/
+            p=outfld(p,sep,(sol->dtr[2])*1E9,12,2);/* GAL clock offset ns*/
             if(popt->navsys&SYS_CMP){
                 if(popt->bd3opt<=BD3OPT_BD23){
-                    p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[3])*1E9);/* BDS clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[3])*1E9,12,2);/* BDS clock offset ns*/
                 }
                 else if(popt->bd3opt==BD3OPT_BD2_3){
-                    p+=sprintf(p,"%s%12.2f%s%12.2f",sep,(sol->dtr[3])*1E9,sep,(sol->dtr[5])*1E9);/* BD2 and BD3 clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[3])*1E9,12,2); p=outfld(p,sep,(sol->dtr[5])*1E9,12,2);/* BD2 and BD3 clock offset ns*/
                 }
                 else if(popt->bd3opt==BD3OPT_BD3){
-                    p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[5])*1E9);/* BD3 clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[5])*1E9,12,2);/* BD3 clock offset ns*/
                 }
             }
             if(popt->navsys&SYS_QZS){
-                p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[4])*1E9);/* QZS clock offset ns*/
+                p=outfld(p,sep,(sol->dtr[4])*1E9,12,2);/* QZS clock offset ns*/
             }
         }
         else if(popt->navsys&SYS_CMP){ /*BDS main*/
             if(popt->bd3opt<=BD3OPT_BD23){
-                p+=sprintf(p,"%s%12.2f",sep,sol->dtr[3]*1E9);
+                p=outfld(p,sep,sol->dtr[3]*1E9,12,2);
                 if(popt->navsys&SYS_QZS){
-                    p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[4])*1E9);/* QZS clock offset ns*/
+                    p=outfld(p,sep,(sol->dtr[4])*1E9,12,2);/* QZS clock offset ns*/
                 }
             }
             else if(popt->bd3opt==BD3OPT_BD2_3){
-                p+=sprintf(p,"%s%12.2f%s%12.2f",sep,sol->dtr[3]*1E9,sep,(sol->dtr[5])*1E9);
+                p=outfld(p,sep,sol->dtr[3]*1E9,12,2); p=outfld(p,sep,(sol->dtr[5])*1E9,12,2);
             }
             if(popt->navsys&SYS_QZS){
-                p+=sprintf(p,"%s%12.2f",sep,(sol->dtr[4])*1E9);/* QZS clock offset ns*/
+                p=outfld(p,sep,(sol->dtr[4])*1E9,12,2);/* QZS clock offset ns*/
             }
         }
     }
     if(opt->outtrp){
-        p+=sprintf(p,"%s%12.2f%s%12.2f",sep,sol->ztrp[0],sep,sol->ztrp[1]);/* IRN clock offset ns*/
+        p=outfld(p,sep,sol->ztrp[0],12,2); p=outfld(p,sep,sol->ztrp[1],12,2);/* IRN clock offset ns*/
     }
 
     if(popt->ionoopt==IONOOPT_UC_CONS){
-        if(popt->navsys&SYS_GPS) p+=sprintf(p,"%s%12.2f",sep,sol->rdcb[0]*1E9);
-        if(popt->navsys&SYS_GLO) p+=sprintf(p,"%s%12.2f",sep,sol->rdcb[1]*1E9);
-        if(popt->navsys&SYS_GAL) p+=sprintf(p,"%s%12.2f",sep,sol->rdcb[2]*1E9);
+        if(popt->navsys&SYS_GPS) p=outfld(p,sep,sol->rdcb[0]*1E9,12,2);
+        if(popt->navsys&SYS_GLO) p=outfld(p,sep,sol->rdcb[1]*1E9,12,2);
+        if(popt->navsys&SYS_GAL) p=outfld(p,sep,sol->rdcb[2]*1E9,12,2);
         if(popt->navsys&SYS_CMP||popt->navsys&SYS_BD3){
             if(popt->bd3opt<=BD3OPT_BD23){
-                p+=sprintf(p,"%s%12.2f",sep,sol->rdcb[3]*1E9);
+                p=outfld(p,sep,sol->rdcb[3]*1E9,12,2);
             }
             else if(popt->bd3opt==BD3OPT_BD2_3){
-                p+=sprintf(p,"%s%12.2f%s%12.2f",sep,sol->rdcb[3]*1E9,sep,sol->rdcb[5]*1E-9);
+                p=outfld(p,sep,sol->rdcb[3]*1E9,12,2); p=outfld(p,sep,sol->rdcb[5]*1E-9,12,2);
             }
             else{
-                p+=sprintf(p,"%s%12.2f",sep,sol->rdcb[5]*1E9);
+                p=outfld(p,sep,sol->rdcb[5]*1E9,12,2);
             }
         }
-        if(popt->navsys&SYS_QZS) p+=sprintf(p,"%s%12.2f",sep,sol->rdcb[4]*1E9);
+        if(popt->navsys&SYS_QZS) p=outfld(p,sep,sol->rdcb[4]*1E9,12,2);
     }
 
     if(popt->nf>=3&&(popt->ionoopt==IONOOPT_UC||popt->ionoopt==IONOOPT_UC_CONS)){
-        if(popt->navsys&SYS_GPS) p+=sprintf(p,"%s%12.2f",sep,sol->ifcb[0]*1E9);
-        if(popt->navsys&SYS_GLO) p+=sprintf(p,"%s%12.2f",sep,sol->ifcb[1]*1E9);
-        if(popt->navsys&SYS_GAL) p+=sprintf(p,"%s%12.2f",sep,sol->ifcb[2]*1E9);
-        if(popt->navsys&SYS_CMP) p+=sprintf(p,"%s%12.2f",sep,sol->ifcb[3]*1E9);
-        if(popt->navsys&SYS_QZS) p+=sprintf(p,"%s%12.2f",sep,sol->ifcb[4]*1E9);
+        if(popt->navsys&SYS_GPS) p=outfld(p,sep,sol->ifcb[0]*1E9,12,2);
+        if(popt->navsys&SYS_GLO) p=outfld(p,sep,sol->ifcb[1]*1E9,12,2);
+        if(popt->navsys&SYS_GAL) p=outfld(p,sep,sol->ifcb[2]*1E9,12,2);
+        if(popt->navsys&SYS_CMP) p=outfld(p,sep,sol->ifcb[3]*1E9,12,2);
+        if(popt->navsys&SYS_QZS) p=outfld(p,sep,sol->ifcb[4]*1E9,12,2);
     }
 
-    p+=sprintf(p,"\r\n");
+    *p++='\r'; *p++='\n';
     return p-(char *)buff;
 }
 /* output solution as the form of e/n/u-baseline -----------------------------*/
@@ -1655,11 +1835,20 @@ static int outenu(uint8_t *buff, const char *s, const sol_t *sol,
     soltocov(sol,P);
     covenu(pos,P,Q);
     ecef2enu(pos,rr,enu);
-    p+=sprintf(p,"%s%s%14.4f%s%14.4f%s%14.4f%s%3d%s%3d%s%4.1f%s%8.4f%s%8.4f%s%8.4f%s"
-               "%8.4f%s%8.4f%s%8.4f%s%6.2f%s%6.1f\r\n",
-               s,sep,enu[0],sep,enu[1],sep,enu[2],sep,sol->stat,sep,sol->ns,sep,sol->dop[1],sep,
-               SQRT(Q[0]),sep,SQRT(Q[4]),sep,SQRT(Q[8]),sep,sqvar(Q[1]),
-               sep,sqvar(Q[5]),sep,sqvar(Q[2]),sep,sol->age,sep,sol->ratio);
+    p+=sprintf(p,"%s",s);
+    for (i=0;i<3;i++) p=outfld(p,sep,enu[i],14,4);
+    p=outfld(p,sep,sol->stat,3,0);
+    p=outfld(p,sep,sol->ns,3,0);
+    p=outfld(p,sep,sol->dop[1],4,1);
+    p=outfld(p,sep,SQRT(Q[0]),8,4);
+    p=outfld(p,sep,SQRT(Q[4]),8,4);
+    p=outfld(p,sep,SQRT(Q[8]),8,4);
+    p=outfld(p,sep,sqvar(Q[1]),8,4);
+    p=outfld(p,sep,sqvar(Q[5]),8,4);
+    p=outfld(p,sep,sqvar(Q[2]),8,4);
+    p=outfld(p,sep,sol->age,6,2);
+    p=outfld(p,sep,sol->ratio,6,1);
+    *p++='\r'; *p++='\n';
     return p-(char *)buff;
 }
 /* output solution in the form of NMEA RMC sentence --------------------------*/
@@ -2030,7 +2219,8 @@ extern int outsolheads(uint8_t *buff, const solopt_t *opt,const prcopt_t *popt)
     trace(4,"outsolheads:\n");
     ins=popt->mode>=PMODE_INS_MECH;
 
-    if (opt->posf==SOLF_NMEA||opt->posf==SOLF_STAT||opt->posf==SOLF_GSIF) {
+    if (opt->posf==SOLF_NMEA||opt->posf==SOLF_STAT||opt->posf==SOLF_GSIF||
+        opt->posf==SOLF_BIN) {
         return 0;
     }
     if (opt->outhead) {
@@ -2260,6 +2450,86 @@ static double sol_std(const sol_t *sol)
     if (sol->qr[1]>sol->qr[2]) return SQRT(sol->qr[1]);
     return SQRT(sol->qr[2]);
 }
+/* output binary solution record ---------------------------------------------
+* output solution as binary record
+* args   : uint8_t *buff    IO  output buffer
+*          sol_t  *sol      I   solution
+* return : number of output bytes
+* notes  : record = sync (0xD4,0x53) + type (1) + payload length + payload +
+*          crc-16 of the preceding bytes. all fields are little-endian
+*          regardless of the host byte order (R4,R8: ieee 754 binary).
+*          payload (201 bytes):
+*            0: time.time (I8)   8: time.sec (R8)  16: rr[6] (R8)
+*           64: qr[6] (R4)      88: qv[6] (R4)    112: dtr[6] (R8)
+*          160: ztrp[2] (R4)   168: dop[4] (R4)   184: age (R4)
+*          188: ratio (R4)     192: thres (R4)
+*          196: type,stat,ns,ar_wl_ns,ar_nl_ns (U1)
+*-----------------------------------------------------------------------------*/
+extern int outsolbs(uint8_t *buff, const sol_t *sol)
+{
+    uint8_t *p=buff+4;
+    int i;
+    
+    trace(4,"outsolbs:\n");
+    
+    buff[0]=SOLBSYNC1; buff[1]=SOLBSYNC2; buff[2]=SOLB_SOL; buff[3]=SOLBLEN_SOL;
+    setI8(p,(int64_t)sol->time.time); setR8(p+8,sol->time.sec);
+    for (i=0;i<6;i++) setR8(p+ 16+i*8,sol->rr [i]);
+    for (i=0;i<6;i++) setR4(p+ 64+i*4,sol->qr [i]);
+    for (i=0;i<6;i++) setR4(p+ 88+i*4,sol->qv [i]);
+    for (i=0;i<6;i++) setR8(p+112+i*8,sol->dtr[i]);
+    for (i=0;i<2;i++) setR4(p+160+i*4,sol->ztrp[i]);
+    for (i=0;i<4;i++) setR4(p+168+i*4,sol->dop[i]);
+    setR4(p+184,sol->age);
+    setR4(p+188,sol->ratio);
+    setR4(p+192,sol->thres);
+    p[196]=sol->type;
+    p[197]=sol->stat;
+    p[198]=sol->ns;
+    p[199]=sol->ar_wl_ns;
+    p[200]=sol->ar_nl_ns;
+    setU2(buff+4+SOLBLEN_SOL,rtk_crc16(buff,4+SOLBLEN_SOL));
+    return 4+SOLBLEN_SOL+2;
+}
+/* output binary solution status record ----------------------------------------
+* output solution status as binary record
+* args   : uint8_t *buff    IO  output buffer
+*          solstat_t *stat  I   solution status
+* return : number of output bytes
+* notes  : record type 2, payload (64 bytes):
+*            0: time.time (I8)   8: time.sec (R8)  16: sat,frq,flag (U1)
+*           20: az,el,resp,resc (R4)              36: snr (U2)
+*           38: lock,outc,slipc,rejc (U2)
+*           48: amb,var_amb,nv_cp,nv_pr (R4)
+*-----------------------------------------------------------------------------*/
+extern int outsolstatbs(uint8_t *buff, const solstat_t *stat)
+{
+    uint8_t *p=buff+4;
+    
+    trace(4,"outsolstatbs:\n");
+    
+    memset(buff,0,4+SOLBLEN_SAT);
+    buff[0]=SOLBSYNC1; buff[1]=SOLBSYNC2; buff[2]=SOLB_SAT; buff[3]=SOLBLEN_SAT;
+    setI8(p,(int64_t)stat->time.time); setR8(p+8,stat->time.sec);
+    p[16]=stat->sat;
+    p[17]=stat->frq;
+    p[18]=stat->flag;
+    setR4(p+20,stat->az);
+    setR4(p+24,stat->el);
+    setR4(p+28,stat->resp);
+    setR4(p+32,stat->resc);
+    setU2(p+36,stat->snr);
+    setU2(p+38,stat->lock);
+    setU2(p+40,stat->outc);
+    setU2(p+42,stat->slipc);
+    setU2(p+44,stat->rejc);
+    setR4(p+48,stat->amb);
+    setR4(p+52,stat->var_amb);
+    setR4(p+56,stat->nv_cp);
+    setR4(p+60,stat->nv_pr);
+    setU2(buff+4+SOLBLEN_SAT,rtk_crc16(buff,4+SOLBLEN_SAT));
+    return 4+SOLBLEN_SAT+2;
+}
 /* output solution body --------------------------------------------------------
 * output solution body to buffer
 * args   : uint8_t *buff    IO  output buffer
@@ -2291,6 +2561,8 @@ extern int outsols(uint8_t *buff, const sol_t *sol, const double *rb,
     if (sol->stat<=SOLQ_NONE||(opt->posf==SOLF_ENU&&norm(rb,3)<=0.0)) {
         return 0;
     }
+    if (opt->posf==SOLF_BIN) return outsolbs(buff,sol);
+    
     timeu=opt->timeu<0?0:(opt->timeu>20?20:opt->timeu);
     
     time=sol->time;
@@ -74,15 +74,25 @@
 *                           accept HTTP/1.1 as protocol for NTRIP caster
 *                           suppress warning for buffer overflow by sprintf()
 *                           use integer types in stdint.h
+*           2026/10/18 1.30 add api strwaitinit(),strwaitfree(),strwait()
+*                           add api strwaitp()
+*           2026/10/18 1.31 add api strwritefrm(),strfrmnew(),strfrmfree()
+*                           queue data not sent to tcp server clients
+*                           support stream type STR_NTRIPCAS in API stropen()
 *-----------------------------------------------------------------------------*/
 #include <ctype.h>
 #include "rtklib.h"
 #ifndef WIN32
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#ifndef __USE_MISC
 #define __USE_MISC
+#endif
 #ifndef CRTSCTS
 #define CRTSCTS  020000000000
 #endif
@@ -103,6 +113,10 @@
 #define MAXCLI              32          /* max client connection for tcp svr */
 #define MAXSTATMSG          32          /* max length of status message */
 #define DEFAULT_MEMBUF_SIZE 4096        /* default memory buffer size (bytes) */
+#define MAXWAITEV           64          /* max number of events per wait */
+#define TINTWAITREG         1000        /* interval of re-registration (ms) */
+#define MAXSENDQ            256         /* max frames in client send queue */
+#define SENDQSIZE           262144      /* max bytes in client send queue */
 
 #define NTRIP_AGENT         "RTKLIB/" VER_RTKLIB
 #define NTRIP_CLI_PORT      2101        /* default ntrip-client connection port */
@@ -173,9 +187,17 @@ typedef struct {            /* tcp control type */
     uint32_t tdis;          /* disconnect tick */
 } tcp_t;
 
+typedef struct {            /* client send queue type */
+    int n,rp;               /* number of queued frames and read pointer */
+    int off;                /* sent bytes of first frame */
+    int nb;                 /* queued bytes not sent */
+    strfrm_t *frm[MAXSENDQ]; /* queued frames */
+} sendq_t;
+
 typedef struct tcpsvr_tag { /* tcp server type */
     tcp_t svr;              /* tcp server control */
     tcp_t cli[MAXCLI];      /* tcp client controls */
+    sendq_t que[MAXCLI];    /* tcp client send queues */
 } tcpsvr_t;
 
 typedef struct {            /* tcp cilent type */
@@ -264,7 +286,8 @@ typedef struct {            /* memory buffer type */
 
 static tcpsvr_t *opentcpsvr(const char *path, char *msg);
 static void closetcpsvr(tcpsvr_t *tcpsvr);
-static int writetcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, char *msg);
+static int writetcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, strfrm_t *frm,
+                       char *msg);
 
 /* global options ------------------------------------------------------------*/
 
@@ -518,7 +541,7 @@ static int readserial(serial_t *serial, uint8_t *buff, int n, char *msg)
     
     /* write received stream to tcp server port */
     if (serial->tcpsvr&&nr>0) {
-        writetcpsvr(serial->tcpsvr,buff,(int)nr,msg_tcp);
+        writetcpsvr(serial->tcpsvr,buff,(int)nr,NULL,msg_tcp);
     }
     return nr;
 }
@@ -1082,6 +1105,28 @@ static int send_nb(socket_t sock, uint8_t *buff, int n)
     ns=send(sock,(char *)buff,n,0);
     return ns<n?-1:ns;
 }
+/* non-block partial send ----------------------------------------------------*/
+static int send_part(socket_t sock, const uint8_t *buff, int n)
+{
+#ifdef WIN32
+    u_long mode=1;
+    int ns,err;
+
+    /* no MSG_DONTWAIT on winsock: switch to non-blocking during send */
+    if (ioctlsocket(sock,FIONBIO,&mode)) return -1;
+    ns=send(sock,(const char *)buff,n,0);
+    err=errsock();
+    mode=0;
+    ioctlsocket(sock,FIONBIO,&mode);
+    if (ns>=0) return ns;
+    return err==WSAEWOULDBLOCK||err==WSAEINTR?0:-1;
+#else
+    int ns;
+
+    if ((ns=send(sock,(const char *)buff,n,MSG_DONTWAIT))>=0) return ns;
+    return errno==EAGAIN||errno==EWOULDBLOCK||errno==EINTR?0:-1;
+#endif
+}
 /* generate tcp socket -------------------------------------------------------*/
 static int gentcp(tcp_t *tcp, int type, char *msg)
 {
@@ -1150,6 +1195,87 @@ static void discontcp(tcp_t *tcp, int tcon)
     tcp->tcon=tcon;
     tcp->tdis=tickget();
 }
+/* add reference count of frame ----------------------------------------------*/
+#ifdef WIN32
+static int addref(strfrm_t *frm, int n)
+{
+    return (int)InterlockedExchangeAdd((volatile LONG *)&frm->nref,n)+n;
+}
+#else
+static int addref(strfrm_t *frm, int n)
+{
+    return __atomic_add_fetch(&frm->nref,n,__ATOMIC_ACQ_REL);
+}
+#endif
+/* clear client send queue ---------------------------------------------------*/
+static void clearque(sendq_t *que)
+{
+    for (;que->n>0;que->n--) {
+        strfrmfree(que->frm[que->rp]);
+        que->rp=(que->rp+1)%MAXSENDQ;
+    }
+    que->rp=que->off=que->nb=0;
+}
+/* flush client send queue ---------------------------------------------------*/
+static int flushque(sendq_t *que, socket_t sock)
+{
+    strfrm_t *frm;
+    int ns;
+
+    while (que->n>0) {
+        frm=que->frm[que->rp];
+        if ((ns=send_part(sock,frm->buff+que->off,frm->n-que->off))<0) {
+            return -1;
+        }
+        que->nb-=ns;
+        if ((que->off+=ns)<frm->n) break;
+        strfrmfree(frm);
+        que->rp=(que->rp+1)%MAXSENDQ;
+        que->n--;
+        que->off=0;
+    }
+    return que->n;
+}
+/* send data to tcp server client --------------------------------------------*/
+static int sendcli(tcpsvr_t *tcpsvr, int i, const uint8_t *buff, int n,
+                   strfrm_t **frm)
+{
+    sendq_t *que=tcpsvr->que+i;
+    int ns=0;
+
+    /* send queued data before new data */
+    if (flushque(que,tcpsvr->cli[i].sock)<0) {
+        tracet(2,"sendcli: send error i=%d sock=%d err=%d\n",i,
+               tcpsvr->cli[i].sock,errsock());
+        return 0;
+    }
+    if (que->n<=0) {
+        if ((ns=send_part(tcpsvr->cli[i].sock,buff,n))<0) {
+            tracet(2,"sendcli: send error i=%d sock=%d err=%d\n",i,
+                   tcpsvr->cli[i].sock,errsock());
+            return 0;
+        }
+        if (ns>=n) return 1;
+        que->off=ns;
+    }
+    /* queue rest of data as shared frame (slow client disconnected) */
+    if (que->n>=MAXSENDQ||(que->n>0&&que->nb+n-ns>SENDQSIZE)) {
+        tracet(2,"sendcli: send queue overflow i=%d sock=%d nb=%d\n",i,
+               tcpsvr->cli[i].sock,que->nb);
+        return 0;
+    }
+    if (!*frm&&!(*frm=strfrmnew(buff,n))) return 0;
+    addref(*frm,1);
+    que->frm[(que->rp+que->n++)%MAXSENDQ]=*frm;
+    que->nb+=n-ns;
+    return 1;
+}
+/* disconnect tcp server client ----------------------------------------------*/
+static void discontcpsvr(tcpsvr_t *tcpsvr, int i)
+{
+    discontcp(&tcpsvr->cli[i],ticonnect);
+    clearque(tcpsvr->que+i);
+}
 /* open tcp server -----------------------------------------------------------*/
 static tcpsvr_t *opentcpsvr(const char *path, char *msg)
 {
@@ -1183,6 +1309,7 @@ static void closetcpsvr(tcpsvr_t *tcpsvr)
     
     for (i=0;i<MAXCLI;i++) {
         if (tcpsvr->cli[i].state) closesocket(tcpsvr->cli[i].sock);
+        clearque(tcpsvr->que+i);
     }
     closesocket(tcpsvr->svr.sock);
     free(tcpsvr);
@@ -1248,15 +1375,26 @@ static int accsock(tcpsvr_t *tcpsvr, char *msg)
     tcpsvr->cli[i].tact=tickget();
     return 1;
 }
-/* wait socket accept --------------------------------------------------------*/
+/* wait socket accept and flush client send queues ---------------------------*/
 static int waittcpsvr(tcpsvr_t *tcpsvr, char *msg)
 {
+    int i;
+    
     tracet(4,"waittcpsvr: sock=%d state=%d\n",tcpsvr->svr.sock,tcpsvr->svr.state);
     
     if (tcpsvr->svr.state<=0) return 0;
     
     while (accsock(tcpsvr,msg)) ;
     
+    for (i=0;i<MAXCLI;i++) {
+        if (tcpsvr->cli[i].state!=2||tcpsvr->que[i].n<=0) continue;
+        
+        if (flushque(tcpsvr->que+i,tcpsvr->cli[i].sock)<0) {
+            tracet(2,"waittcpsvr: send error i=%d sock=%d err=%d\n",i,
+                   tcpsvr->cli[i].sock,errsock());
+            discontcpsvr(tcpsvr,i);
+        }
+    }
     updatetcpsvr(tcpsvr,msg);
     return tcpsvr->svr.state==2;
 }
@@ -1277,7 +1415,7 @@ static int readtcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, char *msg)
                 tracet(2,"readtcpsvr: recv error sock=%d err=%d\n",
                        tcpsvr->cli[i].sock,err);
             }
-            discontcp(&tcpsvr->cli[i],ticonnect);
+            discontcpsvr(tcpsvr,i);
             updatetcpsvr(tcpsvr,msg);
         }
         if (nr>0) {
@@ -1288,31 +1426,31 @@ static int readtcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, char *msg)
     return 0;
 }
 /* write tcp server ----------------------------------------------------------*/
-static int writetcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, char *msg)
+static int writetcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, strfrm_t *frm,
+                       char *msg)
 {
-    int i,ns=0,nmax=0,err;
+    strfrm_t *f=frm;
+    int i,ns=0;
     
     tracet(4,"writetcpsvr: state=%d n=%d\n",tcpsvr->svr.state,n);
     
     if (!waittcpsvr(tcpsvr,msg)) return 0;
     
+    /* data not sent are queued as frame shared by clients */
     for (i=0;i<MAXCLI;i++) {
         if (tcpsvr->cli[i].state!=2) continue;
         
-        if ((ns=send_nb(tcpsvr->cli[i].sock,buff,n))==-1) {
-            if ((err=errsock())) {
-                tracet(2,"writetcpsvr: send error i=%d sock=%d err=%d\n",i,
-                       tcpsvr->cli[i].sock,err);
-            }
-            discontcp(&tcpsvr->cli[i],ticonnect);
+        if (!sendcli(tcpsvr,i,buff,n,&f)) {
+            discontcpsvr(tcpsvr,i);
             updatetcpsvr(tcpsvr,msg);
         }
         else {
-            if (ns>nmax) nmax=ns;
-            if (ns>0) tcpsvr->cli[i].tact=tickget();
+            ns=n;
+            tcpsvr->cli[i].tact=tickget();
         }
     }
-    return nmax;
+    if (f!=frm) strfrmfree(f);
+    return ns;
 }
 /* get state tcp server ------------------------------------------------------*/
 static int statetcpsvr(tcpsvr_t *tcpsvr)
@@ -1843,7 +1981,7 @@ static void discon_ntripc(ntripc_t *ntripc, int i)
 {
     tracet(3,"discon_ntripc: i=%d\n",i);
     
-    discontcp(&ntripc->tcp->cli[i],ticonnect);
+    discontcpsvr(ntripc->tcp,i);
     ntripc->con[i].nb=0;
     ntripc->con[i].buff[0]='\0';
     ntripc->con[i].state=0;
@@ -1929,13 +2067,22 @@ static void rsp_ntripc(ntripc_t *ntripc, int i)
 static void wait_ntripc(ntripc_t *ntripc, char *msg)
 {
     uint8_t *buff;
-    int i,n,nmax,err;
+    int i,n,nmax,err,stat;
     
     tracet(4,"wait_ntripc\n");
     
     ntripc->state=ntripc->tcp->svr.state;
     
-    if (!waittcpsvr(ntripc->tcp,msg)) return;
+    stat=waittcpsvr(ntripc->tcp,msg);
+    
+    /* reset connections disconnected by send error */
+    for (i=0;i<MAXCLI;i++) {
+        if (!ntripc->con[i].state||ntripc->tcp->cli[i].state) continue;
+        ntripc->con[i].nb=0;
+        ntripc->con[i].buff[0]='\0';
+        ntripc->con[i].state=0;
+    }
+    if (!stat) return;
     
     for (i=0;i<MAXCLI;i++) {
         if (ntripc->tcp->cli[i].state!=2||ntripc->con[i].state) continue;
@@ -1988,30 +2135,29 @@ static int readntripc(ntripc_t *ntripc, uint8_t *buff, int n, char *msg)
     return 0;
 }
 /* write ntrip-caster --------------------------------------------------------*/
-static int writentripc(ntripc_t *ntripc, uint8_t *buff, int n, char *msg)
+static int writentripc(ntripc_t *ntripc, uint8_t *buff, int n, strfrm_t *frm,
+                       char *msg)
 {
-    int i,ns=0,err;
+    strfrm_t *f=frm;
+    int i,ns=0;
 
     tracet(4,"writentripc: n=%d\n",n);
     
     wait_ntripc(ntripc,msg);
     
+    /* data not sent are queued as frame shared by clients */
     for (i=0;i<MAXCLI;i++) {
         if (!ntripc->con[i].state) continue;
         
-        ns=send_nb(ntripc->tcp->cli[i].sock,buff,n);
-        
-        if (ns<n) {
-            if ((err=errsock())) {
-                tracet(2,"writentripc: send error i=%d sock=%d err=%d\n",i,
-                       ntripc->tcp->cli[i].sock,err);
-            }
+        if (!sendcli(ntripc->tcp,i,buff,n,&f)) {
             discon_ntripc(ntripc,i);
         }
         else {
+            ns=n;
             ntripc->tcp->cli[i].tact=tickget();
         }
     }
+    if (f!=frm) strfrmfree(f);
     return ns;
 }
 /* get state ntrip-caster ----------------------------------------------------*/
@@ -2613,8 +2759,7 @@ extern void strinit(stream_t *stream)
 *                                 STR_TCPCLI   = TCP client
 *                                 STR_NTRIPSVR = NTRIP server
 *                                 STR_NTRIPCLI = NTRIP client
-*                                 STR_NTRIPC_S = NTRIP caster server
-*                                 STR_NTRIPC_C = NTRIP caster client
+*                                 STR_NTRIPCAS = NTRIP caster
 *                                 STR_UDPSVR   = UDP server (read only)
 *                                 STR_UDPCLI   = UDP client (write only)
 *                                 STR_MEMBUF   = memory buffer (FIFO)
@@ -2731,6 +2876,7 @@ extern int stropen(stream_t *stream, int type, int mode, const char *path)
         case STR_TCPCLI  : stream->port=opentcpcli(path,     stream->msg); break;
         case STR_NTRIPSVR: stream->port=openntrip (path,0,   stream->msg); break;
         case STR_NTRIPCLI: stream->port=openntrip (path,1,   stream->msg); break;
+        case STR_NTRIPCAS: stream->port=openntripc(path,     stream->msg); break;
         case STR_UDPSVR  : stream->port=openudpsvr(path,     stream->msg); break;
         case STR_UDPCLI  : stream->port=openudpcli(path,     stream->msg); break;
         case STR_MEMBUF  : stream->port=openmembuf(path,     stream->msg); break;
@@ -2760,6 +2906,7 @@ extern void strclose(stream_t *stream)
             case STR_TCPCLI  : closetcpcli((tcpcli_t *)stream->port); break;
             case STR_NTRIPSVR: closentrip ((ntrip_t  *)stream->port); break;
             case STR_NTRIPCLI: closentrip ((ntrip_t  *)stream->port); break;
+            case STR_NTRIPCAS: closentripc((ntripc_t *)stream->port); break;
             case STR_UDPSVR  : closeudpsvr((udp_t    *)stream->port); break;
             case STR_UDPCLI  : closeudpcli((udp_t    *)stream->port); break;
             case STR_MEMBUF  : closemembuf((membuf_t *)stream->port); break;
@@ -2802,6 +2949,198 @@ extern void strsync(stream_t *stream1, stream_t *stream2)
 *-----------------------------------------------------------------------------*/
 extern void strlock  (stream_t *stream) {lock  (&stream->lock);}
 extern void strunlock(stream_t *stream) {unlock(&stream->lock);}
+/* get descriptors of tcp server --------------------------------------------*/
+static int fdtcpsvr(tcpsvr_t *tcpsvr, int *fd, int *out, int nmax)
+{
+    int i,n=0,nfree=0;
+    
+    if (tcpsvr->svr.state<=0) return 0;
+    
+    for (i=0;i<MAXCLI&&n<nmax;i++) {
+        if (tcpsvr->cli[i].state==2) {
+            out[n]=tcpsvr->que[i].n>0; /* wait send for queued data */
+            fd[n++]=(int)tcpsvr->cli[i].sock;
+        }
+        else if (tcpsvr->cli[i].state==0) nfree++;
+    }
+    /* listening socket only if client connection can be accepted */
+    if (nfree>0&&n<nmax) {
+        out[n]=0;
+        fd[n++]=(int)tcpsvr->svr.sock;
+    }
+    return n;
+}
+/* get descriptors of stream for input data arrival --------------------------*/
+static int strfd(stream_t *stream, int *fd, int *out, int nmax)
+{
+    tcp_t *tcp=NULL;
+    udp_t *udp;
+    
+    if (nmax<=0) return 0;
+    
+    switch (stream->type) {
+#ifndef WIN32
+        case STR_SERIAL:
+            fd[0]=(int)((serial_t *)stream->port)->dev;
+            out[0]=0;
+            return 1;
+#endif
+        case STR_TCPSVR:
+            return fdtcpsvr((tcpsvr_t *)stream->port,fd,out,nmax);
+        case STR_NTRIPCAS:
+            return fdtcpsvr(((ntripc_t *)stream->port)->tcp,fd,out,nmax);
+        case STR_TCPCLI:
+            tcp=&((tcpcli_t *)stream->port)->svr;
+            break;
+        case STR_NTRIPSVR:
+        case STR_NTRIPCLI:
+            tcp=&((ntrip_t *)stream->port)->tcp->svr;
+            break;
+        case STR_UDPSVR:
+            udp=(udp_t *)stream->port;
+            if (udp->state<=0) return 0;
+            fd[0]=(int)udp->sock;
+            out[0]=0;
+            return 1;
+    }
+    /* no descriptor for file, memory buffer and ftp/http (polled by timeout) */
+    if (!tcp||tcp->state!=2) return 0;
+    fd[0]=(int)tcp->sock;
+    out[0]=0;
+    return 1;
+}
+/* initialize/free stream waiter -----------------------------------------------
+* initialize/free stream event waiter
+* args   : strwait_t *wait  IO stream waiter
+* return : status (1:ok 0:error)
+* notes  : without epoll (non-linux), strwait() sleeps for the timeout
+*-----------------------------------------------------------------------------*/
+extern int strwaitinit(strwait_t *wait)
+{
+    tracet(3,"strwaitinit:\n");
+    
+    wait->n=0;
+    wait->tick=tickget();
+#ifdef __linux__
+    if ((wait->epfd=epoll_create1(EPOLL_CLOEXEC))<0) {
+        tracet(1,"strwaitinit: epoll_create error (%d)\n",errno);
+        return 0;
+    }
+#else
+    wait->epfd=-1;
+#endif
+    return 1;
+}
+extern void strwaitfree(strwait_t *wait)
+{
+    tracet(3,"strwaitfree:\n");
+    
+#ifdef __linux__
+    if (wait->epfd>=0) close(wait->epfd);
+#endif
+    wait->epfd=-1;
+    wait->n=0;
+}
+/* wait input data arrival -----------------------------------------------------
+* wait until input data arrives to any of streams or timeout expires
+* args   : strwait_t *wait  IO stream waiter
+*          stream_t *stream I  streams
+*          int    n         I  number of streams
+*          int    timeout   I  timeout (ms)
+* return : number of ready descriptors (0: timeout)
+* notes  : sockets and serial devices of input streams are waited by epoll.
+*          data arrival to file, memory buffer or ftp/http streams is not
+*          signaled, so the timeout should be set to the server cycle.
+*          tcp server clients with queued send data are also waited to be
+*          writable, so that the queues are flushed by next strread().
+*          descriptors are registered when they appear and unregistered when
+*          they disappear. on timeout, all descriptors are registered again to
+*          recover a descriptor number reused after close (at most once per
+*          TINTWAITREG).
+*-----------------------------------------------------------------------------*/
+extern int strwait(strwait_t *wait, stream_t *stream, int n, int timeout)
+{
+    stream_t *streams[MAXSTRWAIT];
+    int i;
+    
+    for (i=0;i<n&&i<MAXSTRWAIT;i++) streams[i]=stream+i;
+    return strwaitp(wait,streams,i,timeout);
+}
+/* wait input data arrival by stream pointers ----------------------------------
+* wait until input data arrives to any of streams or timeout expires
+* args   : strwait_t *wait  IO stream waiter
+*          stream_t **stream I pointers to streams
+*          int    n         I  number of streams
+*          int    timeout   I  timeout (ms)
+* return : number of ready descriptors (0: timeout)
+* notes  : same as strwait() for streams not in an array
+*-----------------------------------------------------------------------------*/
+extern int strwaitp(strwait_t *wait, stream_t **stream, int n, int timeout)
+{
+#ifdef __linux__
+    struct epoll_event ev={0},evs[MAXWAITEV];
+    int i,j,nfd=0,nev,fd[MAXSTRWAIT],out[MAXSTRWAIT],events[MAXSTRWAIT];
+    
+    tracet(5,"strwaitp: n=%d timeout=%d\n",n,timeout);
+    
+    if (timeout<=0) return 0;
+    
+    if (wait->epfd<0) {
+        sleepms(timeout);
+        return 0;
+    }
+    for (i=0;i<n;i++) {
+        if (!(stream[i]->mode&STR_MODE_R)||!stream[i]->port) continue;
+        strlock(stream[i]);
+        if (stream[i]->port) {
+            nfd+=strfd(stream[i],fd+nfd,out+nfd,MAXSTRWAIT-nfd);
+        }
+        strunlock(stream[i]);
+    }
+    /* register new descriptors or modify events */
+    for (i=0;i<nfd;i++) {
+        events[i]=EPOLLIN|(out[i]?EPOLLOUT:0);
+        for (j=0;j<wait->n;j++) if (wait->fd[j]==fd[i]) break;
+        if (j<wait->n&&wait->ev[j]==events[i]) continue;
+        ev.events=events[i];
+        ev.data.fd=fd[i];
+        if (epoll_ctl(wait->epfd,j<wait->n?EPOLL_CTL_MOD:EPOLL_CTL_ADD,fd[i],
+                      &ev)<0&&errno!=EEXIST) {
+            tracet(2,"strwaitp: epoll_ctl error fd=%d (%d)\n",fd[i],errno);
+        }
+    }
+    /* unregister disappeared descriptors (error if already closed) */
+    for (j=0;j<wait->n;j++) {
+        for (i=0;i<nfd;i++) if (fd[i]==wait->fd[j]) break;
+        if (i>=nfd) epoll_ctl(wait->epfd,EPOLL_CTL_DEL,wait->fd[j],&ev);
+    }
+    memcpy(wait->fd,fd,sizeof(int)*nfd);
+    memcpy(wait->ev,events,sizeof(int)*nfd);
+    wait->n=nfd;
+    
+    if ((nev=epoll_wait(wait->epfd,evs,MAXWAITEV,timeout))<0) {
+        if (errno!=EINTR) {
+            tracet(2,"strwaitp: epoll_wait error (%d)\n",errno);
+            sleepms(timeout);
+        }
+        return 0;
+    }
+    if (nev==0&&(int)(tickget()-wait->tick)>=TINTWAITREG) {
+        for (i=0;i<nfd;i++) {
+            ev.events=events[i];
+            ev.data.fd=fd[i];
+            epoll_ctl(wait->epfd,EPOLL_CTL_ADD,fd[i],&ev);
+        }
+        wait->tick=tickget();
+    }
+    return nev;
+#else
+    tracet(5,"strwaitp: n=%d timeout=%d\n",n,timeout);
+    
+    sleepms(timeout);
+    return 0;
+#endif
+}
 
 /* read stream -----------------------------------------------------------------
 * read data from stream (unblocked)
@@ -2830,6 +3169,7 @@ extern int strread(stream_t *stream, uint8_t *buff, int n)
         case STR_TCPCLI  : nr=readtcpcli((tcpcli_t *)stream->port,buff,n,msg); break;
         case STR_NTRIPSVR:
         case STR_NTRIPCLI: nr=readntrip ((ntrip_t  *)stream->port,buff,n,msg); break;
+        case STR_NTRIPCAS: nr=readntripc((ntripc_t *)stream->port,buff,n,msg); break;
         case STR_UDPSVR  : nr=readudpsvr((udp_t    *)stream->port,buff,n,msg); break;
         case STR_MEMBUF  : nr=readmembuf((membuf_t *)stream->port,buff,n,msg); break;
         case STR_FTP     : nr=readftp   ((ftp_t    *)stream->port,buff,n,msg); break;
@@ -2852,21 +3192,14 @@ extern int strread(stream_t *stream, uint8_t *buff, int n)
     strunlock(stream);
     return nr;
 }
-/* write stream ----------------------------------------------------------------
-* write data to stream (unblocked)
-* args   : stream_t *stream I   stream
-*          unsinged char *buff I data buffer
-*          int    n         I   data length
-* return : status (0:error,1:ok)
-* notes  : write data to buffer and return immediately
-*-----------------------------------------------------------------------------*/
-extern int strwrite(stream_t *stream, uint8_t *buff, int n)
+/* write stream with shared frame --------------------------------------------*/
+static int writestr(stream_t *stream, uint8_t *buff, int n, strfrm_t *frm)
 {
     uint32_t tick=tickget();
     char *msg=stream->msg;
     int ns,tt;
     
-    tracet(4,"strwrite: n=%d\n",n);
+    tracet(4,"writestr: n=%d\n",n);
     
     if (!(stream->mode&STR_MODE_W)||!stream->port) return 0;
     
@@ -2875,10 +3208,11 @@ extern int strwrite(stream_t *stream, uint8_t *buff, int n)
     switch (stream->type) {
         case STR_SERIAL  : ns=writeserial((serial_t *)stream->port,buff,n,msg); break;
         case STR_FILE    : ns=writefile  ((file_t   *)stream->port,buff,n,msg); break;
-        case STR_TCPSVR  : ns=writetcpsvr((tcpsvr_t *)stream->port,buff,n,msg); break;
+        case STR_TCPSVR  : ns=writetcpsvr((tcpsvr_t *)stream->port,buff,n,frm,msg); break;
         case STR_TCPCLI  : ns=writetcpcli((tcpcli_t *)stream->port,buff,n,msg); break;
         case STR_NTRIPSVR:
         case STR_NTRIPCLI: ns=writentrip ((ntrip_t  *)stream->port,buff,n,msg); break;
+        case STR_NTRIPCAS: ns=writentripc((ntripc_t *)stream->port,buff,n,frm,msg); break;
         case STR_UDPCLI  : ns=writeudpcli((udp_t    *)stream->port,buff,n,msg); break;
         case STR_MEMBUF  : ns=writemembuf((membuf_t *)stream->port,buff,n,msg); break;
         case STR_FTP     :
@@ -2901,6 +3235,58 @@ extern int strwrite(stream_t *stream, uint8_t *buff, int n)
     strunlock(stream);
     return ns;
 }
+/* write stream ----------------------------------------------------------------
+* write data to stream (unblocked)
+* args   : stream_t *stream I   stream
+*          unsinged char *buff I data buffer
+*          int    n         I   data length
+* return : status (0:error,1:ok)
+* notes  : write data to buffer and return immediately
+*-----------------------------------------------------------------------------*/
+extern int strwrite(stream_t *stream, uint8_t *buff, int n)
+{
+    return writestr(stream,buff,n,NULL);
+}
+/* write shared frame to stream ------------------------------------------------
+* write data of shared frame to stream (unblocked)
+* args   : stream_t *stream I   stream
+*          strfrm_t *frm    I   shared frame generated by strfrmnew()
+* return : status (0:error,1:ok)
+* notes  : tcp server and ntrip caster queue a reference of the frame for
+*          clients not accepting all data instead of copying the data, so
+*          one frame may be written to many streams and clients without copy.
+*          the frame is released by strfrmfree() after written to streams.
+*-----------------------------------------------------------------------------*/
+extern int strwritefrm(stream_t *stream, strfrm_t *frm)
+{
+    return writestr(stream,frm->buff,frm->n,frm);
+}
+/* generate/free shared frame --------------------------------------------------
+* generate shared frame or release reference of shared frame
+* args   : uint8_t *buff    I   data buffer
+*          int    n         I   data length (bytes)
+*          strfrm_t *frm    IO  shared frame
+* return : shared frame with reference count 1 (NULL: error)
+* notes  : data of the frame should not be modified after generated.
+*          strfrmfree() frees the frame when the reference count gets 0.
+*-----------------------------------------------------------------------------*/
+extern strfrm_t *strfrmnew(const uint8_t *buff, int n)
+{
+    strfrm_t *frm;
+    
+    tracet(4,"strfrmnew: n=%d\n",n);
+    
+    if (n<0||!(frm=(strfrm_t *)malloc(sizeof(strfrm_t)+n))) return NULL;
+    frm->nref=1;
+    frm->n=n;
+    frm->buff=(uint8_t *)(frm+1);
+    if (n>0) memcpy(frm->buff,buff,n);
+    return frm;
+}
+extern void strfrmfree(strfrm_t *frm)
+{
+    if (frm&&addref(frm,-1)<=0) free(frm);
+}
 /* get stream status -----------------------------------------------------------
 * get stream status
 * args   : stream_t *stream I   stream
@@ -2928,6 +3314,7 @@ extern int strstat(stream_t *stream, char *msg)
         case STR_TCPCLI  : state=statetcpcli((tcpcli_t *)stream->port); break;
         case STR_NTRIPSVR:
         case STR_NTRIPCLI: state=statentrip ((ntrip_t  *)stream->port); break;
+        case STR_NTRIPCAS: state=statentripc((ntripc_t *)stream->port); break;
         case STR_UDPSVR  : state=stateudpsvr((udp_t    *)stream->port); break;
         case STR_UDPCLI  : state=stateudpcli((udp_t    *)stream->port); break;
         case STR_MEMBUF  : state=statemembuf((membuf_t *)stream->port); break;
@@ -2966,6 +3353,7 @@ extern int strstatx(stream_t *stream, char *msg)
         case STR_TCPCLI  : state=statextcpcli((tcpcli_t *)stream->port,msg); break;
         case STR_NTRIPSVR:
         case STR_NTRIPCLI: state=statexntrip ((ntrip_t  *)stream->port,msg); break;
+        case STR_NTRIPCAS: state=statexntripc((ntripc_t *)stream->port,msg); break;
         case STR_UDPSVR  : state=statexudpsvr((udp_t    *)stream->port,msg); break;
         case STR_UDPCLI  : state=statexudpcli((udp_t    *)stream->port,msg); break;
         case STR_MEMBUF  : state=statexmembuf((membuf_t *)stream->port,msg); break;
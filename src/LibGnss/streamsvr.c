@@ -31,6 +31,9 @@
 *                           support multiple ephemeris sets (e.g. I/NAV-F/NAV)
 *                           delete API strsvrsetsrctbl()
 *                           use integer types in stdint.h
+*           2026/10/18 1.16 wait data arrival by strwait() in strsvrthread()
+*           2026/10/18 1.17 write input and converted data as shared frames
+*                           convert data once for same converters of outputs
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -98,6 +101,8 @@ extern strconv_t *strconvnew(int itype, int otype, const char *msgs, int staid,
     conv->itype=itype;
     conv->otype=otype;
     conv->stasel=stasel;
+    conv->nb=conv->nbmax=0;
+    conv->obuf=NULL;
     if (!init_rtcm(&conv->rtcm)||!init_rtcm(&conv->out)) {
         free(conv);
         return NULL;
@@ -124,8 +129,47 @@ extern void strconvfree(strconv_t *conv)
     free_rtcm(&conv->rtcm);
     free_rtcm(&conv->out);
     free_raw(&conv->raw);
+    free(conv->obuf);
     free(conv);
 }
+/* test same conversion of stream converters ---------------------------------*/
+static int sameconv(const strconv_t *conv1, const strconv_t *conv2)
+{
+    int i;
+    
+    if (conv1==conv2) return 1;
+    
+    if (conv1->itype!=conv2->itype||conv1->otype!=conv2->otype||
+        conv1->stasel!=conv2->stasel||conv1->nmsg!=conv2->nmsg||
+        strcmp(conv1->rtcm.opt,conv2->rtcm.opt)) return 0;
+    
+    if (conv1->stasel&&conv1->out.staid!=conv2->out.staid) return 0;
+    
+    for (i=0;i<conv1->nmsg;i++) {
+        if (conv1->msgs[i]!=conv2->msgs[i]||
+            conv1->tint[i]!=conv2->tint[i]) return 0;
+    }
+    return 1;
+}
+/* write output message to buffer --------------------------------------------*/
+static void outmsg(strconv_t *conv, const uint8_t *buff, int n)
+{
+    uint8_t *obuf;
+    int nmax;
+    
+    if (conv->nb+n>conv->nbmax) {
+        nmax=conv->nbmax<4096?4096:conv->nbmax*2;
+        if (nmax<conv->nb+n) nmax=conv->nb+n;
+        if (!(obuf=(uint8_t *)realloc(conv->obuf,nmax))) {
+            tracet(1,"outmsg: memory allocation error n=%d\n",nmax);
+            return;
+        }
+        conv->obuf=obuf;
+        conv->nbmax=nmax;
+    }
+    memcpy(conv->obuf+conv->nb,buff,n);
+    conv->nb+=n;
+}
 /* copy received data from receiver raw to rtcm ------------------------------*/
 static void raw2rtcm(rtcm_t *out, const raw_t *raw, int ret)
 {
@@ -219,9 +263,10 @@ static void rtcm2rtcm(rtcm_t *out, const rtcm_t *rtcm, int ret, int stasel)
         if (!stasel) out->sta=rtcm->sta;
     }
 }
-/* write rtcm3 msm to stream -------------------------------------------------*/
-static void write_rtcm3_msm(stream_t *str, rtcm_t *out, int msg, int sync)
+/* write rtcm3 msm to buffer -------------------------------------------------*/
+static void write_rtcm3_msm(strconv_t *conv, int msg, int sync)
 {
+    rtcm_t *out=&conv->out;
     obsd_t *data,buff[MAXOBS];
     int i,j,n,ns,sys,nobs,code,nsat=0,nsig=0,nmsg,mask[MAXCODE]={0};
     
@@ -268,14 +313,14 @@ static void write_rtcm3_msm(stream_t *str, rtcm_t *out, int msg, int sync)
         out->obs.n=n;
         
         if (gen_rtcm3(out,msg,0,i<nmsg-1?1:sync)) {
-            strwrite(str,out->buff,out->nbyte);
+            outmsg(conv,out->buff,out->nbyte);
         }
     }
     out->obs.data=data;
     out->obs.n=nobs;
 }
 /* write obs data messages ---------------------------------------------------*/
-static void write_obs(gtime_t time, stream_t *str, strconv_t *conv)
+static void write_obs(gtime_t time, strconv_t *conv)
 {
     int i,j=0;
     
@@ -291,22 +336,22 @@ static void write_obs(gtime_t time, stream_t *str, strconv_t *conv)
         if (conv->otype==STRFMT_RTCM2) {
             if (!gen_rtcm2(&conv->out,conv->msgs[i],i!=j)) continue;
             
-            /* write messages to stream */
-            strwrite(str,conv->out.buff,conv->out.nbyte);
+            /* write messages to buffer */
+            outmsg(conv,conv->out.buff,conv->out.nbyte);
         }
         else if (conv->otype==STRFMT_RTCM3) {
             if (conv->msgs[i]<=1012) {
                 if (!gen_rtcm3(&conv->out,conv->msgs[i],0,i!=j)) continue;
-                strwrite(str,conv->out.buff,conv->out.nbyte);
+                outmsg(conv,conv->out.buff,conv->out.nbyte);
             }
-            else { /* write rtcm3 msm to stream */
-                write_rtcm3_msm(str,&conv->out,conv->msgs[i],i!=j);
+            else { /* write rtcm3 msm to buffer */
+                write_rtcm3_msm(conv,conv->msgs[i],i!=j);
             }
         }
     }
 }
 /* write nav data messages ---------------------------------------------------*/
-static void write_nav(gtime_t time, stream_t *str, strconv_t *conv)
+static void write_nav(gtime_t time, strconv_t *conv)
 {
     int i;
     
@@ -322,8 +367,8 @@ static void write_nav(gtime_t time, stream_t *str, strconv_t *conv)
         }
         else continue;
         
-        /* write messages to stream */
-        strwrite(str,conv->out.buff,conv->out.nbyte);
+        /* write messages to buffer */
+        outmsg(conv,conv->out.buff,conv->out.nbyte);
     }
 }
 /* next ephemeris satellite --------------------------------------------------*/
@@ -359,7 +404,7 @@ static int nextsat(nav_t *nav, int sat, int msg)
     return 0;
 }
 /* write cyclic nav data messages --------------------------------------------*/
-static void write_nav_cycle(stream_t *str, strconv_t *conv)
+static void write_nav_cycle(strconv_t *conv)
 {
     uint32_t tick=tickget();
     int i,sat,tint;
@@ -387,12 +432,12 @@ static void write_nav_cycle(stream_t *str, strconv_t *conv)
         }
         else continue;
         
-        /* write messages to stream */
-        strwrite(str,conv->out.buff,conv->out.nbyte);
+        /* write messages to buffer */
+        outmsg(conv,conv->out.buff,conv->out.nbyte);
     }
 }
 /* write cyclic station info messages ----------------------------------------*/
-static void write_sta_cycle(stream_t *str, strconv_t *conv)
+static void write_sta_cycle(strconv_t *conv)
 {
     uint32_t tick=tickget();
     int i,tint;
@@ -414,41 +459,44 @@ static void write_sta_cycle(stream_t *str, strconv_t *conv)
         }
         else continue;
         
-        /* write messages to stream */
-        strwrite(str,conv->out.buff,conv->out.nbyte);
+        /* write messages to buffer */
+        outmsg(conv,conv->out.buff,conv->out.nbyte);
     }
 }
-/* convert stearm ------------------------------------------------------------*/
-static void strconv(stream_t *str, strconv_t *conv, uint8_t *buff, int n)
+/* convert stearm to output buffer ------------------------------------------*/
+static void strconv(strconv_t *conv, uint8_t *buff, int n)
 {
     int i,ret;
     
-    for (i=0;i<n;i++) {
+    conv->nb=0;
+    
+    for (i=0;i<n;) {
+        ret=0;
         
         /* input rtcm 2 messages */
         if (conv->itype==STRFMT_RTCM2) {
-            ret=input_rtcm2(&conv->rtcm,buff[i]);
+            ret=input_rtcm2(&conv->rtcm,buff[i++]);
             rtcm2rtcm(&conv->out,&conv->rtcm,ret,conv->stasel);
         }
         /* input rtcm 3 messages */
         else if (conv->itype==STRFMT_RTCM3) {
-            ret=input_rtcm3(&conv->rtcm,buff[i]);
+            i+=(int)input_rtcm3_buf(&conv->rtcm,buff+i,n-i,NULL,&ret);
             rtcm2rtcm(&conv->out,&conv->rtcm,ret,conv->stasel);
         }
         /* input receiver raw messages */
         else {
-            ret=input_raw(&conv->raw,conv->itype,buff[i]);
+            i+=(int)input_raw_buf(&conv->raw,conv->itype,buff+i,n-i,NULL,&ret);
             raw2rtcm(&conv->out,&conv->raw,ret);
         }
-        /* write obs and nav data messages to stream */
+        /* write obs and nav data messages to buffer */
         switch (ret) {
-            case 1: write_obs(conv->out.time,str,conv); break;
-            case 2: write_nav(conv->out.time,str,conv); break;
+            case 1: write_obs(conv->out.time,conv); break;
+            case 2: write_nav(conv->out.time,conv); break;
         }
     }
-    /* write cyclic nav data and station info messages to stream */
-    write_nav_cycle(str,conv);
-    write_sta_cycle(str,conv);
+    /* write cyclic nav data and station info messages to buffer */
+    write_nav_cycle(conv);
+    write_sta_cycle(conv);
 }
 /* periodic command ----------------------------------------------------------*/
 static void periodic_cmd(int cycle, const char *cmd, stream_t *stream)
@@ -482,31 +530,46 @@ static void *strsvrthread(void *arg)
 #endif
 {
     strsvr_t *svr=(strsvr_t *)arg;
+    strwait_t wait;
+    strfrm_t *frm[16];
     sol_t sol_nmea={{0}};
     uint32_t tick,tick_nmea;
     uint8_t buff[1024];
-    int i,n,cyc;
+    int i,j,n,cyc;
     
     tracet(3,"strsvrthread:\n");
     
+    strwaitinit(&wait);
     svr->tick=tickget();
     tick_nmea=svr->tick-1000;
     
-    for (cyc=0;svr->state;cyc++) {
+    for (cyc=0;svr->state;) {
         tick=tickget();
         
         /* read data from input stream */
         while ((n=strread(svr->stream,svr->buff,svr->buffsize))>0&&svr->state) {
             
-            /* write data to output streams */
+            /* convert data once for converters shared by output streams */
             for (i=1;i<svr->nstr;i++) {
-                if (svr->conv[i-1]) {
-                    strconv(svr->stream+i,svr->conv[i-1],svr->buff,n);
-                }
-                else {
-                    strwrite(svr->stream+i,svr->buff,n);
+                if (!svr->conv[i-1]||svr->convsrc[i]) continue;
+                strconv(svr->conv[i-1],svr->buff,n);
+            }
+            /* write input or converted data to output streams as frames */
+            for (i=0;i<svr->nstr;i++) frm[i]=NULL;
+            
+            for (i=1;i<svr->nstr;i++) {
+                j=!svr->conv[i-1]?0:(svr->convsrc[i]?svr->convsrc[i]:i);
+                
+                if (!frm[j]) {
+                    if (j==0) frm[j]=strfrmnew(svr->buff,n);
+                    else frm[j]=strfrmnew(svr->conv[j-1]->obuf,
+                                          svr->conv[j-1]->nb);
+                    if (!frm[j]) continue;
                 }
+                if (frm[j]->n>0) strwritefrm(svr->stream+i,frm[j]);
             }
+            for (i=0;i<svr->nstr;i++) strfrmfree(frm[i]);
+            
             /* write data to log stream */
             strwrite(svr->strlog,svr->buff,n);
             
@@ -529,9 +592,12 @@ static void *strsvrthread(void *arg)
                 strwrite(svr->strlog+i,buff,n);
             }
         }
-        /* write periodic command to input stream */
-        for (i=0;i<svr->nstr;i++) {
-            periodic_cmd(cyc*svr->cycle,svr->cmds_periodic[i],svr->stream+i);
+        /* write periodic command to input stream at each server cycle */
+        for (;cyc<=(int)(tick-svr->tick)/svr->cycle;cyc++) {
+            for (i=0;i<svr->nstr;i++) {
+                periodic_cmd(cyc*svr->cycle,svr->cmds_periodic[i],
+                             svr->stream+i);
+            }
         }
         /* write nmea messages to input stream */
         if (svr->nmeacycle>0&&(int)(tick-tick_nmea)>=svr->nmeacycle) {
@@ -541,8 +607,11 @@ static void *strsvrthread(void *arg)
             strsendnmea(svr->stream,&sol_nmea);
             tick_nmea=tick;
         }
-        sleepms(svr->cycle-(int)(tickget()-tick));
+        /* wait data arrival to input/output streams until next cycle */
+        strwait(&wait,svr->stream,svr->nstr,
+                cyc*svr->cycle-(int)(tickget()-svr->tick));
     }
+    strwaitfree(&wait);
     for (i=0;i<svr->nstr;i++) strclose(svr->stream+i);
     for (i=0;i<svr->nstr;i++) strclose(svr->strlog+i);
     svr->npb=0;
@@ -577,6 +646,7 @@ extern void strsvrinit(strsvr_t *svr, int nout)
     for (i=0;i<nout+1&&i<16;i++) strinit(svr->strlog+i);
     svr->nstr=i;
     for (i=0;i<16;i++) svr->conv[i]=NULL;
+    for (i=0;i<16;i++) svr->convsrc[i]=0;
     svr->thread=0;
     initlock(&svr->lock);
 }
@@ -634,7 +704,7 @@ extern int strsvrstart(strsvr_t *svr, int *opts, int *strs, char **paths,
                        char **logs, strconv_t **conv, char **cmds,
                        char **cmds_periodic, const double *nmeapos)
 {
-    int i,rw,stropt[5]={0};
+    int i,j,rw,stropt[5]={0};
     char file1[MAXSTRPATH],file2[MAXSTRPATH],*p;
     
     tracet(3,"strsvrstart:\n");
@@ -656,6 +726,18 @@ extern int strsvrstart(strsvr_t *svr, int *opts, int *strs, char **paths,
     }
     for (i=0;i<svr->nstr-1;i++) svr->conv[i]=conv[i];
     
+    /* output streams sharing converted data of same converter */
+    for (i=1;i<svr->nstr;i++) {
+        svr->convsrc[i]=0;
+        if (!svr->conv[i-1]) continue;
+        for (j=1;j<i;j++) {
+            if (!svr->conv[j-1]||svr->convsrc[j]) continue;
+            if (!sameconv(svr->conv[j-1],svr->conv[i-1])) continue;
+            svr->convsrc[i]=j;
+            break;
+        }
+    }
+    
     if (!(svr->buff=(uint8_t *)malloc(svr->buffsize))||
         !(svr->pbuf=(uint8_t *)malloc(svr->buffsize))) {
         free(svr->buff); free(svr->pbuf);
@@ -20,6 +20,9 @@
 * history : 2015/05/10 1.0  separated from ppp.c
 *           2015/06/11 1.1  fix bug on computing days in tide_oload() (#128)
 *           2017/04/11 1.2  fix bug on calling geterp() in timdedisp()
+*           2026/10/18 1.3  add api tidedisp_tbl()
+*                           add option of single-precision kernels to
+*                           tidedisp()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -29,6 +32,7 @@
 #define GME         3.986004415E+14 /* earth gravitational constant */
 #define GMS         1.327124E+20    /* sun gravitational constant */
 #define GMM         4.902801E+12    /* moon gravitational constant */
+#define TOL_TIDEPOS 500.0           /* site position tolerance of tide table (m) */
 
 /* function prototypes -------------------------------------------------------*/
 #ifdef IERS_MODEL
@@ -79,19 +83,55 @@ static void tide_pl(const double *eu, const double *rp, double GMp,
     
     trace(5,"tide_pl : dr=%.3f %.3f %.3f\n",dr[0],dr[1],dr[2]);
 }
+/* solar/lunar tides in single precision -------------------------------------*/
+static void tide_plf(const double *eu, const double *rp, double GMp,
+                     const double *pos, double *dr)
+{
+    const float H3=0.292f,L3=0.015f;
+    float ep[3],latp,lonp,p,K2,K3,a,H2,L2,dp,du,cosp,sinl,cosl;
+    double r;
+    int i;
+    
+    if ((r=norm(rp,3))<=0.0) return;
+    
+    for (i=0;i<3;i++) ep[i]=(float)(rp[i]/r);
+    
+    K2=(float)(GMp/GME*SQR(RE_WGS84)*SQR(RE_WGS84)/(r*r*r));
+    K3=K2*(float)(RE_WGS84/r);
+    latp=asinf(ep[2]); lonp=atan2f(ep[1],ep[0]);
+    cosp=cosf(latp); sinl=sinf((float)pos[0]); cosl=cosf((float)pos[0]);
+    
+    p=(3.0f*sinl*sinl-1.0f)/2.0f;
+    H2=0.6078f-0.0006f*p;
+    L2=0.0847f+0.0002f*p;
+    a=ep[0]*(float)eu[0]+ep[1]*(float)eu[1]+ep[2]*(float)eu[2];
+    dp=K2*3.0f*L2*a;
+    du=K2*(H2*(1.5f*a*a-0.5f)-3.0f*L2*a*a);
+    
+    dp+=K3*L3*(7.5f*a*a-1.5f);
+    du+=K3*(H3*(2.5f*a*a*a-1.5f*a)-L3*(7.5f*a*a-1.5f)*a);
+    
+    du+=0.75f*0.0025f*K2*sinf(2.0f*latp)*sinf(2.0f*(float)pos[0])*
+        sinf((float)pos[1]-lonp);
+    du+=0.75f*0.0022f*K2*cosp*cosp*cosl*cosl*sinf(2.0f*((float)pos[1]-lonp));
+    
+    for (i=0;i<3;i++) dr[i]=dp*ep[i]+du*(float)eu[i];
+}
 /* displacement by solid earth tide (ref [2] 7) ------------------------------*/
 static void tide_solid(const double *rsun, const double *rmoon,
                        const double *pos, const double *E, double gmst, int opt,
                        double *dr)
 {
+    void (*pl)(const double *,const double *,double,const double *,double *);
     double dr1[3],dr2[3],eu[3],du,dn,sinl,sin2l;
     
     trace(3,"tide_solid: pos=%.3f %.3f opt=%d\n",pos[0]*R2D,pos[1]*R2D,opt);
     
     /* step1: time domain */
     eu[0]=E[2]; eu[1]=E[5]; eu[2]=E[8];
-    tide_pl(eu,rsun, GMS,pos,dr1);
-    tide_pl(eu,rmoon,GMM,pos,dr2);
+    pl=(opt&16)?tide_plf:tide_pl;
+    pl(eu,rsun, GMS,pos,dr1);
+    pl(eu,rmoon,GMM,pos,dr2);
     
     /* step2: frequency domain, only K1 radial */
     sin2l=sin(2.0*pos[0]);
@@ -115,7 +155,7 @@ static void tide_solid(const double *rsun, const double *rmoon,
 #endif /* !IERS_MODEL */
 
 /* displacement by ocean tide loading (ref [2] 7) ----------------------------*/
-static void tide_oload(gtime_t tut, const double *odisp, double *denu)
+static void tide_oload(gtime_t tut, const double *odisp, int sp, double *denu)
 {
     const double args[][5]={
         {1.40519E-4, 2.0,-2.0, 0.0, 0.00},  /* M2 */
@@ -132,6 +172,7 @@ static void tide_oload(gtime_t tut, const double *odisp, double *denu)
     };
     const double ep1975[]={1975,1,1,0,0,0};
     double ep[6],fday,days,t,t2,t3,a[5],ang,dp[3]={0};
+    float dpf[3]={0};
     int i,j;
     
     trace(3,"tide_oload:\n");
@@ -154,8 +195,17 @@ static void tide_oload(gtime_t tut, const double *odisp, double *denu)
     for (i=0;i<11;i++) {
         ang=0.0;
         for (j=0;j<5;j++) ang+=a[j]*args[i][j];
-        for (j=0;j<3;j++) dp[j]+=odisp[j+i*6]*cos(ang-odisp[j+3+i*6]*D2R);
+        if (sp) { /* argument reduced to +/-pi in double */
+            ang-=floor(ang/(2.0*PI)+0.5)*2.0*PI;
+            for (j=0;j<3;j++) {
+                dpf[j]+=(float)odisp[j+i*6]*cosf((float)(ang-odisp[j+3+i*6]*D2R));
+            }
+        }
+        else {
+            for (j=0;j<3;j++) dp[j]+=odisp[j+i*6]*cos(ang-odisp[j+3+i*6]*D2R);
+        }
     }
+    if (sp) for (j=0;j<3;j++) dp[j]=dpf[j];
     denu[0]=-dp[1];
     denu[1]=-dp[2];
     denu[2]= dp[0];
@@ -182,9 +232,10 @@ static void iers_mean_pole(gtime_t tut, double *xp_bar, double *yp_bar)
 }
 /* displacement by pole tide (ref [7] eq.7.26) --------------------------------*/
 static void tide_pole(gtime_t tut, const double *pos, const double *erpv,
-                      double *denu)
+                      int sp, double *denu)
 {
     double xp_bar,yp_bar,m1,m2,cosl,sinl;
+    float m1f,m2f,coslf,sinlf;
     
     trace(3,"tide_pole: pos=%.3f %.3f\n",pos[0]*R2D,pos[1]*R2D);
     
@@ -196,6 +247,15 @@ static void tide_pole(gtime_t tut, const double *pos, const double *erpv,
     m2=-erpv[1]/AS2R+yp_bar*1E-3;
     
     /* sin(2*theta) = sin(2*phi), cos(2*theta)=-cos(2*phi) */
+    if (sp) {
+        m1f=(float)m1; m2f=(float)m2;
+        coslf=cosf((float)pos[1]);
+        sinlf=sinf((float)pos[1]);
+        denu[0]=  9E-3f*sinf((float)pos[0])     *(m1f*sinlf-m2f*coslf);
+        denu[1]= -9E-3f*cosf(2.0f*(float)pos[0])*(m1f*coslf+m2f*sinlf);
+        denu[2]=-33E-3f*sinf(2.0f*(float)pos[0])*(m1f*coslf+m2f*sinlf);
+        return;
+    }
     cosl=cos(pos[1]);
     sinl=sin(pos[1]);
     denu[0]=  9E-3*sin(pos[0])    *(m1*sinl-m2*cosl); /* de= Slambda (m) */
@@ -213,7 +273,9 @@ static void tide_pole(gtime_t tut, const double *pos, const double *erpv,
 *                                 2: ocean tide loading
 *                                 4: pole tide
 *                                 8: elimate permanent deformation
+*                                16: single-precision kernels
 *          double *erp      I   earth rotation parameters (NULL: not used)
+*          astro_t *ast     I   astronomical context of epoch (NULL: not used)
 *          double *odisp    I   ocean loading parameters  (NULL: not used)
 *                                 odisp[0+i*6]: consituent i amplitude radial(m)
 *                                 odisp[1+i*6]: consituent i amplitude west  (m)
@@ -228,9 +290,12 @@ static void tide_pole(gtime_t tut, const double *pos, const double *erpv,
 * notes  : see ref [1], [2] chap 7
 *          see ref [4] 5.2.1, 5.2.2, 5.2.3
 *          ver.2.4.0 does not use ocean loading and pole tide corrections
+*          single-precision kernels evaluate the solid, ocean loading and pole
+*          tide terms in float. sun/moon positions, erp, time arguments and
+*          the enu to ecef rotation stay in double
 *-----------------------------------------------------------------------------*/
 extern void tidedisp(gtime_t tutc, const double *rr, int opt, const erp_t *erp,
-                     const double *odisp, double *dr)
+                     const astro_t *ast, const double *odisp, double *dr)
 {
     gtime_t tut;
     double pos[2],E[9],drt[3],denu[3],rs[3],rm[3],gmst,erpv[5]={0};
@@ -258,7 +323,7 @@ extern void tidedisp(gtime_t tutc, const double *rr, int opt, const erp_t *erp,
     if (opt&1) { /* solid earth tides */
         
         /* sun and moon position in ecef */
-        sunmoonpos(tutc,erpv,rs,rm,&gmst);
+        astrosunmoon(ast,tutc,erpv,rs,rm,&gmst);
         
 #ifdef IERS_MODEL
         time2epoch(tutc,ep);
@@ -275,14 +340,92 @@ extern void tidedisp(gtime_t tutc, const double *rr, int opt, const erp_t *erp,
         for (i=0;i<3;i++) dr[i]+=drt[i];
     }
     if ((opt&2)&&odisp) { /* ocean tide loading */
-        tide_oload(tut,odisp,denu);
+        tide_oload(tut,odisp,opt&16,denu);
         matmul("TN",3,1,3,1.0,E,denu,0.0,drt);
         for (i=0;i<3;i++) dr[i]+=drt[i];
     }
     if ((opt&4)&&erp) { /* pole tide */
-        tide_pole(tut,pos,erpv,denu);
+        tide_pole(tut,pos,erpv,opt&16,denu);
         matmul("TN",3,1,3,1.0,E,denu,0.0,drt);
         for (i=0;i<3;i++) dr[i]+=drt[i];
     }
     trace(5,"tidedisp: dr=%.3f %.3f %.3f\n",dr[0],dr[1],dr[2]);
 }
+/* tidal displacement by table ---------------------------------------------------
+* displacements by earth tides interpolated from a table of nodes
+* args   : tidetbl_t *tbl   IO  tidal displacement table
+*                               (tbl->tint: node interval (s), 0: exact)
+*          gtime_t tutc     I   time in utc
+*          double *rr       I   site position (ecef) (m)
+*          int    opt       I   options (see tidedisp())
+*          double *erp      I   earth rotation parameters (NULL: not used)
+*          astro_t *ast     I   astronomical context of epoch (NULL: not used)
+*          double *odisp    I   ocean loading parameters  (NULL: not used)
+*          double *dr       O   displacement by earth tides (ecef) (m)
+* return : none
+* notes  : the nodes are aligned to multiples of tint and evaluated by
+*          tidedisp() at the site position of the table. the NTIDENODE nodes
+*          around the time are kept and slid as time advances, and are
+*          recomputed if the site moves more than TOL_TIDEPOS or the options
+*          change. displacements are interpolated by lagrange polynomial of
+*          order NTIDENODE-1 (error < 1E-5 m for tint<=600s)
+*          the table is for a static site. a moving site rebuilds all nodes
+*          each time, which is slower than tidedisp()
+*-----------------------------------------------------------------------------*/
+extern void tidedisp_tbl(tidetbl_t *tbl, gtime_t tutc, const double *rr, int opt,
+                         const erp_t *erp, const astro_t *ast,
+                         const double *odisp, double *dr)
+{
+    const gtime_t t0={0};
+    gtime_t tk;
+    double s,k0,x,w,dp[3];
+    int i,j,k,k1=0,k2=NTIDENODE,ns=0;
+    
+    if (tbl->tint<=0.0) {
+        tidedisp(tutc,rr,opt,erp,ast,odisp,dr);
+        return;
+    }
+    s=timediff(tutc,t0)/tbl->tint;
+    k0=floor(s)-(NTIDENODE/2-1);
+    
+    for (i=0;i<3;i++) dp[i]=rr[i]-tbl->rr[i];
+    
+    if (tbl->n<NTIDENODE||tbl->opt!=opt||norm(dp,3)>TOL_TIDEPOS||
+        fabs(k0-tbl->k0)>=NTIDENODE) { /* recompute all nodes */
+        for (i=0;i<3;i++) tbl->rr[i]=rr[i];
+        tbl->opt=opt;
+        k1=0;
+    }
+    else if (k0>tbl->k0) { /* slide nodes forward */
+        ns=(int)(k0-tbl->k0);
+        for (i=0;i<(NTIDENODE-ns)*3;i++) tbl->dr[i]=tbl->dr[i+ns*3];
+        k1=NTIDENODE-ns;
+    }
+    else if (k0<tbl->k0) { /* slide nodes backward (backward filter) */
+        ns=(int)(tbl->k0-k0);
+        for (i=NTIDENODE*3-1;i>=ns*3;i--) tbl->dr[i]=tbl->dr[i-ns*3];
+        k2=ns;
+    }
+    else k1=NTIDENODE;
+    
+    for (k=k1;k<k2;k++) {
+        x=(k0+k)*tbl->tint;
+        tk.time=(time_t)floor(x);
+        tk.sec=x-floor(x);
+        tidedisp(tk,tbl->rr,opt,erp,NULL,odisp,tbl->dr+k*3);
+    }
+    tbl->k0=k0;
+    tbl->n=NTIDENODE;
+    
+    trace(4,"tidedisp_tbl: tutc=%s k0=%.0f ns=%d\n",time_str(tutc,0),k0,ns);
+    
+    /* lagrange interpolation */
+    x=s-k0;
+    dr[0]=dr[1]=dr[2]=0.0;
+    for (k=0;k<NTIDENODE;k++) {
+        for (j=0,w=1.0;j<NTIDENODE;j++) {
+            if (j!=k) w*=(x-j)/(k-j);
+        }
+        for (i=0;i<3;i++) dr[i]+=w*tbl->dr[i+k*3];
+    }
+}
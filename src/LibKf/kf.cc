@@ -32,6 +32,47 @@ static void cal_Qvv(const double *R,const double *H,int n,int m,double *Qvv)
     free(T1);free(T2);free(T3);free(R_);
 }
 
+/* post-fit residuals and covariance -----------------------------------------
+* post-fit residuals from kalman filter innovation as follows:
+*
+*   post_v=-R*Q^-1*v, Qvv=R*Q^-1*R, sigma0=sqrt(v'*Q^-1*v/m)
+*
+* args   : rmat_t *R        I   covariance matrix of measurement error (m x m)
+*          double *Q        I   inverse of innovation covariance Q^-1 (m x m)
+*          double *v        I   innovation (m x 1)
+*          int    m         I   number of measurements
+*          res_t  *res      IO  residuals (post_v,Qvv,sigma0,Qvvf)
+* return : none
+* notes  : only diagonal of Qvv is computed (O(m*b^2) with b the block size of R)
+*          unless full Qvv is requested by res->qvvfull
+*-----------------------------------------------------------------------------*/
+static void postres_(const rmat_t *R,const double *Q,const double *v,int m,res_t *res)
+{
+    double *w=mat(m,1),*RQ;
+    int i;
+
+    res->post_v=mat(m,1); res->Qvv=mat(m,1);
+
+    matmul("NN",m,1,m,1.0,Q,v,0.0,w);      /* w=Q^-1*v */
+    rmat_mull(R,w,1,res->post_v);           /* post_v=-R*w */
+    for (i=0;i<m;i++) res->post_v[i]=-res->post_v[i];
+
+    /*观测值的单位权中误差*/
+    res->sigma0=SQRT(dot(v,w,m)/m);
+
+    if (res->qvvfull) {
+        RQ=mat(m,m); res->Qvvf=mat(m,m);
+        rmat_mull(R,Q,m,RQ);                /* RQ=R'*Q^-1 (R'=R) */
+        rmat_mulr(RQ,m,R,res->Qvvf);
+        for (i=0;i<m;i++) res->Qvv[i]=res->Qvvf[i+i*m];
+        free(RQ);
+    }
+    else {
+        rmat_diagrar(R,Q,res->Qvv);
+    }
+    free(w);
+}
+
 /* kalman filter ---------------------------------------------------------------
 * kalman filter state update as follows:
 *
@@ -41,7 +82,7 @@ static void cal_Qvv(const double *R,const double *H,int n,int m,double *Qvv)
 *          double *P        I   covariance matrix of states (n x n)
 *          double *H        I   transpose of design matrix (n x m)
 *          double *v        I   innovation (measurement - model) (m x 1)
-*          double *R        I   covariance matrix of measurement error (m x m)
+*          rmat_t *R        I   covariance matrix of measurement error (m x m)
 *          int    n,m       I   number of states and measurements
 *          double *xp       O   states vector after update (n x 1)
 *          double *Pp       O   covariance matrix of states after update (n x n)
@@ -50,14 +91,14 @@ static void cal_Qvv(const double *R,const double *H,int n,int m,double *Qvv)
 *          if state x[i]==0.0, not updates state x[i]/P[i+i*n]
 *-----------------------------------------------------------------------------*/
 static int filter_(const double *x, const double *P, const double *H,
-                   const double *v, const double *R, int n, int m,
+                   const double *v, const rmat_t *R, int n, int m,
                    double *xp, double *Pp,int qc,res_t *res)
 {
     double *F=mat(n,m),*Q=mat(m,m),*K=mat(n,m),*I=eye(n),*dx=mat(n,1);
     double *P1=mat(n,n),*P2=mat(n,n),*R1=mat(n,m);
     int info;
 
-    matcpy(Q,R,m,m);
+    rmat_todense(R,Q);
     matcpy(xp,x,n,1);
     matmul("NN",n,m,n,1.0,P,H,0.0,F);       /* Q=H'*P*H+R */
     matmul("TN",m,m,n,1.0,H,F,1.0,Q);
@@ -69,33 +110,19 @@ static int filter_(const double *x, const double *P, const double *H,
         matmul("NN",n,n,n,1.0,I,P,0.0,P1);  /* P1=(I-K*H')*P */
         matmul("NT",n,n,n,1.0,P1,I,0.0,P2); /* P2=(I-K*H')*P*(I-K*H')' */
         matcpy(Pp,P2,n,n);
-        matmul("NN",n,m,m,1.0,K,R,0.0,R1);  /* R1=K*R */
+        rmat_mulr(K,n,R,R1);                /* R1=K*R */
         matmul("NT",n,n,m,1.0,R1,K,1.0,Pp); /* Pp=P2+K*R*K'=(I-K*H')*P*(I-K*H')'+K*R*K' */
 
-        if(res){
-            double *RQ=mat(m,m);
-            res->post_v=mat(m,1);res->Qvv=mat(m,m);
-
-            matmul("TN",m,m,m,1.0,R,Q,0.0,RQ);
-            matmul("NN",m,m,m,1.0,RQ,R,0.0,res->Qvv);
-            matmul("NN",m,1,m,-1.0,RQ,v,0.0,res->post_v);
-
-            /*观测值的单位权中误差*/
-            double *Qv=mat(m,1),sigma0=0.0;
-            matmul("NT",m,1,m,1.0,Q,v,0.0,Qv);
-            matmul("NN",1,1,m,1.0,v,Qv,0.0,&sigma0);
-            res->sigma0=SQRT(sigma0/m);
-
-            free(Qv);free(RQ);
-        }
+        if(res) postres_(R,Q,v,m,res);
     }
     free(F); free(Q); free(K); free(I); free(dx);
+    free(P1); free(P2); free(R1);
     return info;
 }
 
 /*ref to "A Variational Bayesian-Based Robust Adaptive Filtering for Precise Point Positioning Using Undifferenced and Uncombined Observations"*/
 static int vbakf_(const double *x,const double *P,const double *H,const double *v,
-                  const double *R,int n,int m,double *xp,double *Pp)
+                  const rmat_t *R,int n,int m,double *xp,double *Pp)
 {
     double *x_1=mat(n, 1),*xk1k=mat(n,1),*Pk1k1=mat(n,n),*Pk1k=mat(n,n);
     double *Tk1k=mat(n,n),*Ak=mat(n,n),*Tkk=mat(n,n),*E_i_Pk1k=mat(n,n);
@@ -103,23 +130,23 @@ static int vbakf_(const double *x,const double *P,const double *H,const double *
     double *Pzzk1k=mat(m,m),*Pxzk1k=mat(n,m),*Kk=mat(n,m),*Kk_=mat(n,n);
     double *P1=mat(n,n),*P2=mat(n,n),*R1=mat(n,m),*I=eye(n),*v_post_=mat(m,m),*v_post=mat(m,1);
     double tao_P=3.0,v_all1=0.0,v_all2=0.0,V_all1=0.0,V_all2=0.0;
-    double *F=mat(n,m),*Q=mat(m,m),*v_N=mat(m,1),*T=mat(m,1),*RI=mat(m,m);
+    double *F=mat(n,m),*Q=mat(m,m),*v_N=mat(m,1),*T=mat(m,1),*RI=mat(m,1);
     int N=10,tk1k,tkk,info,i,j,jj;
     float fabs_v;
 
-    matcpy(Q, R, m, m);
+    rmat_todense(R, Q);
     matmul("NN", n, m, n, 1.0, P, H, 0.0, F);                //F=P*H       F(n,m),P(n,n),H(n,m)
     matmul("TN", m, m, n, 1.0, H, F, 1.0, Q);                //Q=H'*F+R    Q(m,m),H(n,m),F(n,m)
     if (!(info = matinv(Q, m))) {
-        matmul("NN", m, m, m, 1.0, R, Q, 0.0, v_post_);
+        rmat_mull(R, Q, m, v_post_);
     }
     matmul("NN", m, 1, m, -1.0, v_post_, v, 0.0, v_post);    //v_postres=-R*inv(Q)*v_prires;
 
-    /*robust,基于后验残差*/
-    matcpy(RI,R,m,m);
+    /*robust,基于后验残差 (only diagonal of R is inflated)*/
+    for (j=0;j<m;j++) RI[j]=rmat_get(R,j,j);
     for (j=0;j<m;j++) {
         fabs_v=fabs(v_post[j]);
-        v_N[j]=fabs_v/sqrt(v_post_[j*m+j]*RI[j*m+j]);
+        v_N[j]=fabs_v/sqrt(v_post_[j*m+j]*RI[j]);
         if (j%2==0) v_all1=v_all1+v_N[j];
         if (j%2==1) v_all2=v_all2+v_N[j];
     }
@@ -133,19 +160,19 @@ static int vbakf_(const double *x,const double *P,const double *H,const double *
         if (j%2==0) { /*phase*/
             T[j]=fabs(v_N[j]-v_all1/(m/2))/SQRT(V_all1/(m/2));
             if (T[j]>tdistb_0250[m/2]&&T[j]<tdistb_0005[m/2]) {
-                RI[j*m+j]=RI[j*m+j]*T[j]/tdistb_0250[m/2]*SQR((tdistb_0005[m/2]-tdistb_0250[m/2])/(tdistb_0005[m/2]-T[j])); //down weight
+                RI[j]=RI[j]*T[j]/tdistb_0250[m/2]*SQR((tdistb_0005[m/2]-tdistb_0250[m/2])/(tdistb_0005[m/2]-T[j])); //down weight
             }
             if (T[j]>tdistb_0005[m/2]) {
-                RI[j*m+j]=RI[j*m+j]*10000000.0; //rejected
+                RI[j]=RI[j]*10000000.0; //rejected
             }
         }
         if (j%2==1) { /*pseudorange*/
             T[j]=fabs(v_N[j]-v_all2/(m/2))/SQRT(V_all2/(m/2));
             if (T[j]>tdistb_0250[m/2]&&T[j]<tdistb_0005[m/2]) {
-                RI[j*m+j]=RI[j*m+j]*T[j]/tdistb_0250[m/2]*SQR((tdistb_0005[m/2]-tdistb_0250[m/2])/(tdistb_0005[m/2]-T[j]));
+                RI[j]=RI[j]*T[j]/tdistb_0250[m/2]*SQR((tdistb_0005[m/2]-tdistb_0250[m/2])/(tdistb_0005[m/2]-T[j]));
             }
             if (T[j]>tdistb_0005[m/2-1]) {
-                RI[j*m+j]=RI[j*m+j]*100000000.0;
+                RI[j]=RI[j]*100000000.0;
             }
         }
     }
@@ -168,7 +195,8 @@ static int vbakf_(const double *x,const double *P,const double *H,const double *
         if (!(info=matinv(Tkk,n))){                                                            /*E_i_Pk1k=(tkk-nx-1)*inv(Tkk)*/
             matmul("NN",n,n,n,1.0, mat_scale(n,(tkk-n-1)*1.0),Tkk,0.0,E_i_Pk1k);
         }
-        matcpy(Pzzk1k, RI, m, m);
+        rmat_todense(R, Pzzk1k);
+        for (j=0;j<m;j++) Pzzk1k[j+j*m]=RI[j];
         if (!(info = matinv(E_i_Pk1k, n))){                                                    /*D_Pk1k = inv(E_i_Pk1k)*/
             matmul("TN", m, n, n, 1.0, H, E_i_Pk1k, 0.0, E_i_Pk1k_0);
             matmul("NN", m, m, n, 1.0, E_i_Pk1k_0, H, 1.0, Pzzk1k);             /*Pzzk1k = H*D_Pk1k*H'+D_R   Pzzk1k=H*Pk1k*H'+R*/
@@ -195,19 +223,19 @@ static int vbakf_(const double *x,const double *P,const double *H,const double *
 }
 
 static int sage_husa_(const double *x,const double *P,const double *H,const double *v,
-                  const double *R,int n,int m,double *xp,double *Pp)
+                  const rmat_t *R,int n,int m,double *xp,double *Pp)
 {
     int i,j,info;
     double *Pxykk_1,*Py0,*ykk_1,*rk,ry=1.0,*R_;
-    static double beta=1.0;
+    static THREADLOCAL double beta=1.0;
 
     Pxykk_1=mat(n,m);Py0=mat(m,m);ykk_1=mat(m,1);rk=mat(m,1);R_=mat(m,m);
-    matcpy(R_,R,m,m);
+    rmat_todense(R,R_);
     matcpy(Pp,P,n,n);
 
     matprint(0,P,n,n,15,6);
     matprint(0,H,n,m,15,6);
-    matprint(0,R,m,m,15,6);
+    matprint(0,R_,m,m,15,6);
 
 
     matmul("NN",n,m,n,1.0,P,H,0.0,Pxykk_1);
@@ -273,8 +301,12 @@ static int sage_husa_(const double *x,const double *P,const double *H,const doub
     return info;
 }
 
-extern int filter(double *x, double *P, const double *H, const double *v,
-                  const double *R, int n, int m,int qc,int kf_type,res_t *res,int tc)
+/* kalman filter ---------------------------------------------------------------
+* kalman filter on non-zero states with covariance of measurement error given
+* as diagonal, block-diagonal or dense matrix (see filter_() and rmat_init())
+*-----------------------------------------------------------------------------*/
+extern int filter_rmat(double *x, double *P, const double *H, const double *v,
+                       const rmat_t *R, int n, int m,int qc,int kf_type,res_t *res,int tc)
 {
     double *x_,*xp_,*P_,*Pp_,*H_;
     int i,j,k,info,*ix;
@@ -313,8 +345,11 @@ extern int filter(double *x, double *P, const double *H, const double *v,
 
     if(tc){
 #if 1
+        double *R_=mat(m,m);
         fprintf(stdout,"coupled post:\n");
-        matprint(0,R,m,m,15,6);
+        rmat_todense(R,R_);
+        matprint(0,R_,m,m,15,6);
+        free(R_);
         matprint(0,xp_,1,k,20,10);
         matprint(0,Pp_,k,k,20,10);
 #endif
@@ -328,3 +363,15 @@ extern int filter(double *x, double *P, const double *H, const double *v,
     free(ix); free(x_); free(xp_); free(P_); free(Pp_); free(H_);
     return info;
 }
+
+/* kalman filter with dense covariance matrix of measurement error -----------
+* same as filter_rmat() with R given as dense matrix (m x m)
+*-----------------------------------------------------------------------------*/
+extern int filter(double *x, double *P, const double *H, const double *v,
+                  const double *R, int n, int m,int qc,int kf_type,res_t *res,int tc)
+{
+    rmat_t R_;
+
+    rmat_wrap(&R_,R,m);
+    return filter_rmat(x,P,H,v,&R_,n,m,qc,kf_type,res,tc);
+}
@@ -64,7 +64,7 @@ static void res_class(res_t *res,int pri)
                 res->pri_pr[j++]=fabs(res->pri_v[i]);
             }
             else{
-                res->norm_pr[j]=res->post_v[i]/(res->sigma0*SQRT(res->R[i+i*res->nv]));
+                res->norm_pr[j]=res->post_v[i]/(res->sigma0*SQRT(res->R[i]));
                 res->post_pr[j++]=res->post_v[i];
             }
         }
@@ -74,7 +74,7 @@ static void res_class(res_t *res,int pri)
                 res->pri_cp[k++]=fabs(res->pri_v[i]);
             }
             else{
-                res->norm_cp[k]=res->post_v[i]/(res->sigma0*SQRT(res->R[i+i*res->nv]));
+                res->norm_cp[k]=res->post_v[i]/(res->sigma0*SQRT(res->R[i]));
                 res->post_cp[k++]=res->post_v[i];
             }
         }
@@ -93,12 +93,16 @@ extern void init_prires(const double *v,const int *vflag,int nv,res_t *res)
     res_class(res,1);
 }
 
-extern void init_postres(rtk_t *rtk,const double *post_v,res_t *res,const double *R)
+extern void init_postres(rtk_t *rtk,const double *post_v,res_t *res,const double *var)
 {
-    res->post_v=mat(res->nv,1);
-    res->R=mat(res->nv,res->nv);
-    matcpy(res->post_v,post_v,res->nv,1);
-    matcpy(res->R,R,res->nv,res->nv);
+    if(res->post_v!=post_v){
+        if(res->post_v) free(res->post_v);
+        res->post_v=mat(res->nv,1);
+        matcpy(res->post_v,post_v,res->nv,1);
+    }
+    if(res->R) free(res->R);
+    res->R=mat(res->nv,1);
+    matcpy(res->R,var,res->nv,1);
 
     res_class(res,0);
 
@@ -153,6 +157,9 @@ extern void freeres(res_t *res)
     if(res->Qvv){
         free(res->Qvv);res->Qvv=nullptr;
     }
+    if(res->Qvvf){
+        free(res->Qvvf);res->Qvvf=nullptr;
+    }
 }
 
 static int resqc_igg_pr(rtk_t *rtk,res_t *res,int *exc,int ppp){
@@ -178,7 +185,7 @@ static int resqc_igg_pr(rtk_t *rtk,res_t *res,int *exc,int ppp){
         qc_flag=1;
         trace(2,"%s(%d): %s P%d norm residual in rejected segment el=%4.2f v=%7.3f norm_v=%7.3f var=%7.3f\n",
               time_str(rtk->sol.time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,sat_id(sat),frq+1,el,
-              res->post_v[res->pr_idx[max_n_pr_idx]],max_n_pr,SQRT(res->R[res->pr_idx[max_n_pr_idx]+res->pr_idx[max_n_pr_idx]*res->nv]));
+              res->post_v[res->pr_idx[max_n_pr_idx]],max_n_pr,SQRT(res->R[res->pr_idx[max_n_pr_idx]]));
     }
     else if(max_n_pr>=k0&&max_n_pr<=k1){
         fact=(max_n_pr/k0)*SQR((k1-k0)/(k1-max_n_pr));
@@ -186,7 +193,7 @@ static int resqc_igg_pr(rtk_t *rtk,res_t *res,int *exc,int ppp){
         qc_flag=1;
         trace(3,"%s(%d): %s P%d norm residual in reduced segment el=%4.2f v=%7.3f norm_v=%7.3f var=%7.3f fact=%7.3f\n",
               time_str(rtk->sol.time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,sat_id(sat),frq+1,el,
-              res->post_v[res->pr_idx[max_n_pr_idx]],max_n_pr,SQRT(res->R[res->pr_idx[max_n_pr_idx]+res->pr_idx[max_n_pr_idx]*res->nv]),fact);
+              res->post_v[res->pr_idx[max_n_pr_idx]],max_n_pr,SQRT(res->R[res->pr_idx[max_n_pr_idx]]),fact);
     }
     else{
         rtk->ssat[sat-1].var_fact[1][frq]=1.0;
@@ -219,7 +226,7 @@ static int resqc_igg_cp(rtk_t *rtk,res_t *res,int *exc,int ppp){
         qc_flag=1;
         trace(2,"%s(%d): %s L%d norm residual in rejected segment el=%4.2f v=%7.3f norm_v=%7.3f var=%7.3f\n",
               time_str(rtk->sol.time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,sat_id(sat),frq+1,el,
-              res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]+res->cp_idx[max_n_cp_idx]*res->nv]));
+              res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]]));
     }
     else if(fabs(max_n_cp)>=k0&&fabs(max_n_cp)<=k1){
         fact=(max_n_cp/k0)*SQR((k1-k0)/(k1-max_n_cp));
@@ -227,7 +234,7 @@ static int resqc_igg_cp(rtk_t *rtk,res_t *res,int *exc,int ppp){
         qc_flag=1;
         trace(3,"%s(%d): %s L%d norm residual in reduced segment el=%4.2f v=%7.3f norm_v=%7.3f var=%7.3f fact=%7.3f\n",
               time_str(rtk->sol.time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,sat_id(sat),frq+1,el,
-              res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]+res->cp_idx[max_n_cp_idx]*res->nv]),fact);
+              res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]]),fact);
     }
     else{
         rtk->ssat[sat-1].var_fact[0][frq]=1.0;
@@ -257,7 +264,7 @@ static int resqc_igg(rtk_t *rtk,res_t *res,int *exc,int ppp){
         qc_flag=1;
         trace(2,"%s(%d): %s P%d norm residual in rejected segment el=%4.2f v=%7.3f norm_v=%7.3f var=%7.3f\n",
               time_str(rtk->sol.time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,sat_id(sat),frq+1,el,
-              res->post_v[res->pr_idx[max_n_pr_idx]],max_n_pr,SQRT(res->R[res->pr_idx[max_n_pr_idx]+res->pr_idx[max_n_pr_idx]*res->nv]));
+              res->post_v[res->pr_idx[max_n_pr_idx]],max_n_pr,SQRT(res->R[res->pr_idx[max_n_pr_idx]]));
     }
     else{
         double max_n_cp;
@@ -270,7 +277,7 @@ static int resqc_igg(rtk_t *rtk,res_t *res,int *exc,int ppp){
             qc_flag=1;
             trace(2,"%s(%d): %s L%d norm residual in rejected segment el=%4.2f v=%7.3f norm_v=%7.3f var=%7.3f\n",
                   time_str(rtk->sol.time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,sat_id(sat),frq+1,el,
-                  res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]+res->cp_idx[max_n_cp_idx]*res->nv]));
+                  res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]]));
         }
         else if(fabs(max_n_cp)>=k0&&fabs(max_n_cp)<=k1){
             fact=(max_n_cp/k0)*SQR((k1-k0)/(k1-max_n_cp));
@@ -278,7 +285,7 @@ static int resqc_igg(rtk_t *rtk,res_t *res,int *exc,int ppp){
             qc_flag=1;
             trace(3,"%s(%d): %s L%d norm residual in reduced segment el=%4.2f v=%7.3f norm_v=%7.3f var=%7.3f fact=%7.3f\n",
                   time_str(rtk->sol.time,1),rtk->tc?rtk->ins_kf->couple_epoch:rtk->epoch,sat_id(sat),frq+1,el,
-                  res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]+res->cp_idx[max_n_cp_idx]*res->nv]),fact);
+                  res->post_v[res->cp_idx[max_n_cp_idx]],max_n_cp,SQRT(res->R[res->cp_idx[max_n_cp_idx]]),fact);
         }
         else{
             rtk->ssat[sat-1].var_fact[0][frq]=1.0;
@@ -0,0 +1,103 @@
+/*------------------------------------------------------------------------------
+* bench_glo.cc : benchmark of glonass orbit integration cache
+*
+* evaluates geph2pos() for 24 glonass satellites at 1 Hz over one day with a
+* new ephemeris every 30 min and compares the cached integration with the
+* integration from toe (forced by alternating the ephemeris iode)
+*
+* usage  : bench_glo [-r rate_hz] [-b]
+*          -r rate  evaluation rate (Hz) (default 1)
+*          -b       evaluate backward in time
+* output : us per epoch of cached and uncached integration, max position
+*          difference (m). exit status 1 if the difference exceeds 1E-4 m
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define NSAT        24          /* number of satellites */
+#define TEPH        1800.0      /* ephemeris interval (s) */
+#define RGLO        25510000.0  /* glonass orbit radius (m) */
+#define INCGLO      (64.8*D2R)  /* glonass orbit inclination (rad) */
+#define OMGE_GLO    7.292115E-5 /* earth angular velocity (rad/s) */
+#define MU_GLO      3.9860044E14 /* gravitational constant */
+#define TOL_DIFF    1E-4        /* tolerance of position difference (m) */
+
+/* ephemeris by circular orbit of satellite at toe ---------------------------*/
+static void geneph(int i, gtime_t toe, double t, geph_t *geph)
+{
+    double n=sqrt(MU_GLO/(RGLO*RGLO*RGLO)),u,omg,ri[3],vi[3],th,c,s;
+    int j;
+
+    memset(geph,0,sizeof(geph_t));
+    geph->sat=satno(SYS_GLO,i+1);
+    geph->iode=(int)(t/900.0)&0x7F;
+    geph->toe=geph->tof=toe;
+
+    omg=(i/8)*120.0*D2R;              /* ascending node of plane */
+    u=(i%8)*45.0*D2R+(i/8)*15.0*D2R+n*t; /* argument of latitude */
+    ri[0]=RGLO*(cos(u)*cos(omg)-sin(u)*cos(INCGLO)*sin(omg));
+    ri[1]=RGLO*(cos(u)*sin(omg)+sin(u)*cos(INCGLO)*cos(omg));
+    ri[2]=RGLO*sin(u)*sin(INCGLO);
+    vi[0]=RGLO*n*(-sin(u)*cos(omg)-cos(u)*cos(INCGLO)*sin(omg));
+    vi[1]=RGLO*n*(-sin(u)*sin(omg)+cos(u)*cos(INCGLO)*cos(omg));
+    vi[2]=RGLO*n*cos(u)*sin(INCGLO);
+
+    /* inertial to ecef */
+    th=OMGE_GLO*t; c=cos(th); s=sin(th);
+    geph->pos[0]= c*ri[0]+s*ri[1];
+    geph->pos[1]=-s*ri[0]+c*ri[1];
+    geph->pos[2]=ri[2];
+    geph->vel[0]= c*vi[0]+s*vi[1]+OMGE_GLO*geph->pos[1];
+    geph->vel[1]=-s*vi[0]+c*vi[1]-OMGE_GLO*geph->pos[0];
+    geph->vel[2]=vi[2];
+    for (j=0;j<3;j++) geph->acc[j]=0.0;
+}
+/* evaluate orbits of one day ------------------------------------------------*/
+static double runday(gtime_t t0, double rate, int back, int nocache,
+                     double *rs)
+{
+    geph_t geph[NSAT];
+    gtime_t time;
+    double t,dts[2],var,tick=tickget();
+    int i,k,n=(int)(86400.0*rate),beph=-1;
+
+    for (k=0;k<n;k++) {
+        t=(back?n-1-k:k)/rate;
+        time=timeadd(t0,t);
+        if ((int)(t/TEPH)!=beph) {
+            beph=(int)(t/TEPH);
+            for (i=0;i<NSAT;i++) {
+                geneph(i,timeadd(t0,(beph+0.5)*TEPH),(beph+0.5)*TEPH,geph+i);
+            }
+        }
+        for (i=0;i<NSAT;i++) {
+            if (nocache) geph[i].iode^=0x80; /* invalidate cache */
+            geph2pos(time,geph+i,rs+(k*NSAT+i)*3,dts,&var);
+        }
+    }
+    return (tickget()-tick)*1E3/n;
+}
+int main(int argc, char **argv)
+{
+    double ep[]={2020,1,1,0,0,0},rate=1.0,tc,tn,d,dmax=0.0,*rs1,*rs2;
+    int i,j,n,back=0;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-r")&&i+1<argc) rate=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-b")) back=1;
+    }
+    n=(int)(86400.0*rate);
+    if (rate<=0.0||!(rs1=mat(3*NSAT,n))||!(rs2=mat(3*NSAT,n))) return -1;
+
+    tc=runday(epoch2time(ep),rate,back,0,rs1);
+    tn=runday(epoch2time(ep),rate,back,1,rs2);
+
+    for (i=0;i<n*NSAT;i++) {
+        for (j=0,d=0.0;j<3;j++) d+=SQR(rs1[i*3+j]-rs2[i*3+j]);
+        if (sqrt(d)>dmax) dmax=sqrt(d);
+    }
+    printf("geph2pos %d sats %.1f Hz %s: cached %.2f us/epoch, from toe %.2f "
+           "us/epoch, max diff %.2E m\n",NSAT,rate,back?"backward":"forward",
+           tc,tn,dmax);
+    free(rs1); free(rs2);
+    return dmax>TOL_DIFF;
+}
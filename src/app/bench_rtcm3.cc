@@ -0,0 +1,206 @@
+/*------------------------------------------------------------------------------
+* bench_rtcm3.cc : benchmark of rtcm 3 decode throughput
+*
+* decodes a recorded rtcm 3 stream by input_rtcm3() byte by byte and by
+* input_rtcm3_buf() in blocks. without input file, the stream is generated
+* from the simulated gps and galileo observations of the GNSS_DATA day
+* (simobs.h) as msm7 (1077, 1097), station position (1005) every epoch and
+* gps ephemerides (1019) every 2 h
+*
+* usage  : bench_rtcm3 [-f file] [-o file] [-d dir] [-h hours] [-i tint]
+*                      [-b bytes] [-n loop]
+*          -f file   recorded rtcm 3 stream (default: generate)
+*          -o file   write generated stream to file
+*          -d dir    GNSS_DATA directory (default GNSS_DATA)
+*          -h hours  time span of generated stream (h) (default 24)
+*          -i tint   observation interval of generated stream (s) (default 30)
+*          -b bytes  block size of input_rtcm3_buf() (default 4096)
+*          -n loop   number of decode passes (default 20)
+* output : decoded messages per second of the byte and block input. exit
+*          status 1 if the number of messages, observation epochs or data of
+*          the block input differ from the byte input (or the generated stream)
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+#include "simobs.h"
+
+#define MAXSTRM     (64*1024*1024) /* max size of stream (bytes) */
+
+typedef struct {                /* decode counter type */
+    int nmsg;                   /* number of messages (status!=0) */
+    int nobs;                   /* number of observation epochs (status=1) */
+    int nsat;                   /* number of observation data */
+} count_t;
+
+/* append generated message to stream ----------------------------------------*/
+static int addmsg(rtcm_t *rtcm, int type, int sync, uint8_t *strm, int *n)
+{
+    if (!gen_rtcm3(rtcm,type,0,sync)) return 0;
+    if (*n+rtcm->nbyte>MAXSTRM) return -1;
+    memcpy(strm+*n,rtcm->buff,rtcm->nbyte);
+    *n+=rtcm->nbyte;
+    return 1;
+}
+/* generate rtcm 3 stream of simulated observations ----------------------------
+* cnt returns the expected decode counts. msm with sync flag returns no status
+*-----------------------------------------------------------------------------*/
+static int genstrm(const char *dir, double hours, double tint, uint8_t *strm,
+                   count_t *cnt)
+{
+    static nav_t nav;
+    static rtcm_t rtcm;
+    eph_t eph;
+    gtime_t ts,time;
+    double rr[3];
+    int i,j,n=0,ne=(int)(7200.0/tint);
+
+    memset(cnt,0,sizeof(count_t));
+    if (!sim_readnav(dir,&nav)) {
+        fprintf(stderr,"no precise ephemeris: %s%c%s\n",dir,FILEPATHSEP,SIMSP3);
+        return -1;
+    }
+    if (!init_rtcm(&rtcm)) return -1;
+    pos2ecef(sim_pos,rr);
+    ts=epoch2time(sim_ep0);
+    for (i=0;i<3;i++) rtcm.sta.pos[i]=rr[i];
+
+    for (i=0;i<(int)(hours*3600.0/tint);i++) {
+        time=timeadd(ts,i*tint);
+        if (ne<=0||i%ne==0) {
+            for (j=1;j<=MAXSAT;j++) {
+                if (!sim_eph(j,time,&nav,&eph)) continue;
+                rtcm.nav.eph[j-1]=eph;
+                rtcm.ephsat=j;
+                if (addmsg(&rtcm,1019,0,strm,&n)>0) cnt->nmsg++;
+            }
+        }
+        if ((rtcm.obs.n=sim_obs(time,rr,&nav,SYS_GPS|SYS_GAL,rtcm.obs.data))<=0) {
+            continue;
+        }
+        rtcm.time=time;
+        if (addmsg(&rtcm,1005,1,strm,&n)<=0||
+            addmsg(&rtcm,1077,1,strm,&n)<=0||
+            addmsg(&rtcm,1097,0,strm,&n)<=0) {
+            fprintf(stderr,"rtcm 3 message generation error\n");
+            break;
+        }
+        cnt->nmsg+=2;
+        cnt->nobs++;
+        cnt->nsat+=rtcm.obs.n;
+    }
+    free_rtcm(&rtcm);
+    freenav(&nav,0xFF);
+    return n;
+}
+/* count decoded message -----------------------------------------------------*/
+static void cntmsg(rtcm_t *rtcm, int stat, count_t *cnt)
+{
+    cnt->nmsg++;
+    if (stat==1) {
+        cnt->nobs++;
+        cnt->nsat+=rtcm->obs.n;
+    }
+}
+/* message callback of input_rtcm3_buf() --------------------------------------*/
+static int msgfunc(rtcm_t *rtcm, int stat, void *arg)
+{
+    cntmsg(rtcm,stat,(count_t *)arg);
+    return 1;
+}
+/* decode stream (bsize=0: byte input) (s) -----------------------------------*/
+static double decode(const uint8_t *strm, int n, int bsize, int loop,
+                     count_t *cnt)
+{
+    static rtcm_t rtcm;
+    uint32_t tick;
+    double t=0.0;
+    int i,j,m,stat;
+
+    for (i=0;i<loop;i++) {
+        memset(cnt,0,sizeof(count_t));
+        if (!init_rtcm(&rtcm)) return -1.0;
+        tick=tickget();
+        if (bsize<=0) {
+            for (j=0;j<n;j++) {
+                if ((stat=input_rtcm3(&rtcm,strm[j]))) cntmsg(&rtcm,stat,cnt);
+            }
+        }
+        else {
+            for (j=0;j<n;j+=m) {
+                m=n-j<bsize?n-j:bsize;
+                input_rtcm3_buf(&rtcm,strm+j,m,msgfunc,cnt);
+            }
+        }
+        t+=(tickget()-tick)*1E-3;
+        free_rtcm(&rtcm);
+    }
+    return t;
+}
+int main(int argc, char **argv)
+{
+    FILE *fp;
+    count_t cnt[3];
+    const char *dir=SIMDIR,*file="",*ofile="";
+    uint8_t *strm;
+    double hours=24.0,tint=30.0,t[2];
+    int i,n,bsize=4096,loop=20,stat;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-f")&&i+1<argc) file=argv[++i];
+        else if (!strcmp(argv[i],"-o")&&i+1<argc) ofile=argv[++i];
+        else if (!strcmp(argv[i],"-d")&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-h")&&i+1<argc) hours=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-i")&&i+1<argc) tint=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-b")&&i+1<argc) bsize=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-n")&&i+1<argc) loop=atoi(argv[++i]);
+    }
+    if (tint<=0.0||bsize<=0||loop<=0||!(strm=(uint8_t *)malloc(MAXSTRM))) {
+        return -1;
+    }
+    if (*file) {
+        if (!(fp=fopen(file,"rb"))) {
+            fprintf(stderr,"file open error: %s\n",file);
+            free(strm);
+            return -1;
+        }
+        n=(int)fread(strm,1,MAXSTRM,fp);
+        fclose(fp);
+    }
+    else {
+        n=genstrm(dir,hours,tint,strm,cnt+2);
+        if (n>0&&*ofile&&(fp=fopen(ofile,"wb"))) {
+            fwrite(strm,1,n,fp);
+            fclose(fp);
+        }
+    }
+    if (n<=0) {
+        fprintf(stderr,"no rtcm 3 stream\n");
+        free(strm);
+        return -1;
+    }
+    tracelevel(-1); /* suppress decode error messages of recorded streams */
+
+    t[0]=decode(strm,n,0    ,loop,cnt  );
+    t[1]=decode(strm,n,bsize,loop,cnt+1);
+
+    printf("rtcm3 %s: %d bytes, %d msgs, %d obs epochs, %d obs data\n",
+           *file?file:"simulated",n,cnt[1].nmsg,cnt[1].nobs,cnt[1].nsat);
+    for (i=0;i<2;i++) {
+        printf("%-16s: %.3f s/pass, %.0f msgs/s, %.1f MB/s\n",
+               i?"input_rtcm3_buf":"input_rtcm3",t[i]/loop,
+               t[i]>0.0?cnt[i].nmsg*loop/t[i]:0.0,
+               t[i]>0.0?n*loop/t[i]*1E-6:0.0);
+    }
+    printf("speedup %.2f (block %d bytes)\n",t[1]>0.0?t[0]/t[1]:0.0,bsize);
+
+    if (*file) cnt[2]=cnt[1]; /* no generated counts */
+    for (i=0,stat=cnt[1].nmsg<=0;i<2;i++) {
+        if (cnt[i].nmsg==cnt[2].nmsg&&cnt[i].nobs==cnt[2].nobs&&
+            cnt[i].nsat==cnt[2].nsat) continue;
+        fprintf(stderr,"%s count differ: msgs %d/%d obs epochs %d/%d obs data "
+                "%d/%d\n",i?"input_rtcm3_buf":"input_rtcm3",cnt[i].nmsg,
+                cnt[2].nmsg,cnt[i].nobs,cnt[2].nobs,cnt[i].nsat,cnt[2].nsat);
+        stat=1;
+    }
+    free(strm);
+    return stat;
+}
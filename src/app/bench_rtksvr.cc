@@ -0,0 +1,304 @@
+/*------------------------------------------------------------------------------
+* bench_rtksvr.cc : benchmark of rtk server latency and idle cpu load
+*
+* starts the rtk server (or the multi-rover rtk server) with tcp server rover
+* inputs and tcp server solution outputs on localhost, sends synthetic rtcm 3
+* gps ephemerides and msm7 observations at random intervals of 20-50 ms and
+* measures the time from sending an observation epoch to receiving its
+* solution. then the cpu time of the process is measured while no data arrive
+*
+* usage  : bench_rtksvr [-n nmsg] [-c cycle] [-p port] [-i idle] [-m nrov]
+*                       [-w nworker]
+*          -n nmsg   number of observation epochs (default 200)
+*          -c cycle  server cycle (ms) (default 10)
+*          -p port   first tcp port (default 22001)
+*                    rtksvr : rover input port, solution port+1
+*                    mrtksvr: correction port, rover k input port+1+2k,
+*                             solution port+2+2k
+*          -i idle   idle time to measure cpu load (s) (default 2)
+*          -m nrov   multi-rover rtk server with nrov rovers (epochs are sent
+*                    to the rovers in turn)
+*          -w nworker number of multi-rover server workers (default 2)
+* output : mean/max latency (ms), number of lost solutions and cpu load while
+*          idle. exit status 1 if any solution is lost
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define NSATGEN     32          /* number of generated gps satellites */
+#define TO_SOL      2000        /* timeout of solution (ms) */
+#define MAXBROV     64          /* max number of rovers */
+
+typedef struct {        /* solution line buffer type */
+    char line[1024];    /* solution line */
+    int nl;             /* length of line */
+} solbuf_b;
+
+/* current time (ms) ---------------------------------------------------------*/
+static double tickms(void)
+{
+#ifdef WIN32
+    return (double)tickget();
+#else
+    struct timespec tp;
+    clock_gettime(CLOCK_MONOTONIC,&tp);
+    return tp.tv_sec*1E3+tp.tv_nsec*1E-6;
+#endif
+}
+/* random number (xorshift) --------------------------------------------------*/
+static uint32_t rnd(uint32_t *s)
+{
+    *s^=*s<<13; *s^=*s>>17; *s^=*s<<5;
+    return *s;
+}
+/* generate gps ephemerides as rtcm 3 messages -------------------------------*/
+static int geneph(gtime_t toe, rtcm_t *enc, rtcm_t *dec, uint8_t *buff)
+{
+    eph_t *eph;
+    int i,j,n=0,week;
+    double tow=time2gpst(toe,&week);
+
+    for (i=0;i<NSATGEN;i++) {
+        eph=enc->nav.eph+i;
+        memset(eph,0,sizeof(eph_t));
+        eph->sat=i+1;
+        eph->iode=eph->iodc=1;
+        eph->week=week;
+        eph->toe=eph->toc=eph->ttr=toe;
+        eph->toes=tow;
+        eph->A=SQR(5153.7);
+        eph->e=0.005;
+        eph->i0=55.0*D2R;
+        eph->OMG0=(i%6)*60.0*D2R;
+        eph->M0=(i/6)*60.0*D2R+(i%6)*10.0*D2R;
+        eph->omg=0.5;
+        eph->OMGd=-8E-9;
+        enc->ephsat=i+1;
+        if (!gen_rtcm3(enc,1019,0,0)) continue;
+
+        /* decode ephemeris as received by server */
+        for (j=0;j<enc->nbyte;j++) input_rtcm3(dec,enc->buff[j]);
+        memcpy(buff+n,enc->buff,enc->nbyte);
+        n+=enc->nbyte;
+    }
+    return n;
+}
+/* generate msm7 observation epoch -------------------------------------------*/
+static int genobs(gtime_t time, const double *rr, rtcm_t *enc,
+                  const nav_t *nav)
+{
+    obsd_t *obs;
+    double pos[3],rs[6],dts[2],var,e[3],azel[2],r,P;
+    int i,j,svh;
+
+    ecef2pos(rr,pos);
+    enc->time=time;
+    enc->obs.n=0;
+    for (i=0;i<NSATGEN&&enc->obs.n<MAXOBS;i++) {
+        for (j=0,P=0.0;j<2;j++) { /* iterate signal transmission time */
+            if (!satpos(&prcopt_default,timeadd(time,-P/CLIGHT),time,i+1,
+                        EPHOPT_BRDC,nav,NULL,rs,dts,&var,&svh)) break;
+            r=geodist(rs,rr,e);
+            P=r-CLIGHT*dts[0];
+        }
+        if (j<2||satazel(pos,e,azel)<15.0*D2R) continue;
+
+        obs=enc->obs.data+enc->obs.n++;
+        memset(obs,0,sizeof(obsd_t));
+        obs->time=time;
+        obs->sat=i+1;
+        obs->rcv=1;
+        obs->P[0]=obs->P[1]=P;
+        obs->L[0]=P/(CLIGHT/FREQ1);
+        obs->L[1]=P/(CLIGHT/FREQ2);
+        obs->code[0]=CODE_L1C;
+        obs->code[1]=CODE_L2W;
+        obs->SNR[0]=obs->SNR[1]=(uint16_t)(45.0/SNR_UNIT);
+    }
+    return gen_rtcm3(enc,1077,0,0);
+}
+/* wait solution line from solution stream -----------------------------------*/
+static int waitsol(stream_t *out, solbuf_b *sb, strwait_t *wait, int timeout)
+{
+    uint8_t buff[1024];
+    double t0=tickms();
+    int i,n;
+
+    for (;;) {
+        for (n=strread(out,buff,sizeof(buff)),i=0;i<n;i++) {
+            if (buff[i]!='\n') {
+                if (sb->nl<(int)sizeof(sb->line)-1) sb->line[sb->nl++]=(char)buff[i];
+                continue;
+            }
+            sb->line[sb->nl]='\0';
+            sb->nl=0;
+            if (sb->line[0]!='%') return 1; /* skip header */
+        }
+        if (tickms()-t0>=timeout) return 0;
+        strwait(wait,out,1,timeout-(int)(tickms()-t0));
+    }
+}
+/* start rtk server ----------------------------------------------------------*/
+static int startsvr(rtksvr_t *svr, int cycle, int port, prcopt_t *prcopt,
+                    const double *pos)
+{
+    solopt_t solopt[2]={solopt_default,solopt_default};
+    char path_in[32],path_out[32],errmsg[2048]="";
+    char *paths[8]={path_in,(char *)"",(char *)"",path_out,(char *)"",(char *)"",
+                    (char *)"",(char *)""};
+    char *cmds[3]={NULL,NULL,NULL},*rcvopts[3]={(char *)"",(char *)"",(char *)""};
+    int strs[8]={STR_TCPSVR,0,0,STR_TCPSVR,0,0,0,0};
+    int formats[3]={STRFMT_RTCM3,STRFMT_RTCM3,STRFMT_RTCM3};
+
+    sprintf(path_in,":%d",port);
+    sprintf(path_out,":%d",port+1);
+    rtksvrinit(svr);
+    if (!rtksvrstart(svr,cycle,32768,strs,paths,formats,0,cmds,cmds,rcvopts,
+                     0,0,pos,prcopt,solopt,NULL,errmsg)) {
+        fprintf(stderr,"rtksvrstart error: %s\n",errmsg);
+        return 0;
+    }
+    return 1;
+}
+/* start multi-rover rtk server ----------------------------------------------*/
+static int startmsvr(mrtksvr_t *svr, int cycle, int port, int nrov,
+                     int nworker, prcopt_t *prcopt)
+{
+    char path_cor[32],path[3][32],errmsg[2048]="";
+    char *paths_cor[MAXMCOR]={path_cor,(char *)"",(char *)"",(char *)""};
+    char *paths[3]={path[0],path[1],path[2]};
+    char *rcvopts[MAXMCOR]={(char *)"",(char *)"",(char *)"",(char *)""};
+    int strs_cor[MAXMCOR]={STR_TCPSVR,0,0,0},strs[3]={STR_TCPSVR,STR_TCPSVR,0};
+    int formats[MAXMCOR]={STRFMT_RTCM3,STRFMT_RTCM3,STRFMT_RTCM3,STRFMT_RTCM3};
+    int i;
+
+    sprintf(path_cor,":%d",port);
+    *path[2]='\0';
+    if (!mrtksvrinit(svr)||
+        !mrtksvrstart(svr,cycle,32768,nworker,strs_cor,paths_cor,formats,
+                      rcvopts,errmsg)) {
+        fprintf(stderr,"mrtksvrstart error: %s\n",errmsg);
+        return 0;
+    }
+    for (i=0;i<nrov;i++) {
+        sprintf(path[0],":%d",port+1+i*2);
+        sprintf(path[1],":%d",port+2+i*2);
+        if (mrtksvraddrov(svr,strs,paths,STRFMT_RTCM3,"",prcopt,&solopt_default,
+                          errmsg)<0) {
+            fprintf(stderr,"mrtksvraddrov error: %s\n",errmsg);
+            return 0;
+        }
+    }
+    return 1;
+}
+int main(int argc, char **argv)
+{
+    static rtksvr_t svr;
+    static mrtksvr_t msvr;
+    static rtcm_t enc,dec;
+    static stream_t in[MAXBROV],out[MAXBROV],cor;
+    static solbuf_b sb[MAXBROV];
+    static uint8_t ephbuff[NSATGEN*128];
+    prcopt_t prcopt=prcopt_default;
+    strwait_t wait;
+    gtime_t t0;
+    double pos[]={35.0*D2R,139.0*D2R,50.0},rr[3];
+    double t,lat,tmean=0.0,tmax=0.0;
+    char path[32],msg[MAXSTRMSG];
+    char *cmds[3]={NULL,NULL,NULL};
+    int i,j,k,n=200,cycle=10,port=22001,idle=2,nrov=0,nworker=2,nsol=0,neph;
+    uint32_t seed=20201;
+    clock_t cpu;
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-n")&&i+1<argc) n=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-c")&&i+1<argc) cycle=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-p")&&i+1<argc) port=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-i")&&i+1<argc) idle=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-m")&&i+1<argc) nrov=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-w")&&i+1<argc) nworker=atoi(argv[++i]);
+    }
+    if (nrov>MAXBROV) nrov=MAXBROV;
+    t0=utc2gpst(timeget()); /* rtcm 3 time of week relative to current time */
+    t0.sec=0.0;
+    pos2ecef(pos,rr);
+    init_rtcm(&enc); enc.staid=1;
+    init_rtcm(&dec); dec.time=t0;
+    neph=geneph(timeadd(t0,900.0),&enc,&dec,ephbuff);
+
+    /* start rtk server or multi-rover rtk server */
+    prcopt.mode=PMODE_SINGLE;
+    prcopt.ionoopt=IONOOPT_OFF;
+    prcopt.tropopt=TROPOPT_OFF;
+    prcopt.gnss_frq_idx[0][0]=1; /* gps L1,L2 */
+    prcopt.gnss_frq_idx[0][1]=2;
+    if (nrov<=0?!startsvr(&svr,cycle,port,&prcopt,pos):
+                !startmsvr(&msvr,cycle,port,nrov,nworker,&prcopt)) {
+        return -1;
+    }
+    /* connect to rover inputs, solution outputs and correction input */
+    for (k=0;k<(nrov>0?nrov:1);k++) {
+        strinit(in+k); strinit(out+k);
+        sprintf(path,"localhost:%d",nrov>0?port+1+k*2:port);
+        stropen(in+k,STR_TCPCLI,STR_MODE_RW,path);
+        sprintf(path,"localhost:%d",nrov>0?port+2+k*2:port+1);
+        stropen(out+k,STR_TCPCLI,STR_MODE_R,path);
+    }
+    strinit(&cor);
+    if (nrov>0) {
+        sprintf(path,"localhost:%d",port);
+        stropen(&cor,STR_TCPCLI,STR_MODE_RW,path);
+    }
+    strwaitinit(&wait);
+    for (i=0;i<50;i++) {
+        for (j=k=0;k<(nrov>0?nrov:1);k++) {
+            strwrite(in+k,(uint8_t *)"",0);
+            waitsol(out+k,sb+k,&wait,0);
+            j+=strstat(in+k,msg)>=2&&strstat(out+k,msg)>=2;
+        }
+        if (nrov>0) strwrite(&cor,(uint8_t *)"",0);
+        if (j>=k&&(nrov<=0||strstat(&cor,msg)>=2)) break;
+        sleepms(100);
+    }
+    strwrite(nrov>0?&cor:in,ephbuff,neph);
+    sleepms(500);
+
+    /* send observation epochs to rovers in turn and wait solutions */
+    for (i=0;i<n;i++) {
+        k=nrov>0?i%nrov:0;
+        if (!genobs(timeadd(t0,nrov>0?i/nrov:i),rr,&enc,&dec.nav)) continue;
+        sleepms(20+(int)(rnd(&seed)%31));
+        t=tickms();
+        strwrite(in+k,enc.buff,enc.nbyte);
+        if (!waitsol(out+k,sb+k,&wait,TO_SOL)) continue;
+        lat=tickms()-t;
+        tmean+=lat;
+        if (lat>tmax) tmax=lat;
+        nsol++;
+    }
+    /* cpu load while no data */
+    cpu=clock();
+    sleepms(idle*1000);
+    cpu=clock()-cpu;
+
+    if (nrov>0) printf("mrtksvr %d rovers %d workers",nrov,nworker);
+    else printf("rtksvr");
+    printf(" cycle %d ms: %d epochs, latency mean %.2f ms max %.2f ms, "
+           "lost %d, idle cpu %.1f ms/s\n",cycle,n,nsol>0?tmean/nsol:0.0,tmax,
+           n-nsol,idle>0?(double)cpu/CLOCKS_PER_SEC*1E3/idle:0.0);
+
+    strwaitfree(&wait);
+    for (k=0;k<(nrov>0?nrov:1);k++) {
+        strclose(in+k); strclose(out+k);
+    }
+    strclose(&cor);
+    if (nrov>0) {
+        mrtksvrstop(&msvr);
+        mrtksvrfree(&msvr);
+    }
+    else {
+        rtksvrstop(&svr,cmds);
+        rtksvrfree(&svr);
+    }
+    free_rtcm(&enc); free_rtcm(&dec);
+    return nsol<n;
+}
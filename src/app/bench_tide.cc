@@ -0,0 +1,91 @@
+/*------------------------------------------------------------------------------
+* bench_tide.cc : benchmark of tidal displacement table
+*
+* evaluates the earth tide displacements (solid, ocean loading and pole tide)
+* of the static station of the GNSS_DATA day (AGGO) at every epoch over one
+* day by tidedisp() and by interpolation of the node table of tidedisp_tbl()
+*
+* usage  : bench_tide [-d dir] [-i tint] [-r rate_hz] [-b]
+*          -d dir    GNSS_DATA directory (default GNSS_DATA)
+*          -i tint   node interval of tide table (s) (default 300)
+*          -r rate   evaluation rate (Hz) (default 1)
+*          -b        evaluate backward in time
+* output : us per epoch of tidedisp() and tidedisp_tbl(), speedup and max
+*          displacement difference (m). exit status 1 if the difference
+*          exceeds 1E-5 m
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+#include "simobs.h"
+
+#define ERPFILE     "2020/igs_erp/igs20867.erp"
+#define BLQFILE     "blq/ocnload.blq"
+#define STANAME     "AGGO"
+#define TIDEOPT     7           /* solid+ocean loading+pole tide */
+#define TOL_DIFF    1E-5        /* tolerance of displacement difference (m) */
+
+/* evaluate tidal displacements of one day -----------------------------------*/
+static double runday(gtime_t t0, double rate, int back, double tint,
+                     const double *rr, const erp_t *erp, const double *odisp,
+                     double *dr)
+{
+    tidetbl_t tbl={0};
+    gtime_t time;
+    double t,tick=tickget();
+    int k,n=(int)(86400.0*rate);
+
+    tbl.tint=tint;
+    for (k=0;k<n;k++) {
+        t=(back?n-1-k:k)/rate;
+        time=gpst2utc(timeadd(t0,t));
+        if (tint>0.0) {
+            tidedisp_tbl(&tbl,time,rr,TIDEOPT,erp,NULL,odisp,dr+k*3);
+        }
+        else {
+            tidedisp(time,rr,TIDEOPT,erp,NULL,odisp,dr+k*3);
+        }
+    }
+    return (tickget()-tick)*1E3/n;
+}
+int main(int argc, char **argv)
+{
+    erp_t erp={0};
+    const char *dir=SIMDIR;
+    char path[1024];
+    double rr[3],odisp[6*11]={0},rate=1.0,tint=300.0,te,tt,d,dmax=0.0;
+    double *dr1,*dr2;
+    int i,j,n,back=0;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-d")&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-i")&&i+1<argc) tint=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-r")&&i+1<argc) rate=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-b")) back=1;
+    }
+    sprintf(path,"%s%c%s",dir,FILEPATHSEP,ERPFILE);
+    if (!readerp(path,&erp)) {
+        fprintf(stderr,"no erp data: %s\n",path);
+        return -1;
+    }
+    sprintf(path,"%s%c%s",dir,FILEPATHSEP,BLQFILE);
+    if (!readblq(path,STANAME,odisp)) {
+        fprintf(stderr,"no ocean loading parameters: %s %s\n",path,STANAME);
+        return -1;
+    }
+    n=(int)(86400.0*rate);
+    if (rate<=0.0||tint<=0.0||!(dr1=mat(3,n))||!(dr2=mat(3,n))) return -1;
+
+    pos2ecef(sim_pos,rr);
+    te=runday(epoch2time(sim_ep0),rate,back,0.0 ,rr,&erp,odisp,dr1);
+    tt=runday(epoch2time(sim_ep0),rate,back,tint,rr,&erp,odisp,dr2);
+
+    for (i=0;i<n;i++) {
+        for (j=0,d=0.0;j<3;j++) d+=SQR(dr1[i*3+j]-dr2[i*3+j]);
+        if (sqrt(d)>dmax) dmax=sqrt(d);
+    }
+    printf("tidedisp %s %.1f Hz %s: exact %.2f us/epoch, table (tint=%.0fs) "
+           "%.2f us/epoch, speedup %.1f, max diff %.2E m\n",STANAME,rate,
+           back?"backward":"forward",te,tint,tt,tt>0.0?te/tt:0.0,dmax);
+    free(dr1); free(dr2);
+    free(erp.data);
+    return dmax>TOL_DIFF;
+}
@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------------
+* chk_bits.cc : self-check of bitfield extraction and setting
+*
+* compares getbitu(),getbits(),setbitu(),setbits() and the sequential bit
+* reader rdbitu()/rdbits() with the bit-by-bit reference implementations for
+* random data, bit positions and lengths
+*
+* usage  : chk_bits [-n ncase] [-s seed]
+* output : number of cases and mismatches. exit status 1 if any mismatch
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define NBUFF       16          /* length of test data (bytes) */
+
+/* reference bit extraction (bit loop) ---------------------------------------*/
+static uint32_t getbitu_ref(const uint8_t *buff, int pos, int len)
+{
+    uint32_t bits=0;
+    int i;
+    for (i=pos;i<pos+len;i++) bits=(bits<<1)+((buff[i/8]>>(7-i%8))&1u);
+    return bits;
+}
+static int32_t getbits_ref(const uint8_t *buff, int pos, int len)
+{
+    uint32_t bits=getbitu_ref(buff,pos,len);
+    if (len<=0||32<=len||!(bits&(1u<<(len-1)))) return (int32_t)bits;
+    return (int32_t)(bits|(~0u<<len)); /* extend sign */
+}
+/* reference bit setting (bit loop) ------------------------------------------*/
+static void setbitu_ref(uint8_t *buff, int pos, int len, uint32_t data)
+{
+    uint32_t mask=1u<<(len-1);
+    int i;
+    if (len<=0||32<len) return;
+    for (i=pos;i<pos+len;i++,mask>>=1) {
+        if (data&mask) buff[i/8]|=1u<<(7-i%8); else buff[i/8]&=~(1u<<(7-i%8));
+    }
+}
+static void setbits_ref(uint8_t *buff, int pos, int len, int32_t data)
+{
+    if (data<0) data|=1<<(len-1); else data&=~(1<<(len-1)); /* set sign bit */
+    setbitu_ref(buff,pos,len,(uint32_t)data);
+}
+/* random number (xorshift) --------------------------------------------------*/
+static uint32_t rnd(uint32_t *s)
+{
+    *s^=*s<<13; *s^=*s>>17; *s^=*s<<5;
+    return *s;
+}
+int main(int argc, char **argv)
+{
+    uint8_t buff[NBUFF],b1[NBUFF],b2[NBUFF];
+    uint32_t seed=20201,data;
+    bitr_t br;
+    int i,j,k,n=1000000,pos,len,lens[8],nerr=0,nchk=0;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-n")&&i+1<argc) n=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-s")&&i+1<argc) seed=(uint32_t)atoi(argv[++i]);
+    }
+    for (i=0;i<n;i++) {
+        for (j=0;j<NBUFF;j++) buff[j]=(uint8_t)rnd(&seed);
+        len=(int)(rnd(&seed)%41)-1; /* -1 to 39 */
+        pos=(int)(rnd(&seed)%(NBUFF*8-(len>0?len:0)+1));
+        data=rnd(&seed);
+
+        /* extraction */
+        nchk+=2;
+        if (getbitu(buff,pos,len)!=getbitu_ref(buff,pos,len)) {
+            if (nerr++<10) printf("getbitu error: pos=%d len=%d\n",pos,len);
+        }
+        if (getbits(buff,pos,len)!=getbits_ref(buff,pos,len)) {
+            if (nerr++<10) printf("getbits error: pos=%d len=%d\n",pos,len);
+        }
+        /* setting */
+        nchk+=2;
+        memcpy(b1,buff,NBUFF); memcpy(b2,buff,NBUFF);
+        setbitu(b1,pos,len,data); setbitu_ref(b2,pos,len,data);
+        if (memcmp(b1,b2,NBUFF)) {
+            if (nerr++<10) printf("setbitu error: pos=%d len=%d\n",pos,len);
+        }
+        if (len>=1&&len<=32) {
+            memcpy(b1,buff,NBUFF); memcpy(b2,buff,NBUFF);
+            setbits(b1,pos,len,(int32_t)data); setbits_ref(b2,pos,len,(int32_t)data);
+            if (memcmp(b1,b2,NBUFF)) {
+                if (nerr++<10) printf("setbits error: pos=%d len=%d\n",pos,len);
+            }
+        }
+        /* sequential reader */
+        for (j=0,k=0;j<8;j++) {
+            lens[j]=(int)(rnd(&seed)%32)+1;
+            if ((k+=lens[j])>NBUFF*8) break;
+        }
+        br.buff=buff; br.pos=0;
+        for (k=0,pos=0;k<j;pos+=lens[k++]) {
+            nchk++;
+            if (k%2?rdbits(&br,lens[k])!=getbits_ref(buff,pos,lens[k]):
+                    rdbitu(&br,lens[k])!=getbitu_ref(buff,pos,lens[k])) {
+                if (nerr++<10) printf("rdbit error: pos=%d len=%d\n",pos,lens[k]);
+            }
+        }
+        if (br.pos!=pos) {
+            if (nerr++<10) printf("rdbit position error: pos=%d\n",br.pos);
+        }
+    }
+    printf("bitfield check: %d cases %d checks %d errors\n",n,nchk,nerr);
+    return nerr>0;
+}
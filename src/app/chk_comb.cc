@@ -0,0 +1,157 @@
+/*------------------------------------------------------------------------------
+* chk_comb.cc : check of concurrent combined forward/backward processing
+*
+* writes simulated gps observations of the GNSS_DATA day (simobs.h) to
+* rinex files and processes them by postpos() in combined ppp-kinematic mode
+* with fix-and-hold ar twice: with the forward and backward passes on two
+* threads, and sequentially (forced by the solution status output that the
+* two passes would share). the solutions of the two runs must be identical
+*
+* usage  : chk_comb [-d dir] [-o dir] [-h hours]
+*          -d dir    GNSS_DATA directory (default GNSS_DATA)
+*          -o dir    output directory (default .)
+*          -h hours  processing time span (h) (default 2)
+* output : processing time of the runs and number of differing solution
+*          lines. exit status 1 if any line differs
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+#include "simobs.h"
+
+#define TINT        30.0        /* observation interval (s) */
+
+/* write simulated observations and ephemerides as rinex 3 files ------------*/
+static int writernx(const char *obsfile, const char *navfile, gtime_t ts,
+                    int n, const nav_t *nav, const double *rr)
+{
+    FILE *fp;
+    rnxopt_t opt;
+    obsd_t obs[MAXOBS];
+    eph_t eph;
+    int i,j,nobs;
+
+    sim_rnxopt(SYS_GPS,ts,rr,&opt);
+    opt.tint=TINT;
+
+    if (!(fp=fopen(obsfile,"w"))) return 0;
+    outrnxobsh(fp,&opt,nav);
+    for (i=0;i<n;i++) {
+        nobs=sim_obs(timeadd(ts,i*TINT),rr,nav,SYS_GPS,obs);
+        if (nobs>0) outrnxobsb(fp,&opt,obs,nobs,0);
+    }
+    fclose(fp);
+
+    if (!(fp=fopen(navfile,"w"))) return 0;
+    outrnxnavh(fp,&opt,nav);
+    for (i=0;i<=n*TINT/7200.0;i++) {
+        for (j=1;j<=MAXSAT;j++) {
+            if (sim_eph(j,timeadd(ts,i*7200.0),nav,&eph)) outrnxnavb(fp,&opt,&eph);
+        }
+    }
+    fclose(fp);
+    return 1;
+}
+/* process observations in combined mode ------------------------------------*/
+static double procobs(gtime_t ts, gtime_t te, char **infile,
+                      const char *outfile, int serial)
+{
+    prcopt_t popt=prcopt_default;
+    solopt_t sopt=solopt_default;
+    filopt_t fopt={0};
+    char ofile[1024],frq[]="L1+L2";
+    uint32_t tick=tickget();
+
+    popt.mode=PMODE_PPP_KINEMA;
+    popt.soltype=2;
+    popt.nf=2;
+    popt.navsys=SYS_GPS;
+    popt.sateph=EPHOPT_PREC;
+    popt.modear=ARMODE_FIXHOLD;
+    popt.ionoopt=IONOOPT_IFLC;
+    popt.tropopt=TROPOPT_EST;
+    popt.tropmap=TROPMAP_GMF;
+    popt.dynamics=0;
+    popt.elmin=SIMELMIN;
+    getobsfrqidx(frq,SYS_GPS,popt.nf,popt.gnss_frq_idx[0]);
+
+    sopt.posf=SOLF_XYZ;
+    sopt.sstat=serial; /* shared status file forces sequential passes */
+    sopt.trace=-1;
+
+    strcpy(ofile,outfile);
+
+    if (postpos(ts,te,0.0,0.0,&popt,&sopt,&fopt,infile,3,ofile,"","")) {
+        return -1.0;
+    }
+    return (tickget()-tick)*1E-3;
+}
+/* compare solution lines of output files -------------------------------------*/
+static int cmpsol(const char *file1, const char *file2, int *nline)
+{
+    FILE *fp1,*fp2;
+    char buff1[1024],buff2[1024];
+    int ndiff=0;
+
+    *nline=0;
+    if (!(fp1=fopen(file1,"r"))) return -1;
+    if (!(fp2=fopen(file2,"r"))) {
+        fclose(fp1);
+        return -1;
+    }
+    for (;;) {
+        while (fgets(buff1,sizeof(buff1),fp1)&&buff1[0]=='%') ;
+        while (fgets(buff2,sizeof(buff2),fp2)&&buff2[0]=='%') ;
+        if (feof(fp1)||feof(fp2)) break;
+        if (strcmp(buff1,buff2)&&ndiff++<5) {
+            fprintf(stderr,"differ: %s        %s",buff1,buff2);
+        }
+        (*nline)++;
+    }
+    if (!feof(fp1)||!feof(fp2)) ndiff++; /* different number of lines */
+    fclose(fp1); fclose(fp2);
+    return ndiff;
+}
+int main(int argc, char **argv)
+{
+    static nav_t nav;
+    gtime_t ts,te;
+    const char *dir=SIMDIR,*odir=".";
+    char file[3][1024],*infile[3],outc[1024],outs[1024];
+    double rr[3],hours=2.0,tc,tsq;
+    int i,n,ndiff,nline;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-d")&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-o")&&i+1<argc) odir=argv[++i];
+        else if (!strcmp(argv[i],"-h")&&i+1<argc) hours=atof(argv[++i]);
+    }
+    if (!sim_readnav(dir,&nav)) {
+        fprintf(stderr,"no precise ephemeris: %s%c%s\n",dir,FILEPATHSEP,SIMSP3);
+        return -1;
+    }
+    sprintf(file[0],"%s%cchk_comb.obs",odir,FILEPATHSEP);
+    sprintf(file[1],"%s%cchk_comb.nav",odir,FILEPATHSEP);
+    sprintf(file[2],"%s%c%s",dir,FILEPATHSEP,SIMSP3);
+    for (i=0;i<3;i++) infile[i]=file[i];
+    sprintf(outc,"%s%cchk_comb_c.pos",odir,FILEPATHSEP);
+    sprintf(outs,"%s%cchk_comb_s.pos",odir,FILEPATHSEP);
+
+    pos2ecef(sim_pos,rr);
+    ts=epoch2time(sim_ep0);
+    n=(int)(hours*3600.0/TINT);
+    te=timeadd(ts,(n-1)*TINT);
+    if (n<=0||!writernx(file[0],file[1],ts,n,&nav,rr)) {
+        fprintf(stderr,"rinex file write error: %s\n",file[0]);
+        return -1;
+    }
+    if ((tc =procobs(ts,te,infile,outc,0))<0.0||
+        (tsq=procobs(ts,te,infile,outs,1))<0.0) {
+        fprintf(stderr,"processing error\n");
+        return -1;
+    }
+    ndiff=cmpsol(outc,outs,&nline);
+
+    fprintf(stderr,"combined ppp %d epochs: concurrent %.2f s, sequential %.2f s, "
+           "%d solutions, %d differ\n",n,tc,tsq,nline,ndiff);
+    freenav(&nav,0xFF);
+    return ndiff!=0||nline<=0;
+}
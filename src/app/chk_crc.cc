@@ -0,0 +1,96 @@
+/*------------------------------------------------------------------------------
+* chk_crc.cc : self-check of table-driven crc functions
+*
+* compares rtk_crc32() (slicing-by-8), rtk_crc24q() and rtk_crc16() with the
+* bitwise reference implementations for random buffers, offsets and lengths
+*
+* usage  : chk_crc [-n ncase] [-m maxlen] [-s seed]
+* output : number of cases and mismatches. exit status 1 if any mismatch
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define POLYCRC32   0xEDB88320u /* crc32 polynomial (reflected) */
+#define POLYCRC24Q  0x1864CFBu  /* crc24q polynomial */
+#define POLYCRC16   0x1021u     /* crc16 polynomial (ccitt) */
+
+/* reference crc-32 (bitwise) ------------------------------------------------*/
+static uint32_t crc32_ref(const uint8_t *buff, int len)
+{
+    uint32_t crc=0;
+    int i,j;
+    for (i=0;i<len;i++) {
+        crc^=buff[i];
+        for (j=0;j<8;j++) {
+            if (crc&1) crc=(crc>>1)^POLYCRC32; else crc>>=1;
+        }
+    }
+    return crc;
+}
+/* reference crc-24q (bitwise) -----------------------------------------------*/
+static uint32_t crc24q_ref(const uint8_t *buff, int len)
+{
+    uint32_t crc=0;
+    int i,j;
+    for (i=0;i<len;i++) {
+        crc^=(uint32_t)buff[i]<<16;
+        for (j=0;j<8;j++) {
+            crc<<=1;
+            if (crc&0x1000000u) crc^=POLYCRC24Q;
+        }
+    }
+    return crc&0xFFFFFFu;
+}
+/* reference crc-16 (bitwise) ------------------------------------------------*/
+static uint16_t crc16_ref(const uint8_t *buff, int len)
+{
+    uint32_t crc=0;
+    int i,j;
+    for (i=0;i<len;i++) {
+        crc^=(uint32_t)buff[i]<<8;
+        for (j=0;j<8;j++) {
+            crc<<=1;
+            if (crc&0x10000u) crc^=POLYCRC16;
+        }
+    }
+    return (uint16_t)crc;
+}
+/* random number (xorshift) --------------------------------------------------*/
+static uint32_t rnd(uint32_t *s)
+{
+    *s^=*s<<13; *s^=*s>>17; *s^=*s<<5;
+    return *s;
+}
+int main(int argc, char **argv)
+{
+    uint8_t *buff;
+    uint32_t seed=20201;
+    int i,j,n=2000,maxlen=65000,off,len,nerr=0;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-n")&&i+1<argc) n=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-m")&&i+1<argc) maxlen=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-s")&&i+1<argc) seed=(uint32_t)atoi(argv[++i]);
+    }
+    if (maxlen<=0||!(buff=(uint8_t *)malloc(maxlen+8))) return -1;
+
+    for (i=0;i<maxlen+8;i++) buff[i]=(uint8_t)rnd(&seed);
+
+    for (i=0;i<n;i++) {
+        off=(int)(rnd(&seed)%8); /* unaligned start */
+        len=i<64?i:(int)(rnd(&seed)%(maxlen+1));
+        for (j=0;j<len;j+=61) buff[off+j]=(uint8_t)rnd(&seed);
+
+        if (rtk_crc32(buff+off,len)!=crc32_ref(buff+off,len)) {
+            if (nerr++<10) printf("crc32 error: off=%d len=%d\n",off,len);
+        }
+        if (rtk_crc24q(buff+off,len)!=crc24q_ref(buff+off,len)) {
+            if (nerr++<10) printf("crc24q error: off=%d len=%d\n",off,len);
+        }
+        if (rtk_crc16(buff+off,len)!=crc16_ref(buff+off,len)) {
+            if (nerr++<10) printf("crc16 error: off=%d len=%d\n",off,len);
+        }
+    }
+    printf("crc check: %d cases (len<=%d) %d errors\n",n,maxlen,nerr);
+    free(buff);
+    return nerr>0;
+}
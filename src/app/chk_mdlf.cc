@@ -0,0 +1,170 @@
+/*------------------------------------------------------------------------------
+* chk_mdlf.cc : check of single-precision correction models
+*
+* processes simulated gps observations of the GNSS_DATA day (simobs.h) in ppp
+* kinematic mode with windup, shapiro, satellite/receiver antenna pcv,
+* troposphere mapping (gmf) and earth tide (solid, ocean loading and pole tide
+* of AGGO) corrections by two filters in lockstep: double-precision models
+* with check of the single-precision kernels (-MDL_FLOAT=2) and single-
+* precision models (-MDL_FLOAT=1). the broadcast ephemerides for the initial
+* single point positions are fitted to the precise orbits and the antenna pcv
+* are synthetic since the GNSS_DATA day has no navigation and antex files
+*
+* usage  : chk_mdlf [-d dir] [-h hours]
+*          -d dir    GNSS_DATA directory (default GNSS_DATA)
+*          -h hours  processing time span (h) (default 24)
+* output : max single-double differences of the kernels (rtk->mdlerr) and max
+*          difference of carrier-phase residuals and positions of the double
+*          and single-precision filters. exit status 1 if the residual
+*          difference exceeds 0.1 mm
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+#include "simobs.h"
+
+#define TINT        30.0        /* observation interval (s) */
+#define ERPFILE     "2020/igs_erp/igs20867.erp"
+#define BLQFILE     "blq/ocnload.blq"
+#define STANAME     "AGGO"
+#define TOL_RES     1E-4        /* tolerance of residual difference (m) */
+
+/* synthetic antenna pcv -------------------------------------------------------
+* receiver: offset up 0.1 m and pcv of 5 mm*sin(2*el) at el=90,85,...,0 deg.
+* satellite: pcv of 3 mm*sin(nadir) at nadir=0,1,2,...,18 nodes
+*-----------------------------------------------------------------------------*/
+static void setpcv(pcv_t *pcvr, pcv_t *pcvs)
+{
+    int i,j,k;
+
+    memset(pcvr,0,sizeof(pcv_t));
+    strcpy(pcvr->type,"SIM0");
+    for (i=0;i<2*NFREQ;i++) {
+        pcvr->off[i][2]=0.1+0.01*i;
+        for (j=0;j<=18;j++) pcvr->var[i][j]=0.005*sin(2.0*(90-5*j)*D2R);
+    }
+    for (k=0;k<MAXSAT;k++) {
+        memset(pcvs+k,0,sizeof(pcv_t));
+        pcvs[k].sat=k+1;
+        strcpy(pcvs[k].type,"BLOCK IIF");
+        for (i=0;i<2*NFREQ;i++) {
+            for (j=0;j<=18;j++) pcvs[k].var[i][j]=0.003*sin(j*D2R);
+        }
+    }
+}
+/* add broadcast ephemerides for the single point positioning --------------*/
+static int addeph(gtime_t ts, double hours, nav_t *nav)
+{
+    eph_t eph;
+    int i,j;
+
+    for (i=0;i<=hours/2.0;i++) {
+        for (j=1;j<=MAXSAT;j++) {
+            if (!sim_eph(j,timeadd(ts,i*7200.0),nav,&eph)) continue;
+            if (nav->n>=nav->nmax) {
+                nav->nmax+=256;
+                if (!(nav->eph=(eph_t *)realloc(nav->eph,sizeof(eph_t)*nav->nmax))) {
+                    return 0;
+                }
+            }
+            nav->eph[nav->n++]=eph;
+        }
+    }
+    return nav->n>0;
+}
+/* processing options ---------------------------------------------------------*/
+static void setopt(prcopt_t *popt, int prec)
+{
+    char frq[]="L1+L2";
+
+    *popt=prcopt_default;
+    popt->mode=PMODE_PPP_KINEMA;
+    popt->nf=2;
+    popt->navsys=SYS_GPS;
+    popt->sateph=EPHOPT_PREC;
+    popt->ionoopt=IONOOPT_IFLC;
+    popt->tropopt=TROPOPT_EST;
+    popt->tropmap=TROPMAP_GMF;
+    popt->dynamics=0;
+    popt->elmin=SIMELMIN;
+    popt->tidecorr=2;
+    popt->posopt[0]=popt->posopt[1]=popt->posopt[2]=1;
+    sprintf(popt->pppopt,"-MDL_FLOAT=%d",prec);
+    getobsfrqidx(frq,SYS_GPS,popt->nf,popt->gnss_frq_idx[0]);
+}
+int main(int argc, char **argv)
+{
+    static nav_t nav;
+    static prcopt_t popt[2];
+    static rtk_t rtk[2];
+    const char *type[]={"windup","shapiro","pcv","trop","tide","residual"};
+    static obsd_t obs[MAXOBS],obsc[MAXSAT]; /* pppos() reads MAXSAT obs */
+    gtime_t ts;
+    const char *dir=SIMDIR;
+    char path[1024];
+    double rr[3],hours=24.0,d,dres=0.0,dpos=0.0;
+    int i,j,k,n,nobs,nres=0,stat[2];
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-d")&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-h")&&i+1<argc) hours=atof(argv[++i]);
+    }
+    if (!sim_readnav(dir,&nav)) {
+        fprintf(stderr,"no precise ephemeris: %s%c%s\n",dir,FILEPATHSEP,SIMSP3);
+        return -1;
+    }
+    pos2ecef(sim_pos,rr);
+    ts=epoch2time(sim_ep0);
+    n=(int)(hours*3600.0/TINT);
+    if (n<=0||!addeph(ts,hours,&nav)) {
+        fprintf(stderr,"broadcast ephemeris error\n");
+        return -1;
+    }
+    sprintf(path,"%s%c%s",dir,FILEPATHSEP,ERPFILE);
+    if (!readerp(path,&nav.erp)) {
+        fprintf(stderr,"no erp data: %s\n",path);
+        return -1;
+    }
+    for (i=0;i<2;i++) {
+        setopt(popt+i,i?1:2);
+        setpcv(popt[i].pcvr,nav.pcvs);
+        sprintf(path,"%s%c%s",dir,FILEPATHSEP,BLQFILE);
+        if (!readblq(path,STANAME,popt[i].odisp[0])) {
+            fprintf(stderr,"no ocean loading parameters: %s %s\n",path,STANAME);
+            return -1;
+        }
+        rtkinit(rtk+i,popt+i,NULL);
+        for (j=0;j<3;j++) rtk[i].sol.rr[j]=rr[j]; /* approx position as postpos() */
+    }
+
+    tracelevel(-1); /* suppress outlier messages */
+
+    for (k=0;k<n;k++) {
+        if ((nobs=sim_obs(timeadd(ts,k*TINT),rr,&nav,SYS_GPS,obs))<=0) continue;
+
+        for (i=0;i<2;i++) {
+            memcpy(obsc,obs,sizeof(obsd_t)*nobs);
+            stat[i]=rtkpos(rtk+i,obsc,nobs,&nav);
+        }
+        if (!stat[0]||!stat[1]||rtk[0].sol.stat!=SOLQ_PPP||
+            rtk[1].sol.stat!=SOLQ_PPP) continue;
+
+        for (i=0;i<MAXSAT;i++) {
+            if (!rtk[0].ssat[i].vsat[0]||!rtk[1].ssat[i].vsat[0]) continue;
+            if ((d=fabs(rtk[0].ssat[i].resc[0]-rtk[1].ssat[i].resc[0]))>dres) {
+                dres=d;
+            }
+            nres++;
+        }
+        for (j=0,d=0.0;j<3;j++) d+=SQR(rtk[0].sol.rr[j]-rtk[1].sol.rr[j]);
+        if (sqrt(d)>dpos) dpos=sqrt(d);
+    }
+    for (i=0;i<6;i++) {
+        printf("single-double model diff %-8s: %.2E m\n",type[i],rtk[0].mdlerr[i]);
+    }
+    printf("ppp %s %d epochs: %d phase residuals, max residual diff %.2E m "
+           "(target %.0E m), max position diff %.2E m\n",STANAME,n,nres,dres,
+           TOL_RES,dpos);
+
+    for (i=0;i<2;i++) rtkfree(rtk+i);
+    freenav(&nav,0xFF);
+    return dres>TOL_RES||nres<=0;
+}
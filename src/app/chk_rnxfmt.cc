@@ -0,0 +1,302 @@
+/*------------------------------------------------------------------------------
+* chk_rnxfmt.cc : check of rinex field formatting and rinex conversion time
+*
+* compares fixf2str() with sprintf("%*.*f") and navf2str() (rinex navigation
+* data field of outnavf_n()) with the printf form " %s.%0*.0f%s%+03.0f" byte
+* for byte over edge values (zeros, negative zero, rounding ties and their
+* neighbours, mantissa carry, large exponents, non-finite) and random values.
+* then generates an rtcm 3 stream of the simulated gps and galileo
+* observations of the GNSS_DATA day (simobs.h) and times its conversion to
+* rinex 3.04 obs/nav files by convrnx()
+*
+* usage  : chk_rnxfmt [-n ncase] [-s seed] [-d dir] [-o dir] [-h hours]
+*                     [-i tint]
+*          -n ncase  number of random values (default 1000000)
+*          -s seed   random seed
+*          -d dir    GNSS_DATA directory (default GNSS_DATA)
+*          -o dir    output directory (default .)
+*          -h hours  time span of converted stream (h) (default 24)
+*          -i tint   observation interval of converted stream (s) (default 30)
+* output : number of checked fields and mismatches, ns per field, convrnx
+*          time and number of converted observation data. exit status 1 if
+*          any field differs or the converted observations are missing
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+#include "simobs.h"
+
+#define NERRMSG     5           /* max number of mismatch messages */
+
+static const int navn[]={12,4,9,10}; /* mantissa digits of nav fields */
+
+static int nchk=0,nerr=0;       /* number of checks and mismatches */
+
+/* random number (xorshift) --------------------------------------------------*/
+static uint32_t rnd(uint32_t *s)
+{
+    *s^=*s<<13; *s^=*s>>17; *s^=*s<<5;
+    return *s;
+}
+/* uniform random number in [0,1) --------------------------------------------*/
+static double rndu(uint32_t *s)
+{
+    return (rnd(s)>>5)*(1.0/134217728.0)+(rnd(s)>>6)*(1.0/134217728.0/67108864.0);
+}
+/* reference navigation data field (printf form of outnavf_n()) --------------*/
+static int navf_ref(char *buff, double value, int n)
+{
+    double e=(fabs(value)<1E-99)?0.0:floor(log10(fabs(value))+1.0);
+
+    return sprintf(buff," %s.%0*.0f%s%+03.0f",value<0.0?"-":" ",n,
+                   fabs(value)/pow(10.0,e-n),"D",e);
+}
+/* check fixed-point field ---------------------------------------------------*/
+static void chkfixf(double value, int width, int prec)
+{
+    char s1[512],s2[512];
+    int n1,n2;
+
+    n1=fixf2str(s1,value,width,prec);
+    n2=sprintf(s2,"%*.*f",width,prec,value);
+    nchk++;
+    if (n1==n2&&!strcmp(s1,s2)) return;
+    if (nerr++<NERRMSG) {
+        fprintf(stderr,"fixf2str %.17g %d.%d: \"%s\" != \"%s\"\n",value,width,
+                prec,s1,s2);
+    }
+}
+/* check navigation data field -----------------------------------------------*/
+static void chknavf(double value, int n)
+{
+    char s1[512],s2[512];
+    int n1,n2;
+
+    n1=navf2str(s1,value,n);
+    n2=navf_ref(s2,value,n);
+    nchk++;
+    if (n1==n2&&!strcmp(s1,s2)) return;
+    if (nerr++<NERRMSG) {
+        fprintf(stderr,"navf2str %.17g %d: \"%s\" != \"%s\"\n",value,n,s1,s2);
+    }
+}
+/* check value and its neighbours in all formats -----------------------------*/
+static void chkall(double value)
+{
+    double v[3];
+    int i,j,k;
+
+    v[0]=value;
+    v[1]=nextafter(value,-INFINITY);
+    v[2]=nextafter(value, INFINITY);
+    for (i=0;i<3;i++) for (k=0;k<2;k++) {
+        for (j=0;j<=10;j++) chkfixf(k?-v[i]:v[i],14,j);
+        chkfixf(k?-v[i]:v[i],0,3);
+        for (j=0;j<4;j++) chknavf(k?-v[i]:v[i],navn[j]);
+    }
+}
+/* check edge values ---------------------------------------------------------*/
+static void chkedge(void)
+{
+    static const double edge[]={
+        0.0,0.5,1.5,2.5,0.0005,0.0015,0.0025,0.125,1E-4,9.9995,99.9995,
+        999999999.9995,123456789.0005,1E9,1E12,1E15,1E17,1E18,1E19,1E22,
+        0.99999999999995,9.9999999999995,999999999999.5,1.0,10.0,100.0,
+        1E-99,1.1E-99,9.9E-100,1E-100,1E-150,1E150,1E-300,1E300,1E308,
+        1.7976931348623157E308,2.2250738585072014E-308,4.9E-324,CLIGHT,FREQ1,
+        0.1,0.2,0.3
+    };
+    double scale;
+    int i,j,k;
+
+    for (i=0;i<(int)(sizeof(edge)/sizeof(double));i++) chkall(edge[i]);
+
+    /* non-finite */
+    for (i=0;i<2;i++) {
+        chkfixf(i?-INFINITY:INFINITY,14,3);
+        chknavf(i?-INFINITY:INFINITY,12);
+    }
+    chkfixf(NAN,14,3);
+    chknavf(NAN,12);
+
+    /* decimal ties of fixed-point and nav mantissa */
+    for (i=0;i<=9;i++) {
+        for (j=0,scale=pow(10.0,-i);j<1000;j++) chkall((j+0.5)*scale);
+    }
+    for (i=-30;i<=30;i++) {
+        for (k=0;k<4;k++) {
+            scale=pow(10.0,i-navn[k]);
+            for (j=0;j<20;j++) chkall((pow(10.0,navn[k]-1)*(j+1)+0.5)*scale);
+        }
+    }
+}
+/* check random values -------------------------------------------------------*/
+static void chkrand(int n, uint32_t seed)
+{
+    double v,a;
+    int i,prec;
+
+    for (i=0;i<n;i++) {
+        prec=(int)(rnd(&seed)%10);
+        a=pow(10.0,rndu(&seed)*18.0-8.0);
+        v=(rnd(&seed)&1?-1.0:1.0)*a;
+        chkfixf(v,(int)(rnd(&seed)%20),prec);
+        chkfixf(floor(v*pow(10.0,prec))/pow(10.0,prec)+0.5*pow(10.0,-prec),14,
+                prec);
+        v=(rnd(&seed)&1?-1.0:1.0)*pow(10.0,rndu(&seed)*600.0-300.0);
+        chknavf(v,navn[rnd(&seed)%4]);
+    }
+}
+/* time of formatting values (ns/field) --------------------------------------*/
+static void timefmt(double *tfix, double *tnav)
+{
+    char s[512];
+    uint32_t seed=1,tick;
+    double *v,sum=0.0;
+    int i,j,n=1000000;
+
+    if (!(v=mat(n,1))) return;
+    for (i=0;i<n;i++) v[i]=rndu(&seed)*4E7-2E7;
+    for (j=0;j<4;j++) {
+        tick=tickget();
+        for (i=0;i<n;i++) {
+            switch (j) {
+                case 0: fixf2str(s,v[i],14,3);          break;
+                case 1: sprintf(s,"%14.3f",v[i]);        break;
+                case 2: navf2str(s,v[i]*1E-9,12);       break;
+                case 3: navf_ref(s,v[i]*1E-9,12);       break;
+            }
+            sum+=s[13];
+        }
+        (j<2?tfix:tnav)[j%2]=(tickget()-tick)*1E6/n;
+    }
+    if (sum==0.0) fprintf(stderr," "); /* keep the formatting */
+    free(v);
+}
+/* generate rtcm 3 stream of simulated observations --------------------------*/
+static int genrtcm(const char *file, const char *dir, double hours, double tint,
+                   int *nobs)
+{
+    static nav_t nav;
+    static rtcm_t rtcm;
+    FILE *fp;
+    eph_t eph;
+    gtime_t ts,time;
+    double rr[3];
+    int i,j,n,ne=(int)(7200.0/tint),type[]={1005,1077,1097};
+
+    *nobs=0;
+    if (!sim_readnav(dir,&nav)) {
+        fprintf(stderr,"no precise ephemeris: %s%c%s\n",dir,FILEPATHSEP,SIMSP3);
+        return 0;
+    }
+    if (!(fp=fopen(file,"wb"))) {
+        freenav(&nav,0xFF);
+        return 0;
+    }
+    init_rtcm(&rtcm);
+    pos2ecef(sim_pos,rr);
+    ts=epoch2time(sim_ep0);
+    for (i=0;i<3;i++) rtcm.sta.pos[i]=rr[i];
+
+    for (i=0;i<(int)(hours*3600.0/tint);i++) {
+        time=timeadd(ts,i*tint);
+        if (ne<=0||i%ne==0) {
+            for (j=1;j<=MAXSAT;j++) {
+                if (!sim_eph(j,time,&nav,&eph)) continue;
+                rtcm.nav.eph[j-1]=eph;
+                rtcm.ephsat=j;
+                if (gen_rtcm3(&rtcm,1019,0,0)) fwrite(rtcm.buff,rtcm.nbyte,1,fp);
+            }
+        }
+        if ((n=sim_obs(time,rr,&nav,SYS_GPS|SYS_GAL,rtcm.obs.data))<=0) continue;
+        rtcm.obs.n=n;
+        rtcm.time=time;
+        for (j=0;j<3;j++) {
+            if (gen_rtcm3(&rtcm,type[j],0,j<2)) fwrite(rtcm.buff,rtcm.nbyte,1,fp);
+        }
+        *nobs+=n;
+    }
+    fclose(fp);
+    free_rtcm(&rtcm);
+    freenav(&nav,0xFF);
+    return *nobs>0;
+}
+/* convert rtcm 3 stream to rinex (s) ----------------------------------------*/
+static double convobs(const char *file, char **ofile)
+{
+    prcopt_t popt=prcopt_default;
+    rnxopt_t opt={{0}};
+    uint32_t tick;
+    int i;
+
+    opt.rnxver=304;
+    opt.navsys=SYS_GPS|SYS_GAL;
+    opt.obstype=OBSTYPE_ALL;
+    opt.freqtype=FREQTYPE_ALL;
+    opt.ttol=0.005;
+    opt.trtcm=epoch2time(sim_ep0);
+    for (i=0;i<7;i++) memset(opt.mask[i],'1',sizeof(opt.mask[i])-1);
+    strcpy(opt.prog,"chk_rnxfmt");
+
+    tick=tickget();
+    if (convrnx(&popt,STRFMT_RTCM3,&opt,file,ofile)<=0) return -1.0;
+    return (tickget()-tick)*1E-3;
+}
+int main(int argc, char **argv)
+{
+    prcopt_t popt=prcopt_default;
+    static obs_t obs;
+    static nav_t nav;
+    const char *dir=SIMDIR,*odir=".";
+    char file[1024],path[9][1024],*ofile[9];
+    uint32_t seed=20201;
+    double hours=24.0,tint=30.0,tfix[2]={0},tnav[2]={0},tc;
+    int i,n=1000000,nobs,nchke,stat;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-n")&&i+1<argc) n=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-s")&&i+1<argc) seed=(uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-d")&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-o")&&i+1<argc) odir=argv[++i];
+        else if (!strcmp(argv[i],"-h")&&i+1<argc) hours=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-i")&&i+1<argc) tint=atof(argv[++i]);
+    }
+    chkedge();
+    nchke=nchk;
+    chkrand(n,seed);
+    timefmt(tfix,tnav);
+
+    printf("fields: %d edge, %d random, %d mismatch\n",nchke,nchk-nchke,nerr);
+    printf("fixf2str %.1f ns, sprintf(\"%%14.3f\") %.1f ns, navf2str %.1f ns, "
+           "printf form %.1f ns\n",tfix[0],tfix[1],tnav[0],tnav[1]);
+
+    if (tint<=0.0) return -1;
+    sprintf(file,"%s%cchk_rnxfmt.rtcm3",odir,FILEPATHSEP);
+    for (i=0;i<9;i++) {
+        *path[i]='\0';
+        ofile[i]=path[i];
+    }
+    sprintf(path[0],"%s%cchk_rnxfmt.obs",odir,FILEPATHSEP);
+    sprintf(path[1],"%s%cchk_rnxfmt.nav",odir,FILEPATHSEP);
+
+    if (!genrtcm(file,dir,hours,tint,&nobs)) {
+        fprintf(stderr,"rtcm 3 stream generation error: %s\n",file);
+        return -1;
+    }
+    tracelevel(-1); /* suppress station list of convrnx() */
+
+    if ((tc=convobs(file,ofile))<0.0) {
+        fprintf(stderr,"rinex conversion error: %s\n",file);
+        return -1;
+    }
+    popt.navsys=SYS_GPS|SYS_GAL;
+    readrnx(&popt,path[0],1,"",&obs,&nav,NULL);
+    readrnx(&popt,path[1],1,"",NULL,&nav,NULL);
+
+    printf("convrnx %.0f h at %.0f s: %.2f s, %d/%d obs data, %d eph\n",hours,
+           tint,tc,obs.n,nobs,nav.n);
+
+    stat=nerr>0||obs.n!=nobs||nav.n<=0;
+    free(obs.data);
+    freenav(&nav,0xFF);
+    return stat;
+}
@@ -0,0 +1,128 @@
+/*------------------------------------------------------------------------------
+* convbat.cc : batch receiver raw/rtcm to rinex converter
+*
+* converts receiver log files to rinex observation and navigation files in
+* parallel by convrnx_batch(). the output files of <dir>/<name>.<ext> are
+* <dir>/<name>.obs and <dir>/<name>.nav (mixed navigation)
+*
+* usage  : convbat [option ...] file ...
+* option : -r format   receiver format (default: by file extension)
+*                      rtcm2,rtcm3,nov,cnav,ubx,sbp,hemis,stq,javad,nvs,
+*                      binex,rt17,sbf,tersus
+*          -v ver      rinex version (default 3.04)
+*          -ti tint    observation time interval (s) (default all)
+*          -d dir      output directory (default same as input file)
+*          -j nthread  number of conversion threads (default number of files)
+*          -trace level output trace level (convbat.trace)
+* return : exit status 0 if all files are converted
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define MAXBATFILE  256         /* max number of input files */
+#define NOUTFILE    9           /* number of output files per job */
+
+static const char *fmtnames[]={ /* receiver format names */
+    "rtcm2","rtcm3","nov","cnav","ubx","sbp","hemis","stq","gw10","javad",
+    "nvs","binex","rt17","sbf","cmr","tersus",NULL
+};
+static const char *fmtexts[]={  /* receiver format file extensions */
+    ".rtcm2",".rtcm3",".gps",".cnav",".ubx",".sbp",".bin",".stq",".gw10",
+    ".jps",".nvs",".bnx",".rt17",".sbf",".cmr",".trs",NULL
+};
+/* receiver format by name or file extension ---------------------------------*/
+static int getformat(const char *name, const char *file)
+{
+    const char *ext;
+    int i;
+
+    if (name) {
+        for (i=0;fmtnames[i];i++) if (!strcmp(name,fmtnames[i])) return i;
+        return -1;
+    }
+    if (!(ext=strrchr(file,'.'))) return -1;
+    for (i=0;fmtexts[i];i++) if (!strcmp(ext,fmtexts[i])) return i;
+    if (!strcmp(ext,".rtcm")||!strcmp(ext,".rtcm3")) return STRFMT_RTCM3;
+    return -1;
+}
+/* output file path ----------------------------------------------------------*/
+static void outpath(const char *file, const char *dir, const char *ext,
+                    char *path)
+{
+    const char *p,*name=file;
+    char *q;
+
+    if (*dir) {
+        if ((p=strrchr(file,FILEPATHSEP))) name=p+1;
+        sprintf(path,"%s%c%s",dir,FILEPATHSEP,name);
+    }
+    else strcpy(path,file);
+    if ((q=strrchr(path,'.'))&&!strchr(q,FILEPATHSEP)) *q='\0';
+    strcat(path,ext);
+}
+int main(int argc, char **argv)
+{
+    static rnxopt_t opt[MAXBATFILE];
+    rnxopt_t opt0={{0}};
+    prcopt_t popt=prcopt_default;
+    const char *fmt=NULL,*dir="";
+    char *file[MAXBATFILE],*ofile[MAXBATFILE*NOUTFILE];
+    int i,j,n=0,nok,format[MAXBATFILE],stat[MAXBATFILE],nthread=0,trlevel=0;
+    unsigned int tick;
+
+    opt0.rnxver=304;
+    opt0.navsys=SYS_ALL;
+    opt0.obstype=OBSTYPE_ALL;
+    opt0.freqtype=FREQTYPE_ALL;
+    opt0.ttol=0.005;
+    for (i=0;i<7;i++) memset(opt0.mask[i],'1',sizeof(opt0.mask[i])-1);
+    strcpy(opt0.prog,"convbat");
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-r" )&&i+1<argc) fmt=argv[++i];
+        else if (!strcmp(argv[i],"-v" )&&i+1<argc) opt0.rnxver=(int)(atof(argv[++i])*100.0+0.5);
+        else if (!strcmp(argv[i],"-ti")&&i+1<argc) opt0.tint=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-d" )&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-j" )&&i+1<argc) nthread=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-trace")&&i+1<argc) trlevel=atoi(argv[++i]);
+        else if (*argv[i]=='-') {
+            fprintf(stderr,"unknown option: %s\n",argv[i]);
+            return -1;
+        }
+        else if (n<MAXBATFILE) file[n++]=argv[i];
+    }
+    if (n<=0) {
+        fprintf(stderr,"usage: convbat [-r format] [-v ver] [-ti tint] [-d dir] "
+                "[-j nthread] [-trace level] file ...\n");
+        return -1;
+    }
+    if (trlevel>0) {
+        traceopen("convbat.trace");
+        tracelevel(trlevel);
+    }
+    for (i=0;i<n;i++) {
+        if ((format[i]=getformat(fmt,file[i]))<0) {
+            fprintf(stderr,"unknown receiver format: %s\n",fmt?fmt:file[i]);
+            return -1;
+        }
+        opt[i]=opt0;
+        for (j=0;j<NOUTFILE;j++) {
+            ofile[i*NOUTFILE+j]=(char *)calloc(1024,1);
+        }
+        outpath(file[i],dir,".obs",ofile[i*NOUTFILE  ]);
+        outpath(file[i],dir,".nav",ofile[i*NOUTFILE+1]);
+    }
+    tick=tickget();
+
+    nok=convrnx_batch(&popt,n,format,opt,file,ofile,nthread,stat);
+
+    for (i=0;i<n;i++) {
+        fprintf(stderr,"%s: %s -> %s\n",stat[i]>0?"ok   ":"error",file[i],
+                ofile[i*NOUTFILE]);
+    }
+    fprintf(stderr,"converted %d/%d files in %.1f s\n",nok,n,
+            (tickget()-tick)*1E-3);
+
+    for (i=0;i<n*NOUTFILE;i++) free(ofile[i]);
+    if (trlevel>0) traceclose();
+    return nok==n?0:1;
+}
@@ -1,4 +1,18 @@
 #include "rtklib.h"
+#ifndef WIN32
+#include <sys/wait.h>
+#include <errno.h>
+#endif
+
+#define MAXDAYJOB   32          /* max number of days processed concurrently */
+#define DAYMEMFACT  4.0         /* ratio of in-memory to file size of daily data */
+
+typedef struct {                /* daily processing result type */
+    int stat;                   /* status (1:ok,0:error,-1:not processed) */
+    int nepoch,nfix;            /* number of processed/fixed epochs */
+    double tt;                  /* processing time (s) */
+    double mem;                 /* estimated memory of daily data (MB) */
+} dayres_t;
 
 extern int process(prcopt_t *popt, filopt_t *fopt, solopt_t *sopt) {
     int i;
@@ -109,17 +123,270 @@ extern int process(prcopt_t *popt, filopt_t *fopt, solopt_t *sopt) {
     return ret;
 }
 
+/* size of file or files in directory (bytes) --------------------------------*/
+static double filesize(const char *path)
+{
+    struct stat st;
+    struct dirent *file;
+    char path_[1024];
+    double size=0.0;
+    DIR *dir;
+
+    if (!*path||stat(path,&st)) return 0.0;
+    if (!S_ISDIR(st.st_mode)) return (double)st.st_size;
+    if (!(dir=opendir(path))) return 0.0;
+    while ((file=readdir(dir))!=nullptr) {
+        if (file->d_name[0]=='.') continue;
+        sprintf(path_,"%s%c%s",path,FILEPATHSEP,file->d_name);
+        if (!stat(path_,&st)&&!S_ISDIR(st.st_mode)) size+=(double)st.st_size;
+    }
+    closedir(dir);
+    return size;
+}
+/* estimate memory of daily data (MB) ----------------------------------------*/
+static double daymem(const prcopt_t *popt, const filopt_t *fopt)
+{
+    char obs_dir[1024];
+    double ep[6],size=0.0;
+    int i;
+
+    time2epoch(popt->ts,ep);
+    sprintf(obs_dir,"%s%c%04d%c%03d%c%s",popt->prcdir,FILEPATHSEP,int(ep[0]),
+            FILEPATHSEP,int(time2doy(popt->ts)),FILEPATHSEP,
+            popt->obsdir[0]!='\0'?popt->obsdir:"obs");
+    size+=filesize(obs_dir);
+    for (i=0;i<3;i++) {
+        if (fopt->navf[i]) size+=filesize(fopt->navf[i]);
+        if (popt->sateph!=EPHOPT_PREC) continue;
+        if (fopt->sp3f[i]) size+=filesize(fopt->sp3f[i]);
+        if (fopt->clkf[i]) size+=filesize(fopt->clkf[i]);
+    }
+    size+=filesize(fopt->bia)+filesize(fopt->fcb)+filesize(fopt->atx)+
+          filesize(fopt->iono)+filesize(fopt->mgexdcb);
+    return size*DAYMEMFACT/1048576.0;
+}
+/* set processing options of day ---------------------------------------------*/
+static int setday(const prcopt_t *popt, const solopt_t *sopt, const filopt_t *fopt,
+                  int day, prcopt_t *popt_, solopt_t *sopt_, filopt_t *fopt_)
+{
+    int nsta;
+
+    *popt_=*popt;
+    *sopt_=*sopt;
+    *fopt_=*fopt;
+    if (popt->prctype) {
+        popt_->ts=timeadd(popt->ts,86400.0*day);
+        popt_->te=timeadd(popt->ts,86400.0*(day+1));
+    }
+    return loadprcfiles(popt_->prcdir,popt_,fopt_,nullptr,&nsta);
+}
+/* process day ---------------------------------------------------------------*/
+static void procday(prcopt_t *popt, filopt_t *fopt, solopt_t *sopt, long t1,
+                    dayres_t *res)
+{
+    unsigned int tick=tickget();
+    int nepoch,nfix;
+
+    postposstat(&nepoch,&nfix);
+    res->stat=process(popt,fopt,sopt)?1:0;
+    res->tt=(tickget()-tick)*1E-3;
+    postposstat(&res->nepoch,&res->nfix);
+    res->nepoch-=nepoch;
+    res->nfix-=nfix;
+
+    if (res->stat) {
+        long t2=clock();
+        double t=(double)(t2-t1)/CLOCKS_PER_SEC;
+        fprintf(stderr,"total sec: %5.2f\n",t);
+        fflush(stderr);
+    }
+    else{
+        fprintf(stderr,"%s PROCESS ERROR!\n",popt->site_name);
+        fflush(stderr);
+    }
+}
+/* process days sequentially -------------------------------------------------*/
+static int procdays(const prcopt_t *popt, const solopt_t *sopt, const filopt_t *fopt,
+                    int nday, long t1, dayres_t *res)
+{
+    prcopt_t popt_;
+    solopt_t sopt_;
+    filopt_t fopt_;
+    int i;
+
+    for (i=0;i<nday;i++) {
+        if (!setday(popt,sopt,fopt,i,&popt_,&sopt_,&fopt_)) break;
+        res[i].mem=daymem(&popt_,&fopt_);
+        procday(&popt_,&fopt_,&sopt_,t1,res+i);
+        freeprcfiles(&popt_,&fopt_);
+    }
+    return i;
+}
+#ifndef WIN32
+/* process days concurrently ---------------------------------------------------
+* each day runs in a forked process so that the global session data of postpos
+* (obs, nav, products) are isolated between days. the log to stderr of a day
+* is buffered to a temporary file and output in the order of days
+*-----------------------------------------------------------------------------*/
+static int procdays_p(const prcopt_t *popt, const solopt_t *sopt, const filopt_t *fopt,
+                      int nday, int njob, double budget, long t1, dayres_t *res)
+{
+    prcopt_t popt_;
+    solopt_t sopt_;
+    filopt_t fopt_;
+    pid_t *pid=(pid_t *)calloc(nday,sizeof(pid_t));
+    FILE **fp=(FILE **)calloc(nday,sizeof(FILE *));
+    int *fd=(int *)calloc(nday,sizeof(int)),*done=(int *)calloc(nday,sizeof(int));
+    int i=0,j,k,c,nrun=0,iout=0,stat,fds[2],end=0;
+    double mem=0.0;
+    pid_t p;
+
+    if (!pid||!fp||!fd||!done) {
+        free(pid); free(fp); free(fd); free(done);
+        return procdays(popt,sopt,fopt,nday,t1,res);
+    }
+    while (iout<i||(i<nday&&!end)) {
+
+        /* launch days within number of jobs and memory budget */
+        while (i<nday&&!end&&nrun<njob) {
+            if (!setday(popt,sopt,fopt,i,&popt_,&sopt_,&fopt_)) {
+                end=1;
+                break;
+            }
+            res[i].mem=daymem(&popt_,&fopt_);
+            if (nrun>0&&budget>0.0&&mem+res[i].mem>budget) {
+                freeprcfiles(&popt_,&fopt_);
+                break;
+            }
+            fflush(NULL);
+            if (!(fp[i]=tmpfile())||pipe(fds)) {
+                if (fp[i]) fclose(fp[i]);
+                fp[i]=nullptr;
+                freeprcfiles(&popt_,&fopt_);
+                if (nrun>0) break;
+                procday(&popt_,&fopt_,&sopt_,t1,res+i); /* fallback */
+                done[i++]=1;
+                continue;
+            }
+            if ((p=fork())<0) {
+                fclose(fp[i]); fp[i]=nullptr;
+                close(fds[0]); close(fds[1]);
+                freeprcfiles(&popt_,&fopt_);
+                if (nrun>0) break;
+                procday(&popt_,&fopt_,&sopt_,t1,res+i); /* fallback */
+                done[i++]=1;
+                continue;
+            }
+            if (p==0) { /* child */
+                close(fds[0]);
+                dup2(fileno(fp[i]),2);
+                procday(&popt_,&fopt_,&sopt_,clock(),res+i);
+                fflush(NULL);
+                stat=write(fds[1],res+i,sizeof(dayres_t))==(ssize_t)sizeof(dayres_t);
+                _exit(stat?0:1);
+            }
+            close(fds[1]);
+            freeprcfiles(&popt_,&fopt_);
+            pid[i]=p;
+            fd[i]=fds[0];
+            mem+=res[i].mem;
+            nrun++;
+            i++;
+        }
+        /* wait for a day to finish */
+        if (nrun>0&&(p=wait(&stat))>0) {
+            for (j=0;j<i;j++) if (pid[j]==p&&!done[j]) break;
+            if (j<i) {
+                if (read(fd[j],res+j,sizeof(dayres_t))!=(ssize_t)sizeof(dayres_t)) {
+                    res[j].stat=0;
+                }
+                close(fd[j]);
+                mem-=res[j].mem;
+                done[j]=1;
+                nrun--;
+            }
+        }
+        else if (nrun>0&&errno!=EINTR) { /* lost children */
+            for (j=0;j<i;j++) {
+                if (!pid[j]||done[j]) continue;
+                res[j].stat=0;
+                close(fd[j]);
+                done[j]=1;
+            }
+            nrun=0;
+            mem=0.0;
+        }
+        /* output logs in order of days */
+        for (;iout<i&&done[iout];iout++) {
+            if (!fp[iout]) continue;
+            rewind(fp[iout]);
+            while ((c=fgetc(fp[iout]))!=EOF) fputc(c,stderr);
+            fclose(fp[iout]);
+        }
+        fflush(stderr);
+    }
+    for (k=iout;k<i;k++) if (fp[k]) fclose(fp[k]);
+    free(pid); free(fp); free(fd); free(done);
+    return i;
+}
+#endif
+/* output summary of days ----------------------------------------------------*/
+static void outsummary(const prcopt_t *popt, int nday, const dayres_t *res,
+                       long t1, unsigned int tick)
+{
+    gtime_t ts;
+    double ep[6];
+    int i,nepoch=0,nfix=0,nok=0;
+
+    fprintf(stderr,"\n%4s %8s %6s %8s %8s %7s %9s %8s\n","DAY","YYYY/DOY",
+            "STAT","EPOCH","FIX","FIX(%)","TIME(s)","MEM(MB)");
+    for (i=0;i<nday;i++) {
+        ts=popt->prctype?timeadd(popt->ts,86400.0*i):popt->ts;
+        time2epoch(ts,ep);
+        fprintf(stderr,"%4d %04d/%03d %6s %8d %8d %7.1f %9.2f %8.1f\n",i+1,
+                int(ep[0]),int(time2doy(ts)),res[i].stat==1?"OK":"ERROR",
+                res[i].nepoch,res[i].nfix,
+                res[i].nepoch>0?res[i].nfix*100.0/res[i].nepoch:0.0,
+                res[i].tt,res[i].mem);
+        nepoch+=res[i].nepoch;
+        nfix+=res[i].nfix;
+        if (res[i].stat==1) nok++;
+    }
+    fprintf(stderr,"%4s %8s %2d/%-3d %8d %8d %7.1f %9.2f\n","ALL","",nok,nday,
+            nepoch,nfix,nepoch>0?nfix*100.0/nepoch:0.0,(tickget()-tick)*1E-3);
+    fprintf(stderr,"total cpu sec: %5.2f\n",(double)(clock()-t1)/CLOCKS_PER_SEC);
+    fflush(stderr);
+}
+/* parse options of day scheduler --------------------------------------------*/
+static void parsejob(int argc, char **argv, int *njob, double *budget)
+{
+    for (int i=0;i<argc;i++) {
+        if (!strcmp(argv[i],"-J")&&i+1<argc) {
+            *njob=atoi(argv[++i]);
+            if (*njob<1) *njob=1;
+            if (*njob>MAXDAYJOB) *njob=MAXDAYJOB;
+        }
+        else if (!strcmp(argv[i],"-B")&&i+1<argc) {
+            *budget=atof(argv[++i]);
+        }
+    }
+}
+
 int main(int argc,char **argv)
 {
     long t1=clock();
-    prcopt_t popt=prcopt_default,popt_;
-    solopt_t sopt=solopt_default,sopt_;
-    filopt_t fopt={0},fopt_;
-    int nsta;
-    int port = 0;
+    unsigned int tick=tickget();
+    prcopt_t popt=prcopt_default;
+    solopt_t sopt=solopt_default;
+    filopt_t fopt={0};
+    dayres_t *res;
+    double budget=0.0; /* memory budget of concurrent days (MB) (0:no limit) */
+    int njob=1,port=0;
 
     if(!parsecmd(argc,argv,&popt,&sopt,&fopt,&port)) return 0;
 
+    parsejob(argc,argv,&njob,&budget);
+
     gtime_t ts=popt.ts,te=popt.te;
     int nday;
 
@@ -130,29 +397,18 @@ int main(int argc,char **argv)
         nday=newround(timediff(popt.te,popt.ts)/86400.0);
         if(nday>1) popt.prctype=1;
     }
+    if (nday<=0||!(res=(dayres_t *)calloc(nday,sizeof(dayres_t)))) return 0;
+    for (int i=0;i<nday;i++) res[i].stat=-1;
 
-    for(int i=0;i<nday;i++){
-        popt_=popt;
-        sopt_=sopt;
-        fopt_=fopt;
-        if(popt.prctype){
-            popt_.ts=timeadd(ts,86400.0*i);
-            popt_.te=timeadd(ts,86400.0*(i+1));
-        }
-
-        if(!loadprcfiles(popt_.prcdir,&popt_,&fopt_, nullptr,&nsta)) return 0;
-
-        if(process(&popt_,&fopt_,&sopt_)){
-            long t2=clock();
-            double t=(double)(t2-t1)/CLOCKS_PER_SEC;
-            fprintf(stderr,"total sec: %5.2f\n",t);
-            fflush(stderr);
-        }
-        else{
-            fprintf(stderr,"%s PROCESS ERROR!\n",popt_.site_name);
-            fflush(stderr);
-        }
-
-        freeprcfiles(&popt_,&fopt_);
+#ifndef WIN32
+    if (njob>1&&nday>1) {
+        nday=procdays_p(&popt,&sopt,&fopt,nday,njob,budget,t1,res);
     }
-}
\ No newline at end of file
+    else
+#endif
+    nday=procdays(&popt,&sopt,&fopt,nday,t1,res);
+
+    if (nday>1) outsummary(&popt,nday,res,t1,tick);
+    free(res);
+    return 0;
+}
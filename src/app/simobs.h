@@ -0,0 +1,204 @@
+/*------------------------------------------------------------------------------
+* simobs.h : simulated observations of the bundled GNSS_DATA day
+*
+* generates noise-free dual-frequency code and carrier-phase observations of
+* a static station (AGGO) from the precise orbits and clocks of the bundled
+* GNSS_DATA day (2020/01/01, gbm sp3) for the check and benchmark programs
+*
+* notes  : include after rtklib.h. the observations contain the geometric
+*          range, satellite clock, saastamoinen troposphere, klobuchar
+*          ionosphere and constant integer ambiguities. no receiver clock,
+*          antenna, windup, tide or noise terms are added
+*-----------------------------------------------------------------------------*/
+#ifndef SIMOBS_H
+#define SIMOBS_H
+
+#define SIMDIR      "GNSS_DATA" /* default GNSS_DATA directory */
+#define SIMSP3      "2020/001/products/gbm/GBM0MGXRAP_20200010000_01D_05M_ORB.SP3"
+#define SIMELMIN    (10.0*D2R)  /* elevation mask of simulated obs (rad) */
+#define SIMMU       3.9860050E14 /* gps gravitational constant (m^3/s^2) */
+
+static const double sim_ep0[]={2020,1,1,0,0,0};     /* start of day (gpst) */
+static const double sim_pos[]={-34.8737*D2R,-58.1399*D2R,40.0}; /* station */
+static const double sim_ion[]={ /* klobuchar parameters */
+    0.1118E-07,-0.7451E-08,-0.5961E-07, 0.1192E-06,
+    0.1167E+06,-0.2294E+06,-0.1311E+06, 0.1049E+07
+};
+/* read precise orbits and clocks of GNSS_DATA day ---------------------------*/
+static int sim_readnav(const char *dir, nav_t *nav)
+{
+    char path[1024];
+
+    sprintf(path,"%s%c%s",dir,FILEPATHSEP,SIMSP3);
+    readsp3(path,nav,0);
+    return nav->ne>0;
+}
+/* simulated observation codes of satellite (0: not simulated) ---------------*/
+static int sim_codes(int sat, uint8_t *code)
+{
+    switch (satsys(sat,NULL)) {
+        case SYS_GPS: code[0]=CODE_L1C; code[1]=CODE_L2W; return 1;
+        case SYS_GAL: code[0]=CODE_L1C; code[1]=CODE_L5Q; return 1;
+    }
+    return 0;
+}
+/* simulated observations of epoch ---------------------------------------------
+* args   : gtime_t time     I   receiver time (gpst)
+*          double *rr       I   receiver position (ecef) (m)
+*          nav_t  *nav      I   navigation data with precise ephemeris
+*          int    sys       I   navigation systems (SYS_GPS|SYS_GAL)
+*          obsd_t *obs      O   observations (MAXOBS)
+* return : number of observations
+*-----------------------------------------------------------------------------*/
+static int sim_obs(gtime_t time, const double *rr, const nav_t *nav, int sys,
+                   obsd_t *obs)
+{
+    uint8_t code[2];
+    double pos[3],rs[6],dts[2],var,e[3],azel[2],r,tau,trp,ion,freq,zh,zw;
+    int i,j,k,n=0,idx;
+
+    ecef2pos(rr,pos);
+    for (i=1;i<=MAXSAT&&n<MAXOBS;i++) {
+        if (!(satsys(i,NULL)&sys)||!sim_codes(i,code)) continue;
+
+        for (j=0,tau=0.075;j<3;j++) { /* iterate signal transmission time */
+            if (!peph2pos(NULL,timeadd(time,-tau),i,nav,NULL,0,rs,dts,&var)||
+                dts[0]==0.0) break;
+            tau=geodist(rs,rr,e)/CLIGHT;
+        }
+        if (j<3||satazel(pos,e,azel)<SIMELMIN) continue;
+
+        r=geodist(rs,rr,e)-CLIGHT*dts[0];
+        trp=saastamoinen(time,pos,azel,0.7,0,&zh,&zw);
+        ion=klobuchar_GPS(time,sim_ion,pos,azel);
+
+        memset(obs+n,0,sizeof(obsd_t));
+        obs[n].time=time;
+        obs[n].sat=i;
+        obs[n].rcv=1;
+        for (k=0;k<2;k++) {
+            if ((idx=code2idx(satsys(i,NULL),code[k]))<0||idx>=NFREQ) continue;
+            freq=code2freq(satsys(i,NULL),code[k],0);
+            obs[n].code[idx]=code[k];
+            obs[n].P[idx]=r+trp+ion*SQR(FREQ1/freq);
+            obs[n].L[idx]=(r+trp-ion*SQR(FREQ1/freq))*freq/CLIGHT+(i*7+k*3)%50;
+            obs[n].SNR[idx]=(uint16_t)((45.0+10.0*sin(azel[1]))/SNR_UNIT);
+        }
+        n++;
+    }
+    return n;
+}
+/* rinex options of simulated observations ----------------------------------*/
+static void sim_rnxopt(int sys, gtime_t ts, const double *rr, rnxopt_t *opt)
+{
+    static const char *tobs[][4]={
+        {"C1C","L1C","C2W","L2W"},{""},{"C1C","L1C","C5Q","L5Q"}
+    };
+    int i,j;
+
+    memset(opt,0,sizeof(rnxopt_t));
+    opt->rnxver=304;
+    opt->navsys=sys;
+    opt->tstart=ts;
+    strcpy(opt->prog,"simobs");
+    strcpy(opt->marker,"SIM0");
+    for (i=0;i<7;i++) memset(opt->mask[i],'1',sizeof(opt->mask[i])-1);
+    for (i=0;i<3;i++) {
+        opt->apppos[i]=rr[i];
+        if (!(sys&(i==0?SYS_GPS:i==2?SYS_GAL:0))) continue;
+        for (j=0;j<4;j++) strcpy(opt->tobs[i][j],tobs[i][j]);
+        opt->nobs[i]=4;
+    }
+}
+/* orbit elements of ephemeris as parameter vector --------------------------*/
+static void sim_ephpar(eph_t *eph, double **p)
+{
+    p[ 0]=&eph->A;    p[ 1]=&eph->e;    p[ 2]=&eph->i0;   p[ 3]=&eph->OMG0;
+    p[ 4]=&eph->omg;  p[ 5]=&eph->M0;   p[ 6]=&eph->deln; p[ 7]=&eph->OMGd;
+    p[ 8]=&eph->idot; p[ 9]=&eph->crc;  p[10]=&eph->crs;  p[11]=&eph->cuc;
+    p[12]=&eph->cus;  p[13]=&eph->cic;  p[14]=&eph->cis;
+}
+/* osculating orbit elements of satellite state at toe -----------------------*/
+static void sim_kepler(const double *rs, double toes, eph_t *eph)
+{
+    double r[3],v[3],h[3],ev[3],rn,vn,hn,rv,E,nu,u,Om;
+    int i;
+
+    for (i=0;i<3;i++) r[i]=rs[i];
+    v[0]=rs[3]-OMGE*rs[1]; /* inertial velocity in ecef axes at toe */
+    v[1]=rs[4]+OMGE*rs[0];
+    v[2]=rs[5];
+    cross3(r,v,h);
+    rn=norm(r,3); vn=norm(v,3); hn=norm(h,3); rv=dot(r,v,3);
+    for (i=0;i<3;i++) ev[i]=((vn*vn-SIMMU/rn)*r[i]-rv*v[i])/SIMMU;
+
+    eph->A=1.0/(2.0/rn-vn*vn/SIMMU);
+    eph->e=norm(ev,3);
+    eph->i0=acos(h[2]/hn);
+    Om=atan2(h[0],-h[1]);
+    u=atan2(r[2]/sin(eph->i0),r[0]*cos(Om)+r[1]*sin(Om));
+    nu=atan2(rv*hn/SIMMU,hn*hn/SIMMU-rn);
+    E=2.0*atan(sqrt((1.0-eph->e)/(1.0+eph->e))*tan(nu/2.0));
+    eph->omg=u-nu;
+    eph->M0=E-eph->e*sin(E);
+    eph->OMG0=Om+OMGE*toes;
+    eph->OMGd=-8.0E-9;
+}
+/* broadcast ephemeris of gps satellite ----------------------------------------
+* fit a gps broadcast ephemeris to the precise orbit over toe+/-2h. the clock
+* parameters are taken from the precise clock at toe
+* args   : int    sat       I   satellite number
+*          gtime_t toe      I   time of ephemeris (gpst)
+*          nav_t  *nav      I   navigation data with precise ephemeris
+*          eph_t  *eph      O   broadcast ephemeris
+* return : status (1:ok,0:no precise orbit)
+*-----------------------------------------------------------------------------*/
+static int sim_eph(int sat, gtime_t toe, const nav_t *nav, eph_t *eph)
+{
+    const double dx[]={ /* steps of numerical partial derivatives */
+        1.0,1E-8,1E-9,1E-9,1E-9,1E-9,1E-13,1E-13,1E-13,1E-2,1E-2,1E-9,1E-9,
+        1E-9,1E-9
+    };
+    double rs[6],rp[3],rq[3],dts[2],dtp,var,*p[15],x[15],Q[15*15],*A,*y;
+    int i,j,k,m=0,prn,week,iter;
+
+    if (satsys(sat,&prn)!=SYS_GPS||
+        !peph2pos(NULL,toe,sat,nav,NULL,0,rs,dts,&var)) return 0;
+
+    memset(eph,0,sizeof(eph_t));
+    eph->sat=sat;
+    eph->toes=time2gpst(toe,&week);
+    eph->iode=eph->iodc=(int)(eph->toes/7200.0)%256;
+    eph->week=week;
+    eph->toe=eph->toc=toe;
+    eph->ttr=timeadd(toe,-7200.0);
+    eph->code=1;
+    eph->fit=4.0;
+    eph->f0=dts[0];
+    eph->f1=dts[1];
+    sim_kepler(rs,eph->toes,eph);
+    sim_ephpar(eph,p);
+
+    A=mat(15,3*49); y=mat(3*49,1);
+    for (iter=0;iter<6;iter++) {
+        for (i=-24,m=0;i<=24;i++) {
+            if (!peph2pos(NULL,timeadd(toe,i*300.0),sat,nav,NULL,0,rs,dts,&var)) {
+                continue;
+            }
+            eph2pos(timeadd(toe,i*300.0),eph,rp,&dtp,&var);
+            for (j=0;j<15;j++) {
+                *p[j]+=dx[j];
+                eph2pos(timeadd(toe,i*300.0),eph,rq,&dtp,&var);
+                *p[j]-=dx[j];
+                for (k=0;k<3;k++) A[j+(m+k)*15]=(rq[k]-rp[k])/dx[j];
+            }
+            for (k=0;k<3;k++) y[m+k]=rs[k]-rp[k];
+            m+=3;
+        }
+        if (m<45||lsq(A,y,15,m,x,Q)) break;
+        for (j=0;j<15;j++) *p[j]+=x[j];
+    }
+    free(A); free(y);
+    return iter>=6;
+}
+#endif /* SIMOBS_H */